@@ -0,0 +1,41 @@
+# Checks that nanotts -j N gives as many samples as -j 1, i.e. that the
+# text is only cut where the engine itself ends a sentence.  Each corpus is
+# repeated so that it is long enough to be cut into several pieces.
+#
+#   cmake -DNANOTTS=<nanotts> -DLANG_DIR=<dir> -DCORPUS_DIR=<dir> -DWORK_DIR=<dir>
+#         -DVOICES=<voice;...> -DJOBS=<N> -P check_jobs.cmake
+
+set(failures 0)
+foreach(voice ${VOICES})
+    file(READ "${CORPUS_DIR}/${voice}.txt" corpus)
+    set(text "${corpus}${corpus}${corpus}${corpus}")
+    file(WRITE "${WORK_DIR}/${voice}.txt" "${text}")
+
+    set(sizes "")
+    foreach(jobs 1 ${JOBS})
+        execute_process(
+            COMMAND "${NANOTTS}" -v ${voice} -l "${LANG_DIR}" -c -j ${jobs}
+            INPUT_FILE "${WORK_DIR}/${voice}.txt"
+            OUTPUT_FILE "${WORK_DIR}/${voice}-j${jobs}.pcm"
+            ERROR_QUIET
+            RESULT_VARIABLE result)
+        if (NOT result EQUAL 0)
+            message(FATAL_ERROR "nanotts -v ${voice} -j ${jobs} failed: ${result}")
+        endif()
+        file(SIZE "${WORK_DIR}/${voice}-j${jobs}.pcm" size)
+        list(APPEND sizes ${size})
+    endforeach()
+
+    list(GET sizes 0 serial)
+    list(GET sizes 1 parallel)
+    if (serial EQUAL parallel)
+        message(STATUS "${voice}: ${serial} bytes with -j 1 and -j ${JOBS}")
+    else()
+        message(STATUS "${voice}: ${serial} bytes with -j 1 but ${parallel} with -j ${JOBS}")
+        math(EXPR failures "${failures} + 1")
+    endif()
+endforeach()
+
+if (failures GREATER 0)
+    message(FATAL_ERROR "${failures} voice(s) came out at another length with -j ${JOBS}")
+endif()
@@ -0,0 +1,671 @@
+/* nanotts_bench.cpp
+ *
+ *    Runs a fixed text per voice through the svox engine and reports the
+ *    real-time factor, the time to the first PCM sample, the peak use of
+ *    the engine's memory area and the samples produced per second.
+ *
+ *    The results can be written as JSON (one line per voice, so that two
+ *    runs diff cleanly) and compared against those of an earlier run.
+ *
+ *    The samples can be saved as well, and checked against those of an
+ *    earlier run by their log-spectral distance; that is how a build
+ *    with other DSP arithmetic (e.g. -DPICO_DSP_FLOAT=ON) is held to the
+ *    fixed point reference.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+extern "C"
+{
+#include "picoapi.h"
+#include "picoapid.h"
+#include "picoextapi.h"
+}
+#include "cxxopts.hpp"
+#include "PicoVoices.h"
+
+#define SAMPLE_RATE 16000
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double msSince(bench_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+struct bench_run_t
+{
+    double wall_ms;
+    double ttfa_ms; // time to the first PCM sample
+    unsigned long long samples;
+    unsigned int pcm_hash; // FNV-1a of the samples, to spot changed output
+};
+
+struct bench_result_t
+{
+    std::string voice;
+    size_t text_bytes;
+    unsigned long long samples;
+    unsigned int pcm_hash;
+    double audio_s;
+    double init_ms;
+    double wall_ms; // median of the runs
+    double wall_min_ms;
+    double wall_max_ms;
+    double ttfa_ms; // median of the runs
+    double rtf;
+    double samples_per_s;
+    int peak_arena_bytes;
+};
+
+/*
+================================================
+BenchEngine
+
+one engine with its lingware, driven through the C API directly so that
+the first sample can be timed as soon as the engine has it
+================================================
+*/
+class BenchEngine
+{
+private:
+    pico_System system;
+    pico_Resource ta_resource;
+    pico_Resource sg_resource;
+    pico_Engine engine;
+    void *mem_area;
+    char voice_name[16];
+
+    int fail(const char *what, pico_Status status);
+
+public:
+    BenchEngine() : system(0), ta_resource(0), sg_resource(0), engine(0), mem_area(0) { strcpy(voice_name, "BenchVoice"); }
+    ~BenchEngine();
+
+    int start(const std::string &dir, PicoVoices_t &voices, int pipeline_stages, bool expand_pdfs);
+    int run(const std::string &text, bench_run_t &result, std::vector<short> *pcm = 0);
+    int peakArena();
+};
+
+BenchEngine::~BenchEngine()
+{
+    if (engine)
+    {
+        pico_disposeEngine(system, &engine);
+        pico_releaseVoiceDefinition(system, (pico_Char *)voice_name);
+    }
+    if (sg_resource)
+        pico_unloadResource(system, &sg_resource);
+    if (ta_resource)
+        pico_unloadResource(system, &ta_resource);
+    if (system)
+        pico_terminate(&system);
+    free(mem_area);
+}
+
+int BenchEngine::fail(const char *what, pico_Status status)
+{
+    pico_Retstring message;
+    pico_getSystemStatusMessage(system, status, message);
+    fprintf(stderr, " **error: %s (%i): %s\n", what, status, message);
+    return -1;
+}
+
+int BenchEngine::start(const std::string &dir, PicoVoices_t &voices, int pipeline_stages, bool expand_pdfs)
+{
+    // sized like src/Pico, so the peak arena reported is the engine's own
+    const int MEM_SIZE = PICOCTRL_SYSTEM_MEM_SIZE(pipeline_stages);
+    pico_Retstring ta_name, sg_name;
+    pico_Status ret;
+
+    mem_area = malloc(MEM_SIZE);
+    if ((ret = pico_initialize(mem_area, MEM_SIZE, &system)))
+        return fail("cannot initialize pico", ret);
+    if ((ret = picoext_setPdfExpansion(system, expand_pdfs)))
+        return fail("cannot set the pdf expansion", ret);
+
+    std::string ta_file = dir + voices.getTaName();
+    std::string sg_file = dir + voices.getSgName();
+    if ((ret = picoext_loadSharedResource(system, (const pico_Char *)ta_file.c_str(), &ta_resource)))
+        return fail("cannot load text analysis resource file", ret);
+    if ((ret = picoext_loadSharedResource(system, (const pico_Char *)sg_file.c_str(), &sg_resource)))
+        return fail("cannot load signal generation resource file", ret);
+    if ((ret = pico_getResourceName(system, ta_resource, ta_name)) ||
+        (ret = pico_getResourceName(system, sg_resource, sg_name)))
+        return fail("cannot get resource name", ret);
+
+    if ((ret = pico_createVoiceDefinition(system, (const pico_Char *)voice_name)) ||
+        (ret = pico_addResourceToVoiceDefinition(system, (const pico_Char *)voice_name, (pico_Char *)ta_name)) ||
+        (ret = pico_addResourceToVoiceDefinition(system, (const pico_Char *)voice_name, (pico_Char *)sg_name)))
+        return fail("cannot define the voice", ret);
+
+    if ((ret = picoext_newPipelinedEngine(system, (const pico_Char *)voice_name, pipeline_stages, &engine)))
+        return fail("cannot create a new pico engine", ret);
+    return 0;
+}
+
+static unsigned int fnv1a(unsigned int hash, const void *data, size_t length)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    for (size_t i = 0; i < length; i++)
+        hash = (hash ^ p[i]) * 16777619u;
+    return hash;
+}
+
+// synthesizes 'text' once, keeping the samples only to count and hash them
+// unless 'pcm' is given
+int BenchEngine::run(const std::string &text, bench_run_t &result, std::vector<short> *pcm)
+{
+    const int MAX_OUTBUF_SAMPLES = 32768;
+    // until the first sample has come, the engine is asked after every step
+    const int FIRST_OUTBUF_SIZE = 1024;
+    std::vector<short> outbuf(MAX_OUTBUF_SAMPLES);
+    pico_Uint64 bytes_sent;
+    pico_Uint32 samples_recv;
+    pico_Int16 step_bytes, out_data_type;
+    pico_Status ret, getstatus;
+
+    // the same soft reset nanotts does before each of its inputs
+    if ((ret = pico_resetEngine(engine, PICO_RESET_SOFT)))
+        return fail("cannot reset engine", ret);
+
+    result.samples = 0;
+    result.pcm_hash = 2166136261u;
+    if (pcm)
+        pcm->clear();
+    result.ttfa_ms = 0;
+    bench_clock::time_point start = bench_clock::now();
+
+    // the terminating '\0' makes the engine flush the last sentence
+    const pico_Char *inp = (const pico_Char *)text.c_str();
+    size_t remaining = text.size() + 1;
+    while (remaining > 0)
+    {
+        if ((ret = picoext_putText(engine, inp, remaining, &bytes_sent)))
+            return fail("cannot put text", ret);
+        remaining -= bytes_sent;
+        inp += bytes_sent;
+
+        do
+        {
+            if (result.samples == 0)
+            {
+                getstatus = pico_getData(engine, outbuf.data(), FIRST_OUTBUF_SIZE, &step_bytes, &out_data_type);
+                samples_recv = step_bytes / 2;
+                if (samples_recv > 0)
+                    result.ttfa_ms = msSince(start);
+            }
+            else
+            {
+                getstatus = picoext_getData(engine, outbuf.data(), MAX_OUTBUF_SAMPLES, &samples_recv, &out_data_type);
+            }
+            if (getstatus != PICO_STEP_BUSY && getstatus != PICO_STEP_IDLE)
+                return fail("cannot get data", getstatus);
+            result.samples += samples_recv;
+            result.pcm_hash = fnv1a(result.pcm_hash, outbuf.data(), samples_recv * 2);
+            if (pcm)
+                pcm->insert(pcm->end(), outbuf.begin(), outbuf.begin() + samples_recv);
+        } while (getstatus == PICO_STEP_BUSY);
+    }
+
+    result.wall_ms = msSince(start);
+    return 0;
+}
+
+// the most of the engine's memory area used since it was created
+int BenchEngine::peakArena()
+{
+    pico_Int32 used, incr_used, max_used;
+    if (picoext_getEngineMemUsage(engine, 0, &used, &incr_used, &max_used))
+        return -1;
+    return max_used;
+}
+
+static double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+static int benchVoice(const std::string &dir, const std::string &corpus_dir, const char *name, int warmup, int runs,
+                      int pipeline_stages, bool expand_pdfs, bench_result_t &result, std::vector<short> &pcm)
+{
+    PicoVoices_t voices;
+    voices.setVoice(name);
+
+    std::string corpus_file = corpus_dir + name + ".txt";
+    std::ifstream in(corpus_file, std::ios::binary);
+    if (!in)
+    {
+        fprintf(stderr, "skipping %s: no corpus \"%s\"\n", name, corpus_file.c_str());
+        return 1;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+
+    if (access((dir + voices.getTaName()).c_str(), R_OK) != 0 || access((dir + voices.getSgName()).c_str(), R_OK) != 0)
+    {
+        fprintf(stderr, "skipping %s: no lingware in \"%s\"\n", name, dir.c_str());
+        return 1;
+    }
+
+    bench_clock::time_point start = bench_clock::now();
+    BenchEngine engine;
+    if (engine.start(dir, voices, pipeline_stages, expand_pdfs) < 0)
+        return -1;
+    result.init_ms = msSince(start);
+
+    bench_run_t run;
+    for (int i = 0; i < warmup; i++)
+    {
+        if (engine.run(text.str(), run) < 0)
+            return -1;
+    }
+
+    std::vector<double> walls, ttfas;
+    for (int i = 0; i < runs; i++)
+    {
+        if (engine.run(text.str(), run, i == runs - 1 ? &pcm : 0) < 0)
+            return -1;
+        if (i > 0 && run.pcm_hash != result.pcm_hash)
+            fprintf(stderr, " **warning: %s: run %d gave other samples than run 1\n", name, i + 1);
+        result.samples = run.samples;
+        result.pcm_hash = run.pcm_hash;
+        walls.push_back(run.wall_ms);
+        ttfas.push_back(run.ttfa_ms);
+    }
+
+    result.voice = name;
+    result.text_bytes = text.str().size();
+    result.audio_s = (double)result.samples / SAMPLE_RATE;
+    result.wall_ms = median(walls);
+    result.wall_min_ms = *std::min_element(walls.begin(), walls.end());
+    result.wall_max_ms = *std::max_element(walls.begin(), walls.end());
+    result.ttfa_ms = median(ttfas);
+    result.rtf = result.audio_s > 0 ? result.wall_ms / 1000 / result.audio_s : 0;
+    result.samples_per_s = result.wall_ms > 0 ? result.samples / (result.wall_ms / 1000) : 0;
+    result.peak_arena_bytes = engine.peakArena();
+    return 0;
+}
+
+static void printResults(const std::vector<bench_result_t> &results)
+{
+    printf("%-6s %7s %9s %9s %10s %10s %10s %9s %8s %12s %11s\n", "voice", "bytes", "audio s", "init ms", "wall ms",
+           "min ms", "max ms", "ttfa ms", "RTF", "samples/s", "peak arena");
+    for (auto &r : results)
+    {
+        printf("%-6s %7zu %9.3f %9.2f %10.2f %10.2f %10.2f %9.2f %8.4f %12.0f %11d\n", r.voice.c_str(), r.text_bytes,
+               r.audio_s, r.init_ms, r.wall_ms, r.wall_min_ms, r.wall_max_ms, r.ttfa_ms, r.rtf, r.samples_per_s,
+               r.peak_arena_bytes);
+    }
+}
+
+static int writeJson(const std::string &filename, const std::vector<bench_result_t> &results, int warmup, int runs,
+                     int pipeline_stages)
+{
+    FILE *fp = fopen(filename.c_str(), "w");
+    if (!fp)
+    {
+        fprintf(stderr, "Cannot open results file: %s\n", filename.c_str());
+        return -1;
+    }
+
+    // one voice per line, for compareJson() and for diffing two runs
+    fprintf(fp, "{\n  \"warmup\": %d,\n  \"runs\": %d,\n  \"pipeline_stages\": %d,\n  \"voices\": [", warmup, runs,
+            pipeline_stages);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const bench_result_t &r = results[i];
+        fprintf(fp, "%s\n    {\"voice\": \"%s\", \"text_bytes\": %zu, \"samples\": %llu, \"pcm_hash\": \"%08x\", "
+                    "\"audio_s\": %.3f, "
+                    "\"init_ms\": %.3f, \"wall_ms\": %.3f, \"wall_min_ms\": %.3f, \"wall_max_ms\": %.3f, "
+                    "\"ttfa_ms\": %.3f, \"rtf\": %.5f, \"samples_per_s\": %.0f, \"peak_arena_bytes\": %d}",
+                i ? "," : "", r.voice.c_str(), r.text_bytes, r.samples, r.pcm_hash, r.audio_s, r.init_ms, r.wall_ms, r.wall_min_ms,
+                r.wall_max_ms, r.ttfa_ms, r.rtf, r.samples_per_s, r.peak_arena_bytes);
+    }
+    fprintf(fp, "\n  ]\n}\n");
+    fclose(fp);
+
+    fprintf(stderr, "wrote \"%s\"\n", filename.c_str());
+    return 0;
+}
+
+// the number after "key": on a line written by writeJson()
+static bool jsonNumber(const std::string &line, const char *key, double &value)
+{
+    std::string tag = std::string("\"") + key + "\": ";
+    size_t at = line.find(tag);
+    if (at == std::string::npos)
+        return false;
+    value = strtod(line.c_str() + at + tag.size(), 0);
+    return true;
+}
+
+/*
+    compares 'results' with those in the JSON file 'baseline'; a voice
+    whose real-time factor, time to first sample or peak arena grew by
+    more than 'tolerance' percent is a regression.  Returns the number of
+    regressions, or -1 if the baseline cannot be read.
+*/
+static int compareJson(const std::string &baseline, const std::vector<bench_result_t> &results, double tolerance)
+{
+    std::ifstream in(baseline);
+    if (!in)
+    {
+        fprintf(stderr, "Cannot open baseline file: %s\n", baseline.c_str());
+        return -1;
+    }
+
+    int regressions = 0;
+    std::string line;
+    printf("\ncompared with \"%s\" (tolerance %.1f%%):\n", baseline.c_str(), tolerance);
+    while (std::getline(in, line))
+    {
+        size_t at = line.find("\"voice\": \"");
+        if (at == std::string::npos)
+            continue;
+        std::string voice = line.substr(at + 10, line.find('"', at + 10) - (at + 10));
+
+        auto r = std::find_if(results.begin(), results.end(), [&](const bench_result_t &x) { return x.voice == voice; });
+        if (r == results.end())
+            continue;
+
+        double rtf, ttfa, arena;
+        if (!jsonNumber(line, "rtf", rtf) || !jsonNumber(line, "ttfa_ms", ttfa) ||
+            !jsonNumber(line, "peak_arena_bytes", arena))
+            continue;
+
+        const struct
+        {
+            const char *name;
+            double before, now;
+        } metrics[] = {{"RTF", rtf, r->rtf}, {"ttfa", ttfa, r->ttfa_ms}, {"arena", arena, (double)r->peak_arena_bytes}};
+
+        printf("%-6s", voice.c_str());
+        for (auto &m : metrics)
+        {
+            double change = m.before > 0 ? 100.0 * (m.now - m.before) / m.before : 0.0;
+            bool worse = change > tolerance;
+            printf("  %s %+6.1f%%%s", m.name, change, worse ? " REGRESSED" : "");
+            regressions += worse;
+        }
+        char hash[16];
+        snprintf(hash, sizeof(hash), "\"%08x\"", r->pcm_hash);
+        if (line.find(std::string("\"pcm_hash\": ") + hash) == std::string::npos)
+            printf("  (output changed)");
+        printf("\n");
+    }
+    return regressions;
+}
+
+static int writePcm(const std::string &filename, const std::vector<short> &pcm)
+{
+    FILE *fp = fopen(filename.c_str(), "wb");
+    if (!fp)
+    {
+        fprintf(stderr, "Cannot open PCM file: %s\n", filename.c_str());
+        return -1;
+    }
+    fwrite(pcm.data(), sizeof(short), pcm.size(), fp);
+    fclose(fp);
+    return 0;
+}
+
+static int readPcm(const std::string &filename, std::vector<short> &pcm)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+    {
+        fprintf(stderr, "Cannot open reference PCM file: %s\n", filename.c_str());
+        return -1;
+    }
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    pcm.resize(bytes.size() / sizeof(short));
+    memcpy(pcm.data(), bytes.data(), pcm.size() * sizeof(short));
+    return 0;
+}
+
+// in-place radix-2 FFT, x.size() a power of 2
+static void fft(std::vector<std::complex<double>> &x)
+{
+    size_t n = x.size();
+    for (size_t i = 1, j = 0; i < n; i++)
+    {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(x[i], x[j]);
+    }
+    for (size_t len = 2; len <= n; len <<= 1)
+    {
+        std::complex<double> wl = std::polar(1.0, -2 * M_PI / len);
+        for (size_t i = 0; i < n; i += len)
+        {
+            std::complex<double> w = 1;
+            for (size_t k = 0; k < len / 2; k++, w *= wl)
+            {
+                std::complex<double> u = x[i + k], v = x[i + k + len / 2] * w;
+                x[i + k] = u + v;
+                x[i + k + len / 2] = u - v;
+            }
+        }
+    }
+}
+
+// dB energies of the Hann-windowed frame at pcm[at] in bands of 'band' FFT bins, floored 60 dB below the loudest
+static void frameSpectrum(const std::vector<short> &pcm, size_t at, size_t n, size_t band, std::vector<double> &db)
+{
+    std::vector<std::complex<double>> x(n);
+    for (size_t i = 0; i < n; i++)
+        x[i] = pcm[at + i] * (0.5 - 0.5 * cos(2 * M_PI * i / n));
+    fft(x);
+    db.assign(n / 2 / band, 0.0);
+    double peak = 0;
+    for (size_t k = 0; k < db.size(); k++)
+    {
+        for (size_t i = 0; i < band; i++)
+            db[k] += std::norm(x[k * band + i]);
+        peak = std::max(peak, db[k]);
+    }
+    for (size_t k = 0; k < db.size(); k++)
+        db[k] = 10 * log10(std::max(db[k], peak * 1e-6) + 1e-9);
+}
+
+/*
+    log-spectral distance of 'pcm' from 'reference' in dB: the RMS
+    difference of their 32 ms spectra, in bands of 8 bins (250 Hz at
+    16 kHz), averaged over the frames that are not silent in the
+    reference.  Unlike the difference of the samples, it does not grow
+    with small shifts of the pitch pulses, and the bands keep it from
+    growing with the harmonics moving between bins.  Returns -1 if the
+    lengths differ.
+*/
+static double logSpectralDistance(const std::vector<short> &reference, const std::vector<short> &pcm)
+{
+    const size_t N = 512, HOP = 256, BAND = 8;
+    const double SILENCE = 100.0; // RMS below which a reference frame is skipped
+
+    if (reference.size() != pcm.size())
+        return -1;
+
+    std::vector<double> a, b;
+    double sum = 0;
+    int frames = 0;
+    for (size_t at = 0; at + N <= reference.size(); at += HOP)
+    {
+        double energy = 0;
+        for (size_t i = 0; i < N; i++)
+            energy += (double)reference[at + i] * reference[at + i];
+        if (sqrt(energy / N) < SILENCE)
+            continue;
+        frameSpectrum(reference, at, N, BAND, a);
+        frameSpectrum(pcm, at, N, BAND, b);
+        double d = 0;
+        for (size_t k = 0; k < a.size(); k++)
+            d += (a[k] - b[k]) * (a[k] - b[k]);
+        sum += sqrt(d / a.size());
+        frames++;
+    }
+    return frames ? sum / frames : 0;
+}
+
+/*
+    compares the samples of each voice with <reference_dir>/<voice>.pcm;
+    a voice further away than 'max_lsd' dB, or of another length, fails.
+    Returns the number of failures, or -1 if a reference cannot be read.
+*/
+static int comparePcm(const std::string &reference_dir, const std::vector<bench_result_t> &results,
+                      const std::vector<std::vector<short>> &pcms, double max_lsd)
+{
+    int failures = 0;
+    printf("\nsamples compared with \"%s\" (at most %.2f dB log-spectral distance):\n", reference_dir.c_str(), max_lsd);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        std::vector<short> reference;
+        if (readPcm(reference_dir + results[i].voice + ".pcm", reference) < 0)
+            return -1;
+        double lsd = logSpectralDistance(reference, pcms[i]);
+        bool failed = lsd < 0 || lsd > max_lsd;
+        if (lsd < 0)
+            printf("%-6s  %zu samples instead of %zu FAILED\n", results[i].voice.c_str(), pcms[i].size(), reference.size());
+        else
+            printf("%-6s  %.3f dB%s\n", results[i].voice.c_str(), lsd, failed ? " FAILED" : "");
+        failures += failed;
+    }
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    cxxopts::Options options("nanotts_bench", "Measures the speed of the svox engine on a fixed text per voice");
+    options.add_options()("h,help", "Print this help")("l,lang-file-dir", "the directory containing the language files", cxxopts::value<std::string>()->default_value("./lang"))("corpus", "the directory containing a <voice>.txt to synthesize for each voice", cxxopts::value<std::string>()->default_value("./bench/corpus"))("v,voices", "the comma-separated voices to run; all of those with lingware by default", cxxopts::value<std::vector<std::string>>())("warmup", "untimed runs before the timed ones", cxxopts::value<int>()->default_value("1"))("runs", "timed runs per voice", cxxopts::value<int>()->default_value("5"))("pipeline-stages", "split synthesis across <1-3> threads", cxxopts::value<int>()->default_value("1"))("packed-pdfs", "keep the pdfs of the lingware packed instead of expanding them at load time")("json", "write the results to the JSON file <path>", cxxopts::value<std::string>())("baseline", "compare the results with the JSON file <path> of an earlier run, and fail on a regression", cxxopts::value<std::string>())("tolerance", "the percentage a result may be worse than the baseline's", cxxopts::value<double>()->default_value("10"))("save-pcm", "write the samples of each voice to <dir>/<voice>.pcm", cxxopts::value<std::string>())("reference", "check the samples against the <dir>/<voice>.pcm of an earlier run, and fail if they differ too much", cxxopts::value<std::string>())("max-lsd", "the log-spectral distance in dB the samples may have from the reference", cxxopts::value<double>()->default_value("2.0"));
+    auto args = options.parse(argc, argv);
+
+    if (args.count("help"))
+    {
+        std::cout << options.help() << std::endl;
+        return 0;
+    }
+
+    std::string dir = args["lang-file-dir"].as<std::string>();
+    if (dir.empty() || dir.back() != '/')
+        dir += "/";
+    std::string corpus_dir = args["corpus"].as<std::string>();
+    if (corpus_dir.empty() || corpus_dir.back() != '/')
+        corpus_dir += "/";
+    int warmup = std::max(0, args["warmup"].as<int>());
+    int runs = std::max(1, args["runs"].as<int>());
+    int pipeline_stages = args["pipeline-stages"].as<int>();
+    if (pipeline_stages < 1 || pipeline_stages > 3)
+    {
+        fprintf(stderr, " **error: --pipeline-stages must be 1, 2 or 3\n");
+        return 1;
+    }
+    bool expand_pdfs = !args.count("packed-pdfs");
+
+    std::vector<std::string> names;
+    if (args.count("voices"))
+    {
+        names = args["voices"].as<std::vector<std::string>>();
+        for (auto &name : names)
+        {
+            PicoVoices_t voices;
+            if (voices.setVoice(name.c_str()) < 0)
+            {
+                fprintf(stderr, " **error: unknown voice \"%s\"\n", name.c_str());
+                return 1;
+            }
+            name = voices.getVoice();
+        }
+    }
+    else
+    {
+        for (int i = 0; i < PICO_NUM_VOICES; i++)
+        {
+            PicoVoices_t voices;
+            voices.setVoice(i);
+            names.push_back(voices.getVoice());
+        }
+    }
+
+    std::vector<bench_result_t> results;
+    std::vector<std::vector<short>> pcms;
+    for (auto &name : names)
+    {
+        bench_result_t result;
+        std::vector<short> pcm;
+        int r = benchVoice(dir, corpus_dir, name.c_str(), warmup, runs, pipeline_stages, expand_pdfs, result, pcm);
+        if (r < 0)
+            return 1;
+        if (r == 0)
+        {
+            results.push_back(result);
+            pcms.push_back(std::move(pcm));
+        }
+    }
+    if (results.empty())
+    {
+        fprintf(stderr, " **error: no voice could be run\n");
+        return 1;
+    }
+
+    printResults(results);
+
+    if (args.count("json") && writeJson(args["json"].as<std::string>(), results, warmup, runs, pipeline_stages) < 0)
+        return 1;
+
+    if (args.count("save-pcm"))
+    {
+        std::string pcm_dir = args["save-pcm"].as<std::string>();
+        if (pcm_dir.empty() || pcm_dir.back() != '/')
+            pcm_dir += "/";
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            if (writePcm(pcm_dir + results[i].voice + ".pcm", pcms[i]) < 0)
+                return 1;
+        }
+    }
+
+    int failures = 0;
+    if (args.count("reference"))
+    {
+        std::string reference_dir = args["reference"].as<std::string>();
+        if (reference_dir.empty() || reference_dir.back() != '/')
+            reference_dir += "/";
+        failures = comparePcm(reference_dir, results, pcms, args["max-lsd"].as<double>());
+        if (failures < 0)
+            return 1;
+        if (failures > 0)
+            fprintf(stderr, "%d voice%s differ%s from the reference\n", failures, failures == 1 ? "" : "s",
+                    failures == 1 ? "s" : "");
+    }
+
+    if (args.count("baseline"))
+    {
+        int regressions = compareJson(args["baseline"].as<std::string>(), results, args["tolerance"].as<double>());
+        if (regressions < 0)
+            return 1;
+        if (regressions > 0)
+        {
+            fprintf(stderr, "%d regression%s\n", regressions, regressions == 1 ? "" : "s");
+            return 2;
+        }
+    }
+    return failures > 0 ? 2 : 0;
+}
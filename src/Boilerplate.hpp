@@ -28,6 +28,24 @@ class Boilerplate
     float volume;
 
     const unsigned int padslen;
+    // each instance has its own, pointing at its own values
+    pads_t pads[3];
+
+    void init()
+    {
+        speed = -1.0f;
+        pitch = -1.0f;
+        volume = -1.0f;
+
+        memset(plate_begin, 0, 100);
+        memset(plate_end, 0, 50);
+
+        for (unsigned int i = 0; i < padslen; i++)
+            pads[i] = formats[i];
+        pads[0].val = &speed;
+        pads[1].val = &pitch;
+        pads[2].val = &volume;
+    }
 
     void setOne(const char *verb, float value)
     {
@@ -63,29 +81,24 @@ class Boilerplate
     }
 
 public:
-    static pads_t pads[];
+    static const pads_t formats[];
 
     Boilerplate() : padslen(3)
     {
-        speed = -1.0f;
-        pitch = -1.0f;
-        volume = -1.0f;
-
-        memset(plate_begin, 0, 100);
-        memset(plate_end, 0, 50);
-
-        pads[0].val = &speed;
-        pads[1].val = &pitch;
-        pads[2].val = &volume;
+        init();
     }
 
     Boilerplate(float s, float p, float v) : padslen(3)
     {
+        init();
         setSpeed(s);
         setPitch(p);
         setVolume(v);
     }
 
+    Boilerplate(const Boilerplate &) = delete;
+    Boilerplate &operator=(const Boilerplate &) = delete;
+
     bool isChanged()
     {
         return !((speed == -1.0f) && (pitch == -1.0f) && (volume == -1.0f));
@@ -115,6 +128,11 @@ public:
         setOne("volume", f);
     }
 
+    // -1 when not set
+    float getSpeed() const { return speed; }
+    float getPitch() const { return pitch; }
+    float getVolume() const { return volume; }
+
     const char *getStatusMessage()
     {
         static char buf[100];
@@ -36,6 +36,10 @@ int GetNextLowestFilenameNumber(const char *prefix, const char *suffix, int zero
 #define PICO_DEFAULT_VOLUME 1.00f
 
 #define FILE_OUTPUT_SUFFIX ".wav"
+// how far the synthesis may run ahead of an output on a thread of its own
+#define OUTPUT_THREAD_MS 1000
+// roughly how much speech a byte of text makes, to reserve the space of a file
+#define SAMPLES_PER_TEXT_BYTE 1200
 #define FILENAME_NUMBERING_LEADING_ZEROS 4
 
 // software version information
@@ -62,14 +66,29 @@ Nano::Nano(int i, char **v) : my_argc(i),
                               prefix(),
                               out_filename(),
                               in_filename(),
+                              in_filenames(),
                               words(),
-                              listener(this)
+                              serve_path(),
+                              connect_path(),
+                              profile_json()
 {
     sprintf(suffix, FILE_OUTPUT_SUFFIX);
     in_fp = 0;
     out_fp = 0;
     input_buffer = 0;
     input_size = 0;
+    split_lines = false;
+    inputs_read = 0;
+    pending_text = 0;
+    pending_size = 0;
+    numbered_outputs = false;
+    next_file_number = 1;
+    mmfile = 0;
+    pipeline_stages = 1;
+    jobs = 1;
+    profile = false;
+    playback_profile = PLAYBACK_DEFAULT;
+    output_threads = false;
 
     silence_output = true;
 }
@@ -78,19 +97,14 @@ Nano::~Nano()
 {
     if (input_buffer)
     {
-        switch (in_mode)
-        {
-        case IN_STDIN:
-            delete[] input_buffer;
-            break;
-        case IN_SINGLE_FILE:
-            delete mmfile;
-            mmfile = 0;
-        default:
-            break;
-        }
+        delete[] input_buffer;
         input_buffer = 0;
     }
+    if (mmfile)
+    {
+        delete mmfile;
+        mmfile = 0;
+    }
 
     if (in_fp != 0 && in_fp != stdin)
     {
@@ -108,7 +122,7 @@ int Nano::parse_commandline_arguments()
 {
 
     cxxopts::Options options("NanoTTS", "A flexible text-to-speech engine");
-    options.add_options()("h,help", "Print this help")("version", "Print the version")("i,input", "input text argument", cxxopts::value<std::string>())("f,file", "use the given text file as input", cxxopts::value<std::string>())("o,output", "Write output to WAV/PCM file (enables WAV output)", cxxopts::value<std::string>())("w,wav", "Write output to WAV file, will generate filename if '-o' option not provided")("p,play", "Play audio output")("m,no-play", "do NOT play output on PC's soundcard")("c,stdout", "Send raw PCM output to stdout")("x,prefix", "Set the file prefix (e.g. 'MyRecording'). Generated files will be auto-numbered. Good for running multiple times with different inputs", cxxopts::value<std::string>()->default_value("nanotts-output-"))("speed", "change voice speed <0.2-5.0>", cxxopts::value<float>()->default_value("0.88"))("pitch", "change the voice pitch <0.5-2.0>", cxxopts::value<float>()->default_value("1.05"))("volume", "change the voice volume <0.0-5.0> (>1.0 may result in degraded quality)", cxxopts::value<float>()->default_value("1.00"))("v,voice", "Set the voice to use.  Possible voices: en-US, en-GB, de-DE, es-ES, fr-FR, it-IT", cxxopts::value<std::string>()->default_value("en-GB"))("l,lang-file-dir", "the directory containing the language files", cxxopts::value<std::string>()->default_value("./lang"));
+    options.add_options()("h,help", "Print this help")("version", "Print the version")("i,input", "input text argument", cxxopts::value<std::string>())("f,file", "use the given text file as input", cxxopts::value<std::string>())("o,output", "Write output to WAV/PCM file (enables WAV output)", cxxopts::value<std::string>())("w,wav", "Write output to WAV file, will generate filename if '-o' option not provided")("p,play", "Play audio output")("m,no-play", "do NOT play output on PC's soundcard")("c,stdout", "Send raw PCM output to stdout")("x,prefix", "Set the file prefix (e.g. 'MyRecording'). Generated files will be auto-numbered. Good for running multiple times with different inputs", cxxopts::value<std::string>()->default_value("nanotts-output-"))("speed", "change voice speed <0.2-5.0>", cxxopts::value<float>()->default_value("0.88"))("pitch", "change the voice pitch <0.5-2.0>", cxxopts::value<float>()->default_value("1.05"))("volume", "change the voice volume <0.0-5.0> (>1.0 may result in degraded quality)", cxxopts::value<float>()->default_value("1.00"))("v,voice", "Set the voice to use.  Possible voices: en-US, en-GB, de-DE, es-ES, fr-FR, it-IT", cxxopts::value<std::string>()->default_value("en-GB"))("l,lang-file-dir", "the directory containing the language files", cxxopts::value<std::string>()->default_value("./lang"))("pipeline-stages", "split synthesis across <1-3> threads; output is the same for any value", cxxopts::value<int>()->default_value("1"))("j,jobs", "synthesize <N> sentences at once on separate engines", cxxopts::value<int>()->default_value("1"))("serve", "keep engines for all voices running and synthesize for clients connecting to the Unix socket <path>; -j sets the engines per voice", cxxopts::value<std::string>())("connect", "have the server listening on the Unix socket <path> synthesize, instead of starting an engine", cxxopts::value<std::string>())("files", "use each of the given comma-separated text files as an input of its own", cxxopts::value<std::vector<std::string>>())("lines", "synthesize every line of the input on its own")("profile", "print the time and throughput of each stage of the synthesis at exit")("profile-json", "also write the profile to the JSON file <path>", cxxopts::value<std::string>())("play-buffer", "let synthesis run up to <ms> milliseconds ahead of the playback", cxxopts::value<int>()->default_value(std::to_string(PLAYBACK_DEFAULT_MS)))("latency", "sound card latency: 'low' (12 ms), 'default' (50 ms) or 'low-cpu' (500 ms, fewer wakeups)", cxxopts::value<std::string>()->default_value("default"))("rate", "sample rate of the WAV/PCM files, the PCM output and the playback, e.g. 8000, 22050, 44100 or 48000", cxxopts::value<int>()->default_value("16000"))("output-threads", "write the raw PCM output from a thread of its own");
     auto args = options.parse(my_argc, my_argv);
 
     if (args["h"].count() > 0)
@@ -134,6 +148,61 @@ int Nano::parse_commandline_arguments()
     voice = args["voice"].as<std::string>();
     langfiledir = args["l"].as<std::string>();
 
+    pipeline_stages = args["pipeline-stages"].as<int>();
+    if (pipeline_stages < 1 || pipeline_stages > 3)
+    {
+        fprintf(stderr, " **error: --pipeline-stages must be between 1 and 3\n\n");
+        return -1;
+    }
+
+    jobs = args["jobs"].as<int>();
+    if (jobs < 1)
+    {
+        fprintf(stderr, " **error: --jobs must be at least 1\n\n");
+        return -1;
+    }
+
+    int play_buffer = args["play-buffer"].as<int>();
+    if (play_buffer < 100)
+    {
+        fprintf(stderr, " **error: --play-buffer must be at least 100 ms\n\n");
+        return -1;
+    }
+    int rate = args["rate"].as<int>();
+    if (rate < 4000 || rate > 96000 || !resample.getResampler().setRates(PLAYBACK_RATE, rate))
+    {
+        fprintf(stderr, " **error: cannot resample to --rate %d\n\n", rate);
+        return -1;
+    }
+    streamHandler.SetRingDepth(play_buffer, rate);
+
+    std::string latency = args["latency"].as<std::string>();
+    if (latency == "low")
+        playback_profile = PLAYBACK_LOW_LATENCY;
+    else if (latency == "low-cpu")
+        playback_profile = PLAYBACK_LOW_CPU;
+    else if (latency == "default")
+        playback_profile = PLAYBACK_DEFAULT;
+    else
+    {
+        fprintf(stderr, " **error: --latency must be low, default or low-cpu\n\n");
+        return -1;
+    }
+
+    if (args["profile-json"].count() > 0)
+        profile_json = args["profile-json"].as<std::string>();
+    profile = args["profile"].count() > 0 || !profile_json.empty();
+
+    // a server takes its input and output from its clients
+    if (args["serve"].count() > 0)
+    {
+        serve_path = args["serve"].as<std::string>();
+        return 0;
+    }
+
+    if (args["connect"].count() > 0)
+        connect_path = args["connect"].as<std::string>();
+
     // need to validate the langfilefile dir.  Possibly use install dir for pico?
     // "/usr/share/pico/lang"
 
@@ -159,13 +228,33 @@ int Nano::parse_commandline_arguments()
         words = args["i"].as<std::string>();
     }
 
+    if (args["files"].count() > 0)
+    {
+        if (in_mode != IN_NOT_SET)
+        {
+            fprintf(stderr, " **error: multiple inputs\n\n");
+            return -1;
+        }
+        in_mode = IN_MULTIPLE_FILES;
+        in_filenames = args["files"].as<std::vector<std::string>>();
+    }
+
+    // several inputs go to numbered files, one each
+    split_lines = args["lines"].count() > 0;
+    numbered_outputs = split_lines || in_mode == IN_MULTIPLE_FILES;
+    if (numbered_outputs && args["o"].count() > 0)
+    {
+        fprintf(stderr, " **error: -o names a single file; use -x to name the files of several inputs\n\n");
+        return -1;
+    }
+
     if (args["o"].count() > 0)
     {
         out_mode |= OUT_SINGLE_FILE;
         out_filename = args["o"].as<std::string>();
     }
 
-    if (!isatty(fileno(stdin)))
+    if (in_mode == IN_NOT_SET && !isatty(fileno(stdin)))
     {
         in_mode = IN_STDIN;
     }
@@ -183,6 +272,7 @@ int Nano::parse_commandline_arguments()
 
     if (args["c"].count() > 0)
         out_mode |= OUT_STDOUT;
+    output_threads = args["output-threads"].count() > 0;
 
     if (args["w"].count() > 0)
         out_mode |= OUT_SINGLE_FILE;
@@ -229,8 +319,8 @@ int Nano::parse_commandline_arguments()
 
     if (out_filename.empty())
     {
-        int next = GetNextLowestFilenameNumber(prefix.c_str(), suffix, FILENAME_NUMBERING_LEADING_ZEROS);
-        out_filename = fmt::format("{}{:04d}{}", prefix, next, suffix);
+        next_file_number = GetNextLowestFilenameNumber(prefix.c_str(), suffix, FILENAME_NUMBERING_LEADING_ZEROS);
+        out_filename = fmt::format("{}{:04d}{}", prefix, next_file_number, suffix);
     }
 
     //
@@ -277,7 +367,7 @@ int Nano::setup_input_output()
     case IN_CMDLINE_TRAILING:
         break;
     case IN_MULTIPLE_FILES:
-        __NOT_IMPL__
+        break;
     default:
         __NOT_IMPL__
         break;
@@ -305,18 +395,12 @@ int Nano::setup_input_output()
         }
     }
 
-    if ((out_mode & (OUT_PLAYBACK | OUT_STDOUT)) == (OUT_PLAYBACK | OUT_STDOUT))
-    {
-        SetListenerPlaybackAndStdout();
-    }
-    else if (out_mode & OUT_PLAYBACK)
-    {
-        SetListenerPlayback();
-    }
-    else if (out_mode & OUT_STDOUT)
-    {
-        SetListenerStdout();
-    }
+    if (out_mode & OUT_STDOUT)
+        addStdoutSink();
+    if (out_mode & OUT_PLAYBACK)
+        addPlaybackSink();
+    if (out_mode & OUT_SINGLE_FILE)
+        outputs.add(&wav_file);
 
 #undef __NOT_IMPL__
     return 0;
@@ -339,31 +423,77 @@ int Nano::verify_input_output()
     return 0;
 }
 
-void Nano::SetListenerStdout()
+void Nano::addStdoutSink()
 {
-    listener.setCallback(&Nano::write_short_to_stdout);
+    stdout_sink = std::make_unique<PcmFileSink>(out_fp);
+    if (!output_threads)
+    {
+        outputs.add(stdout_sink.get());
+        return;
+    }
+    size_t depth = (size_t)resample.getResampler().outRate() * OUTPUT_THREAD_MS / 1000;
+    stdout_thread = std::make_unique<PcmThreadedSink>(stdout_sink.get(), "stdout", depth);
+    stdout_thread->start();
+    outputs.add(stdout_thread.get());
 }
-void Nano::SetListenerPlayback()
+
+void Nano::addPlaybackSink()
 {
 #ifdef _USE_ALSA
-    streamHandler.player = new Player_Alsa();
+    streamHandler.player = new Player_Alsa(playback_profile, resample.getResampler().outRate());
 #endif
     streamHandler.StreamOpen();
-    listener.setCallback(&Nano::write_short_to_playback);
+    outputs.add(&streamHandler);
 }
-void Nano::SetListenerPlaybackAndStdout()
+
+// puts the next input into *data, and number_bytes into bytes
+// returns 1 on data, 0 on no more data, <0 on errors
+int Nano::ProduceInput(unsigned char **data, unsigned int *bytes)
 {
-#ifdef _USE_ALSA
-    streamHandler.player = new Player_Alsa();
-#endif
-    streamHandler.StreamOpen();
-    listener.setCallback(&Nano::write_short_to_playback_and_stdout);
+    int ret = split_lines ? produceLine(data, bytes) : produceText(data, bytes);
+    if (ret > 0 && numbered_outputs)
+        out_filename = fmt::format("{}{:04d}{}", prefix, next_file_number++, suffix);
+    return ret;
 }
 
-// puts input into *data, and number_bytes into bytes
-// returns 0 on no more data
-int Nano::ProduceInput(unsigned char **data, unsigned int *bytes)
+// the next non-blank line of the inputs
+int Nano::produceLine(unsigned char **data, unsigned int *bytes)
+{
+    while (1)
+    {
+        if (pending_size == 0)
+        {
+            int ret = produceText(&pending_text, &pending_size);
+            if (ret <= 0)
+                return ret;
+        }
+
+        unsigned char *end = pending_text;
+        unsigned char *stop = pending_text + pending_size;
+        while (end < stop && *end != '\n' && *end != '\0')
+            end++;
+        line.assign((const char *)pending_text, end - pending_text);
+        if (end < stop)
+            end++;
+        pending_size -= end - pending_text;
+        pending_text = end;
+
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        *data = (unsigned char *)line.c_str();
+        *bytes = line.size() + 1; /* 1 additional for terminating '\0' */
+        return 1;
+    }
+}
+
+// the next input as a whole
+int Nano::produceText(unsigned char **data, unsigned int *bytes)
 {
+    // all modes but IN_MULTIPLE_FILES have a single input
+    if (in_mode != IN_MULTIPLE_FILES && inputs_read > 0)
+        return 0;
+
     switch (in_mode)
     {
     case IN_STDIN:
@@ -387,14 +517,26 @@ int Nano::ProduceInput(unsigned char **data, unsigned int *bytes)
         fprintf(stderr, "read: %u bytes from command line\n", *bytes);
         break;
     case IN_MULTIPLE_FILES:
-        fprintf(stderr, "multiple files not supported\n");
-        return -1;
+        if (inputs_read >= in_filenames.size())
+            return 0;
+        if (access(in_filenames[inputs_read].c_str(), R_OK) != 0)
+        {
+            fprintf(stderr, " **error: cannot read \"%s\"\n", in_filenames[inputs_read].c_str());
+            return -1;
+        }
+        delete mmfile;
+        mmfile = new mmfile_t(in_filenames[inputs_read].c_str());
+        *data = mmfile->data;
+        *bytes = mmfile->size + 1; /* 1 additional for terminating '\0' */
+        fprintf(stderr, "read: %u bytes from \"%s\"\n", mmfile->size, in_filenames[inputs_read].c_str());
+        break;
     default:
         fprintf(stderr, "unknown input\n");
         return -1;
     }
 
-    return 0;
+    inputs_read++;
+    return 1;
 }
 
 //
@@ -416,31 +558,62 @@ const std::string &Nano::getLangFilePath()
     return langfiledir;
 }
 
-void Nano::write_short_to_stdout(short *data, unsigned int shorts)
+// passes on what the resampler still holds and waits for the outputs
+// to take everything; with --profile also says how the threaded outputs
+// kept up
+void Nano::finishOutput()
 {
-    if (out_mode & OUT_STDOUT)
-        fwrite(data, 2, shorts, out_fp);
+    if (outputs.empty())
+        return;
+
+    resample.finish();
+    if (!profile)
+        return;
+
+    if (out_mode & OUT_PLAYBACK)
+        fprintf(stderr, "playback: %u ms buffer, synthesis waited %u times, ran dry %u times\n",
+                streamHandler.RingDepth(), streamHandler.Overruns(), streamHandler.Underruns());
+    if (stdout_thread)
+        fprintf(stderr, "%s: %u ms buffer, synthesis waited %u times, ran dry %u times\n", stdout_thread->getName().c_str(),
+                (unsigned int)(stdout_thread->getDepth() * 1000 / resample.getResampler().outRate()),
+                stdout_thread->writerWaits(), stdout_thread->ranDry());
 }
 
-void Nano::write_short_to_playback(short *data, unsigned int shorts)
+// opens out_filename for the samples of the next input, at the output rate
+int Nano::beginOutput(unsigned int text_length)
 {
-    if (out_mode & OUT_PLAYBACK)
-        streamHandler.SubmitFrames((unsigned char *)data, shorts);
+    if (!(out_mode & OUT_SINGLE_FILE))
+        return 0;
+
+    unsigned int rate = resample.getResampler().outRate();
+    unsigned long long expected = (unsigned long long)text_length * SAMPLES_PER_TEXT_BYTE * rate / PLAYBACK_RATE;
+    if (wav_file.open(out_filename, rate, expected) < 0)
+    {
+        fprintf(stderr, "Cannot open output wave file: %s\n", out_filename.c_str());
+        return -1;
+    }
+    return 0;
 }
 
-void Nano::write_short_to_playback_and_stdout(short *data, unsigned int shorts)
+// the resampler passes on what it holds back of the input, so that the
+// file ends with it, and the file is finished
+void Nano::endOutput()
 {
-    if (out_mode & OUT_STDOUT)
-        fwrite(data, 2, shorts, out_fp);
-    if (out_mode & OUT_PLAYBACK)
-        streamHandler.SubmitFrames((unsigned char *)data, shorts);
+    if (!wav_file.isOpen())
+        return;
+
+    resample.flush();
+    wav_file.finish();
+    fprintf(stderr, "wrote \"%s\" (%llu bytes)\n", out_filename.c_str(), wav_file.fileBytes());
 }
 
-Listener<short> *Nano::getListener()
+// the root of the output graph, 0 without outputs
+PcmSink *Nano::getSink()
 {
-    if (!listener.hasConsumer())
+    if (outputs.empty())
         return 0;
-    return &listener;
+    resample.setNext(&outputs);
+    return &resample;
 }
 
 Boilerplate *Nano::getModifiers()
@@ -1,10 +1,13 @@
 #ifndef _NANO_HPP_
 #define _NANO_HPP_
 
+#include <memory>
 #include <string>
-#include "Listener.hpp"
+#include <vector>
 #include "Boilerplate.hpp"
+#include "PcmSink.hpp"
 #include "StreamHandler.h"
+#include "WavSink.hpp"
 #include "mmfile.h"
 
 /*
@@ -48,22 +51,49 @@ private:
     char suffix[100];
     std::string out_filename;
     std::string in_filename;
+    std::vector<std::string> in_filenames;
     std::string words;
+    std::string serve_path;
+    std::string connect_path;
     FILE *in_fp;
     FILE *out_fp;
 
     unsigned char *input_buffer;
     unsigned int input_size;
 
+    // several utterances in one run: --files, --lines
+    bool split_lines;
+    size_t inputs_read;
+    unsigned char *pending_text;
+    unsigned int pending_size;
+    std::string line;
+    bool numbered_outputs;
+    int next_file_number;
+    int pipeline_stages;
+    int jobs;
+    bool profile;
+    std::string profile_json;
+    playbackProfile_t playback_profile;
+
     mmfile_t *mmfile;
 
-    Listener<short> listener;
-    void write_short_to_stdout(short *, unsigned int);
-    void write_short_to_playback(short *data, unsigned int shorts);
-    void write_short_to_playback_and_stdout(short *data, unsigned int shorts);
+    int produceText(unsigned char **data, unsigned int *bytes);
+    int produceLine(unsigned char **data, unsigned int *bytes);
 
-    Boilerplate modifiers;
+    // the output graph: the engine's samples go through the resampler to
+    // each of the outputs
+    PcmResampleSink resample;
+    PcmFanout outputs;
+    bool output_threads;
+    std::unique_ptr<PcmFileSink> stdout_sink;
+    std::unique_ptr<PcmThreadedSink> stdout_thread;
     StreamHandler streamHandler;
+    WavFileSink wav_file;
+
+    void addStdoutSink();
+    void addPlaybackSink();
+
+    Boilerplate modifiers;
 
 public:
     bool silence_output;
@@ -81,17 +111,21 @@ public:
     const std::string &getVoice();
     const std::string &getLangFilePath();
 
-    const std::string &outFilename() const { return out_filename; }
+    int pipelineStages() const { return pipeline_stages; }
+    int numJobs() const { return jobs; }
+    const std::string &servePath() const { return serve_path; }
+    const std::string &connectPath() const { return connect_path; }
+    bool profiling() const { return profile; }
+    const std::string &profileJsonFilename() const { return profile_json; }
 
-    Listener<short> *getListener();
+    PcmSink *getSink();
+    // open and close the WAV/PCM file of each input around its synthesis
+    int beginOutput(unsigned int text_length);
+    void endOutput();
 
     Boilerplate *getModifiers();
 
-    void SetListenerStdout();
-    void SetListenerPlayback();
-    void SetListenerPlaybackAndStdout();
-
-    bool writingWaveFile() { return (out_mode & OUT_SINGLE_FILE) == OUT_SINGLE_FILE; }
+    void finishOutput();
 };
 
 #endif
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/*
+================================================
+PcmRing
+
+lock-free ring of samples between a single producer and a single
+consumer thread. head and tail count the samples ever written and read,
+so the ring is empty when they are equal and full when they are a
+capacity apart; only the producer moves head and only the consumer tail.
+
+Either side can block until the other has made progress: wake is bumped
+whenever samples are written or the ring is closed, tail whenever
+samples are read.
+================================================
+*/
+template <typename type>
+class PcmRing
+{
+    std::vector<type> data;
+
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) std::atomic<unsigned int> wake;
+    std::atomic<bool> closed;
+
+public:
+    explicit PcmRing(size_t capacity = 0) : head(0), tail(0), wake(0), closed(false)
+    {
+        resize(capacity);
+    }
+
+    // only while neither thread is using the ring
+    void resize(size_t capacity)
+    {
+        data.assign(capacity > 0 ? capacity : 1, type());
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        closed.store(false, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return data.size(); }
+    size_t readable() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+
+    // producer: copies in as many of the samples as fit, returns how many
+    size_t write(const type *samples, size_t count)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t room = data.size() - (h - tail.load(std::memory_order_acquire));
+        if (count > room)
+            count = room;
+        if (count == 0)
+            return 0;
+
+        size_t at = h % data.size();
+        size_t first = count < data.size() - at ? count : data.size() - at;
+        std::copy(samples, samples + first, data.begin() + at);
+        std::copy(samples + first, samples + count, data.begin());
+
+        head.store(h + count, std::memory_order_release);
+        wake.fetch_add(1, std::memory_order_release);
+        wake.notify_one();
+        return count;
+    }
+
+    // producer: blocks until the consumer has read something
+    void waitForRoom()
+    {
+        size_t t = tail.load(std::memory_order_acquire);
+        if (head.load(std::memory_order_relaxed) - t == data.size())
+            tail.wait(t, std::memory_order_acquire);
+    }
+
+    // producer: no more samples follow, the consumer drains the rest and stops
+    void close()
+    {
+        closed.store(true, std::memory_order_release);
+        wake.fetch_add(1, std::memory_order_release);
+        wake.notify_one();
+    }
+
+    // consumer: the samples up to the end of the ring that are ready to be
+    // read in place; *count is 0 once the ring is empty
+    const type *peek(size_t *count) const
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t at = t % data.size();
+        size_t ready = head.load(std::memory_order_acquire) - t;
+        *count = ready < data.size() - at ? ready : data.size() - at;
+        return data.data() + at;
+    }
+
+    // consumer: releases samples returned by peek() to the producer
+    void consume(size_t count)
+    {
+        tail.store(tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+        tail.notify_one();
+    }
+
+    // consumer: blocks until samples are written or the ring is closed;
+    // false once it is closed and empty
+    bool waitForData()
+    {
+        while (true)
+        {
+            unsigned int w = wake.load(std::memory_order_acquire);
+            if (head.load(std::memory_order_acquire) != tail.load(std::memory_order_relaxed))
+                return true;
+            if (closed.load(std::memory_order_acquire))
+                return false;
+            wake.wait(w, std::memory_order_acquire);
+        }
+    }
+};
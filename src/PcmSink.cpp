@@ -0,0 +1,143 @@
+#include "PcmSink.hpp"
+
+void PcmFanout::write(const short *samples, unsigned int count)
+{
+    for (PcmSink *sink : sinks)
+        sink->write(samples, count);
+}
+
+void PcmFanout::finish()
+{
+    for (PcmSink *sink : sinks)
+        sink->finish();
+}
+
+void PcmFileSink::write(const short *samples, unsigned int count)
+{
+    fwrite(samples, sizeof(short), count, fp);
+}
+
+void PcmFileSink::finish()
+{
+    fflush(fp);
+}
+
+void PcmResampleSink::write(const short *samples, unsigned int count)
+{
+    if (!resampler.active())
+    {
+        next->write(samples, count);
+        return;
+    }
+    resampler.process(samples, count, resampled);
+    if (!resampled.empty())
+        next->write(resampled.data(), resampled.size());
+}
+
+void PcmResampleSink::flush()
+{
+    if (resampler.active())
+    {
+        resampler.finish(resampled);
+        if (!resampled.empty())
+            next->write(resampled.data(), resampled.size());
+    }
+}
+
+void PcmResampleSink::finish()
+{
+    flush();
+    next->finish();
+}
+
+void PcmPlayerSink::write(const short *samples, unsigned int count)
+{
+    if (player)
+        player->SubmitFrames((unsigned char *)samples, count);
+}
+
+PcmThreadedSink::PcmThreadedSink(PcmSink *t, const std::string &n, size_t d, unsigned int c)
+    : target(t), name(n), depth(d), chunk(c), waits(0), dry(0)
+{
+}
+
+PcmThreadedSink::~PcmThreadedSink()
+{
+    if (thread.joinable())
+    {
+        ring.close();
+        thread.join();
+    }
+}
+
+void PcmThreadedSink::start()
+{
+    if (thread.joinable())
+        return;
+
+    ring.resize(depth < chunk ? chunk : depth);
+    waits = 0;
+    dry = 0;
+    thread = std::thread(&PcmThreadedSink::run, this);
+}
+
+void PcmThreadedSink::run()
+{
+    bool ran_dry = false;
+
+    // waitForData() returns false once the ring is closed and empty, so
+    // running dry is only counted when more samples follow
+    while (ring.waitForData())
+    {
+        if (ran_dry)
+            dry++;
+
+        size_t count;
+        const short *samples = ring.peek(&count);
+        while (count > 0)
+        {
+            if (count > chunk)
+                count = chunk;
+            target->write(samples, count);
+            ring.consume(count);
+            samples = ring.peek(&count);
+        }
+        ran_dry = true;
+    }
+}
+
+void PcmThreadedSink::write(const short *samples, unsigned int count)
+{
+    if (!thread.joinable())
+    {
+        target->write(samples, count);
+        return;
+    }
+
+    bool waited = false;
+    while (count > 0)
+    {
+        size_t written = ring.write(samples, count);
+        samples += written;
+        count -= written;
+        if (count > 0)
+        {
+            if (!waited)
+            {
+                waits++;
+                waited = true;
+            }
+            ring.waitForRoom();
+        }
+    }
+}
+
+void PcmThreadedSink::finish()
+{
+    if (thread.joinable())
+    {
+        ring.close();
+        thread.join();
+    }
+    target->finish();
+}
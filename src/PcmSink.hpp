@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "PcmRing.h"
+#include "PlayerInterface.h"
+#include "Resampler.hpp"
+
+/*
+================================================
+PcmSink
+
+a destination of the synthesized samples. Sinks are put together into a
+graph: the synthesizer writes each block of samples into the root of it
+once, and the block is handed on by reference from sink to sink; only
+stages that change the samples (resampling) or that have to keep them
+past the call (a thread's ring) copy them.
+================================================
+*/
+class PcmSink
+{
+public:
+    virtual ~PcmSink() {}
+
+    // the samples are only valid during the call
+    virtual void write(const short *samples, unsigned int count) = 0;
+    // no more samples follow: passes on whatever is held back
+    virtual void finish() {}
+};
+
+/*
+================================================
+PcmFanout
+
+hands every block to each of its sinks in turn
+================================================
+*/
+class PcmFanout : public PcmSink
+{
+    std::vector<PcmSink *> sinks;
+
+public:
+    void add(PcmSink *sink) { sinks.push_back(sink); }
+    bool empty() const { return sinks.empty(); }
+
+    void write(const short *samples, unsigned int count) override;
+    void finish() override;
+};
+
+/*
+================================================
+PcmFileSink
+
+raw 16 bit samples to a stream, such as stdout
+================================================
+*/
+class PcmFileSink : public PcmSink
+{
+    FILE *fp;
+
+public:
+    explicit PcmFileSink(FILE *f) : fp(f) {}
+
+    void write(const short *samples, unsigned int count) override;
+    void finish() override;
+};
+
+/*
+================================================
+PcmResampleSink
+
+resamples to the rate its Resampler is set to and passes the result on;
+blocks go through untouched while the rates are the same
+================================================
+*/
+class PcmResampleSink : public PcmSink
+{
+    Resampler resampler;
+    std::vector<short> resampled;
+    PcmSink *next;
+
+public:
+    explicit PcmResampleSink(PcmSink *n = 0) : next(n) {}
+
+    Resampler &getResampler() { return resampler; }
+    void setNext(PcmSink *n) { next = n; }
+
+    void write(const short *samples, unsigned int count) override;
+    // passes on what the resampler holds back, without finishing the sinks
+    // after it; the next sample starts the stream over
+    void flush();
+    void finish() override;
+};
+
+/*
+================================================
+PcmPlayerSink
+
+submits the samples to a PlayerInterface, which blocks until the
+device has taken them
+================================================
+*/
+class PcmPlayerSink : public PcmSink
+{
+    PlayerInterface *player;
+
+public:
+    explicit PcmPlayerSink(PlayerInterface *p = 0) : player(p) {}
+
+    void setPlayer(PlayerInterface *p) { player = p; }
+
+    void write(const short *samples, unsigned int count) override;
+};
+
+/*
+================================================
+PcmThreadedSink
+
+runs another sink on a thread of its own: write() only copies the
+samples into a lock-free ring, which the thread hands on to the sink in
+pieces of up to 'chunk' samples. The writer waits once the ring is
+full, so that a slow sink holds the synthesis back instead of the ring
+growing.
+
+waits counts the times the writer had to wait for room in the ring,
+dry the times the ring ran empty before finish().
+================================================
+*/
+class PcmThreadedSink : public PcmSink
+{
+    PcmSink *target;
+    std::string name;
+    PcmRing<short> ring;
+    std::thread thread;
+    size_t depth;
+    unsigned int chunk;
+    unsigned int waits;
+    unsigned int dry;
+
+    void run();
+
+public:
+    PcmThreadedSink(PcmSink *target, const std::string &name, size_t depth, unsigned int chunk = 1024);
+    virtual ~PcmThreadedSink();
+
+    // only while the thread is not running
+    void setDepth(size_t samples) { depth = samples; }
+    size_t getDepth() const { return depth; }
+    const std::string &getName() const { return name; }
+
+    void start();
+    bool running() const { return thread.joinable(); }
+
+    void write(const short *samples, unsigned int count) override;
+    // drains the ring, stops the thread and finishes the target
+    void finish() override;
+
+    // only read these once finished
+    unsigned int writerWaits() const { return waits; }
+    unsigned int ranDry() const { return dry; }
+};
@@ -22,9 +22,9 @@
 #include <cstring>
 
 #include "Pico.hpp"
-#include "Listener.hpp"
+#include "PcmSink.hpp"
 
-pads_t Boilerplate::pads[] = {
+const pads_t Boilerplate::formats[] = {
     {"speed", "<speed level=\"%d\">", "</speed>", 0},
     {"pitch", "<pitch level=\"%d\">", "</pitch>", 0},
     {"volume", "<volume level=\"%d\">", "</volume>", 0}};
@@ -35,14 +35,12 @@ Pico::Pico() : picoLingwarePath()
     picoTaResource = 0;
     picoSgResource = 0;
     picoEngine = 0;
-    sdOutFile = 0;
-    out_filename = 0;
 
     strcpy(picoVoiceName, "PicoVoice");
 
     total_text_length = 0;
     text_remaining = 0;
-    listener = 0;
+    pcm_sink = 0;
     modifiers = 0;
 
     picoMemArea = 0;
@@ -51,7 +49,9 @@ Pico::Pico() : picoLingwarePath()
     picoTaResourceName = 0;
     picoSgResourceName = 0;
 
-    pico_writeWavPcm = false;
+    pipelineStages = 1;
+    profiling = false;
+    expandPdfs = true;
 }
 
 Pico::~Pico()
@@ -72,7 +72,9 @@ Pico::~Pico()
 
 int Pico::initializeSystem()
 {
-    const int PICO_MEM_SIZE = 2500000;
+    // the lingware is shared outside of this area, so it only has to hold
+    // the engine, sized for its pipeline stages, and the system's own bookkeeping
+    const int PICO_MEM_SIZE = PICOCTRL_SYSTEM_MEM_SIZE(pipelineStages);
     pico_Retstring outMessage;
     int ret;
 
@@ -88,6 +90,16 @@ int Pico::initializeSystem()
         return -1;
     }
 
+    if ((ret = picoext_setPdfExpansion(picoSystem, expandPdfs)))
+    {
+        pico_getSystemStatusMessage(picoSystem, ret, outMessage);
+        fprintf(stderr, "Cannot set the pdf expansion (%i): %s\n", ret, outMessage);
+
+        pico_terminate(&picoSystem);
+        picoSystem = 0;
+        return -1;
+    }
+
     /* Load the text analysis Lingware resource file.   */
     picoTaFileName = (pico_Char *)malloc(PICO_MAX_DATAPATH_NAME_SIZE + PICO_MAX_FILE_NAME_SIZE);
 
@@ -103,7 +115,7 @@ int Pico::initializeSystem()
     strcat((char *)picoTaFileName, voices.getTaName());
 
     // attempt to load it
-    if ((ret = pico_loadResource(picoSystem, picoTaFileName, &picoTaResource)))
+    if ((ret = picoext_loadSharedResource(picoSystem, picoTaFileName, &picoTaResource)))
     {
         pico_getSystemStatusMessage(picoSystem, ret, outMessage);
         fprintf(stderr, "Cannot load text analysis resource file (%i): %s\n", ret, outMessage);
@@ -118,7 +130,7 @@ int Pico::initializeSystem()
         strcat((char *)picoSgFileName, "/");
     strcat((char *)picoSgFileName, voices.getSgName());
 
-    if ((ret = pico_loadResource(picoSystem, picoSgFileName, &picoSgResource)))
+    if ((ret = picoext_loadSharedResource(picoSystem, picoSgFileName, &picoSgResource)))
     {
         pico_getSystemStatusMessage(picoSystem, ret, outMessage);
         fprintf(stderr, "Cannot load signal generation Lingware resource file (%i): %s\n", ret, outMessage);
@@ -168,13 +180,20 @@ int Pico::initializeSystem()
     }
 
     /* Create a new Pico engine. */
-    if ((ret = pico_newEngine(picoSystem, (const pico_Char *)picoVoiceName, &picoEngine)))
+    if ((ret = picoext_newPipelinedEngine(picoSystem, (const pico_Char *)picoVoiceName, pipelineStages, &picoEngine)))
     {
         pico_getSystemStatusMessage(picoSystem, ret, outMessage);
         fprintf(stderr, "Cannot create a new pico engine (%i): %s\n", ret, outMessage);
         goto disposeEngine;
     }
 
+    if (profiling && (ret = picoext_setProfiling(picoEngine, 1)))
+    {
+        pico_getSystemStatusMessage(picoSystem, ret, outMessage);
+        fprintf(stderr, "Cannot enable profiling (%i): %s\n", ret, outMessage);
+        goto disposeEngine;
+    }
+
     /* success */
     return 0;
 
@@ -213,13 +232,6 @@ unloadTaResource:
 
 void Pico::cleanup()
 {
-    if (sdOutFile)
-    {
-        picoos_Common common = (picoos_Common)pico_sysGetCommon(picoSystem);
-        picoos_sdfCloseOut(common, &sdOutFile);
-        sdOutFile = 0;
-    }
-
     if (picoEngine)
     {
         pico_disposeEngine(picoSystem, &picoEngine);
@@ -257,17 +269,39 @@ void Pico::sendTextForProcessing(unsigned char *words, long long int word_len)
     total_text_length = word_len;
 }
 
+/*
+    synthesizes the text given to sendTextForProcessing().  Afterwards the
+    engine is soft-reset, so that another text and other modifiers can
+    follow without loading the voice again.
+*/
 int Pico::process()
 {
-    const int MAX_OUTBUF_SIZE = 128;
-    const int PCM_BUFFER_SIZE = 256;
+    int ret = processText();
+
+    pico_Retstring outMessage;
+    int status;
+    text_remaining = 0;
+    if ((status = pico_resetEngine(picoEngine, PICO_RESET_SOFT)))
+    {
+        pico_getSystemStatusMessage(picoSystem, status, outMessage);
+        fprintf(stderr, "Cannot reset engine (%i): %s\n", status, outMessage);
+        if (ret == 0)
+            ret = -3;
+    }
+
+    return ret;
+}
+
+int Pico::processText()
+{
+    const int MAX_OUTBUF_SAMPLES = 32768;
     pico_Char *inp = 0;
-    pico_Int16 bytes_sent, bytes_recv, out_data_type;
-    short outbuf[MAX_OUTBUF_SIZE / 2];
+    pico_Uint64 bytes_sent;
+    pico_Uint32 samples_recv;
+    pico_Int16 out_data_type;
+    std::vector<short> outbuf(MAX_OUTBUF_SAMPLES);
     pico_Retstring outMessage;
-    char pcm_buffer[PCM_BUFFER_SIZE];
     int ret, getstatus;
-    picoos_bool done = TRUE;
 
     bool do_startpad = false;
     bool do_endpad = false;
@@ -287,27 +321,12 @@ int Pico::process()
         inp = (pico_Char *)local_text;
     }
 
-    unsigned int bufused = 0;
-    memset(pcm_buffer, 0, PCM_BUFFER_SIZE);
-
-    // open output WAVE/PCM for writing
-    if (pico_writeWavPcm)
-    {
-        picoos_Common common = (picoos_Common)pico_sysGetCommon(picoSystem);
-        if (TRUE != (done = picoos_sdfOpenOut(common, &sdOutFile, (picoos_char *)out_filename, SAMPLE_FREQ_16KHZ, PICOOS_ENC_LIN)))
-        {
-            fprintf(stderr, "Cannot open output wave file: %s\n", out_filename);
-            return -1;
-        }
-    }
-
     long long int text_length = total_text_length;
 
     /* synthesis loop   */
     while (1)
     {
-        //−32,768 to 32,767.
-        if (text_remaining <= 0)
+        if (text_remaining == 0)
         {
             // text_remaining run-out; end pre-pad text
             if (do_startpad)
@@ -315,9 +334,8 @@ int Pico::process()
                 do_startpad = false;
                 // start normal text
                 inp = (pico_Char *)local_text;
-                int increment = text_length >= 32767 ? 32767 : text_length;
-                text_length -= increment;
-                text_remaining = increment;
+                text_remaining = text_length;
+                text_length = 0;
             }
             // main text ran out
             else if (text_length <= 0)
@@ -335,17 +353,16 @@ int Pico::process()
                     break; /* done */
                 }
             }
-            // continue feed main text
+            // feed main text
             else
             {
-                int increment = text_length >= 32767 ? 32767 : text_length;
-                text_length -= increment;
-                text_remaining = increment;
+                text_remaining = text_length;
+                text_length = 0;
             }
         }
 
         /* Feed the text into the engine.   */
-        if ((ret = pico_putTextUtf8(picoEngine, inp, text_remaining, &bytes_sent)))
+        if ((ret = picoext_putText(picoEngine, inp, text_remaining, &bytes_sent)))
         {
             pico_getSystemStatusMessage(picoSystem, ret, outMessage);
             fprintf(stderr, "Cannot put Text (%i): %s\n", ret, outMessage);
@@ -357,9 +374,8 @@ int Pico::process()
 
         do
         {
-
-            /* Retrieve the samples */
-            getstatus = pico_getData(picoEngine, (void *)outbuf, MAX_OUTBUF_SIZE, &bytes_recv, &out_data_type);
+            /* Retrieve the samples of as many steps as fit into outbuf */
+            getstatus = picoext_getData(picoEngine, (void *)outbuf.data(), MAX_OUTBUF_SAMPLES, &samples_recv, &out_data_type);
             if ((getstatus != PICO_STEP_BUSY) && (getstatus != PICO_STEP_IDLE))
             {
                 pico_getSystemStatusMessage(picoSystem, getstatus, outMessage);
@@ -367,61 +383,117 @@ int Pico::process()
                 return -4;
             }
 
-            /* copy partial encoding and get more bytes */
-            if (bytes_recv > 0)
+            if (samples_recv > 0)
             {
-                if ((bufused + bytes_recv) <= PCM_BUFFER_SIZE)
+                if (pcm_sink)
                 {
-                    memcpy(pcm_buffer + bufused, (int8_t *)outbuf, bytes_recv);
-                    bufused += bytes_recv;
-                }
-
-                /* or write the buffer to wavefile, and retrieve any leftover decoding bytes */
-                else
-                {
-                    if (pico_writeWavPcm)
-                    {
-                        done = picoos_sdfPutSamples(sdOutFile, bufused / 2, (picoos_int16 *)pcm_buffer);
-                    }
-
-                    if (listener)
-                    {
-                        listener->writeData((short *)pcm_buffer, bufused / 2);
-                    }
-
-                    bufused = 0;
-                    memcpy(pcm_buffer, (int8_t *)outbuf, bytes_recv);
-                    bufused += bytes_recv;
+                    pcm_sink->write(outbuf.data(), samples_recv);
                 }
             }
 
         } while (PICO_STEP_BUSY == getstatus);
+    }
 
-        /* This chunk of synthesis is finished; pass the remaining samples. */
-        if (pico_writeWavPcm)
-        {
-            done = picoos_sdfPutSamples(sdOutFile, bufused / 2, (picoos_int16 *)pcm_buffer);
-        }
+    return 0;
+}
 
-        if (listener)
-        {
-            listener->writeData((short *)pcm_buffer, bufused / 2);
-        }
+/*
+    synthesize one self-contained piece of text (wrapped in the modifier
+    pads like process() does) and append the samples to 'pcm'.  The engine
+    is left idle, ready for the next piece.
+*/
+int Pico::synthesize(const unsigned char *text, size_t length, std::vector<short> &pcm)
+{
+    return synthesize(text, length, [&pcm](short *samples, unsigned int count)
+                      {
+        pcm.insert(pcm.end(), samples, samples + count);
+        return true; });
+}
+
+/*
+    as above, but hands the samples to 'sink' as they are produced.  If the
+    sink returns false, synthesis stops and -5 is returned; the engine is
+    reset by the next call.
+*/
+int Pico::synthesize(const unsigned char *text, size_t length, const std::function<bool(short *, unsigned int)> &sink)
+{
+    const int MAX_OUTBUF_SAMPLES = 32768;
+    std::vector<short> outbuf(MAX_OUTBUF_SAMPLES);
+    pico_Retstring outMessage;
+    pico_Uint64 bytes_sent;
+    pico_Uint32 samples_recv;
+    pico_Int16 out_data_type;
+    int ret, getstatus;
+
+    const pico_Char *pieces[4];
+    size_t lengths[4];
+    unsigned int len;
+
+    pieces[0] = (const pico_Char *)(modifiers ? modifiers->getOpener(&len) : "");
+    lengths[0] = modifiers ? len : 0;
+    pieces[1] = (const pico_Char *)text;
+    lengths[1] = length;
+    // a '\0' makes the engine flush the last sentence
+    pieces[2] = (const pico_Char *)"";
+    lengths[2] = (length > 0 && text[length - 1] == '\0') ? 0 : 1;
+    pieces[3] = (const pico_Char *)(modifiers ? modifiers->getCloser(&len) : "");
+    lengths[3] = modifiers ? len : 0;
+
+    // start from a clean engine, so that a piece sounds the same whichever
+    // engine synthesized what came before it
+    if ((ret = pico_resetEngine(picoEngine, PICO_RESET_SOFT)))
+    {
+        pico_getSystemStatusMessage(picoSystem, ret, outMessage);
+        fprintf(stderr, "Cannot reset engine (%i): %s\n", ret, outMessage);
+        return -3;
     }
 
-    // close output wave file, so it can be opened elsewhere
-    if (sdOutFile)
+    for (int i = 0; i < 4; i++)
     {
-        picoos_Common common = (picoos_Common)pico_sysGetCommon(picoSystem);
-        picoos_sdfCloseOut(common, &sdOutFile);
-        sdOutFile = 0;
+        const pico_Char *inp = pieces[i];
+        size_t remaining = lengths[i];
+
+        while (remaining > 0)
+        {
+            if ((ret = picoext_putText(picoEngine, inp, remaining, &bytes_sent)))
+            {
+                pico_getSystemStatusMessage(picoSystem, ret, outMessage);
+                fprintf(stderr, "Cannot put Text (%i): %s\n", ret, outMessage);
+                return -2;
+            }
+            remaining -= bytes_sent;
+            inp += bytes_sent;
 
-        // report
-        int bytes = fileSize(out_filename);
-        fprintf(stderr, "wrote \"%s\" (%d bytes)\n", out_filename, bytes);
+            do
+            {
+                getstatus = picoext_getData(picoEngine, (void *)outbuf.data(), MAX_OUTBUF_SAMPLES, &samples_recv, &out_data_type);
+                if ((getstatus != PICO_STEP_BUSY) && (getstatus != PICO_STEP_IDLE))
+                {
+                    pico_getSystemStatusMessage(picoSystem, getstatus, outMessage);
+                    fprintf(stderr, "Cannot get Data (%i): %s\n", getstatus, outMessage);
+                    return -4;
+                }
+                if (samples_recv > 0 && !sink(outbuf.data(), samples_recv))
+                {
+                    return -5;
+                }
+            } while (PICO_STEP_BUSY == getstatus);
+        }
     }
 
-    return bufused;
+    return 0;
+}
+
+// adds this engine's counters to 'profile'
+int Pico::getProfile(PicoProfile &profile)
+{
+    picoext_PuProfile units[PICOEXT_MAX_PROFILED_PUS];
+    pico_Int16 count;
+
+    if (!picoEngine || picoext_getProfile(picoEngine, units, PICOEXT_MAX_PROFILED_PUS, &count))
+        return -1;
+    profile.add(units, count);
+    return 0;
 }
 
 int Pico::setVoice(const char *v)
@@ -431,21 +503,9 @@ int Pico::setVoice(const char *v)
     return r;
 }
 
-int Pico::fileSize(const char *filename)
-{
-    FILE *file_p = fopen(filename, "rb");
-    if (!file_p)
-        return -1;
-    fseek(file_p, 0L, SEEK_SET);
-    int beginning = ftell(file_p);
-    fseek(file_p, 0L, SEEK_END);
-    int end = ftell(file_p);
-    return end - beginning;
-}
-
-void Pico::setListener(Listener<short> *listener)
+void Pico::setSink(PcmSink *sink)
 {
-    this->listener = listener;
+    pcm_sink = sink;
 }
 
 void Pico::addModifiers(Boilerplate *modifiers)
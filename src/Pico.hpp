@@ -4,11 +4,15 @@ extern "C"
 {
 #include "picoapi.h"
 #include "picoapid.h"
+#include "picoextapi.h"
 #include "picoos.h"
 }
+#include <functional>
 #include <string>
+#include <vector>
 #include "Boilerplate.hpp"
-#include "Listener.hpp"
+#include "PcmSink.hpp"
+#include "PicoProfile.hpp"
 #include "PicoVoices.h"
 
 /*
@@ -27,16 +31,14 @@ private:
     pico_Resource picoTaResource;
     pico_Resource picoSgResource;
     pico_Engine picoEngine;
-    picoos_SDFile sdOutFile;
-    char *out_filename;
 
     pico_Char *local_text;
-    pico_Int16 text_remaining;
+    pico_Uint64 text_remaining;
     long long int total_text_length;
     std::string picoLingwarePath;
 
     char picoVoiceName[10];
-    Listener<short> *listener;
+    PcmSink *pcm_sink;
     Boilerplate *modifiers;
 
     void *picoMemArea;
@@ -44,7 +46,11 @@ private:
     pico_Char *picoSgFileName;
     pico_Char *picoTaResourceName;
     pico_Char *picoSgResourceName;
-    bool pico_writeWavPcm;
+    int pipelineStages;
+    bool profiling;
+    bool expandPdfs;
+
+    int processText();
 
 public:
     Pico();
@@ -55,12 +61,20 @@ public:
     void cleanup();
     void sendTextForProcessing(unsigned char *, long long int);
     int process();
+    int synthesize(const unsigned char *text, size_t length, std::vector<short> &pcm);
+    int synthesize(const unsigned char *text, size_t length, const std::function<bool(short *, unsigned int)> &sink);
 
     int setVoice(const char *);
-    void setOutFilename(const char *fn) { out_filename = const_cast<char *>(fn); }
 
-    int fileSize(const char *filename);
-    void setListener(Listener<short> *);
+    void setSink(PcmSink *);
     void addModifiers(Boilerplate *);
-    void writeWavePcm(bool new_setting = true) { pico_writeWavPcm = new_setting; }
+    // number of threads the synthesis chain is split across (1 = serial)
+    void setPipelineStages(int stages) { pipelineStages = stages; }
+    // count the time and throughput of each processing unit; takes effect
+    // in initializeSystem()
+    void setProfiling(bool on = true) { profiling = on; }
+    // decode the lingware's pdfs once at load time (about 2MB per voice)
+    // instead of on every frame; takes effect in initializeSystem()
+    void setPdfExpansion(bool on = true) { expandPdfs = on; }
+    int getProfile(PicoProfile &profile);
 };
@@ -0,0 +1,133 @@
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "PicoClient.hpp"
+#include "PicoProtocol.hpp"
+#include "PicoVoices.h"
+
+PicoClient::PicoClient(const std::string &path) : socket_path(path), fd(-1), voice(), pcm_sink(0), modifiers(0),
+                                                  local_text(0), total_text_length(0)
+{
+}
+
+PicoClient::~PicoClient()
+{
+    cleanup();
+}
+
+int PicoClient::setVoice(const char *v)
+{
+    PicoVoices_t voices;
+    int r = voices.setVoice(v);
+    if (r >= 0)
+    {
+        voice = voices.getVoice();
+        fprintf(stderr, "using lang: %s\n", voice.c_str());
+    }
+    return r;
+}
+
+int PicoClient::initializeSystem()
+{
+    struct sockaddr_un addr;
+    if (socket_path.size() >= sizeof(addr.sun_path))
+    {
+        fprintf(stderr, " **error: socket path too long: \"%s\"\n", socket_path.c_str());
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path.c_str());
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        perror(socket_path.c_str());
+        cleanup();
+        return -1;
+    }
+    return 0;
+}
+
+void PicoClient::cleanup()
+{
+    if (fd >= 0)
+    {
+        close(fd);
+        fd = -1;
+    }
+}
+
+void PicoClient::sendTextForProcessing(unsigned char *words, long long int word_len)
+{
+    local_text = words;
+    total_text_length = word_len;
+}
+
+int PicoClient::process()
+{
+    if (total_text_length > PICO_PROTOCOL_MAX_TEXT)
+    {
+        fprintf(stderr, " **error: input too long for the server\n");
+        return -1;
+    }
+
+    pico_request_t request;
+    memset(&request, 0, sizeof(request));
+    request.magic = PICO_PROTOCOL_MAGIC;
+    request.text_length = (uint32_t)total_text_length;
+    strncpy(request.voice, voice.c_str(), sizeof(request.voice) - 1);
+    request.speed = modifiers ? modifiers->getSpeed() : -1.0f;
+    request.pitch = modifiers ? modifiers->getPitch() : -1.0f;
+    request.volume = modifiers ? modifiers->getVolume() : -1.0f;
+
+    if (modifiers)
+        fprintf(stderr, "%s", modifiers->getStatusMessage());
+
+    if (!pico_writeAll(fd, &request, sizeof(request)) || !pico_writeAll(fd, local_text, request.text_length))
+    {
+        fprintf(stderr, " **error: lost the connection to the server\n");
+        return -2;
+    }
+
+    std::vector<short> samples;
+    int ret = 0;
+    while (1)
+    {
+        pico_reply_t reply;
+        if (!pico_readAll(fd, &reply, sizeof(reply)))
+        {
+            fprintf(stderr, " **error: lost the connection to the server\n");
+            ret = -4;
+            break;
+        }
+        if (reply.status < 0)
+        {
+            std::string message(reply.length, '\0');
+            pico_readAll(fd, &message[0], reply.length);
+            fprintf(stderr, " **error: server: %s\n", message.c_str());
+            ret = -4;
+            break;
+        }
+        if (reply.length == 0)
+            break; // done
+
+        samples.resize(reply.length / sizeof(short));
+        if (!pico_readAll(fd, samples.data(), reply.length))
+        {
+            fprintf(stderr, " **error: lost the connection to the server\n");
+            ret = -4;
+            break;
+        }
+
+        if (pcm_sink)
+            pcm_sink->write(samples.data(), samples.size());
+    }
+
+    return ret;
+}
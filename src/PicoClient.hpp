@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include "Boilerplate.hpp"
+#include "PcmSink.hpp"
+#include "PicoProfile.hpp"
+
+/*
+================================================
+PicoClient
+
+has a "nanotts --serve" process synthesize the text instead of starting
+an engine of its own, and passes the PCM it streams back on to the
+output sink just like Pico does.
+
+Offers the same setup calls as Pico; those about the engine itself are
+up to the server and ignored.
+================================================
+*/
+class PicoClient
+{
+private:
+    std::string socket_path;
+    int fd;
+
+    std::string voice;
+    PcmSink *pcm_sink;
+    Boilerplate *modifiers;
+
+    unsigned char *local_text;
+    long long int total_text_length;
+
+public:
+    explicit PicoClient(const std::string &path);
+    virtual ~PicoClient();
+
+    void setLangFilePath(const std::string &) {}
+    int initializeSystem();
+    void cleanup();
+    void sendTextForProcessing(unsigned char *, long long int);
+    int process();
+
+    int setVoice(const char *);
+
+    void setSink(PcmSink *s) { pcm_sink = s; }
+    void addModifiers(Boilerplate *m) { modifiers = m; }
+    void setPipelineStages(int) {}
+    // the engines are the server's
+    void setProfiling(bool = true) {}
+    int getProfile(PicoProfile &) { return -1; }
+};
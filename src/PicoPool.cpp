@@ -0,0 +1,227 @@
+
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#include "PicoPool.hpp"
+#include "WorkStealingPool.hpp"
+
+// pieces are at least this long, so that short sentences travel together
+#define MIN_PIECE_LENGTH 512
+// pieces in flight per engine; bounds the memory held by the reorder buffer
+#define PIECES_PER_ENGINE 4
+
+PicoPool::PicoPool(unsigned int jobs) : pcm_sink(0), local_text(0), total_text_length(0)
+{
+    if (jobs == 0)
+        jobs = 1;
+    for (unsigned int i = 0; i < jobs; i++)
+        engines.emplace_back(new Pico);
+}
+
+PicoPool::~PicoPool()
+{
+    cleanup();
+}
+
+void PicoPool::setLangFilePath(const std::string &path)
+{
+    for (auto &e : engines)
+        e->setLangFilePath(path);
+}
+
+int PicoPool::setVoice(const char *v)
+{
+    for (auto &e : engines)
+        if (e->setVoice(v) < 0)
+            return -1;
+    return 0;
+}
+
+void PicoPool::setSink(PcmSink *s)
+{
+    pcm_sink = s;
+}
+
+void PicoPool::addModifiers(Boilerplate *m)
+{
+    for (auto &e : engines)
+        e->addModifiers(m);
+}
+
+void PicoPool::setPipelineStages(int stages)
+{
+    for (auto &e : engines)
+        e->setPipelineStages(stages);
+}
+
+void PicoPool::setProfiling(bool on)
+{
+    for (auto &e : engines)
+        e->setProfiling(on);
+}
+
+// sums up the counters of all engines
+int PicoPool::getProfile(PicoProfile &profile)
+{
+    for (auto &e : engines)
+        if (e->getProfile(profile) < 0)
+            return -1;
+    return 0;
+}
+
+int PicoPool::initializeSystem()
+{
+    for (auto &e : engines)
+        if (e->initializeSystem() < 0)
+            return -1;
+    return 0;
+}
+
+void PicoPool::cleanup()
+{
+    for (auto &e : engines)
+        e->cleanup();
+}
+
+void PicoPool::sendTextForProcessing(unsigned char *words, long long int word_len)
+{
+    local_text = words;
+    total_text_length = word_len;
+}
+
+static bool is_space(unsigned char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/*
+    returns (offset, length) pieces covering all of 'text'.  A piece ends
+    after a sentence terminator ('.', '!' or '?', possibly followed by closing
+    quotes or brackets) and the whitespace behind it, unless the next word
+    starts in lower case or the terminator may end an abbreviation: a short
+    word such as "Dr." or an initial, a word with a full stop inside such as
+    "p.m." or "e.g.", or a short lower case word such as "etc.".  The engine
+    itself may not end a sentence there, and a piece ending there would get
+    a sentence pause the serial synthesis does not have, so such places are
+    left for the engine.  Text with markup is never split, as tags may span
+    sentences.
+*/
+std::vector<std::pair<size_t, size_t>> PicoPool::splitSentences(const unsigned char *text, size_t length, size_t min_length)
+{
+    std::vector<std::pair<size_t, size_t>> pieces;
+    size_t start = 0;
+
+    if (memchr(text, '<', length) != 0)
+    {
+        pieces.push_back(std::make_pair(0, length));
+        return pieces;
+    }
+
+    for (size_t i = 0; i < length; i++)
+    {
+        unsigned char c = text[i];
+        if (c != '.' && c != '!' && c != '?')
+            continue;
+
+        if (c == '.')
+        {
+            // length of the word in front of the full stop
+            size_t w = i;
+            while (w > start && !is_space(text[w - 1]))
+                w--;
+            if (i - w <= 2 || (i - w == 3 && text[w] == 'M'))
+                continue; // "A.", "Dr.", "Mrs." ...
+            if (memchr(text + w, '.', i - w) != 0)
+                continue; // "a.m.", "e.g.", "U.S." ...
+            size_t lower = w;
+            while (lower < i && text[lower] >= 'a' && text[lower] <= 'z')
+                lower++;
+            if (lower == i && i - w <= 3)
+                continue; // "etc.", "vs." ...
+        }
+
+        size_t end = i + 1;
+        while (end < length && strchr("\"')]", text[end]) && text[end] != 0)
+            end++;
+        if (end == length || !is_space(text[end]))
+            continue;
+        while (end < length && is_space(text[end]))
+            end++;
+        if (end < length && text[end] >= 'a' && text[end] <= 'z')
+            continue;
+
+        if (end - start >= min_length)
+        {
+            pieces.push_back(std::make_pair(start, end - start));
+            start = end;
+        }
+        i = end - 1;
+    }
+
+    if (start < length)
+    {
+        // a short tail joins the previous piece
+        if (!pieces.empty() && length - start < min_length / 2)
+            pieces.back().second += length - start;
+        else
+            pieces.push_back(std::make_pair(start, length - start));
+    }
+    return pieces;
+}
+
+int PicoPool::process()
+{
+    std::vector<std::pair<size_t, size_t>> pieces = splitSentences(local_text, total_text_length, MIN_PIECE_LENGTH);
+
+    // reorder buffer: pieces finished out of order wait here for their turn
+    std::mutex lock;
+    std::condition_variable ready;
+    std::map<size_t, std::vector<short>> finished;
+    int failed = 0;
+
+    // declared last so its workers are joined before the above goes away
+    WorkStealingPool pool((unsigned int)engines.size());
+
+    auto submit = [&](size_t index)
+    {
+        pool.submit([&, index](unsigned int worker)
+                    {
+            std::vector<short> pcm;
+            int ret = engines[worker]->synthesize(local_text + pieces[index].first, pieces[index].second, pcm);
+
+            std::lock_guard<std::mutex> guard(lock);
+            if (ret < 0)
+                failed = ret;
+            finished[index] = std::move(pcm);
+            ready.notify_one(); });
+    };
+
+    const size_t window = engines.size() * PIECES_PER_ENGINE;
+    size_t submitted = 0;
+    while (submitted < pieces.size() && submitted < window)
+        submit(submitted++);
+
+    for (size_t next = 0; next < pieces.size(); next++)
+    {
+        std::vector<short> pcm;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ready.wait(guard, [&] { return finished.count(next) > 0; });
+            pcm = std::move(finished[next]);
+            finished.erase(next);
+        }
+
+        if (submitted < pieces.size())
+            submit(submitted++);
+
+        if (pcm.empty())
+            continue;
+
+        if (pcm_sink)
+            pcm_sink->write(pcm.data(), pcm.size());
+    }
+
+    return failed;
+}
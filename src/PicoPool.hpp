@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Pico.hpp"
+
+/*
+================================================
+PicoPool
+
+synthesizes a document on several Pico engines at once.  The text is cut
+at sentence boundaries into pieces which are handed to a work-stealing
+thread pool, one engine per worker.  The finished pieces are put back in
+document order (reorder buffer) before they reach the output sink.  Every piece ends on a sentence boundary, so the engine's
+own sentence pause is what joins it to the next one.
+
+Offers the same setup calls as Pico.
+================================================
+*/
+class PicoPool
+{
+private:
+    std::vector<std::unique_ptr<Pico>> engines;
+
+    PcmSink *pcm_sink;
+    unsigned char *local_text;
+    long long int total_text_length;
+
+public:
+    explicit PicoPool(unsigned int jobs);
+    virtual ~PicoPool();
+
+    void setLangFilePath(const std::string &path);
+    int initializeSystem();
+    void cleanup();
+    void sendTextForProcessing(unsigned char *, long long int);
+    int process();
+
+    int setVoice(const char *);
+
+    void setSink(PcmSink *);
+    void addModifiers(Boilerplate *);
+    void setPipelineStages(int stages);
+    void setProfiling(bool on = true);
+    int getProfile(PicoProfile &profile);
+
+    static std::vector<std::pair<size_t, size_t>> splitSentences(const unsigned char *text, size_t length, size_t min_length);
+};
@@ -0,0 +1,76 @@
+
+#include <cstring>
+
+#include "PicoProfile.hpp"
+
+void PicoProfile::add(const picoext_PuProfile *profile, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        size_t j = 0;
+        while (j < units.size() && strcmp((const char *)units[j].name, (const char *)profile[i].name) != 0)
+            j++;
+        if (j == units.size())
+        {
+            units.push_back(profile[i]);
+            continue;
+        }
+        units[j].steps += profile[i].steps;
+        units[j].idleSteps += profile[i].idleSteps;
+        units[j].outFullSteps += profile[i].outFullSteps;
+        units[j].nanos += profile[i].nanos;
+        units[j].bytesIn += profile[i].bytesIn;
+        units[j].bytesOut += profile[i].bytesOut;
+        units[j].cacheHits += profile[i].cacheHits;
+        units[j].cacheMisses += profile[i].cacheMisses;
+    }
+    engines++;
+}
+
+void PicoProfile::print(FILE *fp) const
+{
+    pico_Uint64 total = 0;
+    for (auto &u : units)
+        total += u.nanos;
+
+    fprintf(fp, "profile of %d engine%s:\n", engines, engines == 1 ? "" : "s");
+    fprintf(fp, "  %-6s %10s %10s %10s %12s %7s %12s %12s %9s\n", "PU", "steps", "idle", "out full", "time ms", "time", "bytes in", "bytes out", "memo hits");
+    for (auto &u : units)
+    {
+        fprintf(fp, "  %-6s %10u %10u %10u %12.3f %6.1f%% %12llu %12llu", (const char *)u.name, u.steps, u.idleSteps,
+                u.outFullSteps, u.nanos / 1e6, total ? 100.0 * u.nanos / total : 0.0, u.bytesIn, u.bytesOut);
+        // only the PUs keeping a memo do any lookups
+        pico_Uint64 lookups = (pico_Uint64)u.cacheHits + u.cacheMisses;
+        if (lookups)
+            fprintf(fp, " %8.1f%%\n", 100.0 * u.cacheHits / lookups);
+        else
+            fprintf(fp, " %9s\n", "-");
+    }
+    fprintf(fp, "  %-6s %10s %10s %10s %12.3f\n", "total", "", "", "", total / 1e6);
+}
+
+int PicoProfile::writeJson(const std::string &filename, const std::string &voice) const
+{
+    FILE *fp = fopen(filename.c_str(), "w");
+    if (!fp)
+    {
+        fprintf(stderr, "Cannot open profile file: %s\n", filename.c_str());
+        return -1;
+    }
+
+    // PU names and voices are plain ASCII, nothing to escape
+    fprintf(fp, "{\n  \"voice\": \"%s\",\n  \"engines\": %d,\n  \"units\": [", voice.c_str(), engines);
+    for (size_t i = 0; i < units.size(); i++)
+    {
+        const picoext_PuProfile &u = units[i];
+        fprintf(fp, "%s\n    {\"name\": \"%s\", \"steps\": %u, \"idle_steps\": %u, \"out_full_steps\": %u, "
+                    "\"ns\": %llu, \"bytes_in\": %llu, \"bytes_out\": %llu, \"cache_hits\": %u, \"cache_misses\": %u}",
+                i ? "," : "", (const char *)u.name, u.steps, u.idleSteps, u.outFullSteps, u.nanos, u.bytesIn, u.bytesOut,
+                u.cacheHits, u.cacheMisses);
+    }
+    fprintf(fp, "\n  ]\n}\n");
+    fclose(fp);
+
+    fprintf(stderr, "wrote \"%s\"\n", filename.c_str());
+    return 0;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include "picoapi.h"
+#include "picoextapi.h"
+}
+
+/*
+================================================
+PicoProfile
+
+the time and throughput of each processing unit (PU) of the TTS chain
+(see picoext_getProfile), summed up over one or more engines, and their
+report as a table or as JSON.
+================================================
+*/
+class PicoProfile
+{
+private:
+    std::vector<picoext_PuProfile> units;
+    int engines;
+
+public:
+    PicoProfile() : engines(0) {}
+
+    // adds the counters of one engine
+    void add(const picoext_PuProfile *profile, int count);
+
+    void print(FILE *fp) const;
+    int writeJson(const std::string &filename, const std::string &voice) const;
+};
@@ -0,0 +1,44 @@
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include "PicoProtocol.hpp"
+
+// a peer that went away must not kill us with SIGPIPE
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
+bool pico_readAll(int fd, void *data, size_t size)
+{
+    char *p = (char *)data;
+    while (size > 0)
+    {
+        ssize_t n = recv(fd, p, size, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool pico_writeAll(int fd, const void *data, size_t size)
+{
+    const char *p = (const char *)data;
+    while (size > 0)
+    {
+        ssize_t n = send(fd, p, size, SEND_FLAGS);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+================================================
+PicoProtocol
+
+framing between "nanotts --serve" and "nanotts --connect" over a Unix
+domain socket.  Both ends run on the same host, so everything is in host
+byte order.
+
+A connection carries any number of requests, one after the other.  A
+request is a pico_request_t followed by 'text_length' bytes of UTF-8 text.
+It is answered by a series of pico_reply_t, each followed by 'length'
+bytes: 16-bit mono PCM at 16 kHz while 'status' is 0, or an error message
+if 'status' is negative.  A reply with status 0 and length 0 ends the
+answer to the request; an error reply ends it as well.
+================================================
+*/
+
+#define PICO_PROTOCOL_MAGIC 0x4f43504e // "NPCO"
+#define PICO_PROTOCOL_MAX_TEXT (16 * 1024 * 1024)
+
+struct pico_request_t
+{
+    uint32_t magic;
+    uint32_t text_length;
+    char voice[16]; // as for --voice, '\0' terminated
+    float speed;    // -1 keeps the engine's default
+    float pitch;
+    float volume;
+};
+
+struct pico_reply_t
+{
+    int32_t status;
+    uint32_t length;
+};
+
+// read or write exactly 'size' bytes; false on error or end of stream
+bool pico_readAll(int fd, void *data, size_t size);
+bool pico_writeAll(int fd, const void *data, size_t size);
@@ -0,0 +1,292 @@
+
+#include <csignal>
+#include <cstring>
+#include <thread>
+#include <pthread.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "PicoServer.hpp"
+#include "PicoProtocol.hpp"
+#include "PicoVoices.h"
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void onStopSignal(int)
+{
+    stop_requested = 1;
+}
+
+// -1 keeps the default; otherwise the range nanotts offers for the setting.
+// NaN fails both tests
+static bool isModifierValid(float value, float lowest, float highest)
+{
+    return value == -1.0f || (value >= lowest && value <= highest);
+}
+
+PicoServer::PicoServer(const std::string &path) : socket_path(path), lang_path("./lang"), engines_per_voice(1),
+                                                  pipeline_stages(1), listen_fd(-1), active_clients(0)
+{
+}
+
+PicoServer::~PicoServer()
+{
+    for (auto &e : engines)
+        e->cleanup();
+}
+
+// starts the engines of every voice whose lingware is present; returns
+// the number of voices available
+int PicoServer::warmUp()
+{
+    std::string dir = lang_path;
+    if (dir.empty() || dir.back() != '/')
+        dir += "/";
+
+    for (int i = 0; i < PICO_NUM_VOICES; i++)
+    {
+        PicoVoices_t voices;
+        voices.setVoice(i);
+        std::string name = voices.getVoice();
+
+        if (access((dir + voices.getTaName()).c_str(), R_OK) != 0 || access((dir + voices.getSgName()).c_str(), R_OK) != 0)
+            continue;
+
+        std::vector<Pico *> ready;
+        for (int j = 0; j < engines_per_voice; j++)
+        {
+            Pico *engine = new Pico;
+            engines.emplace_back(engine);
+            engine->setLangFilePath(lang_path);
+            engine->setVoice(name.c_str());
+            engine->setPipelineStages(pipeline_stages);
+            if (engine->initializeSystem() < 0)
+            {
+                fprintf(stderr, " **error: cannot start the engines for %s\n", name.c_str());
+                ready.clear();
+                break;
+            }
+            ready.push_back(engine);
+        }
+        if (!ready.empty())
+            idle[name] = ready;
+    }
+    return (int)idle.size();
+}
+
+// waits for a free engine for 'voice'; 0 if there are none for it
+Pico *PicoServer::acquire(const std::string &voice)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    auto it = idle.find(voice);
+    if (it == idle.end())
+        return 0;
+
+    changed.wait(guard, [&] { return !it->second.empty(); });
+    Pico *engine = it->second.back();
+    it->second.pop_back();
+    return engine;
+}
+
+void PicoServer::release(const std::string &voice, Pico *engine)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    idle[voice].push_back(engine);
+    changed.notify_all();
+}
+
+bool PicoServer::sendError(int fd, const char *message)
+{
+    pico_reply_t reply;
+    reply.status = -1;
+    reply.length = strlen(message);
+    return pico_writeAll(fd, &reply, sizeof(reply)) && pico_writeAll(fd, message, reply.length);
+}
+
+void PicoServer::serveClient(int fd)
+{
+    pico_request_t request;
+    std::vector<unsigned char> text;
+    PicoVoices_t voices;
+
+    while (pico_readAll(fd, &request, sizeof(request)))
+    {
+        if (request.magic != PICO_PROTOCOL_MAGIC || request.text_length > PICO_PROTOCOL_MAX_TEXT)
+        {
+            sendError(fd, "malformed request");
+            break;
+        }
+        text.resize(request.text_length);
+        if (!text.empty() && !pico_readAll(fd, text.data(), text.size()))
+            break;
+
+        if (!isModifierValid(request.speed, 0.2f, 5.0f) || !isModifierValid(request.pitch, 0.5f, 2.0f) ||
+            !isModifierValid(request.volume, 0.0f, 5.0f))
+        {
+            if (!sendError(fd, "speed, pitch or volume out of range"))
+                break;
+            continue;
+        }
+
+        request.voice[sizeof(request.voice) - 1] = '\0';
+        Pico *engine = 0;
+        std::string voice;
+        if (voices.setVoice(request.voice) >= 0)
+        {
+            voice = voices.getVoice();
+            engine = acquire(voice);
+        }
+        if (!engine)
+        {
+            if (!sendError(fd, "voice not available"))
+                break;
+            continue;
+        }
+
+        Boilerplate modifiers(request.speed, request.pitch, request.volume);
+        engine->addModifiers(modifiers.isChanged() ? &modifiers : 0);
+        int ret = engine->synthesize(text.data(), text.size(), [fd](short *samples, unsigned int count)
+                                     {
+            pico_reply_t reply;
+            reply.status = 0;
+            reply.length = count * sizeof(short);
+            return pico_writeAll(fd, &reply, sizeof(reply)) && pico_writeAll(fd, samples, reply.length); });
+        engine->addModifiers(0);
+        release(voice, engine);
+
+        if (ret == -5)
+            break; // the client went away
+        if (ret < 0)
+        {
+            if (!sendError(fd, "synthesis failed"))
+                break;
+            continue;
+        }
+
+        pico_reply_t done;
+        done.status = 0;
+        done.length = 0;
+        if (!pico_writeAll(fd, &done, sizeof(done)))
+            break;
+    }
+
+    close(fd);
+
+    std::lock_guard<std::mutex> guard(lock);
+    for (size_t i = 0; i < clients.size(); i++)
+    {
+        if (clients[i] == fd)
+        {
+            clients.erase(clients.begin() + i);
+            break;
+        }
+    }
+    active_clients--;
+    changed.notify_all();
+}
+
+int PicoServer::run()
+{
+    struct sockaddr_un addr;
+    if (socket_path.size() >= sizeof(addr.sun_path))
+    {
+        fprintf(stderr, " **error: socket path too long: \"%s\"\n", socket_path.c_str());
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path.c_str());
+
+    // SIGINT and SIGTERM are only taken while waiting for clients; every
+    // thread started from here on inherits them blocked
+    sigset_t stop_signals, old_mask, wait_mask;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, &old_mask);
+    wait_mask = old_mask;
+    sigdelset(&wait_mask, SIGINT);
+    sigdelset(&wait_mask, SIGTERM);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onStopSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, 0);
+    sigaction(SIGTERM, &action, 0);
+
+    if (warmUp() == 0)
+    {
+        fprintf(stderr, " **error: no voices found in \"%s\"\n", lang_path.c_str());
+        pthread_sigmask(SIG_SETMASK, &old_mask, 0);
+        return -1;
+    }
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0)
+    {
+        perror("socket");
+        pthread_sigmask(SIG_SETMASK, &old_mask, 0);
+        return -1;
+    }
+
+    // a socket left behind by a server that is gone may be replaced, one
+    // that still answers may not
+    if (connect(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+    {
+        fprintf(stderr, " **error: a server is already running on \"%s\"\n", socket_path.c_str());
+        close(listen_fd);
+        pthread_sigmask(SIG_SETMASK, &old_mask, 0);
+        return -1;
+    }
+    close(listen_fd);
+    unlink(socket_path.c_str());
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0 || bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, SOMAXCONN) < 0)
+    {
+        perror(socket_path.c_str());
+        if (listen_fd >= 0)
+            close(listen_fd);
+        pthread_sigmask(SIG_SETMASK, &old_mask, 0);
+        return -1;
+    }
+    fprintf(stderr, "serving on \"%s\"\n", socket_path.c_str());
+
+    while (!stop_requested)
+    {
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(listen_fd, &fds);
+        if (pselect(listen_fd + 1, &fds, 0, 0, 0, &wait_mask) < 0)
+            continue; // EINTR: a stop signal, most likely
+
+        int fd = accept(listen_fd, 0, 0);
+        if (fd < 0)
+            continue;
+
+        std::lock_guard<std::mutex> guard(lock);
+        clients.push_back(fd);
+        active_clients++;
+        std::thread(&PicoServer::serveClient, this, fd).detach();
+    }
+
+    close(listen_fd);
+    listen_fd = -1;
+    unlink(socket_path.c_str());
+    fprintf(stderr, "shutting down\n");
+
+    // cut off the clients and wait until their threads are done with the
+    // engines
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        for (int fd : clients)
+            shutdown(fd, SHUT_RDWR);
+        changed.wait(guard, [this] { return active_clients == 0; });
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old_mask, 0);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Pico.hpp"
+
+/*
+================================================
+PicoServer
+
+keeps Pico engines warm for every voice whose lingware is found, and
+synthesizes the requests of any number of clients connected to a Unix
+domain socket (see PicoProtocol.hpp).  Each client is served on a thread
+of its own; a request waits until an engine for its voice is free, so
+at most 'engines per voice' requests of one voice are synthesized at
+once.  PCM is streamed back while it is produced.
+
+runs until SIGINT or SIGTERM.
+================================================
+*/
+class PicoServer
+{
+private:
+    std::string socket_path;
+    std::string lang_path;
+    int engines_per_voice;
+    int pipeline_stages;
+    int listen_fd;
+
+    std::vector<std::unique_ptr<Pico>> engines;
+
+    // guards everything below
+    std::mutex lock;
+    std::condition_variable changed;
+    std::map<std::string, std::vector<Pico *>> idle; // free engines by voice
+    std::vector<int> clients;                        // connected sockets
+    int active_clients;
+
+    int warmUp();
+    Pico *acquire(const std::string &voice);
+    void release(const std::string &voice, Pico *engine);
+    void serveClient(int fd);
+    bool sendError(int fd, const char *message);
+
+public:
+    explicit PicoServer(const std::string &path);
+    virtual ~PicoServer();
+
+    void setLangFilePath(const std::string &path) { lang_path = path; }
+    void setEnginesPerVoice(int n) { engines_per_voice = n < 1 ? 1 : n; }
+    void setPipelineStages(int stages) { pipeline_stages = stages; }
+
+    int run();
+};
@@ -12,19 +12,19 @@ PicoVoices_t::PicoVoices_t() {
     const char * _picoInternalSgLingware[]       = { "en-US_lh0_sg.bin", "en-GB_kh0_sg.bin", "de-DE_gl0_sg.bin", "es-ES_zl0_sg.bin", "fr-FR_nk0_sg.bin", "it-IT_cm0_sg.bin" };
     const char * _picoInternalUtppLingware[]     = { "en-US_utpp.bin",   "en-GB_utpp.bin",   "de-DE_utpp.bin",   "es-ES_utpp.bin",   "fr-FR_utpp.bin",   "it-IT_utpp.bin" };
 
-    picoSupportedLangIso3 = new char*[6];
-    picoSupportedCountryIso3 = new char*[6];
-    picoSupportedLang = new char*[6];
-    picoInternalLang = new char*[6];
-    picoInternalTaLingware = new char*[6];
-    picoInternalSgLingware = new char*[6];
-    picoInternalUtppLingware = new char*[6];
+    picoSupportedLangIso3 = new char*[PICO_NUM_VOICES];
+    picoSupportedCountryIso3 = new char*[PICO_NUM_VOICES];
+    picoSupportedLang = new char*[PICO_NUM_VOICES];
+    picoInternalLang = new char*[PICO_NUM_VOICES];
+    picoInternalTaLingware = new char*[PICO_NUM_VOICES];
+    picoInternalSgLingware = new char*[PICO_NUM_VOICES];
+    picoInternalUtppLingware = new char*[PICO_NUM_VOICES];
 
     char * memory = new char[140 * 7];
     memset( memory, 0, 7 * 140 );
     float f;
 
-    for ( int i = 0; i < 6; i++ ) {
+    for ( int i = 0; i < PICO_NUM_VOICES; i++ ) {
         f = i;
         picoSupportedLangIso3[i]    = &memory[ (int)(f / 7 * 140) + 140 * 0 ];
         picoSupportedCountryIso3[i] = &memory[ (int)(f / 7 * 140) + 140 * 1 ];
@@ -56,7 +56,7 @@ PicoVoices_t::~PicoVoices_t() {
 }
 
 int PicoVoices_t::setVoice( int i ) {
-    if ( i >= 0 && i < 6 ) {
+    if ( i >= 0 && i < PICO_NUM_VOICES ) {
         voice = i;
         return 0;
     }
@@ -65,7 +65,7 @@ int PicoVoices_t::setVoice( int i ) {
 
 int PicoVoices_t::setVoice( const char * voc ) {
     char ** matchable[] = { picoSupportedLang, picoSupportedLangIso3, picoSupportedCountryIso3, 0 };
-    for ( int i = 0 ; i < 6; i++ ) {
+    for ( int i = 0 ; i < PICO_NUM_VOICES; i++ ) {
         int j = 0;
         while ( matchable[j] )
         {
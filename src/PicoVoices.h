@@ -4,6 +4,9 @@
 #include <stdio.h>
 #include <string.h>
 
+// the number of voices in the tables of PicoVoices.cpp
+#define PICO_NUM_VOICES 6
+
 class PicoVoices_t {
 private:
     int voice;
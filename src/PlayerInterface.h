@@ -6,6 +6,14 @@ enum {
     STREAM_ERROR    = -1
 };
 
+// trade-off between the delay until a sample is heard and how often the
+// player has to wake up to refill the sound card
+enum playbackProfile_t {
+    PLAYBACK_DEFAULT,
+    PLAYBACK_LOW_LATENCY,
+    PLAYBACK_LOW_CPU
+};
+
 class PlayerInterface {
 public:
     virtual ~PlayerInterface() { }
@@ -1,8 +1,24 @@
 
-// extremely basic Alsa stream device that has hardcoded PCM parameters
+// Alsa stream device playing mono, with its latency set by a playbackProfile_t
 #include "Player_Alsa.h"
+#include <errno.h>
+#include <string.h>
 
-Player_Alsa::Player_Alsa() : blocking_flag( 0 ), interface_started( false ) {
+// the device buffer of each profile, in periods of period_us; the device
+// is started once start_periods are written, or once the buffer is full
+// when that is 0
+static const struct {
+    unsigned int period_us;
+    unsigned int periods;
+    unsigned int start_periods;
+} player_profiles[] = {
+    {  12500, 4, 0 },       // PLAYBACK_DEFAULT: 50 ms, as snd_pcm_set_params() had it
+    {   4000, 3, 2 },       // PLAYBACK_LOW_LATENCY: 12 ms, starts after 8 ms
+    { 100000, 5, 0 },       // PLAYBACK_LOW_CPU: 500 ms, waking up every 100 ms
+};
+
+Player_Alsa::Player_Alsa( playbackProfile_t p, unsigned int r ) : handle( 0 ), blocking_flag( 0 ), interface_started( false ),
+    profile( p ), rate( r ), mmap_access( false ), period_size( 0 ), buffer_size( 0 ), start_threshold( 0 ) {
 }
 
 Player_Alsa::~Player_Alsa() {
@@ -20,17 +36,13 @@ int Player_Alsa::StreamOpen() {
     // open the PCM device
     if ( (err = snd_pcm_open( &handle, device, SND_PCM_STREAM_PLAYBACK, blocking_flag )) < 0 ) {
         fprintf( stderr, "error: opening pcm device failed %s\n", snd_strerror(err) );
+        return STREAM_ERROR;
     }
 
     // setup our pcm state (on the snd_pcm_t handle)
-    if ( (err = snd_pcm_set_params( handle,
-                                    SND_PCM_FORMAT_S16_LE,
-                                    SND_PCM_ACCESS_RW_INTERLEAVED,
-                                    1,
-                                    16000,
-                                    1,
-                                    50000 ) ) < 0 ) {   /* 0.05 sec */
-        fprintf( stderr, "Playback open error: %s\n", snd_strerror(err) );
+    if ( SetHwParams() < 0 || SetSwParams() < 0 ) {
+        snd_pcm_close( handle );
+        return STREAM_ERROR;
     }
 
     interface_started = true;
@@ -38,31 +50,208 @@ int Player_Alsa::StreamOpen() {
     return STREAM_OK;
 }
 
+// access, format and the period and buffer sizes of the profile, as near
+// as the device gets to them
+int Player_Alsa::SetHwParams() {
+    snd_pcm_hw_params_t * params;
+    int dir = 0;
+    int err = 0;
+
+    if ( (err = snd_pcm_hw_params_malloc( &params )) < 0 ) {
+        fprintf( stderr, "Playback open error: %s\n", snd_strerror(err) );
+        return err;
+    }
+
+    snd_pcm_hw_params_any( handle, params );
+
+    // let alsa resample only if the device cannot play our rate
+    snd_pcm_hw_params_set_rate_resample( handle, params, 1 );
+
+    mmap_access = snd_pcm_hw_params_set_access( handle, params, SND_PCM_ACCESS_MMAP_INTERLEAVED ) >= 0;
+    if ( !mmap_access ) {
+        err = snd_pcm_hw_params_set_access( handle, params, SND_PCM_ACCESS_RW_INTERLEAVED );
+    }
+    if ( err >= 0 ) {
+        err = snd_pcm_hw_params_set_format( handle, params, SND_PCM_FORMAT_S16_LE );
+    }
+    if ( err >= 0 ) {
+        err = snd_pcm_hw_params_set_channels( handle, params, 1 );
+    }
+    if ( err >= 0 ) {
+        // the samples keep coming at our rate, so a device that cannot take
+        // it even with alsa resampling would play them at the wrong speed
+        unsigned int device_rate = rate;
+        err = snd_pcm_hw_params_set_rate_near( handle, params, &device_rate, 0 );
+        if ( err >= 0 && device_rate != rate ) {
+            fprintf( stderr, "Playback open error: the device plays %u Hz instead of %u Hz\n", device_rate, rate );
+            snd_pcm_hw_params_free( params );
+            return -EINVAL;
+        }
+    }
+    if ( err >= 0 ) {
+        period_size = (snd_pcm_uframes_t)rate * player_profiles[profile].period_us / 1000000;
+        err = snd_pcm_hw_params_set_period_size_near( handle, params, &period_size, &dir );
+    }
+    if ( err >= 0 ) {
+        buffer_size = period_size * player_profiles[profile].periods;
+        err = snd_pcm_hw_params_set_buffer_size_near( handle, params, &buffer_size );
+    }
+    if ( err >= 0 ) {
+        err = snd_pcm_hw_params( handle, params );
+    }
+    if ( err >= 0 ) {
+        snd_pcm_hw_params_get_period_size( params, &period_size, &dir );
+        snd_pcm_hw_params_get_buffer_size( params, &buffer_size );
+    }
+
+    snd_pcm_hw_params_free( params );
+
+    if ( err < 0 ) {
+        fprintf( stderr, "Playback open error: %s\n", snd_strerror(err) );
+    }
+    return err;
+}
+
+// when the device starts and how much room it needs to wake us up
+int Player_Alsa::SetSwParams() {
+    snd_pcm_sw_params_t * params;
+    int err;
+
+    if ( (err = snd_pcm_sw_params_malloc( &params )) < 0 ) {
+        fprintf( stderr, "Playback open error: %s\n", snd_strerror(err) );
+        return err;
+    }
+
+    start_threshold = period_size * player_profiles[profile].start_periods;
+    if ( start_threshold == 0 || start_threshold > buffer_size ) {
+        start_threshold = buffer_size / period_size * period_size;
+    }
+
+    err = snd_pcm_sw_params_current( handle, params );
+    if ( err >= 0 ) {
+        err = snd_pcm_sw_params_set_start_threshold( handle, params, start_threshold );
+    }
+    if ( err >= 0 ) {
+        err = snd_pcm_sw_params_set_avail_min( handle, params, period_size );
+    }
+    if ( err >= 0 ) {
+        err = snd_pcm_sw_params( handle, params );
+    }
+
+    snd_pcm_sw_params_free( params );
+
+    if ( err < 0 ) {
+        fprintf( stderr, "Playback open error: %s\n", snd_strerror(err) );
+    }
+    return err;
+}
+
+int Player_Alsa::Recover( int err, const char * what ) {
+    fprintf( stderr, "error: %s: %s\n", what, snd_strerror( err ) );
+    err = snd_pcm_recover( handle, err, 0 );
+    if ( err < 0 ) {
+        fprintf( stderr, "error: %s failed: %s\n", what, snd_strerror( err ) );
+    }
+    return err;
+}
+
 int Player_Alsa::SubmitFrames( unsigned char * buffer, unsigned int frame_count )
 {
-    snd_pcm_sframes_t frames = snd_pcm_writei( handle, buffer, frame_count );
-
-    if ( frames < 0 ) {
-        fprintf( stderr, "error: snd_pcm_writei: %s\n", snd_strerror( frames ) );
-        fflush( stdout );
-        frames = snd_pcm_recover( handle, frames, 0 );
-        if ( frames < 0 ) {
-            fprintf( stderr, "error: snd_pcm_writei failed: %s\n", snd_strerror( frames ) );
-            fflush( stdout );
-            return STREAM_ERROR;
+    if ( !interface_started ) {
+        return STREAM_ERROR;
+    }
+
+    if ( mmap_access ) {
+        return WriteMmap( (const short *)buffer, frame_count );
+    }
+    return WriteRw( (const short *)buffer, frame_count );
+}
+
+int Player_Alsa::WriteRw( const short * frames, snd_pcm_uframes_t frame_count )
+{
+    while ( frame_count > 0 ) {
+        snd_pcm_sframes_t written = snd_pcm_writei( handle, frames, frame_count );
+        if ( written < 0 ) {
+            if ( Recover( written, "snd_pcm_writei" ) < 0 ) {
+                return STREAM_ERROR;
+            }
+            continue;
         }
+        frames += written;
+        frame_count -= written;
     }
 
-//    if ( frames > 0 ) {
-//        printf( "Played %li frames\n", frames );
-//    }
+    return STREAM_OK;
+}
+
+// copies the frames straight into the device's buffer, waiting for a
+// period's worth of room (or room for all of them) at a time. The device
+// is started by hand, as only writei starts it at the start threshold.
+int Player_Alsa::WriteMmap( const short * frames, snd_pcm_uframes_t frame_count )
+{
+    while ( frame_count > 0 ) {
+        snd_pcm_sframes_t avail = snd_pcm_avail_update( handle );
+        if ( avail < 0 ) {
+            if ( Recover( avail, "snd_pcm_avail_update" ) < 0 ) {
+                return STREAM_ERROR;
+            }
+            continue;
+        }
+
+        if ( (snd_pcm_uframes_t)avail < period_size && (snd_pcm_uframes_t)avail < frame_count ) {
+            int err;
+            if ( snd_pcm_state( handle ) == SND_PCM_STATE_PREPARED ) {
+                err = snd_pcm_start( handle );
+            } else {
+                err = snd_pcm_wait( handle, 1000 );
+            }
+            if ( err < 0 && Recover( err, "snd_pcm_wait" ) < 0 ) {
+                return STREAM_ERROR;
+            }
+            continue;
+        }
+
+        const snd_pcm_channel_area_t * areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t count = frame_count;
+        int err = snd_pcm_mmap_begin( handle, &areas, &offset, &count );
+        if ( err < 0 ) {
+            if ( Recover( err, "snd_pcm_mmap_begin" ) < 0 ) {
+                return STREAM_ERROR;
+            }
+            continue;
+        }
+
+        // one channel of 16 bit samples: first and step are in bits
+        unsigned char * to = (unsigned char *)areas[0].addr + areas[0].first / 8 + offset * areas[0].step / 8;
+        memcpy( to, frames, count * sizeof( short ) );
+
+        snd_pcm_sframes_t committed = snd_pcm_mmap_commit( handle, offset, count );
+        if ( committed < 0 || (snd_pcm_uframes_t)committed != count ) {
+            if ( Recover( committed < 0 ? committed : -EPIPE, "snd_pcm_mmap_commit" ) < 0 ) {
+                return STREAM_ERROR;
+            }
+            continue;
+        }
+        frames += count;
+        frame_count -= count;
+
+        if ( snd_pcm_state( handle ) == SND_PCM_STATE_PREPARED
+             && buffer_size - ( (snd_pcm_uframes_t)avail - count ) >= start_threshold ) {
+            if ( (err = snd_pcm_start( handle )) < 0 && Recover( err, "snd_pcm_start" ) < 0 ) {
+                return STREAM_ERROR;
+            }
+        }
+    }
 
     return STREAM_OK;
 }
 
+// plays what the device still has before closing it
 int Player_Alsa::StreamClose()
 {
     if ( interface_started ) {
+        snd_pcm_drain( handle );
         snd_pcm_close( handle );
         interface_started = false;
         return STREAM_OK;
@@ -10,8 +10,22 @@ public:
     int             blocking_flag;          // 0 = blocking; SND_PCM_NONBLOCK = not blocking
     bool            interface_started;
 
+    playbackProfile_t   profile;
+    unsigned int        rate;
+    bool                mmap_access;        // writing straight into the device's buffer
+    snd_pcm_uframes_t   period_size;        // as negotiated with the device
+    snd_pcm_uframes_t   buffer_size;
+    snd_pcm_uframes_t   start_threshold;
+
+private:
+    int SetHwParams();
+    int SetSwParams();
+    int Recover( int err, const char * what );
+    int WriteMmap( const short * frames, snd_pcm_uframes_t frame_count );
+    int WriteRw( const short * frames, snd_pcm_uframes_t frame_count );
+
 public:
-    Player_Alsa();
+    Player_Alsa( playbackProfile_t profile = PLAYBACK_DEFAULT, unsigned int rate = 16000 );
     ~Player_Alsa();
     int StreamOpen();
     int SubmitFrames( unsigned char * frames, unsigned int frame_count );
@@ -19,3 +33,4 @@ public:
 };
 
 #endif // __Player_Alsa__
+
@@ -0,0 +1,181 @@
+#include "Resampler.hpp"
+
+#include <cmath>
+#include <numeric>
+
+extern "C"
+{
+#include "picopal.h"
+#include "picosimd.h"
+}
+
+// taps per phase when upsampling; downsampling widens the filter by the ratio
+#define RESAMPLER_TAPS 64
+// the passband edge relative to the lower Nyquist frequency
+#define RESAMPLER_CUTOFF 0.91
+// the Kaiser window's shape; the Q14 coefficients, not the window, limit
+// the stopband (see Resampler.hpp)
+#define RESAMPLER_KAISER_BETA 8.6
+#define RESAMPLER_SHIFT 14
+
+Resampler::Resampler() : in_rate(16000), out_rate(16000), up(1), down(1), taps(0), pos(0), phase(0), vector_unit(false)
+{
+#if defined(PICOSIMD)
+    vector_unit = (picopal_cpu_features() & PICOSIMD_CPU) != 0;
+#endif
+}
+
+bool Resampler::setRates(unsigned int in, unsigned int out)
+{
+    if (in == 0 || out == 0 || out > 8 * in || in > 8 * out)
+        return false;
+
+    unsigned int g = std::gcd(in, out);
+    // the phase tables grow with up: 44.1 kHz from 16 kHz takes 441
+    if (out / g > 1000)
+        return false;
+
+    in_rate = in;
+    out_rate = out;
+    up = out / g;
+    down = in / g;
+
+    if (active())
+    {
+        design();
+        reset();
+    }
+    return true;
+}
+
+static double besselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 50; k++)
+    {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// the prototype low-pass at L times the input rate, split into its phases
+// and scaled to a gain of 1 in each of them
+void Resampler::design()
+{
+    taps = RESAMPLER_TAPS;
+    if (down > up)
+        taps = (RESAMPLER_TAPS * down / up + 7) & ~7u;
+
+    const unsigned int length = up * taps;
+    // the newest input sample of phase 0 is taps / 2 after the output
+    const double center = length / 2.0;
+    // cycles per sample of the upsampled signal
+    const double cutoff = RESAMPLER_CUTOFF * 0.5 / (down > up ? down : up);
+    const double norm = besselI0(RESAMPLER_KAISER_BETA);
+
+    std::vector<double> prototype(length);
+    for (unsigned int n = 0; n < length; n++)
+    {
+        double t = n - center;
+        double x = 2 * cutoff * t;
+        double sinc = x == 0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+        double r = t / center;
+        double window = besselI0(RESAMPLER_KAISER_BETA * std::sqrt(1 - r * r)) / norm;
+        prototype[n] = sinc * window;
+    }
+
+    // phase p takes prototype[p + j * up] to the input sample j before the
+    // newest, stored in the order of the input
+    coefs.assign(up * taps, 0);
+    for (unsigned int p = 0; p < up; p++)
+    {
+        double sum = 0;
+        for (unsigned int j = 0; j < taps; j++)
+            sum += prototype[p + j * up];
+        for (unsigned int j = 0; j < taps; j++)
+        {
+            double c = prototype[p + j * up] / sum;
+            coefs[p * taps + (taps - 1 - j)] = (int16_t)std::lround(c * (1 << RESAMPLER_SHIFT));
+        }
+    }
+}
+
+// the phase's taps coefficients against the taps samples from 'samples' on;
+// the magnitudes of each phase's coefficients add up to less than 3, so
+// the Q14 sum of 16 bit samples cannot overflow
+#if defined(PICOSIMD)
+PICOSIMD_FN static int32_t dotVector(const int16_t *samples, const int16_t *phase_coefs, unsigned int taps)
+{
+    picosimd_int32x4 sum = PICOSIMD_DUP(0);
+    for (unsigned int k = 0; k < taps; k += 8)
+    {
+        picosimd_int32x4 x = PICOSIMD_LOAD16(samples + k);
+        picosimd_int32x4 c = PICOSIMD_LOAD16(phase_coefs + k);
+        sum = PICOSIMD_ADD(sum, PICOSIMD_DOT16(x, c));
+    }
+    return PICOSIMD_HSUM(sum);
+}
+#endif
+
+int32_t Resampler::dot(const int16_t *samples, const int16_t *phase_coefs) const
+{
+#if defined(PICOSIMD)
+    if (vector_unit)
+        return dotVector(samples, phase_coefs, taps);
+#endif
+    int32_t sum = 0;
+    for (unsigned int k = 0; k < taps; k++)
+        sum += (int32_t)samples[k] * phase_coefs[k];
+    return sum;
+}
+
+void Resampler::reset()
+{
+    // the samples before the first one are silence
+    history.assign(taps / 2 - 1, 0);
+    pos = taps - 1;
+    phase = 0;
+}
+
+// every output whose window is complete, then drops the input no later
+// window needs
+void Resampler::run(std::vector<short> &out)
+{
+    while (pos < history.size())
+    {
+        int32_t sum = dot(history.data() + pos - (taps - 1), coefs.data() + phase * taps);
+        sum = (sum + (1 << (RESAMPLER_SHIFT - 1))) >> RESAMPLER_SHIFT;
+        if (sum > 32767)
+            sum = 32767;
+        else if (sum < -32768)
+            sum = -32768;
+        out.push_back((short)sum);
+
+        phase += down;
+        pos += phase / up;
+        phase %= up;
+    }
+
+    size_t drop = pos - (taps - 1);
+    history.erase(history.begin(), history.begin() + drop);
+    pos -= drop;
+}
+
+void Resampler::process(const short *in, unsigned int count, std::vector<short> &out)
+{
+    out.clear();
+    history.insert(history.end(), in, in + count);
+    out.reserve((size_t)count * up / down + 1);
+    run(out);
+}
+
+void Resampler::finish(std::vector<short> &out)
+{
+    out.clear();
+    // the silence after the last sample, as far as the windows of the
+    // outputs up to it look ahead
+    history.resize(history.size() + taps / 2, 0);
+    run(out);
+    reset();
+}
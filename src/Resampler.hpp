@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+================================================
+Resampler
+
+streaming polyphase resampler from the 16 kHz the engine synthesizes at
+to another rate. The rates' ratio is reduced to out/in = L/M, and each
+output sample is the dot product of the last few input samples with one
+of the L phases of a Kaiser-windowed sinc low-pass, in Q14 fixed point.
+The dot products use the SSE4.1 kernels of picosimd.h where the
+processor has them (and the NEON ones on arm64 builds with
+PICO_SIMD_NEON); the result is the same either way.
+
+The rounding of the coefficients to Q14 bounds how far images and
+aliases are suppressed: by 64 dB going to 8 kHz, 70 dB to 32 and 48 kHz
+and 84 dB to 11.025, 22.05 and 44.1 kHz, measured with tones across the
+passband.
+
+The output is aligned with the input: the first output sample is at the
+time of the first input sample, and finish() supplies the input that
+the last output samples still look ahead to. The stage holds back half
+a filter length of the input, 2 ms at 16 kHz (4 ms downsampling to 8
+kHz).
+================================================
+*/
+class Resampler
+{
+private:
+    unsigned int in_rate;
+    unsigned int out_rate;
+    unsigned int up;   // L
+    unsigned int down; // M
+    unsigned int taps; // per phase, a multiple of 8
+
+    // taps coefficients per phase, in the order of the input samples
+    std::vector<int16_t> coefs;
+
+    // the input still needed, the window of the next output ending at pos
+    std::vector<int16_t> history;
+    size_t pos;
+    unsigned int phase;
+
+    bool vector_unit;
+
+    void design();
+    int32_t dot(const int16_t *samples, const int16_t *phase_coefs) const;
+    void run(std::vector<short> &out);
+
+public:
+    Resampler();
+
+    // false for rates it cannot convert between, keeping the rates it had
+    bool setRates(unsigned int in_rate, unsigned int out_rate);
+    unsigned int outRate() const { return out_rate; }
+    // nothing to do when the rates are the same
+    bool active() const { return in_rate != out_rate; }
+
+    // resamples the count samples at in; out gets the samples ready so far
+    void process(const short *in, unsigned int count, std::vector<short> &out);
+    // the samples the input so far still makes, then starts over
+    void finish(std::vector<short> &out);
+    void reset();
+};
@@ -1,7 +1,13 @@
 
 #include "StreamHandler.h"
 
-StreamHandler::StreamHandler() : player( 0 ) {
+// largest piece handed to the player at once, so that the ring frees up
+// in steps while the player blocks
+#define PLAYBACK_CHUNK_FRAMES   1024
+
+StreamHandler::StreamHandler() : player( 0 ),
+    playback( &player_sink, "playback", PLAYBACK_RATE * PLAYBACK_DEFAULT_MS / 1000, PLAYBACK_CHUNK_FRAMES ),
+    rate( PLAYBACK_RATE ) {
 }
 
 StreamHandler::~StreamHandler() {
@@ -12,25 +18,47 @@ StreamHandler::~StreamHandler() {
     }
 }
 
+void StreamHandler::SetRingDepth( unsigned int milliseconds, unsigned int frames_per_second ) {
+    rate = frames_per_second;
+    playback.setDepth( (unsigned long long)rate * milliseconds / 1000 );
+}
+
 int StreamHandler::StreamOpen() {
-    if ( player ) {
-        player->StreamOpen();
+    if ( !player || playback.running() ) {
+        return 0;
+    }
+    if ( player->StreamOpen() != STREAM_OK ) {
+        return STREAM_ERROR;
     }
+
+    player_sink.setPlayer( player );
+    playback.start();
     return 0;
 }
 
 int StreamHandler::SubmitFrames( unsigned char * frames, unsigned int frame_count ) {
-    if ( player ) {
-        player->SubmitFrames( frames, frame_count );
+    if ( playback.running() ) {
+        playback.write( (const short *)frames, frame_count );
     }
     return 0;
 }
 
+// plays what is left in the ring before closing the player
 int StreamHandler::StreamClose() {
+    if ( playback.running() ) {
+        playback.finish();
+    }
     if ( player ) {
         player->StreamClose();
     }
     return 0;
 }
 
+void StreamHandler::write( const short * samples, unsigned int count ) {
+    SubmitFrames( (unsigned char *)samples, count );
+}
+
+void StreamHandler::finish() {
+    StreamClose();
+}
 
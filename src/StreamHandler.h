@@ -2,52 +2,56 @@
 #define __StreamHandler__
 
 #include "PlayerInterface.h"
-
-class StreamHandler : public PlayerInterface {
+#include "PcmSink.hpp"
+
+// the rate pico synthesizes at, in frames per second
+#define PLAYBACK_RATE           16000
+// how much of the speech synthesis may run ahead of the playback
+#define PLAYBACK_DEFAULT_MS     5000
+
+/*
+================================================
+StreamHandler
+
+plays through a thread of its own: SubmitFrames only copies the frames
+into a ring, which the playback thread hands on to the player at the
+pace the sound card takes them. Synthesis thus only waits for the card
+once it is more than the ring ahead, and the card keeps playing what
+is in the ring while a slow sentence is being synthesized.
+
+As a PcmSink it takes part in the output graph; finishing it closes
+the stream.
+
+overruns counts the times synthesis had to wait for room in the ring,
+underruns the times the ring ran dry before the stream was closed.
+================================================
+*/
+class StreamHandler : public PlayerInterface, public PcmSink {
 public:
     PlayerInterface * player;
 
+private:
+    PcmPlayerSink   player_sink;
+    PcmThreadedSink playback;
+    unsigned int    rate;
+
 public:
     StreamHandler();
     virtual ~StreamHandler();
     virtual int StreamOpen();
     virtual int SubmitFrames( unsigned char * frames, unsigned int frame_count );
     virtual int StreamClose();
-};
 
+    void write( const short * samples, unsigned int count ) override;
+    void finish() override;
 
-#if 0
-StreamHandler::StreamHandler() : player( 0 ) {
-}
-
-StreamHandler::~StreamHandler() {
-    StreamClose();
-    if ( player ) {
-        delete player;
-        player = 0;
-    }
-}
-
-int StreamHandler::StreamOpen() {
-    if ( player ) {
-        player->StreamOpen();
-    }
-    return 0;
-}
-
-int StreamHandler::SubmitFrames( unsigned char * frames, unsigned int frame_count ) {
-    if ( player ) {
-        player->SubmitFrames( frames, frame_count );
-    }
-    return 0;
-}
-
-int StreamHandler::StreamClose() {
-    if ( player ) {
-        player->StreamClose();
-    }
-    return 0;
-}
-#endif
+    // only before StreamOpen
+    void SetRingDepth( unsigned int milliseconds, unsigned int frames_per_second = PLAYBACK_RATE );
+    unsigned int RingDepth() const { return (unsigned long long)playback.getDepth() * 1000 / rate; }
+
+    // only read these once the stream is closed
+    unsigned int Overruns() const { return playback.writerWaits(); }
+    unsigned int Underruns() const { return playback.ranDry(); }
+};
 
 #endif // __StreamHandler__
@@ -0,0 +1,221 @@
+#include "WavSink.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "wav.h"
+
+// a multiple of the page size, so that full buffers go out in whole pages
+#define WAV_BUFFER_BYTES (256 * 1024)
+#define WAV_BUFFER_ALIGN 4096
+
+// WAV is little endian
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define WAV_SWAP_SAMPLES 1
+static unsigned int le32(unsigned int v) { return __builtin_bswap32(v); }
+static unsigned short le16(unsigned short v) { return __builtin_bswap16(v); }
+#else
+static unsigned int le32(unsigned int v) { return v; }
+static unsigned short le16(unsigned short v) { return v; }
+#endif
+
+static void fillHeader(struct WAV_HEADER &header, unsigned int rate, unsigned long long data_bytes)
+{
+    // what a 32 bit RIFF file can say
+    if (data_bytes > 0xffffffffULL - (sizeof(header) - 8))
+        data_bytes = 0xffffffffULL - (sizeof(header) - 8);
+
+    memcpy(&header.header.riff, "RIFF", 4);
+    header.header.filesize = le32((unsigned int)(sizeof(header) - 8 + data_bytes));
+    memcpy(&header.header.wave, "WAVE", 4);
+    memcpy(&header.header.format, "fmt ", 4);
+    header.header.formatLength = le32(sizeof(header.format));
+    header.format.formatTag = le16(1); // PCM
+    header.format.channels = le16(1);
+    header.format.samplesPerSec = le32(rate);
+    header.format.averageBytesPerSec = le32(rate * sizeof(short));
+    header.format.blockAlign = le16(sizeof(short));
+    header.format.bitsPerSample = le16(16);
+    memcpy(&header.data.type, "data", 4);
+    header.data.len = le32((unsigned int)data_bytes);
+}
+
+static bool hasWavSuffix(const std::string &name)
+{
+    return name.size() >= 4 && strcasecmp(name.c_str() + name.size() - 4, ".wav") == 0;
+}
+
+WavFileSink::WavFileSink() : fd(-1), raw(false), rate(0), buffer(0), buffered(0), data_bytes(0), error(0)
+{
+}
+
+WavFileSink::~WavFileSink()
+{
+    finish();
+    free(buffer);
+}
+
+int WavFileSink::open(const std::string &name, unsigned int r, unsigned long long expected_samples)
+{
+    finish();
+
+    if (!buffer)
+    {
+        buffer = (char *)aligned_alloc(WAV_BUFFER_ALIGN, WAV_BUFFER_BYTES);
+        if (!buffer)
+            return -1;
+    }
+
+    fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+        return -1;
+
+    filename = name;
+    raw = !hasWavSuffix(name);
+    rate = r;
+    buffered = 0;
+    data_bytes = 0;
+    error = 0;
+
+    if (!raw)
+    {
+        // the lengths are patched in by finish()
+        struct WAV_HEADER header;
+        fillHeader(header, rate, 0);
+        memcpy(buffer, &header, sizeof(header));
+        buffered = sizeof(header);
+    }
+
+#if defined(__linux__)
+    // where the file system cannot reserve space this is simply skipped;
+    // finish() cuts the file back to what was written
+    if (expected_samples > 0)
+        fallocate(fd, 0, 0, buffered + expected_samples * sizeof(short));
+#else
+    (void)expected_samples;
+#endif
+    return 0;
+}
+
+// the buffer followed by 'block', in as few system calls as the kernel takes them
+bool WavFileSink::writeOut(const void *block, size_t bytes)
+{
+    struct iovec parts[2];
+    parts[0].iov_base = buffer;
+    parts[0].iov_len = buffered;
+    parts[1].iov_base = const_cast<void *>(block);
+    parts[1].iov_len = bytes;
+
+    struct iovec *part = parts;
+    int count = 2;
+    while (count > 0)
+    {
+        if (part->iov_len == 0)
+        {
+            part++;
+            count--;
+            continue;
+        }
+        ssize_t written = writev(fd, part, count);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            error = errno;
+            return false;
+        }
+        while (count > 0 && (size_t)written >= part->iov_len)
+        {
+            written -= part->iov_len;
+            part++;
+            count--;
+        }
+        if (count > 0)
+        {
+            part->iov_base = (char *)part->iov_base + written;
+            part->iov_len -= written;
+        }
+    }
+    buffered = 0;
+    return true;
+}
+
+void WavFileSink::write(const short *samples, unsigned int count)
+{
+    if (fd < 0 || error)
+        return;
+
+    size_t bytes = count * sizeof(short);
+    data_bytes += bytes;
+
+#if defined(WAV_SWAP_SAMPLES)
+    // swapped into the buffer piece by piece
+    while (count > 0)
+    {
+        size_t room = (WAV_BUFFER_BYTES - buffered) / sizeof(short);
+        size_t n = count < room ? count : room;
+        unsigned short *to = (unsigned short *)(buffer + buffered);
+        for (size_t i = 0; i < n; i++)
+            to[i] = le16((unsigned short)samples[i]);
+        buffered += n * sizeof(short);
+        samples += n;
+        count -= n;
+        if (buffered == WAV_BUFFER_BYTES && !writeOut(0, 0))
+            return;
+    }
+#else
+    if (buffered + bytes <= WAV_BUFFER_BYTES)
+    {
+        memcpy(buffer + buffered, samples, bytes);
+        buffered += bytes;
+        if (buffered == WAV_BUFFER_BYTES)
+            writeOut(0, 0);
+        return;
+    }
+    writeOut(samples, bytes);
+#endif
+}
+
+unsigned long long WavFileSink::fileBytes() const
+{
+    return (raw ? 0 : sizeof(struct WAV_HEADER)) + data_bytes;
+}
+
+void WavFileSink::finish()
+{
+    if (fd < 0)
+        return;
+
+    if (!error && buffered > 0)
+        writeOut(0, 0);
+
+    if (!raw && !error)
+    {
+        struct WAV_HEADER header;
+        fillHeader(header, rate, data_bytes);
+        ssize_t written = pwrite(fd, &header, sizeof(header), 0);
+        if (written != (ssize_t)sizeof(header))
+            error = written < 0 ? errno : EIO;
+    }
+
+    // cut off what fallocate() reserved beyond the samples, even when
+    // writing failed part of the way
+    off_t end = error ? lseek(fd, 0, SEEK_CUR) : (off_t)fileBytes();
+    if (end >= 0 && ftruncate(fd, end) < 0 && !error)
+        error = errno;
+
+    if (error)
+    {
+        // fileBytes() then says what made it into the file
+        unsigned long long header_bytes = raw ? 0 : sizeof(struct WAV_HEADER);
+        data_bytes = end > (off_t)header_bytes ? end - header_bytes : 0;
+        fprintf(stderr, "error: writing \"%s\": %s\n", filename.c_str(), strerror(error));
+    }
+    close(fd);
+    fd = -1;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include "PcmSink.hpp"
+
+/*
+================================================
+WavFileSink
+
+writes 16 bit mono samples to a WAV file, or to a headerless PCM file
+when the name does not end in ".wav".
+
+Blocks are gathered in a large page-aligned buffer; a block that does
+not fit any more goes out with the buffer in one writev(), straight
+from the caller's memory. The header is written with zero lengths and
+patched once when the file is finished. Given an estimate of the
+length, open() reserves the disk space up front, and finish() gives
+back whatever of it went unused.
+================================================
+*/
+class WavFileSink : public PcmSink
+{
+    std::string filename;
+    int fd;
+    bool raw;
+    unsigned int rate;
+
+    char *buffer;
+    size_t buffered;
+    unsigned long long data_bytes;
+    // the errno of the first call that failed, 0 while all is well
+    int error;
+
+    bool writeOut(const void *block, size_t bytes);
+
+public:
+    WavFileSink();
+    virtual ~WavFileSink();
+
+    // 0 on success; expected_samples, if known, reserves the space
+    int open(const std::string &name, unsigned int rate, unsigned long long expected_samples = 0);
+    bool isOpen() const { return fd >= 0; }
+    const std::string &getFilename() const { return filename; }
+    // the length of the file, header included
+    unsigned long long fileBytes() const;
+
+    void write(const short *samples, unsigned int count) override;
+    // patches the header and closes the file
+    void finish() override;
+};
@@ -0,0 +1,92 @@
+#include "WorkStealingPool.hpp"
+
+WorkStealingPool::WorkStealingPool(unsigned int workers) : pending(0), quit(false), next_queue(0)
+{
+    if (workers == 0)
+        workers = 1;
+
+    for (unsigned int i = 0; i < workers; i++)
+        queues.emplace_back(new queue_t);
+
+    for (unsigned int i = 0; i < workers; i++)
+        threads.emplace_back(&WorkStealingPool::run, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        quit = true;
+    }
+    wakeup.notify_all();
+
+    for (auto &t : threads)
+        t.join();
+}
+
+void WorkStealingPool::submit(job_t job)
+{
+    // deal jobs out round-robin; stealing evens out the rest
+    unsigned int q;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        q = next_queue;
+        next_queue = (next_queue + 1) % queues.size();
+        pending++;
+    }
+    {
+        std::lock_guard<std::mutex> guard(queues[q]->lock);
+        queues[q]->jobs.push_back(std::move(job));
+    }
+    wakeup.notify_all();
+}
+
+bool WorkStealingPool::takeJob(unsigned int worker, job_t &job)
+{
+    {
+        queue_t &own = *queues[worker];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.jobs.empty())
+        {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            return true;
+        }
+    }
+
+    for (unsigned int i = 1; i < queues.size(); i++)
+    {
+        queue_t &victim = *queues[(worker + i) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.jobs.empty())
+        {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(unsigned int worker)
+{
+    job_t job;
+
+    while (1)
+    {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wakeup.wait(guard, [this] { return quit || pending > 0; });
+            if (pending == 0)
+                return; // quit, and nothing left to do
+            pending--;
+        }
+
+        // a job is reserved for us, but may sit in any queue
+        while (!takeJob(worker, job))
+            std::this_thread::yield();
+
+        job(worker);
+        job = nullptr;
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+================================================
+WorkStealingPool
+
+fixed set of worker threads, each with its own job queue.  A worker takes
+new work from the back of its own queue and, when that runs dry, steals
+from the front of the others, so long jobs on one worker don't leave the
+rest idle.  Jobs are told which worker runs them, letting each worker own
+per-thread state (e.g. a Pico engine).
+================================================
+*/
+class WorkStealingPool
+{
+public:
+    typedef std::function<void(unsigned int worker)> job_t;
+
+    explicit WorkStealingPool(unsigned int workers);
+    virtual ~WorkStealingPool();
+
+    void submit(job_t job);
+    unsigned int size() const { return (unsigned int)queues.size(); }
+
+private:
+    struct queue_t
+    {
+        std::mutex lock;
+        std::deque<job_t> jobs;
+    };
+
+    std::vector<std::unique_ptr<queue_t>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex lock;                // guards pending and quit, for sleeping
+    std::condition_variable wakeup;
+    unsigned int pending;
+    bool quit;
+    unsigned int next_queue;
+
+    bool takeJob(unsigned int worker, job_t &job);
+    void run(unsigned int worker);
+};
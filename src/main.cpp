@@ -25,65 +25,116 @@
 
 #include "Nano.hpp"
 #include "Pico.hpp"
+#include "PicoClient.hpp"
+#include "PicoPool.hpp"
+#include "PicoServer.hpp"
 #include "PicoVoices.h"
 
-int main(int argc, char **argv)
+// drives a Pico, or a PicoPool or PicoClient which offer the same calls.
+// The engine is started once and reused for every input.
+template <class Synthesizer>
+int synthesize(Nano &nano, Synthesizer &pico)
 {
-    Nano nano(argc, argv);
-    int res;
+    pico.setLangFilePath(nano.getLangFilePath());
 
-    //
-    if ((res = nano.parse_commandline_arguments()) < 0)
+    if (pico.setVoice(nano.getVoice().c_str()) < 0)
     {
-        if (res == -666)
-        {
-            return EXIT_SUCCESS;
-        }
+        std::cerr << "set voice failed, with: \"" << nano.getVoice() << "\"" << std::endl;
         return 127; // command not found
     }
 
+    pico.setSink(nano.getSink());
+    pico.addModifiers(nano.getModifiers());
+    pico.setPipelineStages(nano.pipelineStages());
+    pico.setProfiling(nano.profiling());
+
+    //
+    if (pico.initializeSystem() < 0)
+    {
+        std::cerr << " * problem initializing Svox Pico" << std::endl;
+        return 126; // command found but not executable
+    }
+
     //
     unsigned char *words = 0;
     unsigned int length = 0;
-    if (nano.ProduceInput(&words, &length) < 0)
+    int res;
+    while ((res = nano.ProduceInput(&words, &length)) > 0)
     {
-        return 65; // data format error
+        if (nano.beginOutput(length) < 0)
+            continue;
+        pico.sendTextForProcessing(words, length);
+        pico.process();
+        nano.endOutput();
     }
+    nano.finishOutput();
 
     //
-    Pico pico;
-    pico.setLangFilePath(nano.getLangFilePath());
-    pico.setOutFilename(nano.outFilename().c_str());
-
-    if (pico.setVoice(nano.getVoice().c_str()) < 0)
+    if (nano.profiling())
     {
-        std::cerr << "set voice failed, with: \"" << nano.getVoice() << "\"" << std::endl;
-        return 127; // command not found
+        PicoProfile profile;
+        if (pico.getProfile(profile) < 0)
+        {
+            std::cerr << " * no profile available" << std::endl;
+        }
+        else
+        {
+            profile.print(stderr);
+            if (!nano.profileJsonFilename().empty())
+                profile.writeJson(nano.profileJsonFilename(), nano.getVoice());
+        }
     }
 
-    if (nano.writingWaveFile())
+    //
+    pico.cleanup();
+
+    //
+    if (res < 0)
     {
-        pico.writeWavePcm();
+        return 65; // data format error
     }
-    pico.setListener(nano.getListener());
-    pico.addModifiers(nano.getModifiers());
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    Nano nano(argc, argv);
+    int res;
 
     //
-    if (pico.initializeSystem() < 0)
+    if ((res = nano.parse_commandline_arguments()) < 0)
     {
-        std::cerr << " * problem initializing Svox Pico" << std::endl;
-        return 126; // command found but not executable
+        if (res == -666)
+        {
+            return EXIT_SUCCESS;
+        }
+        return 127; // command not found
     }
 
     //
-    pico.sendTextForProcessing(words, length);
+    if (!nano.servePath().empty())
+    {
+        PicoServer server(nano.servePath());
+        server.setLangFilePath(nano.getLangFilePath());
+        server.setEnginesPerVoice(nano.numJobs());
+        server.setPipelineStages(nano.pipelineStages());
+        return server.run() < 0 ? 126 : EXIT_SUCCESS;
+    }
 
     //
-    pico.process();
+    if (!nano.connectPath().empty())
+    {
+        PicoClient client(nano.connectPath());
+        return synthesize(nano, client);
+    }
 
     //
-    pico.cleanup();
+    if (nano.numJobs() > 1)
+    {
+        PicoPool pool(nano.numJobs());
+        return synthesize(nano, pool);
+    }
 
-    //
-    return EXIT_SUCCESS;
+    Pico pico;
+    return synthesize(nano, pico);
 }
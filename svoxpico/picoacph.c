@@ -154,6 +154,9 @@ typedef struct acph_subobj {
 
     /* dtacc knowledge base */
     picokdt_DtACC dtacc;
+
+    /* classification state of the above trees */
+    picokdt_dtstate_t dtstate;
 } acph_subobj_t;
 
 
@@ -473,7 +476,7 @@ static pico_status_t acphSubPhrasing(picodata_ProcessingUnit this,
 
         /* no continue so far => subphrasing needed */
         /* construct input vector, which is set in dtphr */
-        if (!picokdt_dtPHRconstructInVec(acph->dtphr, valbuf[0], valbuf[1],
+        if (!picokdt_dtPHRconstructInVec(acph->dtphr, &acph->dtstate, valbuf[0], valbuf[1],
                                          valbuf[2], valbuf[3], valbuf[4],
                                          nrwordspre, nrwordsfol, nrsyllsfol)) {
             /* error constructing invec */
@@ -483,7 +486,7 @@ static pico_status_t acphSubPhrasing(picodata_ProcessingUnit this,
             okay = FALSE;
         }
         /* classify */
-        if (okay && (!picokdt_dtPHRclassify(acph->dtphr))) {
+        if (okay && (!picokdt_dtPHRclassify(acph->dtphr, &acph->dtstate))) {
             /* error doing classification */
             PICODBG_WARN(("problem classifying"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_CLASSIFICATION,
@@ -491,7 +494,7 @@ static pico_status_t acphSubPhrasing(picodata_ProcessingUnit this,
             okay = FALSE;
         }
         /* decompose */
-        if (okay && (!picokdt_dtPHRdecomposeOutClass(acph->dtphr, &dtres))) {
+        if (okay && (!picokdt_dtPHRdecomposeOutClass(acph->dtphr, &acph->dtstate, &dtres))) {
             /* error decomposing */
             PICODBG_WARN(("problem decomposing"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_OUTVECTOR,
@@ -760,7 +763,11 @@ static picoos_uint8 acphAccGetNrsLeft(picodata_ProcessingUnit this,
         i--;
     }
 
-    if ((acph->headx[i].boundstrength != PICODATA_ITEMINFO1_BOUND_PHR0) &&
+    /* the loop may have run off the start of headx; headx[-1] used to be
+       read here, which is whatever the memory area held before, so that
+       the accents depended on what the area was used for earlier */
+    if ((i >= 0) &&
+        (acph->headx[i].boundstrength != PICODATA_ITEMINFO1_BOUND_PHR0) &&
         (acph->headx[i].head.type == PICODATA_ITEM_WORDPHON)) {
         (*nrwordspre)++;
         *nrsyllspre += acphGetNrSylls(this, acph, i);
@@ -910,7 +917,7 @@ static pico_status_t acphAccentuation(register picodata_ProcessingUnit this,
 
         /* no continue so far => accentuation needed */
         /* construct input vector, which is set in dtacc */
-        if (!picokdt_dtACCconstructInVec(acph->dtacc, valbuf[0], valbuf[1],
+        if (!picokdt_dtACCconstructInVec(acph->dtacc, &acph->dtstate, valbuf[0], valbuf[1],
                                          valbuf[2], valbuf[3], valbuf[4],
                                          hist1, hist2, nrwordspre, nrsyllspre,
                                          nrwordsfol, nrsyllsfol, footwordsfol,
@@ -922,7 +929,7 @@ static pico_status_t acphAccentuation(register picodata_ProcessingUnit this,
             okay = FALSE;
         }
         /* classify */
-        if (okay && (!picokdt_dtACCclassify(acph->dtacc, &prevout))) {
+        if (okay && (!picokdt_dtACCclassify(acph->dtacc, &acph->dtstate, &prevout))) {
             /* error doing classification */
             PICODBG_WARN(("problem classifying"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_CLASSIFICATION,
@@ -930,7 +937,7 @@ static pico_status_t acphAccentuation(register picodata_ProcessingUnit this,
             okay = FALSE;
         }
         /* decompose */
-        if (okay && (!picokdt_dtACCdecomposeOutClass(acph->dtacc, &dtres))) {
+        if (okay && (!picokdt_dtACCdecomposeOutClass(acph->dtacc, &acph->dtstate, &dtres))) {
             /* error decomposing */
             PICODBG_WARN(("problem decomposing"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_OUTVECTOR,
@@ -300,19 +300,10 @@ PICO_FUNC pico_getSystemWarning(
 
 /* *** Resource loading and unloading functions *******************************/
 
-/**
- * pico_loadResource : Loads a resource file into the Pico system
- * @param    system : pointer to a pico_System struct
- * @param    *lingwareFileName : lingware resource file name
- * @param    *outLingware : pointer to receive the loaded lingware resource memory area address
- * @return  PICO_OK : successful
- * @return     PICO_ERR_INVALID_HANDLE, PICO_ERR_NULLPTR_ACCESS : errors
- * @callgraph
- * @callergraph
-*/
-PICO_FUNC pico_loadResource(
+pico_Status pico_loadResource_priv(
         pico_System system,
         const pico_Char *lingwareFileName,
+        pico_Int16 shared,
         pico_Resource *outLingware
         )
 {
@@ -326,7 +317,11 @@ PICO_FUNC pico_loadResource(
         PICODBG_DEBUG(("memory usage before resource loading"));
         picoos_showMemUsage(system->common->mm, FALSE, TRUE);
         picoos_emReset(system->common->em);
-        status = picorsrc_loadResource(system->rm, (picoos_char *) lingwareFileName, (picorsrc_Resource *) outLingware);
+        if (shared) {
+            status = picorsrc_loadSharedResource(system->rm, (picoos_char *) lingwareFileName, (picorsrc_Resource *) outLingware);
+        } else {
+            status = picorsrc_loadResource(system->rm, (picoos_char *) lingwareFileName, (picorsrc_Resource *) outLingware);
+        }
         PICODBG_DEBUG(("memory used to load resource %s", lingwareFileName));
         picoos_showMemUsage(system->common->mm, TRUE, FALSE);
     }
@@ -334,6 +329,25 @@ PICO_FUNC pico_loadResource(
     return status;
 }
 
+/**
+ * pico_loadResource : Loads a resource file into the Pico system
+ * @param    system : pointer to a pico_System struct
+ * @param    *lingwareFileName : lingware resource file name
+ * @param    *outLingware : pointer to receive the loaded lingware resource memory area address
+ * @return  PICO_OK : successful
+ * @return     PICO_ERR_INVALID_HANDLE, PICO_ERR_NULLPTR_ACCESS : errors
+ * @callgraph
+ * @callergraph
+*/
+PICO_FUNC pico_loadResource(
+        pico_System system,
+        const pico_Char *lingwareFileName,
+        pico_Resource *outLingware
+        )
+{
+    return pico_loadResource_priv(system, lingwareFileName, /*shared*/ FALSE, outLingware);
+}
+
 /**
  * pico_unloadResource : unLoads a resource file from the Pico system
  * @param    system : pointer to a pico_System struct
@@ -495,19 +509,10 @@ PICO_FUNC pico_releaseVoiceDefinition(
 
 /* *** Engine creation and deletion functions *********************************/
 
-/**
- * pico_newEngine : Creates and initializes a new Pico engine
- * @param    system : pointer to a pico_System struct
- * @param    *voiceName : pointer to the area containing the voice definition
- * @param    *outEngine : pointer to the Pico engine handle
- * @return  PICO_OK : successful
- * @return     PICO_ERR_INVALID_HANDLE, PICO_ERR_NULLPTR_ACCESS : errors
- * @callgraph
- * @callergraph
-*/
-PICO_FUNC pico_newEngine(
+pico_Status pico_newEngine_priv(
         pico_System system,
         const pico_Char *voiceName,
+        pico_Int16 numStages,
         pico_Engine *outEngine
         )
 {
@@ -526,7 +531,8 @@ PICO_FUNC pico_newEngine(
     } else {
         picoos_emReset(system->common->em);
         if (system->engine == NULL) {
-            *outEngine = (pico_Engine) picoctrl_newEngine(system->common->mm, system->rm, voiceName);
+            *outEngine = (pico_Engine) picoctrl_newPipelinedEngine(system->common->mm, system->rm,
+                    voiceName, (picoos_uint8) numStages);
             if (*outEngine != NULL) {
                 system->engine = (picoctrl_Engine) *outEngine;
             } else {
@@ -542,6 +548,25 @@ PICO_FUNC pico_newEngine(
     return status;
 }
 
+/**
+ * pico_newEngine : Creates and initializes a new Pico engine
+ * @param    system : pointer to a pico_System struct
+ * @param    *voiceName : pointer to the area containing the voice definition
+ * @param    *outEngine : pointer to the Pico engine handle
+ * @return  PICO_OK : successful
+ * @return     PICO_ERR_INVALID_HANDLE, PICO_ERR_NULLPTR_ACCESS : errors
+ * @callgraph
+ * @callergraph
+*/
+PICO_FUNC pico_newEngine(
+        pico_System system,
+        const pico_Char *voiceName,
+        pico_Engine *outEngine
+        )
+{
+    return pico_newEngine_priv(system, voiceName, /*numStages*/ 1, outEngine);
+}
+
 /**
  * pico_disposeEngine : Disposes a Pico engine
  * @param    system : pointer to a pico_System struct
@@ -598,6 +623,7 @@ PICO_FUNC pico_putTextUtf8(
         pico_Int16 *bytesPut)
 {
     pico_Status status = PICO_OK;
+    picoos_uint32 put;
 
     if (!picoctrl_isValidEngineHandle((picoctrl_Engine) engine)) {
         status = PICO_ERR_INVALID_HANDLE;
@@ -609,7 +635,8 @@ PICO_FUNC pico_putTextUtf8(
         status = PICO_ERR_NULLPTR_ACCESS;
     } else {
         picoctrl_engResetExceptionManager((picoctrl_Engine) engine);
-        status = picoctrl_engFeedText((picoctrl_Engine) engine, (picoos_char *)text, textSize, bytesPut);
+        status = picoctrl_engFeedText((picoctrl_Engine) engine, (picoos_char *)text, textSize, &put);
+        *bytesPut = (pico_Int16) put;
     }
 
     return status;
@@ -149,6 +149,7 @@ typedef struct pico_engine   *pico_Engine;
 #define PICO_UINT16_MAX  0xffff
 #define PICO_INT32_MAX   2147483647
 #define PICO_UINT32_MAX  0xffffffff
+#define PICO_UINT64_MAX  0xffffffffffffffffULL
 
 #include <limits.h>
 
@@ -176,6 +177,12 @@ typedef unsigned int pico_Uint32;
 #error "platform not supported"
 #endif
 
+#if (ULLONG_MAX == PICO_UINT64_MAX)
+typedef unsigned long long pico_Uint64;
+#else
+#error "platform not supported"
+#endif
+
 
 /* Char data type *****************************************************/
 
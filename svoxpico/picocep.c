@@ -71,6 +71,7 @@ extern "C" {
 #endif
 
 #define PICOCEP_MAXWINLEN 10000  /* maximum number of frames that can be smoothed, i.e. maximum sentence length */
+#define PICOCEP_MAXCEPORDER PICOKPDF_MAX_MUL_MGC_CEPORDER  /* maximum number of dimensions smoothed at once */
 #define PICOCEP_MSGSTR_SIZE 32
 #define PICOCEP_IN_BUFF_SIZE PICODATA_BUFSIZE_DEFAULT
 
@@ -188,9 +189,29 @@ typedef struct cep_subobj
     picoos_uint32 nNumFrames;
     /*---------------------- other working variables ---------------------------*/
 
+    /* the bands of WUW and WUm, of numcep dimensions smoothed together:
+     frame i of dimension cepnum+k at [i*numcep+k] */
+#if defined(PICO_DSP_FLOAT)
+    /* the floating point smoothing replaces each value of diag1, diag2 and
+     WUm by its factor or solution value once it has read it */
+    picoos_int32 diag0[PICOCEP_MAXWINLEN];
+    union {
+        picoos_int32 diag1[PICOCEP_MAXWINLEN];
+        picoos_single fdiag1[PICOCEP_MAXWINLEN];
+    };
+    union {
+        picoos_int32 diag2[PICOCEP_MAXWINLEN];
+        picoos_single fdiag2[PICOCEP_MAXWINLEN];
+    };
+    union {
+        picoos_int32 WUm[PICOCEP_MAXWINLEN];
+        picoos_single fWUm[PICOCEP_MAXWINLEN];
+    };
+#else
     picoos_int32 diag0[PICOCEP_MAXWINLEN], diag1[PICOCEP_MAXWINLEN],
             diag2[PICOCEP_MAXWINLEN], WUm[PICOCEP_MAXWINLEN],
             invdiag0[PICOCEP_MAXWINLEN];
+#endif
 
     /*---------------------- constants --------------------------------------*/
     picoos_int32 xi[5], x1[2], x2[3], xm[3], xn[2];
@@ -247,13 +268,16 @@ static picoos_int32 getFromPdf(picokpdf_PdfMUL pdf, picoos_uint32 vecstart,
         picoos_uint8 cepnum, picocep_WantMeanOrIvar_t wantMeanOrIvar,
         picocep_WantStaticOrDelta_t wantStaticOrDeltax);
 
+static picoos_uint8 getNumSmoothed(picokpdf_PdfMUL pdf, picoos_uint8 cepnum,
+        picoos_uint16 N);
+
 static void invMatrix(cep_subobj_t * cep, picoos_uint16 N,
-        picoos_int16 *smoothcep, picoos_uint8 cepnum,
+        picoos_int16 *smoothcep, picoos_uint8 cepnum, picoos_uint8 numcep,
         picokpdf_PdfMUL pdf, picoos_uint8 invpow, picoos_uint8 invDoubleDec);
 
 static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
         picoos_uint16 *indices, picoos_uint16 b, picoos_uint16 N,
-        picoos_uint8 cepnum);
+        picoos_uint8 cepnum, picoos_uint8 numcep);
 
 static void getDirect(picokpdf_PdfMUL pdf, picoos_uint16 *indices,
         picoos_uint16 activeEndPos,
@@ -474,6 +498,7 @@ picodata_ProcessingUnit picocep_newCepUnit(picoos_MemoryManager mm,
  * --------------------------------------------
  */
 
+#if !defined(PICO_DSP_FLOAT)
 /**
  * multiply by 1<<pow and check overflow
  * @param    a : input value
@@ -711,11 +736,10 @@ static picoos_int32 picocep_fixptdiv(picoos_int32 a, picoos_int32 b,
 static picoos_int32 picocep_fixptInvDiagEle(picoos_uint32 d,
         picoos_uint8* rowscpow, picoos_uint8 bigpow, picoos_uint8 invpow)
 {
-    picoos_uint32 r, b, c, h, f, stop;
+    picoos_uint32 r, b, c, f;
+    picoos_uint64 num, q;
     picoos_uint8 dlen;
     /* picoos_int32 zz; */
-    c = 0;
-    stop = 0;
 
     dlen = picocep_highestBitU(d);
     if (invpow + bigpow > 30 + dlen) { /* c must be < 2^32, hence d which is >= 2^(dlen-1) must be > 2^(invpow+bigpow-32), or invpow+bigpow must be <= dlen+30*/
@@ -723,28 +747,16 @@ static picoos_int32 picocep_fixptInvDiagEle(picoos_uint32 d,
     } else {
         *rowscpow = 0;
     }
-    r = 1 << invpow;
     b = d << (*rowscpow);
 
-    /* first */
-    h = r / b;
-    if (h > 0) {
-        c += (h << bigpow);
-        r -= h * b;
-    }
-    bigpow--;
-    r <<= 1;
-
-    /* loop */
-    while ((bigpow > stop) && (r != 0)) {
-        if (r >= b) {
-            c += (1 << bigpow);
-            r -= b;
-        }
-        bigpow--;
-        r <<= 1;
-    }
+    /* the bits of (1<<invpow)/b from 1<<bigpow down to 1<<1, in one
+     division instead of one step per bit, and the remainder left by them */
+    num = ((picoos_uint64) 1) << (invpow + bigpow - 1);
+    q = num / b;
+    c = ((picoos_uint32) q) << 1;
+    r = ((picoos_uint32) (num - q * b)) << 1;
 
+    /* the last bit, rounded */
     if (r != 0) {
         f = r + (b >> 1);
         if (f >= b) {
@@ -800,6 +812,7 @@ static picoos_int32 picocep_fixptinv(picoos_int32 a, picoos_uint32 invb,
     }
     return c;
 }
+#endif /* !PICO_DSP_FLOAT */
 
 /**
  * initializes the coefficients to calculate delta and delta-delta values and the squares of the coefficients
@@ -845,103 +858,208 @@ static void initSmoothing(cep_subobj_t * cep)
     cep->xsqn[1] = 4;
 }
 
+#if defined(PICO_DSP_FLOAT)
+/**
+ * matrix inversion, in floating point
+ * @param    cep : PU sub object pointer
+ * @param    N
+ * @param    smoothcep : pointer to picoos_int16, sequence of smoothed cepstral vectors
+ * @param    cepnum :  first cepstral dimension to be treated
+ * @param    numcep :  number of cepstral dimensions to be treated
+ * @param    pdf :  pdf resource
+ * @param    invpow, invDoubleDec : only used by the fixed point version
+ * @return  void
+ * @remarks solves WUW * c = WUm through an LDL factorization of the band matrix;
+ * as the fixed point values of WUW and WUm share their base 1<<bigpow, c comes
+ * out as the plain value of what the fixed point version computes
+ * @remarks the dimensions are independent, each step is done for all of
+ * them at once (the inner loops run over the dimensions and vectorize)
+ * @remarks diag0, diag1, diag2, WUm  globals needed in this function (object members in pico);
+ * diag1, diag2 and WUm are overwritten
+ * @callgraph
+ * @callergraph
+ */
+static void invMatrix(cep_subobj_t * cep, picoos_uint16 N,
+        picoos_int16 *smoothcep, picoos_uint8 cepnum, picoos_uint8 numcep,
+        picokpdf_PdfMUL pdf, picoos_uint8 invpow, picoos_uint8 invDoubleDec)
+{
+    picoos_int32 j;
+    picoos_uint32 i, k, n;
+    picoos_single d, z, a1, scale;
+    /* per dimension, of the previous two rows: pivots, right hand sides,
+     and l1[j-1], l2[j-1], l2[j-2]; zero before the first row */
+    picoos_single d1[PICOCEP_MAXCEPORDER], d2[PICOCEP_MAXCEPORDER];
+    picoos_single z1[PICOCEP_MAXCEPORDER], z2[PICOCEP_MAXCEPORDER];
+    picoos_single l11[PICOCEP_MAXCEPORDER], l21[PICOCEP_MAXCEPORDER],
+            l22[PICOCEP_MAXCEPORDER];
+    picoos_single *l1 = cep->fdiag1, *l2 = cep->fdiag2, *x = cep->fWUm;
+    picoos_uint8 ceporder = pdf->ceporder;
+
+    for (k = 0; k < numcep; k++) {
+        d1[k] = d2[k] = z1[k] = z2[k] = 0;
+        l11[k] = l21[k] = l22[k] = 0;
+    }
+
+    /* LDL factorization with forward substitution; of D only the last two
+     pivots are needed, x[j] receives z[j]/D[j] */
+    for (j = 0, i = 0; j < N; j++) {
+        for (k = 0; k < numcep; k++, i++) {
+            /* row j of WUW and WUm, before l1, l2 and x take their place */
+            d = (picoos_single) cep->diag0[i];
+            a1 = (picoos_single) cep->diag1[i];
+            z = (picoos_single) cep->WUm[i];
+            d -= l11[k] * l11[k] * d1[k];
+            z -= l11[k] * z1[k];
+            d -= l22[k] * l22[k] * d2[k];
+            z -= l22[k] * z2[k];
+            a1 -= l21[k] * l11[k] * d1[k];
+            l22[k] = l21[k];
+            l1[i] = l11[k] = a1 / d;
+            l2[i] = l21[k] = (picoos_single) cep->diag2[i] / d;
+            x[i] = z / d;
+            d2[k] = d1[k];
+            d1[k] = d;
+            z2[k] = z1[k];
+            z1[k] = z;
+        }
+    }
+
+    /* backward substitution */
+    n = numcep;
+    for (i = (N - 2) * n, k = 0; k < n; k++, i++) {
+        x[i] -= l1[i] * x[i + n];
+    }
+    for (j = N - 3; j >= 0; j--) {
+        for (i = j * n, k = 0; k < n; k++, i++) {
+            x[i] -= l1[i] * x[i + n];
+            x[i] -= l2[i] * x[i + 2 * n];
+        }
+    }
+
+    /* copy N frames into smoothcep (only for coeffs # "cepnum" to
+     "cepnum+numcep-1"), in the fixed point base of the other version,
+     1<<(bigpow-meanpow) */
+    scale = (picoos_single) (1 << pdf->bigpow) / (picoos_single) (1 << pdf->meanpow);
+    for (j = 0, i = 0; j < N; j++) {
+        for (k = 0; k < numcep; k++, i++) {
+            smoothcep[j * ceporder + cepnum + k] = (picoos_int16) (picoos_int32) (x[i] * scale);
+        }
+    }
+}/* invMatrix*/
+#else
 /**
  * matrix inversion
  * @param    cep : PU sub object pointer
  * @param    N
  * @param    smoothcep : pointer to picoos_int16, sequence of smoothed cepstral vectors
- * @param    cepnum :  cepstral dimension to be treated
+ * @param    cepnum :  first cepstral dimension to be treated
+ * @param    numcep :  number of cepstral dimensions to be treated
  * @param    pdf :  pdf resource
  * @param    invpow :  fixed point base for inverse
  * @param    invDoubleDec : boolean indicating that result of picocep_fixptinv has fixed point base 2*bigpow
  *             picocep_fixptmult absorbs double decimal size by dividing its result by extra factor big
  * @return  void
+ * @remarks the dimensions are independent, each step is done for all of
+ * them before the next (which keeps several divisions in flight)
  * @remarks diag0, diag1, diag2, WUm, invdiag0  globals needed in this function (object members in pico)
  * @callgraph
  * @callergraph
  */
 static void invMatrix(cep_subobj_t * cep, picoos_uint16 N,
-        picoos_int16 *smoothcep, picoos_uint8 cepnum,
+        picoos_int16 *smoothcep, picoos_uint8 cepnum, picoos_uint8 numcep,
         picokpdf_PdfMUL pdf, picoos_uint8 invpow, picoos_uint8 invDoubleDec)
 {
     picoos_int32 j, v1, v2, h;
-    picoos_uint32 k;
-    picoos_uint8 rowscpow, prevrowscpow;
+    picoos_uint32 i, i1, i2, k, n;
+    picoos_uint8 rowscpow[PICOCEP_MAXCEPORDER], prevrowscpow[PICOCEP_MAXCEPORDER];
     picoos_uint8 ceporder = pdf->ceporder;
     picoos_uint8 bigpow = pdf->bigpow;
     picoos_uint8 meanpow = pdf->meanpow;
 
+    /* element i is row j of dimension k, i1 and i2 are rows j-1 and j-2 */
+    n = numcep;
+
     /* LDL factorization */
-    prevrowscpow = 0;
-    cep->invdiag0[0] = picocep_fixptInvDiagEle(cep->diag0[0], &rowscpow,
-            bigpow, invpow); /* inverse has fixed point basis 1<<invpow */
-    cep->diag1[0] = picocep_fixptinv((cep->diag1[0]) << rowscpow,
-            cep->invdiag0[0], bigpow, invpow, invDoubleDec); /* perform division via inverse */
-    cep->diag2[0] = picocep_fixptinv((cep->diag2[0]) << rowscpow,
-            cep->invdiag0[0], bigpow, invpow, invDoubleDec);
-    cep->WUm[0] = (cep->WUm[0]) << rowscpow; /* if diag0 too low, multiply LHS and RHS of row in matrix equation by 1<<rowscpow */
+    for (k = 0; k < n; k++) {
+        prevrowscpow[k] = 0;
+        cep->invdiag0[k] = picocep_fixptInvDiagEle(cep->diag0[k], &rowscpow[k],
+                bigpow, invpow); /* inverse has fixed point basis 1<<invpow */
+        cep->diag1[k] = picocep_fixptinv((cep->diag1[k]) << rowscpow[k],
+                cep->invdiag0[k], bigpow, invpow, invDoubleDec); /* perform division via inverse */
+        cep->diag2[k] = picocep_fixptinv((cep->diag2[k]) << rowscpow[k],
+                cep->invdiag0[k], bigpow, invpow, invDoubleDec);
+        cep->WUm[k] = (cep->WUm[k]) << rowscpow[k]; /* if diag0 too low, multiply LHS and RHS of row in matrix equation by 1<<rowscpow */
+    }
     for (j = 1; j < N; j++) {
-        /* do forward substitution */
-        cep->WUm[j] = cep->WUm[j] - picocep_fixptmult(cep->diag1[j - 1],
-                cep->WUm[j - 1], bigpow, invDoubleDec);
-        if (j > 1) {
-            cep->WUm[j] = cep->WUm[j] - picocep_fixptmult(cep->diag2[j - 2],
-                    cep->WUm[j - 2], bigpow, invDoubleDec);
-        }
+        for (k = 0, i = j * n; k < n; k++, i++) {
+            i1 = i - n;
+            i2 = i1 - n;
+            /* do forward substitution */
+            cep->WUm[i] = cep->WUm[i] - picocep_fixptmult(cep->diag1[i1],
+                    cep->WUm[i1], bigpow, invDoubleDec);
+            if (j > 1) {
+                cep->WUm[i] = cep->WUm[i] - picocep_fixptmult(cep->diag2[i2],
+                        cep->WUm[i2], bigpow, invDoubleDec);
+            }
 
-        /* update row j */
-        v1 = picocep_fixptmult((cep->diag1[j - 1]) / (1 << rowscpow),
-                cep->diag0[j - 1], bigpow, invDoubleDec); /* undo scaling by 1<<rowscpow because diag1(j-1) refers to symm ele in column j-1 not in row j-1 */
-        cep->diag0[j] = cep->diag0[j] - picocep_fixptmult(cep->diag1[j - 1],
-                v1, bigpow, invDoubleDec);
-        if (j > 1) {
-            v2 = picocep_fixptmult((cep->diag2[j - 2]) / (1 << prevrowscpow),
-                    cep->diag0[j - 2], bigpow, invDoubleDec); /* undo scaling by 1<<prevrowscpow because diag1(j-2) refers to symm ele in column j-2 not in row j-2 */
-            cep->diag0[j] = cep->diag0[j] - picocep_fixptmult(
-                    cep->diag2[j - 2], v2, bigpow, invDoubleDec);
-        }
-        prevrowscpow = rowscpow;
-        cep->invdiag0[j] = picocep_fixptInvDiagEle(cep->diag0[j], &rowscpow,
-                bigpow, invpow); /* inverse has fixed point basis 1<<invpow */
-        cep->WUm[j] = (cep->WUm[j]) << rowscpow;
-        if (j < N - 1) {
-            h = picocep_fixptmult(cep->diag2[j - 1], v1, bigpow, invDoubleDec);
-            cep->diag1[j] = picocep_fixptinv((cep->diag1[j] - h) << rowscpow,
-                    cep->invdiag0[j], bigpow, invpow, invDoubleDec); /* eliminate column j below pivot */
-        }
-        if (j < N - 2) {
-            cep->diag2[j] = picocep_fixptinv((cep->diag2[j]) << rowscpow,
-                    cep->invdiag0[j], bigpow, invpow, invDoubleDec); /* eliminate column j below pivot */
+            /* update row j */
+            v1 = picocep_fixptmult((cep->diag1[i1]) / (1 << rowscpow[k]),
+                    cep->diag0[i1], bigpow, invDoubleDec); /* undo scaling by 1<<rowscpow because diag1(j-1) refers to symm ele in column j-1 not in row j-1 */
+            cep->diag0[i] = cep->diag0[i] - picocep_fixptmult(cep->diag1[i1],
+                    v1, bigpow, invDoubleDec);
+            if (j > 1) {
+                v2 = picocep_fixptmult((cep->diag2[i2]) / (1 << prevrowscpow[k]),
+                        cep->diag0[i2], bigpow, invDoubleDec); /* undo scaling by 1<<prevrowscpow because diag1(j-2) refers to symm ele in column j-2 not in row j-2 */
+                cep->diag0[i] = cep->diag0[i] - picocep_fixptmult(
+                        cep->diag2[i2], v2, bigpow, invDoubleDec);
+            }
+            prevrowscpow[k] = rowscpow[k];
+            cep->invdiag0[i] = picocep_fixptInvDiagEle(cep->diag0[i], &rowscpow[k],
+                    bigpow, invpow); /* inverse has fixed point basis 1<<invpow */
+            cep->WUm[i] = (cep->WUm[i]) << rowscpow[k];
+            if (j < N - 1) {
+                h = picocep_fixptmult(cep->diag2[i1], v1, bigpow, invDoubleDec);
+                cep->diag1[i] = picocep_fixptinv((cep->diag1[i] - h) << rowscpow[k],
+                        cep->invdiag0[i], bigpow, invpow, invDoubleDec); /* eliminate column j below pivot */
+            }
+            if (j < N - 2) {
+                cep->diag2[i] = picocep_fixptinv((cep->diag2[i]) << rowscpow[k],
+                        cep->invdiag0[i], bigpow, invpow, invDoubleDec); /* eliminate column j below pivot */
+            }
         }
     }
 
     /* divide all entries of WUm by diag0 */
-    for (j = 0; j < N; j++) {
-        cep->WUm[j] = picocep_fixptinv(cep->WUm[j], cep->invdiag0[j], bigpow,
+    for (i = 0; i < N * n; i++) {
+        cep->WUm[i] = picocep_fixptinv(cep->WUm[i], cep->invdiag0[i], bigpow,
                 invpow, invDoubleDec);
         if (invDoubleDec == 1) {
-            cep->WUm[j] = picocep_fixptdivpow(cep->WUm[j], bigpow);
+            cep->WUm[i] = picocep_fixptdivpow(cep->WUm[i], bigpow);
         }
     }
 
     /* backward substitution */
     for (j = N - 2; j >= 0; j--) {
-        cep->WUm[j] = cep->WUm[j] - picocep_fixptmult(cep->diag1[j], cep->WUm[j
-                + 1], bigpow, invDoubleDec);
-        if (j < N - 2) {
-            cep->WUm[j] = cep->WUm[j] - picocep_fixptmult(cep->diag2[j],
-                    cep->WUm[j + 2], bigpow, invDoubleDec);
+        for (k = 0, i = j * n; k < n; k++, i++) {
+            cep->WUm[i] = cep->WUm[i] - picocep_fixptmult(cep->diag1[i],
+                    cep->WUm[i + n], bigpow, invDoubleDec);
+            if (j < N - 2) {
+                cep->WUm[i] = cep->WUm[i] - picocep_fixptmult(cep->diag2[i],
+                        cep->WUm[i + 2 * n], bigpow, invDoubleDec);
+            }
         }
     }
-    /* copy N frames into smoothcep (only for coeff # "cepnum")  */
+    /* copy N frames into smoothcep (only for coeffs # "cepnum" to "cepnum+numcep-1") */
     /* coefficients normalized to occupy short; for correct waveform energy, divide by (1<<(bigpow-meanpow)) then convert e.g. to picoos_single */
-    k = cepnum;
-    for (j = 0; j < N; j++) {
-        smoothcep[k] = (picoos_int16)(cep->WUm[j]/(1<<meanpow));
-        k += ceporder;
+    for (j = 0, i = 0; j < N; j++) {
+        for (k = 0; k < n; k++, i++) {
+            smoothcep[j * ceporder + cepnum + k] = (picoos_int16)(cep->WUm[i]/(1<<meanpow));
+        }
     }
 
 }/* invMatrix*/
+#endif
+
 
 /**
  * Calculate matrix products needed to implement the solution
@@ -949,28 +1067,37 @@ static void invMatrix(cep_subobj_t * cep, picoos_uint16 N,
  * @param    pdf :  pointer to picoos_uint8, sequence of pdf vectors, each vector of length 1+ceporder*2+numdeltas*3+ceporder*3
  * @param    indices : indices of pdf vectors for all frames in current sentence
  * @param    b, N :  to be smoothed frames indices (range will be from b to b+N-1)
- * @param    cepnum :  cepstral dimension to be treated
+ * @param    cepnum :  first cepstral dimension to be treated
+ * @param    numcep :  number of cepstral dimensions to be treated, N*numcep <= PICOCEP_MAXWINLEN
  * @return  void
  * @remarks diag0, diag1, diag2, WUm, invdiag0  globals needed in this function (object members in pico)
  * @remarks WUW --> At x W x A
  * @remarks WUm --> At x W x b
+ * @remarks row i only depends on the pdf vectors of frames i-1, i and i+1,
+ * which are taken from the expanded pdf or else decoded once for all
+ * numcep dimensions
  * @callgraph
  * @callergraph
  */
 static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
         picoos_uint16 *indices, picoos_uint16 b, picoos_uint16 N,
-        picoos_uint8 cepnum)
+        picoos_uint8 cepnum, picoos_uint8 numcep)
 {
+    picoos_int32 vec[3][PICOKPDF_MUL_NUMVALUES * PICOCEP_MAXCEPORDER]; /* frame i is decoded into vec[i % 3] */
+    const picoos_int32 *row[3]; /* values of frame i at row[i % 3], from dimension cepnum on */
+    const picoos_int32 *v, *vn, *vd[2], *vdd[3];
     picoos_uint16 Id[2], Idd[3];
-    /*picoos_uint32      vecstart, k;*/
-    picoos_uint32 vecstart;
     picoos_int32 *x = NULL, *xsq = NULL;
-    picoos_int32 mean, ivar;
+    picoos_int32 diag0[PICOCEP_MAXCEPORDER], WUm[PICOCEP_MAXCEPORDER];
     picoos_uint16 i, j, numd = 0, numdd = 0;
-    picoos_uint8 vecsize = pdf->vecsize;
-    picoos_int32 prev_WUm, prev_diag0, prev_diag1, prev_diag1_1, prev_diag2;
+    picoos_uint32 e;
+    picoos_uint8 k;
+    picoos_uint8 ceporder = pdf->ceporder;
+    /* where the means and inverse variances of a stream start in a row */
+    picoos_uint16 ms = PICOCEP_WANTSTATIC * ceporder, md = PICOCEP_WANTDELTA * ceporder,
+            mdd = PICOCEP_WANTDELTA2 * ceporder;
+    picoos_uint16 is = ms + 3 * ceporder, id = md + 3 * ceporder, idd = mdd + 3 * ceporder;
 
-    prev_WUm = prev_diag0 = prev_diag1 = prev_diag1_1 = prev_diag2 = 0;
     for (i = 0; i < N; i++) {
 
         if ((1 < i) && (i < N - 2)) {
@@ -1007,111 +1134,72 @@ static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
             Id[0] = Idd[0] = N - 2;
         }
 
+        /* frames 0 and 1 are needed from the start, then frame i+1 replaces i-2 */
+        for (j = (i == 0) ? 0 : i + 1; (j <= i + 1) && (j < N); j++) {
+            if (NULL != pdf->values) {
+                row[j % 3] = pdf->values
+                        + indices[b + j] * PICOKPDF_MUL_NUMVALUES * ceporder + cepnum;
+            } else {
+                picokpdf_decodeMUL(pdf, indices[b + j], cepnum, numcep, vec[j % 3]);
+                row[j % 3] = vec[j % 3] + cepnum;
+            }
+        }
+        v = row[i % 3];
+        vn = row[(i + 1) % 3];
+        for (j = 0; j < numd; j++) {
+            vd[j] = row[Id[j] % 3];
+        }
+        for (j = 0; j < numdd; j++) {
+            vdd[j] = row[Idd[j] % 3];
+        }
+
         /* process static means and static inverse variances */
-        if (i > 0 && indices[b + i] == indices[b + i - 1]) {
-            cep->diag0[i] = prev_diag0;
-            cep->WUm[i] = prev_WUm;
-        } else {
-            vecstart = indices[b + i] * vecsize;
-            ivar = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTIVAR,
-                    PICOCEP_WANTSTATIC);
-            prev_diag0 = cep->diag0[i] = ivar << 2; /* multiply ivar by 4 (4 used to be first entry of xsq) */
-            mean = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTMEAN,
-                    PICOCEP_WANTSTATIC);
-            prev_WUm = cep->WUm[i] = mean << 1; /* multiply mean by 2 (2 used to be first entry of x) */
+        for (k = 0; k < numcep; k++) {
+            diag0[k] = v[is + k] << 2; /* multiply ivar by 4 (4 used to be first entry of xsq) */
+            WUm[k] = v[ms + k] << 1; /* multiply mean by 2 (2 used to be first entry of x) */
         }
 
         /* process delta means and delta inverse variances */
         for (j = 0; j < numd; j++) {
-            vecstart = indices[b + Id[j]] * vecsize;
-            ivar = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTIVAR,
-                    PICOCEP_WANTDELTA);
-            cep->diag0[i] += xsq[j] * ivar;
-
-            mean = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTMEAN,
-                    PICOCEP_WANTDELTA);
-            if (mean != 0) {
-                cep->WUm[i] += x[j] * mean;
+            for (k = 0; k < numcep; k++) {
+                diag0[k] += xsq[j] * vd[j][id + k];
+                WUm[k] += x[j] * vd[j][md + k];
             }
         }
 
         /* process delta delta means and delta delta inverse variances */
         for (j = 0; j < numdd; j++) {
-            vecstart = indices[b + Idd[j]] * vecsize;
-            ivar = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTIVAR,
-                    PICOCEP_WANTDELTA2);
-            cep->diag0[i] += xsq[numd + j] * ivar;
-
-            mean = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTMEAN,
-                    PICOCEP_WANTDELTA2);
-            if (mean != 0) {
-                cep->WUm[i] += x[numd + j] * mean;
+            for (k = 0; k < numcep; k++) {
+                diag0[k] += xsq[numd + j] * vdd[j][idd + k];
+                WUm[k] += x[numd + j] * vdd[j][mdd + k];
             }
         }
 
-        cep->diag0[i] = (cep->diag0[i] + 2) / 4; /* long DIV with rounding */
-        cep->WUm[i] = (cep->WUm[i] + 1) / 2; /* long DIV with rounding */
+        e = i * numcep;
+        for (k = 0; k < numcep; k++) {
+            cep->diag0[e + k] = (diag0[k] + 2) / 4; /* long DIV with rounding */
+            cep->WUm[e + k] = (WUm[k] + 1) / 2; /* long DIV with rounding */
+        }
 
         /* calculate diag(A,-1) */
         if (i < N - 1) {
-            if (i < N - 2) {
-                if (i > 0 && indices[b + i + 1] == indices[b + i]) {
-                    cep->diag1[i] = prev_diag1;
-                } else {
-                    vecstart = indices[b + i + 1] * vecsize;
-                    /*
-                     diag1[i] = getFromPdf(pdf, vecstart, numvuv, ceporder, numdeltas, cepnum,
-                     bigpow, meanpowUm, ivarpow, PICOCEP_WANTIVAR, PICOCEP_WANTDELTA2);
-                     */
-                    prev_diag1 = cep->diag1[i] = getFromPdf(pdf, vecstart,
-                            cepnum, PICOCEP_WANTIVAR, PICOCEP_WANTDELTA2);
+            for (k = 0; k < numcep; k++) {
+                cep->diag1[e + k] = 0;
+                if (i < N - 2) {
+                    cep->diag1[e + k] = vn[idd + k];
                 }
-                /*
-                 k = vecstart +pdf->numvuv+pdf->ceporder*2 +    pdf->numdeltas*3 +
-                 pdf->ceporder*2 +cepnum;
-                 cep->diag1[i] = (picoos_int32)(pdf->content[k]) << pdf->bigpow;
-                 */
-            } else {
-                cep->diag1[i] = 0;
-            }
-            if (i > 0) {
-                if (i > 1 && indices[b + i] == indices[b + i - 1]) {
-                    cep->diag1[i] += prev_diag1_1;
-                } else {
-                    vecstart = indices[b + i] * vecsize;
-                    /*
-                     k = vecstart + pdf->numvuv + pdf->ceporder * 2 + pdf->numdeltas * 3 + pdf->ceporder * 2 + cepnum;
-                     cep->diag1[i] += (picoos_int32)(pdf->content[k]) << pdf->bigpow; */
-                    /* cepnum'th delta delta ivar */
-
-                    prev_diag1_1 = getFromPdf(pdf, vecstart, cepnum,
-                            PICOCEP_WANTIVAR, PICOCEP_WANTDELTA2);
-                    cep->diag1[i] += prev_diag1_1;
+                if (i > 0) {
+                    cep->diag1[e + k] += v[idd + k]; /* cepnum'th delta delta ivar */
                 }
-
-            } /*i < N-1 */
-            cep->diag1[i] *= -2;
+                cep->diag1[e + k] *= -2;
+            }
         }
-    }
 
-    /* calculate diag(A,-2) */
-    for (i = 0; i < N - 2; i++) {
-        if (i > 0 && indices[b + i + 1] == indices[b + i]) {
-            cep->diag2[i] = prev_diag2;
-        } else {
-            vecstart = indices[b + i + 1] * vecsize;
-            /*
-             k = vecstart + pdf->numvuv + pdf->ceporder * 2 + pdf->numdeltas * 3 + pdf->ceporder * 2 + cepnum;
-             cep->diag2[i] = (picoos_int32)(pdf->content[k]) << pdf->bigpow;
-             k -= pdf->ceporder;
-             ivar = (picoos_int32)(pdf->content[k]) << pdf->bigpow;
-             */
-            cep->diag2[i] = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTIVAR,
-                    PICOCEP_WANTDELTA2);
-            ivar = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTIVAR,
-                    PICOCEP_WANTDELTA);
-            cep->diag2[i] -= (ivar + 2) / 4;
-            prev_diag2 = cep->diag2[i];
+        /* calculate diag(A,-2) */
+        if (i < N - 2) {
+            for (k = 0; k < numcep; k++) {
+                cep->diag2[e + k] = vn[idd + k] - (vn[id + k] + 2) / 4;
+            }
         }
     }
 
@@ -1291,6 +1379,29 @@ static picoos_int32 getFromPdf(picokpdf_PdfMUL pdf, picoos_uint32 vecstart,
     return 0;
 }
 
+/**
+ * number of cepstral dimensions to smooth at once
+ * @param    pdf :  pdf resource
+ * @param    cepnum :  first cepstral dimension to be treated
+ * @param    N :  number of frames
+ * @return  as many of the remaining dimensions as fit side by side in diag0 etc.
+ * @callgraph
+ * @callergraph
+ */
+static picoos_uint8 getNumSmoothed(picokpdf_PdfMUL pdf, picoos_uint8 cepnum,
+        picoos_uint16 N)
+{
+    picoos_uint32 numcep = PICOCEP_MAXWINLEN / N;
+
+    if (numcep > PICOCEP_MAXCEPORDER) {
+        numcep = PICOCEP_MAXCEPORDER;
+    }
+    if (numcep > (picoos_uint32) (pdf->ceporder - cepnum)) {
+        numcep = pdf->ceporder - cepnum;
+    }
+    return (picoos_uint8) numcep;
+}
+
 /**
  * Retrieve actual values for MGC from PDF resource - Variant "Direct"
  * @param    pdf :  pointer to picoos_uint8, sequence of pdf vectors, each vector of length 1+ceporder*2+numdeltas*3+ceporder*3
@@ -1311,6 +1422,9 @@ static void getDirect(picokpdf_PdfMUL pdf, picoos_uint16 *indices,
     picoos_uint32 vecstart;
     picoos_int32 mean, ivar;
     picoos_int32 prev_mean;
+#if defined(PICO_DSP_FLOAT)
+    picoos_single fmean;
+#endif
     picoos_uint8 vecsize = pdf->vecsize;
     picoos_uint8 order = pdf->ceporder;
 
@@ -1325,7 +1439,14 @@ static void getDirect(picokpdf_PdfMUL pdf, picoos_uint16 *indices,
                     PICOCEP_WANTSTATIC);
             ivar = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTIVAR,
                     PICOCEP_WANTSTATIC);
+#if defined(PICO_DSP_FLOAT)
+            fmean = (picoos_single) mean / (picoos_single) ivar
+                    * (picoos_single) (1 << pdf->bigpow);
+            mean = (picoos_int32) ((fmean >= 0) ? fmean + 0.5f : fmean - 0.5f);
+            prev_mean = mean;
+#else
             prev_mean = mean = picocep_fixptdiv(mean, ivar, pdf->bigpow);
+#endif
         }
         smoothcep[j] = (picoos_int16)(mean/(1<<pdf->meanpow));
         j += order;
@@ -1691,14 +1812,14 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
                     picokpdf_PdfMUL pdf;
 
                     /* picoos_uint16 framesTreated = 0; */
-                    picoos_uint8 cepnum;
+                    picoos_uint8 cepnum, numcep;
                     picoos_uint16 N;
 
                     N = cep->activeEndPos; /* numframes in current step */
 
                     /* the range to be smoothed starts at 0 and is N long */
 
-                    /* smooth each cepstral dimension separately */
+                    /* smooth the cepstral dimensions separately, but as many side by side as fit */
                     /* still to be experimented if higher order coeff can remain unsmoothed, i.e. simple copy from pdf */
 
                     /* reset the f0, ceps and voiced outfuffers */
@@ -1710,14 +1831,16 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
 
                     /* smooth f0 */
                     pdf = cep->pdflfz;
-                    for (cepnum = 0; cepnum < pdf->ceporder; cepnum++) {
+                    for (cepnum = 0; cepnum < pdf->ceporder; cepnum += numcep) {
+                        numcep = 1;
                         if (cep->activeEndPos <= 0) {
                             /* do nothing */
                         } else if (3 < N) {
+                            numcep = getNumSmoothed(pdf, cepnum, N);
                             makeWUWandWUm(cep, pdf, cep->indicesLFZ, 0, N,
-                                    cepnum); /* update diag0, diag1, diag2, WUm */
-                            invMatrix(cep, N, cep->outF0 + cep->outF0WritePos, cepnum, pdf,
-                                    PICOCEP_LFZINVPOW, PICOCEP_LFZDOUBLEDEC);
+                                    cepnum, numcep); /* update diag0, diag1, diag2, WUm */
+                            invMatrix(cep, N, cep->outF0 + cep->outF0WritePos, cepnum,
+                                    numcep, pdf, PICOCEP_LFZINVPOW, PICOCEP_LFZDOUBLEDEC);
                         } else {
                             getDirect(pdf, cep->indicesLFZ, cep->activeEndPos,
                                     cepnum, cep->outF0 + cep->outF0WritePos);
@@ -1727,15 +1850,17 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
 
                     /* smooth mgc */
                     pdf = cep->pdfmgc;
-                    for (cepnum = 0; cepnum < pdf->ceporder; cepnum++) {
+                    for (cepnum = 0; cepnum < pdf->ceporder; cepnum += numcep) {
+                        numcep = 1;
                         if (cep->activeEndPos <= 0) {
                             /* do nothing */
                         } else if (3 < N) {
+                            numcep = getNumSmoothed(pdf, cepnum, N);
                             makeWUWandWUm(cep, pdf, cep->indicesMGC, 0, N,
-                                    cepnum); /* update diag0, diag1, diag2, WUm */
+                                    cepnum, numcep); /* update diag0, diag1, diag2, WUm */
                             invMatrix(cep, N, cep->outXCep
                                             + cep->outXCepWritePos, cepnum,
-                                    pdf, PICOCEP_MGCINVPOW,
+                                    numcep, pdf, PICOCEP_MGCINVPOW,
                                     PICOCEP_MGCDOUBLEDEC);
                         } else {
                             getDirect(pdf, cep->indicesMGC, cep->activeEndPos,
@@ -80,6 +80,9 @@ typedef struct ctrl_subobj {
     picodata_ProcessingUnit procUnit [PICOCTRL_MAX_PROC_UNITS];
     picodata_step_result_t procStatus [PICOCTRL_MAX_PROC_UNITS];
     picodata_CharBuffer procCbOut [PICOCTRL_MAX_PROC_UNITS];
+    /* only touched by the thread stepping this control */
+    picoos_bool profiling;
+    picoctrl_pu_profile_t profile [PICOCTRL_MAX_PROC_UNITS];
 } ctrl_subobj_t;
 
 /**
@@ -140,6 +143,10 @@ static picodata_step_result_t ctrlStep(register picodata_ProcessingUnit this,
     register ctrl_subobj_t * ctrl = (ctrl_subobj_t *) this->subObj;
     picodata_step_result_t status;
     picoos_uint16 puBytesOutput;
+    picodata_ProcessingUnit pu;
+    picoctrl_pu_profile_t * prof = NULL;
+    picoos_uint32 gotBefore = 0, putBefore = 0;
+    picoos_uint64 startTime = 0;
 #if defined(PICO_DEVEL_MODE)
     picoos_uint8  btype;
 #endif
@@ -150,8 +157,25 @@ static picodata_step_result_t ctrlStep(register picodata_ProcessingUnit this,
     /* --------------------- */
     /* do step of current pu */
     /* --------------------- */
-    status = ctrl->procStatus[ctrl->curPU] = ctrl->procUnit[ctrl->curPU]->step(
-            ctrl->procUnit[ctrl->curPU], mode, &puBytesOutput);
+    pu = ctrl->procUnit[ctrl->curPU];
+    if (ctrl->profiling) {
+        prof = &ctrl->profile[ctrl->curPU];
+        gotBefore = picodata_cbGetNumGot(pu->cbIn);
+        putBefore = picodata_cbGetNumPut(pu->cbOut);
+        startTime = picopal_get_nanos();
+    }
+    status = ctrl->procStatus[ctrl->curPU] = pu->step(pu, mode, &puBytesOutput);
+    if (NULL != prof) {
+        prof->nanos += picopal_get_nanos() - startTime;
+        prof->steps++;
+        prof->bytesIn += (picoos_uint32) (picodata_cbGetNumGot(pu->cbIn) - gotBefore);
+        prof->bytesOut += (picoos_uint32) (picodata_cbGetNumPut(pu->cbOut) - putBefore);
+        if (PICODATA_PU_IDLE == status) {
+            prof->idleSteps++;
+        } else if (PICODATA_PU_OUT_FULL == status) {
+            prof->outFullSteps++;
+        }
+    }
 
     if (puBytesOutput) {
 
@@ -269,10 +293,13 @@ static pico_status_t ctrlSubObjDeallocate(register picodata_ProcessingUnit this,
     }
     ctrl = (ctrl_subobj_t *) this->subObj;
     (void)mm;        /* fix warning "var not used in this function"*/
-    /* deallocate members (procCbOut and procUnit) */
+    /* deallocate members (procCbOut and procUnit); the control's own
+       cbIn and cbOut belong to its creator */
     for (i = ctrl->numProcUnits-1; i >= 0; i--) {
         picodata_disposeProcessingUnit(this->common->mm,&ctrl->procUnit[i]);
-        picodata_disposeCharBuffer(this->common->mm, &ctrl->procCbOut[i]);
+        if (ctrl->procCbOut[i] != this->cbOut) {
+            picodata_disposeCharBuffer(this->common->mm, &ctrl->procCbOut[i]);
+        }
     }
     /* deallocate object itself */
     picoos_deallocate(this->common->mm, (void *) &this->subObj);
@@ -280,6 +307,29 @@ static pico_status_t ctrlSubObjDeallocate(register picodata_ProcessingUnit this,
     return PICO_OK;
 }/*ctrlSubObjDeallocate*/
 
+/**
+ * short name of a PU type, as used in profiles
+ * @param    puType : type of the PU
+ * @return    the name
+ * @callgraph
+ * @callergraph
+ */
+static const picoos_char * ctrlPuName(picodata_putype_t puType)
+{
+    switch (puType) {
+        case PICODATA_PUTYPE_TOK:  return (const picoos_char *) "tok";
+        case PICODATA_PUTYPE_PR:   return (const picoos_char *) "pr";
+        case PICODATA_PUTYPE_WA:   return (const picoos_char *) "wa";
+        case PICODATA_PUTYPE_SA:   return (const picoos_char *) "sa";
+        case PICODATA_PUTYPE_ACPH: return (const picoos_char *) "acph";
+        case PICODATA_PUTYPE_SPHO: return (const picoos_char *) "spho";
+        case PICODATA_PUTYPE_PAM:  return (const picoos_char *) "pam";
+        case PICODATA_PUTYPE_CEP:  return (const picoos_char *) "cep";
+        case PICODATA_PUTYPE_SIG:  return (const picoos_char *) "sig";
+        default:                   return (const picoos_char *) "?";
+    }
+}/*ctrlPuName*/
+
 /**
  * inserts a new PU in the TTS processing chain
  * @param    this : pointer to Control PU
@@ -331,6 +381,9 @@ static pico_status_t ctrlAddPU(picodata_ProcessingUnit this,
         }
     }
     ctrl->procStatus[newPU] = PICODATA_PU_IDLE;
+    picoos_mem_set(&ctrl->profile[newPU], 0, sizeof(ctrl->profile[newPU]));
+    picoos_strlcpy(ctrl->profile[newPU].name, ctrlPuName(puType),
+            sizeof(ctrl->profile[newPU].name));
     /*...............*/
     switch (puType) {
     case PICODATA_PUTYPE_TOK:
@@ -392,7 +445,9 @@ static pico_status_t ctrlAddPU(picodata_ProcessingUnit this,
         break;
     }
     if (NULL == ctrl->procUnit[newPU]) {
-        picodata_disposeCharBuffer(this->common->mm,&ctrl->procCbOut[newPU]);
+        if (!last) {
+            picodata_disposeCharBuffer(this->common->mm,&ctrl->procCbOut[newPU]);
+        }
         return PICO_EXC_OUT_OF_MEM;
     }
     ctrl->numProcUnits++;
@@ -403,23 +458,49 @@ static pico_status_t ctrlAddPU(picodata_ProcessingUnit this,
 void picoctrl_disposeControl(picoos_MemoryManager mm,
         picodata_ProcessingUnit * this);
 
+/* the TTS processing chain; an engine may split it into stages after
+ * the PUs listed in ctrlStageSplit, each stage running on its own thread */
+static const picodata_putype_t ctrlChain[] = {
+    PICODATA_PUTYPE_TOK,
+    PICODATA_PUTYPE_PR,
+    PICODATA_PUTYPE_WA,
+    PICODATA_PUTYPE_SA,
+    PICODATA_PUTYPE_ACPH,
+    PICODATA_PUTYPE_SPHO,
+    PICODATA_PUTYPE_PAM,
+    PICODATA_PUTYPE_CEP,
+    PICODATA_PUTYPE_SIG
+};
+#define CTRL_CHAIN_LEN (sizeof(ctrlChain) / sizeof(ctrlChain[0]))
+
+/* index of the last PU of each stage but the last one:
+ * text analysis | PAM and CEP | SIG */
+static const picoos_uint8 ctrlStageSplit[PICOCTRL_MAX_STAGES - 1] = {
+    5,  /* SPHO */
+    7   /* CEP */
+};
+
 /**
- * initializes a control PU object
+ * initializes a control PU object governing part of the TTS chain
  * @param    mm : memory manager
  * @param    common : the common object
  * @param    cbIn : the input char buffer
  * @param    cbOut : the output char buffer
  * @param    voice : the voice object
+ * @param    firstPU : index in ctrlChain of the first PU to create
+ * @param    lastPU : index in ctrlChain of the last PU to create
  * @return    the pointer to the PU object created if OK
- * @return    PICO_EXC_OUT_OF_MEM : no more memory available
  * @return    NULL otherwise
  * @callgraph
  * @callergraph
  */
-picodata_ProcessingUnit picoctrl_newControl(picoos_MemoryManager mm,
+static picodata_ProcessingUnit ctrlNewPartialControl(picoos_MemoryManager mm,
         picoos_Common common, picodata_CharBuffer cbIn,
-        picodata_CharBuffer cbOut, picorsrc_Voice voice) {
+        picodata_CharBuffer cbOut, picorsrc_Voice voice,
+        picoos_uint8 firstPU, picoos_uint8 lastPU) {
     picoos_int16 i;
+    picoos_uint8 pu;
+    pico_status_t status;
     register ctrl_subobj_t * ctrl;
     picodata_ProcessingUnit this = picodata_newProcessingUnit(mm, common, cbIn,
             cbOut,voice);
@@ -446,19 +527,13 @@ picodata_ProcessingUnit picoctrl_newControl(picoos_MemoryManager mm,
         ctrl->procCbOut[i] = NULL;
     }
     ctrl->numProcUnits = 0;
+    ctrl->profiling = FALSE;
 
-    if (
-            (PICO_OK == ctrlAddPU(this,PICODATA_PUTYPE_TOK, /*last*/FALSE)) &&
-            (PICO_OK == ctrlAddPU(this,PICODATA_PUTYPE_PR, FALSE)) &&
-            (PICO_OK == ctrlAddPU(this,PICODATA_PUTYPE_WA, FALSE)) &&
-            (PICO_OK == ctrlAddPU(this,PICODATA_PUTYPE_SA, FALSE)) &&
-            (PICO_OK == ctrlAddPU(this,PICODATA_PUTYPE_ACPH, FALSE)) &&
-            (PICO_OK == ctrlAddPU(this,PICODATA_PUTYPE_SPHO, FALSE)) &&
-            (PICO_OK == ctrlAddPU(this,PICODATA_PUTYPE_PAM, FALSE)) &&
-            (PICO_OK == ctrlAddPU(this,PICODATA_PUTYPE_CEP, FALSE)) &&
-            (PICO_OK == ctrlAddPU(this,PICODATA_PUTYPE_SIG, TRUE))
-         ) {
-
+    status = PICO_OK;
+    for (pu = firstPU; (PICO_OK == status) && (pu <= lastPU); pu++) {
+        status = ctrlAddPU(this, ctrlChain[pu], /*last*/ (pu == lastPU));
+    }
+    if (PICO_OK == status) {
         /* we don't call ctrlInitialize here because ctrlAddPU does initialize the PUs allready and the only thing
          * remaining to initialize is:
          */
@@ -469,6 +544,26 @@ picodata_ProcessingUnit picoctrl_newControl(picoos_MemoryManager mm,
         return NULL;
     }
 
+}/*ctrlNewPartialControl*/
+
+/**
+ * initializes a control PU object
+ * @param    mm : memory manager
+ * @param    common : the common object
+ * @param    cbIn : the input char buffer
+ * @param    cbOut : the output char buffer
+ * @param    voice : the voice object
+ * @return    the pointer to the PU object created if OK
+ * @return    PICO_EXC_OUT_OF_MEM : no more memory available
+ * @return    NULL otherwise
+ * @callgraph
+ * @callergraph
+ */
+picodata_ProcessingUnit picoctrl_newControl(picoos_MemoryManager mm,
+        picoos_Common common, picodata_CharBuffer cbIn,
+        picodata_CharBuffer cbOut, picorsrc_Voice voice) {
+    return ctrlNewPartialControl(mm, common, cbIn, cbOut, voice,
+            0, CTRL_CHAIN_LEN - 1);
 }/*picoctrl_newControl*/
 
 /**
@@ -491,6 +586,22 @@ void picoctrl_disposeControl(picoos_MemoryManager mm,
  *      Engine
  *
  ****************************************************************************/
+/** object       : Stage
+ *  a part of the TTS chain governed by its own control PU. All stages but
+ *  the last one run on a worker thread; the last one is stepped by the
+ *  caller of picoctrl_engFetchOutputItemBytes. Consecutive stages are
+ *  connected by shared CharBuffers.
+ */
+typedef struct picoctrl_stage {
+    struct picoctrl_engine * engine;
+    picoos_Common common;
+    picodata_ProcessingUnit control;
+    picodata_CharBuffer cbIn, cbOut;
+    picopal_Thread thread;
+    volatile picoos_int32 idleSeq;  /* odd while waiting for input */
+    volatile picoos_int32 failed;
+} picoctrl_stage_t;
+
 /** object       : Engine
  *  shortcut     : eng
  */
@@ -499,8 +610,11 @@ typedef struct picoctrl_engine {
     void *raw_mem;
     picoos_Common common;
     picorsrc_Voice voice;
-    picodata_ProcessingUnit control;
+    picodata_ProcessingUnit control;    /* control of the last stage */
     picodata_CharBuffer cbIn, cbOut;
+    picoos_uint8 numStages;
+    picoctrl_stage_t stage[PICOCTRL_MAX_STAGES];
+    volatile picoos_int32 quit;         /* tells the workers to stop */
 } picoctrl_engine_t;
 
 
@@ -512,6 +626,169 @@ typedef struct picoctrl_engine {
 #define CHECK_MAGIC_NUMBER(eng) \
     ((eng)->magic == (((picoos_uint32) (eng)) ^ MAGIC_MASK))
 
+/**
+ * worker thread of a stage: steps the stage's control PU, sleeping
+ * while its input is empty or its output is full
+ * @param    arg : the stage
+ * @callgraph
+ * @callergraph
+ */
+static void engStageRun(void * arg)
+{
+    picoctrl_stage_t * stage = (picoctrl_stage_t *) arg;
+    picoctrl_Engine eng = stage->engine;
+    picodata_step_result_t stepResult;
+    picoos_uint16 bytesOutput;
+    picoos_uint32 inToken, outToken;
+
+    while (!picopal_atomic_get(&eng->quit)) {
+        /* taken before stepping so that any space freed by the consumer
+           in the meantime is noticed */
+        outToken = picodata_cbGetWaitToken(stage->cbOut);
+        stepResult = stage->control->step(stage->control, /* mode */0,
+                &bytesOutput);
+        switch (stepResult) {
+            case PICODATA_PU_IDLE:
+                inToken = picodata_cbGetWaitToken(stage->cbIn);
+                if (picodata_cbIsEmpty(stage->cbIn)
+                        && !picopal_atomic_get(&eng->quit)) {
+                    picopal_atomic_add(&stage->idleSeq, 1);
+                    /* let the consumer find out that we are idle */
+                    picodata_cbNotify(stage->cbOut);
+                    picodata_cbWait(stage->cbIn, inToken);
+                    picopal_atomic_add(&stage->idleSeq, 1);
+                }
+                break;
+            case PICODATA_PU_OUT_FULL:
+                if (!picopal_atomic_get(&eng->quit)) {
+                    picodata_cbWait(stage->cbOut, outToken);
+                }
+                break;
+            case PICODATA_PU_ERROR:
+                picopal_atomic_set(&stage->failed, 1);
+                picodata_cbNotify(stage->cbOut);
+                /* nothing more to do until the engine is reset */
+                while (!picopal_atomic_get(&eng->quit)) {
+                    inToken = picodata_cbGetWaitToken(stage->cbIn);
+                    if (!picopal_atomic_get(&eng->quit)) {
+                        picodata_cbWait(stage->cbIn, inToken);
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}/*engStageRun*/
+
+/**
+ * starts the worker threads of all stages but the last one
+ * @param    this : the engine object
+ * @return    PICO_OK : workers started
+ * @return    PICO_ERR_OTHER : a thread could not be created
+ * @callgraph
+ * @callergraph
+ */
+static pico_status_t engStartStages(picoctrl_Engine this)
+{
+    picoos_uint8 i;
+
+    picopal_atomic_set(&this->quit, 0);
+    for (i = 0; i + 1 < this->numStages; i++) {
+        picopal_atomic_set(&this->stage[i].idleSeq, 0);
+        picopal_atomic_set(&this->stage[i].failed, 0);
+        this->stage[i].thread = picopal_thread_create(engStageRun,
+                &this->stage[i]);
+        if (NULL == this->stage[i].thread) {
+            return PICO_ERR_OTHER;
+        }
+    }
+    return PICO_OK;
+}/*engStartStages*/
+
+/**
+ * stops and joins the worker threads
+ * @param    this : the engine object
+ * @callgraph
+ * @callergraph
+ */
+static void engStopStages(picoctrl_Engine this)
+{
+    picoos_uint8 i;
+
+    picopal_atomic_set(&this->quit, 1);
+    for (i = 0; i + 1 < this->numStages; i++) {
+        if (NULL != this->stage[i].thread) {
+            picodata_cbNotify(this->stage[i].cbIn);
+            picodata_cbNotify(this->stage[i].cbOut);
+        }
+    }
+    for (i = 0; i + 1 < this->numStages; i++) {
+        picopal_thread_join(&this->stage[i].thread);
+    }
+}/*engStopStages*/
+
+/**
+ * checks whether all worker stages are waiting for input that will not
+ * come, i.e. whether the whole pipeline has run dry
+ * @param    this : the engine object
+ * @return    TRUE if no stage has anything left to do
+ * @remarks    must be called from the thread feeding the engine
+ * @callgraph
+ * @callergraph
+ */
+static picoos_bool engStagesIdle(picoctrl_Engine this)
+{
+    picoos_int32 idleSeq[PICOCTRL_MAX_STAGES];
+    picoos_uint8 i;
+
+    /* a worker that went to sleep and stayed asleep while all buffers
+       were seen empty cannot have produced anything in between */
+    for (i = 0; i + 1 < this->numStages; i++) {
+        idleSeq[i] = picopal_atomic_get(&this->stage[i].idleSeq);
+        if (0 == (idleSeq[i] & 1)) {
+            return FALSE;
+        }
+    }
+    for (i = 0; i < this->numStages; i++) {
+        if (!picodata_cbIsEmpty(this->stage[i].cbIn)) {
+            return FALSE;
+        }
+    }
+    for (i = 0; i + 1 < this->numStages; i++) {
+        if (idleSeq[i] != picopal_atomic_get(&this->stage[i].idleSeq)) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}/*engStagesIdle*/
+
+/**
+ * checks the worker stages for errors, copying the first one found to
+ * the engine's exception manager
+ * @param    this : the engine object
+ * @return    TRUE if a stage has failed
+ * @callgraph
+ * @callergraph
+ */
+static picoos_bool engStagesFailed(picoctrl_Engine this)
+{
+    picoos_char msg[PICOOS_MAX_EXC_MSG_LEN];
+    picoos_uint8 i;
+
+    for (i = 0; i + 1 < this->numStages; i++) {
+        if (picopal_atomic_get(&this->stage[i].failed)) {
+            picoos_emGetExceptionMessage(this->stage[i].common->em, msg,
+                    PICOOS_MAX_EXC_MSG_LEN);
+            picoos_emRaiseException(this->common->em,
+                    picoos_emGetExceptionCode(this->stage[i].common->em),
+                    NULL, (picoos_char *) "%s", msg);
+            return TRUE;
+        }
+    }
+    return FALSE;
+}/*engStagesFailed*/
+
 /**
  * performs an engine reset
  * @param    this : the engine object
@@ -523,15 +800,22 @@ typedef struct picoctrl_engine {
 pico_status_t picoctrl_engReset(picoctrl_Engine this, picoos_int32 resetMode)
 {
     pico_status_t status;
+    picoos_uint8 i;
 
     if (NULL == this) {
         return PICO_ERR_NULLPTR_ACCESS;
     }
     picoos_emReset(this->common->em);
 
-    status = this->control->terminate(this->control);
-    if (PICO_OK == status) {
-        status = this->control->initialize(this->control, resetMode);
+    engStopStages(this);
+    status = PICO_OK;
+    for (i = 0; (PICO_OK == status) && (i < this->numStages); i++) {
+        picoos_emReset(this->stage[i].common->em);
+        status = this->stage[i].control->terminate(this->stage[i].control);
+        if (PICO_OK == status) {
+            status = this->stage[i].control->initialize(
+                    this->stage[i].control, resetMode);
+        }
     }
     if (PICO_OK == status) {
         status = picodata_cbReset(this->cbIn);
@@ -539,6 +823,9 @@ pico_status_t picoctrl_engReset(picoctrl_Engine this, picoos_int32 resetMode)
     if (PICO_OK == status) {
         status = picodata_cbReset(this->cbOut);
     }
+    if (PICO_OK == status) {
+        status = engStartStages(this);
+    }
     if (PICO_OK != status) {
         picoos_emRaiseException(this->common->em,status,NULL,(picoos_char*) "problem resetting engine");
     }
@@ -559,6 +846,79 @@ picoos_int16 picoctrl_isValidEngineHandle(picoctrl_Engine this)
     return (this != NULL) && CHECK_MAGIC_NUMBER(this);
 }/*picoctrl_isValidEngineHandle*/
 
+/**
+ * disposes the stages of an engine
+ * @param    this : the engine object
+ * @callgraph
+ * @callergraph
+ */
+static void engDisposeStages(picoctrl_Engine this)
+{
+    picoos_int16 i;
+
+    engStopStages(this);
+    for (i = this->numStages - 1; i >= 0; i--) {
+        if (NULL != this->stage[i].control) {
+            picoctrl_disposeControl(this->common->mm, &this->stage[i].control);
+        }
+        if ((i + 1 < this->numStages) && (NULL != this->stage[i].cbOut)) {
+            picodata_disposeCharBuffer(this->common->mm, &this->stage[i].cbOut);
+        }
+    }
+    this->control = NULL;
+    picodata_disposeCharBuffer(this->common->mm, &this->cbIn);
+    picodata_disposeCharBuffer(this->common->mm, &this->cbOut);
+}/*engDisposeStages*/
+
+/**
+ * creates the stages of an engine
+ * @param    this : the engine object
+ * @return    TRUE if all stages were created
+ * @callgraph
+ * @callergraph
+ */
+static picoos_bool engNewStages(picoctrl_Engine this)
+{
+    picoos_uint8 i, firstPU, lastPU;
+    picoctrl_stage_t * stage;
+    picoos_bool done = TRUE;
+
+    firstPU = 0;
+    for (i = 0; done && (i < this->numStages); i++) {
+        stage = &this->stage[i];
+        stage->cbIn = (0 == i) ? this->cbIn : this->stage[i-1].cbOut;
+        if (i + 1 == this->numStages) {
+            /* the last stage runs in the caller's thread */
+            lastPU = CTRL_CHAIN_LEN - 1;
+            stage->common = this->common;
+            stage->cbOut = this->cbOut;
+        } else {
+            /* a worker needs its own exception manager */
+            lastPU = ctrlStageSplit[i];
+            stage->common = picoos_newCommon(this->common->mm);
+            done = (NULL != stage->common);
+            if (done) {
+                stage->common->mm = this->common->mm;
+                stage->common->em = picoos_newExceptionManager(this->common->mm);
+                stage->cbOut = picodata_newSharedCharBuffer(this->common->mm,
+                        stage->common, PICODATA_BUFSIZE_STAGE);
+                done = (NULL != stage->common->em) && (NULL != stage->cbOut);
+            }
+        }
+        if (done) {
+            stage->control = ctrlNewPartialControl(this->common->mm,
+                    stage->common, stage->cbIn, stage->cbOut, this->voice,
+                    firstPU, lastPU);
+            done = (NULL != stage->control);
+        }
+        firstPU = lastPU + 1;
+    }
+    if (done) {
+        this->control = this->stage[this->numStages - 1].control;
+    }
+    return done;
+}/*engNewStages*/
+
 /**
  * creates a new engine object
  * @param    mm : memory manager to be used for this engine
@@ -572,7 +932,30 @@ picoos_int16 picoctrl_isValidEngineHandle(picoctrl_Engine this)
  */
 picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
         picorsrc_ResourceManager rm, const picoos_char * voiceName) {
+    return picoctrl_newPipelinedEngine(mm, rm, voiceName, 1);
+}/*picoctrl_newEngine*/
+
+/**
+ * creates a new engine object whose TTS chain is split into stages
+ * running concurrently
+ * @param    mm : memory manager to be used for this engine
+ * @param    rm : resource manager to be used for this engine
+ * @param    voiceName : voice definition to be used for this engine
+ * @param    numStages : number of stages (1..PICOCTRL_MAX_STAGES); 1 runs
+ *           the whole chain in the caller's thread, 2 runs the text analysis
+ *           in a worker thread, 3 additionally separates PAM/CEP from SIG
+ * @return    new engine handle
+ * @return  NULL otherwise
+ * @remarks    the output is identical for any number of stages
+ * @callgraph
+ * @callergraph
+ */
+picoctrl_Engine picoctrl_newPipelinedEngine(picoos_MemoryManager mm,
+        picorsrc_ResourceManager rm, const picoos_char * voiceName,
+        picoos_uint8 numStages) {
     picoos_uint8 done= TRUE;
+    picoos_uint8 i;
+    picoos_objsize_t engSize;
 
     picoos_uint16 bSize;
 
@@ -592,15 +975,32 @@ picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
         this->control = NULL;
         this->cbIn = NULL;
         this->cbOut = NULL;
+        if (numStages < 1) {
+            numStages = 1;
+        } else if (numStages > PICOCTRL_MAX_STAGES) {
+            numStages = PICOCTRL_MAX_STAGES;
+        }
+        this->numStages = numStages;
+        for (i = 0; i < PICOCTRL_MAX_STAGES; i++) {
+            this->stage[i].engine = this;
+            this->stage[i].common = NULL;
+            this->stage[i].control = NULL;
+            this->stage[i].cbIn = NULL;
+            this->stage[i].cbOut = NULL;
+            this->stage[i].thread = NULL;
+        }
+        this->quit = 0;
 
-        this->raw_mem = picoos_allocate(mm, PICOCTRL_DEFAULT_ENGINE_SIZE);
+        engSize = PICOCTRL_DEFAULT_ENGINE_SIZE
+                + (numStages - 1) * PICOCTRL_STAGE_ENGINE_SIZE;
+        this->raw_mem = picoos_allocate(mm, engSize);
         if (NULL == this->raw_mem) {
             done = FALSE;
         }
     }
 
     if (done) {
-        engMM = picoos_newMemoryManager(this->raw_mem, PICOCTRL_DEFAULT_ENGINE_SIZE,
+        engMM = picoos_newMemoryManager(this->raw_mem, engSize,
                     /*enableMemProt*/ FALSE);
         done = (NULL != engMM);
     }
@@ -618,8 +1018,14 @@ picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
     if (done)  {
         bSize = picodata_get_default_buf_size(PICODATA_PUTYPE_TEXT);
 
-        this->cbIn = picodata_newCharBuffer(this->common->mm,
-                this->common, bSize);
+        if (numStages > 1) {
+            /* text is fed by the caller and consumed by the first worker */
+            this->cbIn = picodata_newSharedCharBuffer(this->common->mm,
+                    this->common, bSize);
+        } else {
+            this->cbIn = picodata_newCharBuffer(this->common->mm,
+                    this->common, bSize);
+        }
         bSize = picodata_get_default_buf_size(PICODATA_PUTYPE_SIG);
 
         this->cbOut = picodata_newCharBuffer(this->common->mm,
@@ -627,16 +1033,19 @@ picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
 
         PICODBG_DEBUG(("cbOut has address %i", (picoos_uint32) this->cbOut));
 
-
-        this->control = picoctrl_newControl(this->common->mm, this->common,
-                this->cbIn, this->cbOut, this->voice);
         done = (NULL != this->cbIn) && (NULL != this->cbOut)
-                && (NULL != this->control);
+                && engNewStages(this);
+    }
+    if (done) {
+        done = (PICO_OK == engStartStages(this));
     }
     if (done) {
         SET_MAGIC_NUMBER(this);
     } else {
         if (NULL != this) {
+            if (NULL != this->common) {
+                engDisposeStages(this);
+            }
             if (NULL != this->voice) {
                 picorsrc_releaseVoice(rm,&(this->voice));
             }
@@ -647,7 +1056,7 @@ picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
         }
     }
     return this;
-}/*picoctrl_newEngine*/
+}/*picoctrl_newPipelinedEngine*/
 
 /**
  * disposes an engine object
@@ -663,12 +1072,10 @@ void picoctrl_disposeEngine(picoos_MemoryManager mm, picorsrc_ResourceManager rm
         picoctrl_Engine * this)
 {
     if (NULL != (*this)) {
+        engDisposeStages(*this);
         if (NULL != (*this)->voice) {
             picorsrc_releaseVoice(rm,&((*this)->voice));
         }
-        if(NULL != (*this)->control) {
-            picoctrl_disposeControl((*this)->common->mm,&((*this)->control));
-        }
         if(NULL != (*this)->raw_mem) {
             picoos_deallocate(mm,&((*this)->raw_mem));
         }
@@ -691,6 +1098,81 @@ void picoctrl_engResetExceptionManager(
         picoos_emReset(this->common->em);
 }/*picoctrl_engResetExceptionManager*/
 
+/**
+ * switches the profiling of all PUs of an engine on or off; switching it
+ * on clears the counters
+ * @param    this : handle of the engine
+ * @param    enable : whether to profile
+ * @return    PICO_OK : done
+ * @return    PICO_ERR_OTHER : the worker threads could not be restarted
+ * @remarks    only call while the engine is idle
+ * @callgraph
+ * @callergraph
+ */
+pico_status_t picoctrl_engSetProfiling(
+        picoctrl_Engine this,
+        picoos_bool enable
+        )
+{
+    ctrl_subobj_t * ctrl;
+    picoos_uint8 i, j;
+
+    /* the counters belong to the stage threads, which are stopped meanwhile */
+    engStopStages(this);
+    for (i = 0; i < this->numStages; i++) {
+        ctrl = (ctrl_subobj_t *) this->stage[i].control->subObj;
+        ctrl->profiling = enable;
+        if (enable) {
+            for (j = 0; j < ctrl->numProcUnits; j++) {
+                ctrl->profile[j].steps = 0;
+                ctrl->profile[j].idleSteps = 0;
+                ctrl->profile[j].outFullSteps = 0;
+                ctrl->profile[j].nanos = 0;
+                ctrl->profile[j].bytesIn = 0;
+                ctrl->profile[j].bytesOut = 0;
+                ctrl->procUnit[j]->cacheHits = 0;
+                ctrl->procUnit[j]->cacheMisses = 0;
+            }
+        }
+    }
+    return engStartStages(this);
+}/*picoctrl_engSetProfiling*/
+
+/**
+ * copies the profiling counters of the PUs of an engine, in the order of
+ * the TTS chain
+ * @param    this : handle of the engine
+ * @param    profile : receives the counters
+ * @param    maxPUs : room in 'profile'
+ * @return    the number of PUs copied
+ * @remarks    only call while the engine is idle
+ * @callgraph
+ * @callergraph
+ */
+picoos_int16 picoctrl_engGetProfile(
+        picoctrl_Engine this,
+        picoctrl_pu_profile_t * profile,
+        picoos_int16 maxPUs
+        )
+{
+    ctrl_subobj_t * ctrl;
+    picoos_uint8 i, j;
+    picoos_int16 n = 0;
+
+    engStopStages(this);
+    for (i = 0; i < this->numStages; i++) {
+        ctrl = (ctrl_subobj_t *) this->stage[i].control->subObj;
+        for (j = 0; (j < ctrl->numProcUnits) && (n < maxPUs); j++) {
+            profile[n] = ctrl->profile[j];
+            profile[n].cacheHits = ctrl->procUnit[j]->cacheHits;
+            profile[n].cacheMisses = ctrl->procUnit[j]->cacheMisses;
+            n++;
+        }
+    }
+    engStartStages(this);
+    return n;
+}/*picoctrl_engGetProfile*/
+
 /**
  * returns the engine common pointer
  * @param    this : handle of the engine
@@ -721,15 +1203,15 @@ picoos_Common picoctrl_engGetCommon(picoctrl_Engine this) {
  */
 pico_status_t picoctrl_engFeedText(picoctrl_Engine this,
         picoos_char * text,
-        picoos_int16 textSize, picoos_int16 * bytesPut) {
+        picoos_uint32 textSize, picoos_uint32 * bytesPut) {
     if (NULL == this) {
         return PICO_ERR_OTHER;
     }
     PICODBG_DEBUG(("get \"%.100s\"", text));
-    *bytesPut = 0;
-    while ((*bytesPut < textSize) && (PICO_OK == picodata_cbPutCh(this->cbIn, text[*bytesPut]))) {
-        (*bytesPut)++;
-    }
+    /* only takes what fits right now: a worker may be emptying cbIn while
+       we feed, and how the text is split into calls must not depend on
+       its timing */
+    *bytesPut = picodata_cbPutBytes(this->cbIn, text, textSize);
 
     return PICO_OK;
 }/*picoctrl_engFeedText*/
@@ -754,9 +1236,14 @@ picodata_step_result_t picoctrl_engFetchOutputItemBytes(
     picodata_step_result_t stepResult;
     pico_status_t rv;
 
+    picoos_uint32 token;
+
     if (NULL == this) {
         return (picodata_step_result_t)PICO_STEP_ERROR;
     }
+    if ((this->numStages > 1) && engStagesFailed(this)) {
+        return (picodata_step_result_t)PICO_STEP_ERROR;
+    }
     PICODBG_DEBUG(("doing one step"));
     stepResult = this->control->step(this->control,/* mode */0,&ui);
     if (PICODATA_PU_ERROR != stepResult) {
@@ -776,6 +1263,18 @@ picodata_step_result_t picoctrl_engFetchOutputItemBytes(
         /* rv must now be PICO_OK or PICO_EOF */
         PICODBG_ASSERT(((PICO_EOF == rv) || (PICO_OK == rv)));
         if ((PICODATA_PU_IDLE == stepResult) && (PICO_EOF == rv)) {
+            if (this->numStages > 1) {
+                /* the last stage is idle; wait for the stages above
+                   unless they have nothing left to do either */
+                token = picodata_cbGetWaitToken(this->control->cbIn);
+                if (!engStagesIdle(this)) {
+                    if (picodata_cbIsEmpty(this->control->cbIn)) {
+                        picodata_cbWait(this->control->cbIn, token);
+                    }
+                    PICODBG_DEBUG(("BUSY"));
+                    return (picodata_step_result_t)PICO_STEP_BUSY;
+                }
+            }
             PICODBG_DEBUG(("IDLE"));
             return (picodata_step_result_t)PICO_STEP_IDLE;
         } else if (PICODATA_PU_ERROR == stepResult) {
@@ -790,6 +1289,47 @@ picodata_step_result_t picoctrl_engFetchOutputItemBytes(
     }
 }/*picoctrl_engFetchOutputItemBytes*/
 
+/**
+ * gets engine output bytes of as many steps as fit into 'buffer'
+ * @param    this : handle of the engine
+ * @param    buffer : the destination buffer
+ * @param    bufferSize : max size of the destination buffer
+ * @param    *bytesReceived : the number of bytes effectively returned
+ * @return    PICO_STEP_BUSY : 'buffer' is full, there is more to come
+ * @return    PICO_STEP_IDLE : all input has been processed
+ * @return    PICO_STEP_ERROR : if error
+ * @remarks    keeps stepping while there is room for one more item of
+ *             speech data, so a large buffer takes the output of many
+ *             steps in one call
+ * @callgraph
+ * @callergraph
+ */
+picodata_step_result_t picoctrl_engFetchOutputBytes(
+        picoctrl_Engine this,
+        picoos_char *buffer,
+        picoos_uint32 bufferSize,
+        picoos_uint32 *bytesReceived) {
+    picodata_step_result_t stepResult;
+    picoos_uint32 room;
+    picoos_int16 n;
+
+    *bytesReceived = 0;
+    do {
+        /* a step yields at most one item */
+        room = bufferSize - *bytesReceived;
+        if (room > PICODATA_MAX_ITEMSIZE) {
+            room = PICODATA_MAX_ITEMSIZE;
+        }
+        n = 0;
+        stepResult = picoctrl_engFetchOutputItemBytes(this,
+                buffer + *bytesReceived, (picoos_int16) room, &n);
+        *bytesReceived += n;
+    } while ((PICO_STEP_BUSY == stepResult)
+            && (bufferSize - *bytesReceived >= PICODATA_MAX_ITEMSIZE));
+
+    return stepResult;
+}/*picoctrl_engFetchOutputBytes*/
+
 /**
  * returns the last scheduled PU
  * @param    this : handle of the engine
@@ -31,6 +31,7 @@
 #include "picoos.h"
 #include "picorsrc.h"
 #include "picodata.h"
+#include "picosa.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -41,13 +42,45 @@ extern "C" {
 
 #define PICOCTRL_MAX_PROC_UNITS 25
 
+/* maximum number of concurrently running parts of the TTS chain */
+#define PICOCTRL_MAX_STAGES 3
+
+/* additional engine memory needed for each stage beyond the first */
+#define PICOCTRL_STAGE_ENGINE_SIZE 32768
+
 /* temporarily increased for preprocessing
 #define PICOCTRL_DEFAULT_ENGINE_SIZE 200000
 */
-#define PICOCTRL_DEFAULT_ENGINE_SIZE 1000000
+/* additional engine memory taken by the memo of the pam PU and the G2P
+   cache of the sa PU */
+#define PICOCTRL_MEMO_ENGINE_SIZE (86016 + PICOSA_G2P_CACHE_MEM_SIZE)
+
+#define PICOCTRL_DEFAULT_ENGINE_SIZE (1000000 + PICOCTRL_MEMO_ENGINE_SIZE)
+
+/* system memory area for a single engine of 'numStages' stages: the
+   engine as allocated by picoctrl_newPipelinedEngine, plus room for the
+   resource manager and the voice definitions (about 4 KB of it used);
+   shared lingware is kept outside of the area */
+#define PICOCTRL_SYSTEM_OVERHEAD_SIZE 100000
+#define PICOCTRL_SYSTEM_MEM_SIZE(numStages) (PICOCTRL_DEFAULT_ENGINE_SIZE \
+        + ((numStages) - 1) * PICOCTRL_STAGE_ENGINE_SIZE + PICOCTRL_SYSTEM_OVERHEAD_SIZE)
 
 typedef struct picoctrl_engine * picoctrl_Engine;
 
+/* profiling counters of one PU of an engine, accumulated over all its
+   steps since profiling was enabled */
+typedef struct picoctrl_pu_profile {
+    picoos_char name[8];        /* "tok", "pr", ..., "sig" */
+    picoos_uint32 steps;
+    picoos_uint32 idleSteps;    /* steps returning PICODATA_PU_IDLE */
+    picoos_uint32 outFullSteps; /* steps returning PICODATA_PU_OUT_FULL */
+    picoos_uint64 nanos;        /* time spent in the PU's step method */
+    picoos_uint64 bytesIn;      /* bytes taken from the PU's input buffer */
+    picoos_uint64 bytesOut;     /* bytes put into the PU's output buffer */
+    picoos_uint32 cacheHits;    /* lookups answered by the PU's memo */
+    picoos_uint32 cacheMisses;  /* lookups the PU's memo could not answer */
+} picoctrl_pu_profile_t;
+
 picoos_int16 picoctrl_isValidEngineHandle(picoctrl_Engine that);
 
 picoctrl_Engine picoctrl_newEngine (
@@ -56,6 +89,13 @@ picoctrl_Engine picoctrl_newEngine (
         const picoos_char * voiceName
         );
 
+picoctrl_Engine picoctrl_newPipelinedEngine (
+        picoos_MemoryManager mm,
+        picorsrc_ResourceManager rm,
+        const picoos_char * voiceName,
+        picoos_uint8 numStages
+        );
+
 void picoctrl_disposeEngine(
         picoos_MemoryManager mm,
         picorsrc_ResourceManager rm,
@@ -65,8 +105,8 @@ void picoctrl_disposeEngine(
 pico_status_t picoctrl_engFeedText(
         picoctrl_Engine engine,
         picoos_char * text,
-        picoos_int16  textSize,
-        picoos_int16 * bytesPut);
+        picoos_uint32  textSize,
+        picoos_uint32 * bytesPut);
 
 pico_status_t picoctrl_engReset(
         picoctrl_Engine engine,
@@ -81,10 +121,28 @@ picodata_step_result_t picoctrl_engFetchOutputItemBytes(
         picoos_int16  * bytesReceived
 );
 
+picodata_step_result_t picoctrl_engFetchOutputBytes(
+        picoctrl_Engine engine,
+        picoos_char * buffer,
+        picoos_uint32 bufferSize,
+        picoos_uint32 * bytesReceived
+);
+
 void picoctrl_engResetExceptionManager(
         picoctrl_Engine that
         );
 
+pico_status_t picoctrl_engSetProfiling(
+        picoctrl_Engine engine,
+        picoos_bool enable
+        );
+
+picoos_int16 picoctrl_engGetProfile(
+        picoctrl_Engine engine,
+        picoctrl_pu_profile_t * profile,
+        picoos_int16 maxPUs
+        );
+
 
 picodata_step_result_t picoctrl_getLastScheduledPU(
         picoctrl_Engine engine
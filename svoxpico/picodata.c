@@ -64,9 +64,21 @@ typedef struct picodata_char_buffer
     picoos_char *buf;
     picoos_uint16 rear; /* next free position to write */
     picoos_uint16 front; /* next position to read */
-    picoos_uint16 len; /* empty: len = 0, full: len = size */
+    volatile picoos_int32 len; /* empty: len = 0, full: len = size */
     picoos_uint16 size;
 
+    /* bytes ever put and got, for profiling; they only ever grow (modulo
+       2^32) and, like 'rear' and 'front', belong to the producer and the
+       consumer respectively */
+    picoos_uint32 numPut;
+    picoos_uint32 numGot;
+
+    /* shared buffers connect two threads (one producer, one consumer);
+       'rear' is owned by the producer, 'front' by the consumer and 'len'
+       is only accessed atomically. 'event' is signalled on every change */
+    picoos_bool shared;
+    picopal_Event event;
+
     picoos_Common common;
 
     picodata_cbGetItemMethod getItem;
@@ -86,11 +98,24 @@ static pico_status_t data_cbGetItem(picodata_CharBuffer this,
         picoos_uint8 *buf, const picoos_uint16 blenmax,
         picoos_uint16 *blen, const picoos_uint8 issd);
 
+static pico_status_t data_cbPutItemShared(picodata_CharBuffer this,
+        const picoos_uint8 *buf, const picoos_uint16 blenmax,
+        picoos_uint16 *blen);
+
+static pico_status_t data_cbGetItemShared(picodata_CharBuffer this,
+        picoos_uint8 *buf, const picoos_uint16 blenmax,
+        picoos_uint16 *blen, const picoos_uint8 issd);
+
+/* must only be called while neither side of a shared buffer is active */
 pico_status_t picodata_cbReset(picodata_CharBuffer this)
 {
     this->rear = 0;
     this->front = 0;
-    this->len = 0;
+    if (this->shared) {
+        picopal_atomic_set(&this->len, 0);
+    } else {
+        this->len = 0;
+    }
     if (NULL != this->subObj) {
         return this->subReset(this);
     } else {
@@ -117,10 +142,15 @@ picodata_CharBuffer picodata_newCharBuffer(picoos_MemoryManager mm,
     }
     this->size = size;
     this->common = common;
+    this->numPut = 0;
+    this->numGot = 0;
 
     this->getItem = data_cbGetItem;
     this->putItem = data_cbPutItem;
 
+    this->shared = FALSE;
+    this->event = NULL;
+
     this->subReset = NULL;
     this->subDeallocate = NULL;
     this->subObj = NULL;
@@ -129,6 +159,30 @@ picodata_CharBuffer picodata_newCharBuffer(picoos_MemoryManager mm,
     return this;
 }
 
+/* shared CharBuffer constructor */
+picodata_CharBuffer picodata_newSharedCharBuffer(picoos_MemoryManager mm,
+        picoos_Common common,
+        picoos_objsize_t size)
+{
+    picodata_CharBuffer this;
+
+    this = picodata_newCharBuffer(mm, common, size);
+    if (NULL == this) {
+        return NULL;
+    }
+    this->event = picopal_event_new();
+    if (NULL == this->event) {
+        picodata_disposeCharBuffer(mm, &this);
+        return NULL;
+    }
+    this->shared = TRUE;
+    this->getItem = data_cbGetItemShared;
+    this->putItem = data_cbPutItemShared;
+
+    picodata_cbReset(this);
+    return this;
+}
+
 void picodata_disposeCharBuffer(picoos_MemoryManager mm,
                                 picodata_CharBuffer *this)
 {
@@ -137,6 +191,7 @@ void picodata_disposeCharBuffer(picoos_MemoryManager mm,
         if (NULL != (*this)->subObj) {
             (*this)->subDeallocate(*this,mm);
         }
+        picopal_event_dispose(&(*this)->event);
         picoos_deallocate(mm,(void*)&(*this)->buf);
         picoos_deallocate(mm,(void*)this);
     }
@@ -145,10 +200,22 @@ void picodata_disposeCharBuffer(picoos_MemoryManager mm,
 pico_status_t picodata_cbPutCh(picodata_CharBuffer this,
                                picoos_char ch)
 {
+    if (this->shared) {
+        if (picopal_atomic_get(&this->len) >= this->size) {
+            return PICO_EXC_BUF_OVERFLOW;
+        }
+        this->buf[this->rear++] = ch;
+        this->rear %= this->size;
+        this->numPut++;
+        picopal_atomic_add(&this->len, 1);
+        picopal_event_signal(this->event);
+        return PICO_OK;
+    }
     if (this->len < this->size) {
         this->buf[this->rear++] = ch;
         this->rear %= this->size;
         this->len++;
+        this->numPut++;
         return PICO_OK;
     } else {
         return PICO_EXC_BUF_OVERFLOW;
@@ -156,19 +223,97 @@ pico_status_t picodata_cbPutCh(picodata_CharBuffer this,
 }
 
 
+picoos_uint32 picodata_cbPutBytes(picodata_CharBuffer this,
+        const picoos_char * bytes, picoos_uint32 len)
+{
+    picoos_uint32 n, span;
+
+    n = (this->shared) ? this->size - picopal_atomic_get(&this->len)
+            : this->size - this->len;
+    if (len < n) {
+        n = len;
+    }
+    if (0 == n) {
+        return 0;
+    }
+    /* at most two spans: up to the end of buf, then from its start */
+    span = this->size - this->rear;
+    if (span > n) {
+        span = n;
+    }
+    picoos_mem_copy(bytes, this->buf + this->rear, span);
+    picoos_mem_copy(bytes + span, this->buf, n - span);
+    this->rear = (this->rear + n) % this->size;
+    this->numPut += n;
+    if (this->shared) {
+        picopal_atomic_add(&this->len, (picoos_int32) n);
+        picopal_event_signal(this->event);
+    } else {
+        this->len += n;
+    }
+    return n;
+}
+
 picoos_int16 picodata_cbGetCh(picodata_CharBuffer this)
 {
     picoos_char ch;
+    if (this->shared) {
+        if (picopal_atomic_get(&this->len) <= 0) {
+            return PICO_EOF;
+        }
+        ch = this->buf[this->front++];
+        this->front %= this->size;
+        this->numGot++;
+        picopal_atomic_add(&this->len, -1);
+        picopal_event_signal(this->event);
+        return ch;
+    }
     if (this->len > 0) {
         ch = this->buf[this->front++];
         this->front %= this->size;
         this->len--;
+        this->numGot++;
         return ch;
     } else {
         return PICO_EOF;
     }
 }
 
+picoos_bool picodata_cbIsEmpty(picodata_CharBuffer this)
+{
+    if (this->shared) {
+        return (0 == picopal_atomic_get(&this->len));
+    }
+    return (0 == this->len);
+}
+
+picoos_uint16 picodata_cbGetFreeSpace(picodata_CharBuffer this)
+{
+    if (this->shared) {
+        return (picoos_uint16) (this->size - picopal_atomic_get(&this->len));
+    }
+    return (picoos_uint16) (this->size - this->len);
+}
+
+picoos_uint32 picodata_cbGetWaitToken(picodata_CharBuffer this)
+{
+    return (this->shared) ? picopal_event_token(this->event) : 0;
+}
+
+void picodata_cbWait(picodata_CharBuffer this, picoos_uint32 token)
+{
+    if (this->shared) {
+        picopal_event_wait(this->event, token);
+    }
+}
+
+void picodata_cbNotify(picodata_CharBuffer this)
+{
+    if (this->shared) {
+        picopal_event_signal(this->event);
+    }
+}
+
 /* ***************************************************************
  *                   items: CharBuffer functions                 *
  *****************************************************************/
@@ -203,6 +348,7 @@ static pico_status_t data_cbGetItem(picodata_CharBuffer this,
                 this->front %= this->size;
                 this->len--;
             }
+            this->numGot += *blen;
             *blen = 0;
             return PICO_OK;
         }
@@ -220,6 +366,8 @@ static pico_status_t data_cbGetItem(picodata_CharBuffer this,
         return PICO_EXC_BUF_OVERFLOW;
     }
 
+    this->numGot += *blen;
+
     /* if getting speech data in item */
     if (issd) {
         /* skip item header */
@@ -303,6 +451,88 @@ static pico_status_t data_cbPutItem(picodata_CharBuffer this,
         this->rear %= this->size;
         this->len++;
     }
+    this->numPut += *blen;
+    return PICO_OK;
+}
+
+/* shared variants of the above: the consumer only reads up to the
+   item count published by the producer, so a complete item is always
+   seen; 'len' is updated once per item */
+static pico_status_t data_cbGetItemShared(picodata_CharBuffer this,
+        picoos_uint8 *buf, const picoos_uint16 blenmax,
+        picoos_uint16 *blen, const picoos_uint8 issd)
+{
+    picoos_uint16 i, skip;
+    picoos_int32 avail;
+
+    avail = picopal_atomic_get(&this->len);
+    if (avail < PICODATA_ITEM_HEADSIZE) {
+        *blen = 0;
+        return (0 == avail) ? PICO_EOF : PICO_EXC_BUF_UNDERFLOW;
+    }
+    *blen = PICODATA_ITEM_HEADSIZE + (picoos_uint8)(this->buf[((this->front) +
+                                      PICODATA_ITEMIND_LEN) % this->size]);
+    if (*blen > avail) {
+        *blen = 0;
+        return PICO_EXC_BUF_UNDERFLOW;
+    }
+    skip = 0;
+    if (issd) {
+        if (this->buf[this->front] != PICODATA_ITEM_FRAME) {
+            PICODBG_WARN(("item type mismatch for speech data: %c",
+                          this->buf[this->front]));
+            this->front = (this->front + *blen) % this->size;
+            this->numGot += *blen;
+            picopal_atomic_add(&this->len, -(picoos_int32) *blen);
+            picopal_event_signal(this->event);
+            *blen = 0;
+            return PICO_OK;
+        }
+        skip = PICODATA_ITEM_HEADSIZE;
+    }
+    if (blenmax < (*blen - skip)) {
+        *blen = 0;
+        return PICO_EXC_BUF_OVERFLOW;
+    }
+    this->front = (this->front + skip) % this->size;
+    for (i = 0; i < (*blen - skip); i++) {
+        buf[i] = (picoos_uint8)(this->buf[this->front++]);
+        this->front %= this->size;
+    }
+    this->numGot += *blen;
+    picopal_atomic_add(&this->len, -(picoos_int32) *blen);
+    picopal_event_signal(this->event);
+    *blen -= skip;
+    return PICO_OK;
+}
+
+static pico_status_t data_cbPutItemShared(picodata_CharBuffer this,
+        const picoos_uint8 *buf, const picoos_uint16 blenmax,
+        picoos_uint16 *blen)
+{
+    picoos_uint16 i;
+
+    if (blenmax < PICODATA_ITEM_HEADSIZE) {
+        *blen = 0;
+        return PICO_EXC_BUF_UNDERFLOW;
+    }
+    *blen = buf[PICODATA_ITEMIND_LEN] + PICODATA_ITEM_HEADSIZE;
+    if (*blen > (this->size - picopal_atomic_get(&this->len))) {
+        *blen = 0;
+        return PICO_EXC_BUF_OVERFLOW;
+    }
+    if (*blen > blenmax) {
+        *blen = 0;
+        return PICO_EXC_BUF_UNDERFLOW;
+    }
+    for (i = 0; i < *blen; i++) {
+        this->buf[this->rear++] = (picoos_char)buf[i];
+        this->rear %= this->size;
+    }
+    this->numPut += *blen;
+    /* publish the complete item */
+    picopal_atomic_add(&this->len, *blen);
+    picopal_event_signal(this->event);
     return PICO_OK;
 }
 
@@ -342,6 +572,18 @@ pico_status_t picodata_cbPutItem(picodata_CharBuffer this,
         return this->putItem(this,buf,blenmax,blen);
 }
 
+/* for profiling: bytes ever put into / got from 'this' (modulo 2^32); only
+   the producer may ask for the former, only the consumer for the latter */
+picoos_uint32 picodata_cbGetNumPut(picodata_CharBuffer this)
+{
+    return this->numPut;
+}
+
+picoos_uint32 picodata_cbGetNumGot(picodata_CharBuffer this)
+{
+    return this->numGot;
+}
+
 /* unsafe, just for measuring purposes */
 picoos_uint8 picodata_cbGetFrontItemType(picodata_CharBuffer this)
 {
@@ -628,6 +870,8 @@ picodata_ProcessingUnit picodata_newProcessingUnit(
     this->step = puSimpleStep;
     this->subDeallocate = NULL;
     this->subObj = NULL;
+    this->cacheHits = 0;
+    this->cacheMisses = 0;
     return this;
 }
 
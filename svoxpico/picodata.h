@@ -85,12 +85,41 @@ void picodata_disposeCharBuffer(picoos_MemoryManager mm,
 /* should not be used for PUs but only for feeding the initial cb */
 pico_status_t picodata_cbPutCh(picodata_CharBuffer that, picoos_char ch);
 
+/* puts as many of the 'len' bytes as fit into cb at once and returns how
+   many were put; same restrictions as picodata_cbPutCh */
+picoos_uint32 picodata_cbPutBytes(picodata_CharBuffer that,
+        const picoos_char * bytes, picoos_uint32 len);
+
 /* should not be used for PUs other than first PU in the chain (picotok) */
 picoos_int16 picodata_cbGetCh(picodata_CharBuffer that);
 
 /* reset cb (as if after newCharBuffer) */
 pico_status_t picodata_cbReset(picodata_CharBuffer that);
 
+/* ** shared CharBuffer ****/
+
+/* a shared cb is a lock-free ring connecting exactly one producer thread
+   and one consumer thread; items are published as a whole. It is used in
+   place of a normal cb wherever the TTS chain is split across threads */
+picodata_CharBuffer picodata_newSharedCharBuffer(picoos_MemoryManager mm,
+        picoos_Common common, picoos_objsize_t size);
+
+/* TRUE if cb does not contain any data */
+picoos_bool picodata_cbIsEmpty(picodata_CharBuffer that);
+
+/* number of bytes that can currently be put into cb */
+picoos_uint16 picodata_cbGetFreeSpace(picodata_CharBuffer that);
+
+/* sleep until a shared cb has changed; take the token first, then check
+   the cb state, then wait (no-ops for normal cbs):
+     token = picodata_cbGetWaitToken(cb);
+     if (picodata_cbIsEmpty(cb)) picodata_cbWait(cb, token); */
+picoos_uint32 picodata_cbGetWaitToken(picodata_CharBuffer that);
+void picodata_cbWait(picodata_CharBuffer that, picoos_uint32 token);
+
+/* wake up any thread waiting on a shared cb */
+void picodata_cbNotify(picodata_CharBuffer that);
+
 /* ** CharBuffer item functions, cf. below in items section ****/
 
 /* ***************************************************************
@@ -325,6 +354,11 @@ pico_status_t picodata_cbPutItem(picodata_CharBuffer that,
         const picoos_uint8 *buf, const picoos_uint16 blenmax,
         picoos_uint16 *blen);
 
+/* for profiling: bytes ever put into / got from 'that' (modulo 2^32); only
+   the producer may ask for the former, only the consumer for the latter */
+picoos_uint32 picodata_cbGetNumPut(picodata_CharBuffer that);
+picoos_uint32 picodata_cbGetNumGot(picodata_CharBuffer that);
+
 /* unsafe, just for measuring purposes */
 picoos_uint8 picodata_cbGetFrontItemType(picodata_CharBuffer that);
 
@@ -451,6 +485,8 @@ picoos_uint8 picodata_is_valid_itemhead(const picodata_itemhead_t *head);
 #define PICODATA_BUFSIZE_CEP     (picoos_uint16) 16 * PICODATA_BUFSIZE_DEFAULT
 #define PICODATA_BUFSIZE_SIG     (picoos_uint16) 16 * PICODATA_BUFSIZE_DEFAULT
 #define PICODATA_BUFSIZE_SINK     (picoos_uint16) 1 * PICODATA_BUFSIZE_DEFAULT
+/* shared cb between pipeline stages running on different threads */
+#define PICODATA_BUFSIZE_STAGE    (picoos_uint16) 64 * PICODATA_BUFSIZE_DEFAULT
 
 /* different types of processing units */
 typedef enum picodata_putype {
@@ -516,6 +552,9 @@ typedef struct picodata_processing_unit
     picodata_CharBuffer            cbIn, cbOut;
     picodata_puSubDeallocateMethod subDeallocate;
     void * subObj;
+    /* lookups of a PU's memo of earlier results (if it keeps one), for
+       profiling; cleared when profiling is switched on */
+    picoos_uint32 cacheHits, cacheMisses;
 
 } picodata_processing_unit_t;
 
@@ -51,6 +51,18 @@ extern pico_Status pico_initialize_priv(
         pico_Int16 enableMemProt,
         pico_System *system);
 
+extern pico_Status pico_loadResource_priv(
+        pico_System system,
+        const pico_Char *lingwareFileName,
+        pico_Int16 shared,
+        pico_Resource *outLingware);
+
+extern pico_Status pico_newEngine_priv(
+        pico_System system,
+        const pico_Char *voiceName,
+        pico_Int16 numStages,
+        pico_Engine *outEngine);
+
 
 /* System initialization and termination functions ****************************/
 
@@ -203,6 +215,106 @@ PICO_FUNC picoext_getEngineMemUsage(
     return status;
 }
 
+/* Resource loading ***********************************************************/
+
+PICO_FUNC picoext_loadSharedResource(
+        pico_System system,
+        const pico_Char *lingwareFileName,
+        pico_Resource *outLingware
+        )
+{
+    return pico_loadResource_priv(system, lingwareFileName, /*shared*/ TRUE, outLingware);
+}
+
+
+PICO_FUNC picoext_setPdfExpansion(
+        pico_System system,
+        pico_Int16 enable
+        )
+{
+    if (!is_valid_system_handle(system)) {
+        return PICO_ERR_INVALID_HANDLE;
+    }
+    picorsrc_setPdfExpansion(system->rm, (picoos_bool) (enable != 0));
+    return PICO_OK;
+}
+
+
+/* Engine creation ************************************************************/
+
+PICO_FUNC picoext_newPipelinedEngine(
+        pico_System system,
+        const pico_Char *voiceName,
+        pico_Int16 numStages,
+        pico_Engine *outEngine
+        )
+{
+    if ((numStages < 1) || (numStages > PICOCTRL_MAX_STAGES)) {
+        return PICO_ERR_INVALID_ARGUMENT;
+    }
+    return pico_newEngine_priv(system, voiceName, numStages, outEngine);
+}
+
+
+/* Text input and speech output **********************************************/
+
+PICO_FUNC picoext_putText(
+        pico_Engine engine,
+        const pico_Char *text,
+        const pico_Uint64 textSize,
+        pico_Uint64 *bytesPut
+        )
+{
+    pico_Status status = PICO_OK;
+    picoos_uint32 put;
+
+    if (!picoctrl_isValidEngineHandle((picoctrl_Engine) engine)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if ((text == NULL) || (bytesPut == NULL)) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else {
+        picoctrl_engResetExceptionManager((picoctrl_Engine) engine);
+        /* the input buffer takes far less than 4GB at once */
+        status = picoctrl_engFeedText((picoctrl_Engine) engine, (picoos_char *)text,
+                (textSize > PICO_UINT32_MAX) ? PICO_UINT32_MAX : (picoos_uint32) textSize,
+                &put);
+        *bytesPut = put;
+    }
+    return status;
+}
+
+
+PICO_FUNC picoext_getData(
+        pico_Engine engine,
+        void *buffer,
+        const pico_Uint32 bufferSamples,
+        pico_Uint32 *samplesReceived,
+        pico_Int16 *outDataType
+        )
+{
+    pico_Status status = PICO_OK;
+    picoos_uint32 bytes;
+
+    if (!picoctrl_isValidEngineHandle((picoctrl_Engine) engine)) {
+        status = PICO_STEP_ERROR;
+    } else if ((buffer == NULL) || (samplesReceived == NULL) || (outDataType == NULL)) {
+        status = PICO_STEP_ERROR;
+    } else {
+        picoctrl_engResetExceptionManager((picoctrl_Engine) engine);
+        /* the items carry whole 16 bit samples */
+        status = picoctrl_engFetchOutputBytes((picoctrl_Engine) engine, (picoos_char *)buffer,
+                (bufferSamples > PICO_UINT32_MAX / 2) ? PICO_UINT32_MAX - 1 : 2 * bufferSamples,
+                &bytes);
+        *samplesReceived = bytes / 2;
+        if ((status != PICO_STEP_IDLE) && (status != PICO_STEP_BUSY)) {
+            status = PICO_STEP_ERROR;
+        }
+        *outDataType = PICO_DATA_PCM_16BIT;
+    }
+    return status;
+}
+
+
 PICO_FUNC picoext_getLastScheduledPU(
         pico_Engine engine
         )
@@ -212,6 +324,53 @@ PICO_FUNC picoext_getLastScheduledPU(
     return status;
 }
 
+PICO_FUNC picoext_setProfiling(
+        pico_Engine engine,
+        pico_Int16 enable
+        )
+{
+    if (!picoctrl_isValidEngineHandle((picoctrl_Engine) engine)) {
+        return PICO_ERR_INVALID_HANDLE;
+    }
+    return picoctrl_engSetProfiling((picoctrl_Engine) engine,
+            (picoos_bool) (enable != 0));
+}
+
+PICO_FUNC picoext_getProfile(
+        pico_Engine engine,
+        picoext_PuProfile *profile,
+        pico_Int16 maxPUs,
+        pico_Int16 *numPUs
+        )
+{
+    picoctrl_pu_profile_t puProfile[PICOEXT_MAX_PROFILED_PUS];
+    picoos_int16 i, n;
+
+    if (!picoctrl_isValidEngineHandle((picoctrl_Engine) engine)) {
+        return PICO_ERR_INVALID_HANDLE;
+    } else if ((profile == NULL) || (numPUs == NULL)) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    if (maxPUs > PICOEXT_MAX_PROFILED_PUS) {
+        maxPUs = PICOEXT_MAX_PROFILED_PUS;
+    }
+    n = picoctrl_engGetProfile((picoctrl_Engine) engine, puProfile, maxPUs);
+    for (i = 0; i < n; i++) {
+        picoos_strlcpy((picoos_char *) profile[i].name, puProfile[i].name,
+                sizeof(profile[i].name));
+        profile[i].steps = puProfile[i].steps;
+        profile[i].idleSteps = puProfile[i].idleSteps;
+        profile[i].outFullSteps = puProfile[i].outFullSteps;
+        profile[i].nanos = puProfile[i].nanos;
+        profile[i].bytesIn = puProfile[i].bytesIn;
+        profile[i].bytesOut = puProfile[i].bytesOut;
+        profile[i].cacheHits = puProfile[i].cacheHits;
+        profile[i].cacheMisses = puProfile[i].cacheMisses;
+    }
+    *numPUs = n;
+    return PICO_OK;
+}
+
 PICO_FUNC picoext_getLastProducedItemType(
         pico_Engine engine
         )
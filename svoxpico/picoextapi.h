@@ -129,6 +129,85 @@ PICO_FUNC picoext_setLogFile(
         );
 
 
+/* Resource loading ***********************************************************/
+
+/* Same as pico_loadResource, but the lingware is read only once per process,
+   into memory outside of the system's memory area. Every system that loads
+   the same resource with picoext_loadSharedResource, on any thread, uses that
+   single read-only copy and its knowledge bases; it is freed when the last
+   of them calls pico_unloadResource. The system memory then only needs to
+   hold the engines. */
+
+PICO_FUNC picoext_loadSharedResource(
+        pico_System system,
+        const pico_Char *lingwareFileName,
+        pico_Resource *outLingware
+        );
+
+/* Has the resources that 'system' loads from now on expand their F0 and
+   spectrum pdfs into tables of decoded values (with 'enable' != 0), or
+   keep them packed (the default). The tables take about 2MB per voice,
+   in the system memory for pico_loadResource, or next to the shared
+   copy for picoext_loadSharedResource (which then is not shared with
+   systems that keep the pdfs packed); in exchange, generating the
+   parameters reads them without decoding. */
+
+PICO_FUNC picoext_setPdfExpansion(
+        pico_System system,
+        pico_Int16 enable
+        );
+
+
+/* Engine creation ************************************************************/
+
+/* Same as pico_newEngine, but splits the TTS processing chain into
+   'numStages' (1..3) parts running concurrently on their own threads:
+   1 runs everything in the calling thread (as pico_newEngine does),
+   2 runs the text analysis on a worker thread, 3 additionally runs the
+   parameter generation on a second worker thread. The output does not
+   depend on 'numStages'. The engine must be used from a single thread. */
+
+PICO_FUNC picoext_newPipelinedEngine(
+        pico_System system,
+        const pico_Char *voiceName,
+        pico_Int16 numStages,
+        pico_Engine *outEngine
+        );
+
+
+/* Text input and speech output **********************************************/
+
+/* Same as pico_putTextUtf8, but for text of any length: puts as much of
+   'text' into the engine's input buffer as fits at once, copying it in
+   bulk, and returns the number of bytes taken in 'bytesPut'. As with
+   pico_putTextUtf8, call pico_getData until it returns PICO_STEP_IDLE
+   before putting the rest. */
+
+PICO_FUNC picoext_putText(
+        pico_Engine engine,
+        const pico_Char *text,
+        const pico_Uint64 textSize,
+        pico_Uint64 *bytesPut
+        );
+
+
+/* Same as pico_getData, but for a buffer of any size (e.g. 32768
+   samples) and counted in 16 bit samples rather than bytes: keeps the
+   engine stepping until 'buffer' has no room for another item of speech
+   data or all input has been processed, instead of returning after a
+   single step. Returns PICO_STEP_BUSY while there is more to come,
+   PICO_STEP_IDLE once all input has been processed; in either case
+   'samplesReceived' samples of 'outDataType' data have been written. */
+
+PICO_FUNC picoext_getData(
+        pico_Engine engine,
+        void *buffer,
+        const pico_Uint32 bufferSamples,
+        pico_Uint32 *samplesReceived,
+        pico_Int16 *outDataType
+        );
+
+
 /* Memory usage ***************************************************************/
 
 PICO_FUNC picoext_getSystemMemUsage(
@@ -151,6 +230,46 @@ PICO_FUNC picoext_getLastScheduledPU(
         pico_Engine engine
         );
 
+
+/* Profiling ******************************************************************/
+
+/* Time and throughput of one processing unit (PU) of an engine's TTS chain,
+   accumulated over all its steps since profiling was switched on. */
+
+typedef struct {
+    pico_Char name[8];          /* "tok", "pr", "wa", ..., "cep", "sig" */
+    pico_Uint32 steps;
+    pico_Uint32 idleSteps;      /* steps that found nothing to do */
+    pico_Uint32 outFullSteps;   /* steps stopped by a full output buffer */
+    pico_Uint64 nanos;          /* time spent stepping the PU */
+    pico_Uint64 bytesIn;        /* bytes taken from its input buffer */
+    pico_Uint64 bytesOut;       /* bytes put into its output buffer */
+    pico_Uint32 cacheHits;      /* lookups answered by its memo (pam, sa) */
+    pico_Uint32 cacheMisses;    /* lookups its memo could not answer */
+} picoext_PuProfile;
+
+#define PICOEXT_MAX_PROFILED_PUS 16
+
+/* Switches the profiling of 'engine' on (clearing its counters) or off.
+   Profiling costs two clock readings per step. Like picoext_getProfile,
+   only call it while the engine is idle, i.e. before any text was put or
+   after pico_getData returned PICO_STEP_IDLE. */
+
+PICO_FUNC picoext_setProfiling(
+        pico_Engine engine,
+        pico_Int16 enable
+        );
+
+/* Copies the counters of up to 'maxPUs' PUs of 'engine', in the order of
+   the TTS chain, to 'profile'; 'numPUs' receives how many were copied. */
+
+PICO_FUNC picoext_getProfile(
+        pico_Engine engine,
+        picoext_PuProfile *profile,
+        pico_Int16 maxPUs,
+        pico_Int16 *numPUs
+        );
+
 PICO_FUNC picoext_getLastProducedItemType(
         pico_Engine engine
         );
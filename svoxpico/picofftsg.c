@@ -28,6 +28,7 @@
 
 #include "picoos.h"
 #include "picofftsg.h"
+#include "picosimd.h"
 #include "picodbg.h"
 
 #ifdef __cplusplus
@@ -431,9 +432,105 @@ static void cftf162(PICOFFTSG_FFTTYPE *a);
 static void cftf081(PICOFFTSG_FFTTYPE *a);
 static void cftf082(PICOFFTSG_FFTTYPE *a);
 
+#if defined(PICOSIMD)
+/* ***********************************************************************************************/
+/* vector kernels */
+/* ***********************************************************************************************/
+/*
+  The passes that make up rdft(PICODSP_FFTSIZE) and dfct_nmf(PICODSP_FFTSIZE/2) have
+  vector versions that give exactly the same results as the scalar code:
+  the twiddle factors the scalar passes compute by recurrence are recorded
+  once by running them on unit impulses (already truncated as Mult_W_W
+  truncates them), and the additions may be reordered as they wrap around
+  like the scalar ones.
+ */
+#define FFTSG_N     PICODSP_FFTSIZE         /* length of the rdft */
+#define FFTSG_NQ    (PICODSP_FFTSIZE >> 2)  /* length of the radix-4 passes of both transforms */
+
+/* set by picofftsg_initialize() once the tables are filled and the CPU has the vector unit */
+static picoos_uint8 fftsgSimd = FALSE;
+static picoos_uint8 fftsgInitialized = FALSE;
+
+/* twiddle factors for fftsg_cmulSimd(): per row, the real parts of all
+   columns followed by the imaginary parts */
+static PICOFFTSG_FFTTYPE fftsgB1stW[4 * (FFTSG_N >> 2)];    /* cftb1st(FFTSG_N), rows 2 and 3 */
+static PICOFFTSG_FFTTYPE fftsgMdl1W[4 * (FFTSG_NQ >> 2)];   /* cftmdl1(FFTSG_NQ), rows 2 and 3 */
+static PICOFFTSG_FFTTYPE fftsgMdl2W[8 * (FFTSG_NQ >> 2)];   /* cftmdl2(FFTSG_NQ), input rows 0 to 3 */
+static PICOFFTSG_FFTTYPE fftsgRftbW[FFTSG_N];               /* rftbsub(FFTSG_N) */
+static PICOFFTSG_FFTTYPE fftsgRftfW16[16];                  /* rftfsub(16) to rftfsub(64) */
+static PICOFFTSG_FFTTYPE fftsgRftfW32[32];
+static PICOFFTSG_FFTTYPE fftsgRftfW64[64];
+
+static PICOSIMD_FN void fftsg_mdl1Simd(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w, picoos_uint8 conj);
+static PICOSIMD_FN void fftsg_mdl2Simd(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w);
+static PICOSIMD_FN void fftsg_f081Simd(PICOFFTSG_FFTTYPE *a);
+static PICOSIMD_FN void fftsg_rftsubSimd(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w);
+static PICOSIMD_FN PICOFFTSG_FFTTYPE fftsg_normSimd(picoos_int32 m2, PICOFFTSG_FFTTYPE *tmpX, PICOFFTSG_FFTTYPE *norm_window);
+static void fftsg_probeMdl(picoos_int32 n, void (*pass)(picoos_int32, PICOFFTSG_FFTTYPE *), PICOFFTSG_FFTTYPE *w);
+static void fftsg_probeMdl2(picoos_int32 n, PICOFFTSG_FFTTYPE *w);
+static void fftsg_probeRft(picoos_int32 n, void (*pass)(picoos_int32, PICOFFTSG_FFTTYPE *), PICOFFTSG_FFTTYPE *w);
+#endif
+
+#if defined(PICO_DSP_FLOAT)
+/* ***********************************************************************************************/
+/* floating point transforms */
+/* ***********************************************************************************************/
+/*
+  irdft_float(), dfct_float() and norm_result_float() compute what rdft(PICODSP_FFTSIZE, -1),
+  dfct_nmf() and norm_result() compute, without the truncations of the fixed point
+  butterflies. The inverse real transform is a complex one of half the length (radix 2,
+  the twiddle factors of each pass stored one after the other so that the inner loops
+  vectorize); the cosine transform is summed up by Clenshaw's recurrence, which costs
+  less than a transform as the signal generator only has the first few of its inputs
+  nonzero. All loops are kept free of branches and of strided stores so that the
+  compiler vectorizes them; together they take about the time of the SIMD fixed point
+  transforms.
+ */
+#define FFTSG_FLT_N     PICODSP_FFTSIZE         /* length of the real transform */
+#define FFTSG_FLT_NH    (PICODSP_FFTSIZE >> 1)  /* length of the complex transform */
+
+static picoos_uint8 fftsgFltInitialized = FALSE;
+static picoos_single fftsgFltCos[FFTSG_FLT_N];  /* cos(2*pi*k/FFTSG_FLT_N) */
+static picoos_single fftsgFltSin[FFTSG_FLT_NH]; /* sin(2*pi*k/FFTSG_FLT_N) */
+/* exp(i*pi*j/h) of the pass that joins transforms of length h, at h-1+j */
+static picoos_single fftsgFltWr[FFTSG_FLT_NH], fftsgFltWi[FFTSG_FLT_NH];
+static picoos_uint8 fftsgFltRev[FFTSG_FLT_NH];  /* bit reversal permutation */
+
+static void fftsg_initFloat(void);
+#endif
+
 /* ***********************************************************************************************/
 /* Exported functions */
 /* ***********************************************************************************************/
+void picofftsg_initialize(void)
+{
+#if defined(PICOSIMD)
+    picopal_global_lock();
+    if (!fftsgInitialized) {
+        fftsgInitialized = TRUE;
+        if (picopal_cpu_features() & PICOSIMD_CPU) {
+            fftsg_probeMdl(FFTSG_N, cftb1st, fftsgB1stW);
+            fftsg_probeMdl(FFTSG_NQ, cftmdl1, fftsgMdl1W);
+            fftsg_probeMdl2(FFTSG_NQ, fftsgMdl2W);
+            fftsg_probeRft(FFTSG_N, rftbsub, fftsgRftbW);
+            fftsg_probeRft(16, rftfsub, fftsgRftfW16);
+            fftsg_probeRft(32, rftfsub, fftsgRftfW32);
+            fftsg_probeRft(64, rftfsub, fftsgRftfW64);
+            fftsgSimd = TRUE;
+        }
+    }
+    picopal_global_unlock();
+#endif
+#if defined(PICO_DSP_FLOAT)
+    picopal_global_lock();
+    if (!fftsgFltInitialized) {
+        fftsg_initFloat();
+        fftsgFltInitialized = TRUE;
+    }
+    picopal_global_unlock();
+#endif
+}
+
 void rdft(picoos_int32 n, picoos_int32 isgn, PICOFFTSG_FFTTYPE *a)
 {
     PICOFFTSG_FFTTYPE xi;
@@ -468,7 +565,14 @@ picoos_single norm_result(picoos_int32 m2, PICOFFTSG_FFTTYPE *tmpX, PICOFFTSG_FF
     PICOFFTSG_FFTTYPE a,b, E;
 
     E = (picoos_int32)0;
-    for (nI=0; nI<m2; nI++) {
+    nI = 0;
+#if defined(PICOSIMD)
+    if (fftsgSimd) {
+        nI = m2 & ~3;
+        E = fftsg_normSimd(nI, tmpX, norm_window);
+    }
+#endif
+    for (; nI<m2; nI++) {
         a = (norm_window[nI]>>18) * ((tmpX[nI]>0) ? tmpX[nI]>>11 : -((-tmpX[nI])>>11));
         tmpX[nI] = a;
         b = (a>=0?a:-a)  >> 18;
@@ -580,6 +684,184 @@ void dfct_nmf(picoos_int32 n, picoos_int32 *a)
 
 }
 
+#if defined(PICO_DSP_FLOAT)
+/**
+ * joins the transforms of length h in xr + i*xi into ones of length 2*h
+ */
+static void fftsg_passFloat(picoos_single *xr, picoos_single *xi, picoos_int32 h)
+{
+    picoos_int32 k, j;
+    picoos_single tr, ti;
+    const picoos_single *wr = fftsgFltWr + h - 1, *wi = fftsgFltWi + h - 1;
+
+    for (k = 0; k < FFTSG_FLT_NH; k += 2 * h) {
+        for (j = 0; j < h; j++) {
+            tr = xr[k + h + j] * wr[j] - xi[k + h + j] * wi[j];
+            ti = xr[k + h + j] * wi[j] + xi[k + h + j] * wr[j];
+            xr[k + h + j] = xr[k + j] - tr;
+            xi[k + h + j] = xi[k + j] - ti;
+            xr[k + j] += tr;
+            xi[k + j] += ti;
+        }
+    }
+}
+
+void irdft_float(picoos_single *a)
+{
+    picoos_int32 m, p, k;
+    picoos_single c, sn, er, ei, dr, di, tr, ti;
+    picoos_single ur[FFTSG_FLT_NH], ui[FFTSG_FLT_NH], xr[FFTSG_FLT_NH], xi[FFTSG_FLT_NH];
+
+    /* with Z[m] = a[2m] - i*a[2m+1] (Z[0] = a[0], Z[n/2] = a[1]), a[k] is
+       the real part of sum_m=0^n/2 Z[m]*exp(2*pi*i*m*k/n), the first and the
+       last term halved; a[2k] + i*a[2k+1] is then the complex transform of
+       length n/2 of U[m] = ((Z[m] + conj(Z[n/2-m])) +
+       i*(Z[m] - conj(Z[n/2-m]))*exp(2*pi*i*m/n)) / 2 */
+    for (m = 0; m < FFTSG_FLT_NH; m++) {
+        xr[m] = a[2 * m];
+        xi[m] = a[2 * m + 1];
+    }
+    ur[0] = 0.5f * (xr[0] + xi[0]);
+    ui[0] = 0.5f * (xr[0] - xi[0]);
+    for (m = 1; m < FFTSG_FLT_NH; m++) {
+        p = FFTSG_FLT_NH - m;
+        er = xr[m] + xr[p];
+        ei = xi[p] - xi[m];
+        dr = xr[m] - xr[p];
+        di = -xi[m] - xi[p];
+        ur[m] = 0.5f * (er - (dr * fftsgFltSin[m] + di * fftsgFltCos[m]));
+        ui[m] = 0.5f * (ei + (dr * fftsgFltCos[m] - di * fftsgFltSin[m]));
+    }
+    for (m = 0; m < FFTSG_FLT_NH; m++) {
+        xr[fftsgFltRev[m]] = ur[m];
+        xi[fftsgFltRev[m]] = ui[m];
+    }
+
+    /* the first two passes at once, their twiddle factors being 1 and i */
+    for (k = 0; k < FFTSG_FLT_NH; k += 4) {
+        er = xr[k] + xr[k + 1];
+        ei = xi[k] + xi[k + 1];
+        dr = xr[k] - xr[k + 1];
+        di = xi[k] - xi[k + 1];
+        tr = xr[k + 2] + xr[k + 3];
+        ti = xi[k + 2] + xi[k + 3];
+        c = xr[k + 2] - xr[k + 3];
+        sn = xi[k + 2] - xi[k + 3];
+        xr[k] = er + tr;
+        xi[k] = ei + ti;
+        xr[k + 2] = er - tr;
+        xi[k + 2] = ei - ti;
+        xr[k + 1] = dr - sn;
+        xi[k + 1] = di + c;
+        xr[k + 3] = dr + sn;
+        xi[k + 3] = di - c;
+    }
+    fftsg_passFloat(xr, xi, 4);
+    fftsg_passFloat(xr, xi, 8);
+    fftsg_passFloat(xr, xi, 16);
+    fftsg_passFloat(xr, xi, 32);
+    fftsg_passFloat(xr, xi, 64);
+
+    for (k = 0; k < FFTSG_FLT_NH; k++) {
+        a[2 * k] = xr[k];
+        a[2 * k + 1] = xi[k];
+    }
+}
+
+void dfct_float(picoos_int32 n, picoos_int32 nz, picoos_single *a)
+{
+    picoos_int32 i, k, nh, step;
+    picoos_single ae, ao, a0, a1, t;
+    picoos_single x[FFTSG_FLT_NH / 2 + 1], y2[FFTSG_FLT_NH / 2 + 1];
+    picoos_single e1[FFTSG_FLT_NH / 2 + 1], e2[FFTSG_FLT_NH / 2 + 1];
+    picoos_single o1[FFTSG_FLT_NH / 2 + 1], o2[FFTSG_FLT_NH / 2 + 1];
+
+    /* a[nz..n] are 0; C[k] = sum_j=0^nz-1 a[j]*cos(pi*j*k/n) = E[k] + O[k],
+       the sums over the even and the odd j, and C[n-k] = E[k] - O[k]. With
+       x = cos(pi*k/n) and y = 2*x*x - 1, cos(pi*j*k/n) = T_j(x), and both
+       T_2i(x) and T_2i+1(x) follow phi_i+1 = 2*y*phi_i - phi_i-1, so that E
+       and O are Clenshaw's recurrence in y over half of the terms, for half
+       of the k */
+    nh = n >> 1;
+    step = FFTSG_FLT_NH / n;
+    for (k = 0; k <= nh; k++) {
+        x[k] = fftsgFltCos[k * step];
+        y2[k] = 2 * fftsgFltCos[2 * k * step];
+        e1[k] = e2[k] = o1[k] = o2[k] = 0;
+    }
+    for (i = (nz - 1) >> 1; i > 0; i--) {
+        ae = a[2 * i];
+        ao = (2 * i + 1 < nz) ? a[2 * i + 1] : 0;
+        for (k = 0; k <= nh; k++) {
+            t = ae + y2[k] * e1[k] - e2[k];
+            e2[k] = e1[k];
+            e1[k] = t;
+            t = ao + y2[k] * o1[k] - o2[k];
+            o2[k] = o1[k];
+            o1[k] = t;
+        }
+    }
+    /* E = b0 - y*b1 and O = x*(b0 - b1) with b0 the last step */
+    a0 = a[0];
+    a1 = (nz > 1) ? a[1] : 0;
+    for (k = 0; k <= nh; k++) {
+        e2[k] = a0 + 0.5f * y2[k] * e1[k] - e2[k];
+        o2[k] = x[k] * (a1 + y2[k] * o1[k] - o2[k] - o1[k]);
+    }
+    for (k = 0; k <= nh; k++) {
+        a[k] = e2[k] + o2[k];
+        a[n - k] = e2[k] - o2[k];
+    }
+}
+
+picoos_single norm_result_float(picoos_int32 m2, picoos_single *tmpX, const picoos_int32 *norm_window)
+{
+    picoos_int16 nI;
+    picoos_single a, b, E;
+
+    E = 0;
+    for (nI = 0; nI < m2; nI++) {
+        a = (picoos_single) norm_window[nI] * tmpX[nI] * (1.0f / (1 << 29));
+        tmpX[nI] = a;
+        b = a * (1.0f / (1 << 18));
+        E += b * b;
+    }
+
+    if (E > 0) {
+        return (picoos_single) sqrt((double) E / 16.0) / m2;
+    } else {
+        return 0.0;
+    }
+}
+
+/**
+ * fills the tables of the floating point transforms
+ */
+static void fftsg_initFloat(void)
+{
+    picoos_int32 k, h, j, r, b;
+
+    for (k = 0; k < FFTSG_FLT_N; k++) {
+        fftsgFltCos[k] = (picoos_single) cos(2.0 * PICODSP_M_PI * k / FFTSG_FLT_N);
+    }
+    for (k = 0; k < FFTSG_FLT_NH; k++) {
+        fftsgFltSin[k] = (picoos_single) sin(2.0 * PICODSP_M_PI * k / FFTSG_FLT_N);
+    }
+    for (h = 1; h < FFTSG_FLT_NH; h <<= 1) {
+        for (j = 0; j < h; j++) {
+            fftsgFltWr[h - 1 + j] = (picoos_single) cos(PICODSP_M_PI * j / h);
+            fftsgFltWi[h - 1 + j] = (picoos_single) sin(PICODSP_M_PI * j / h);
+        }
+    }
+    for (k = 0; k < FFTSG_FLT_NH; k++) {
+        for (r = 0, b = 1; b < FFTSG_FLT_NH; b <<= 1) {
+            r = (r << 1) | ((k & b) ? 1 : 0);
+        }
+        fftsgFltRev[k] = (picoos_uint8) r;
+    }
+}
+#endif /* PICO_DSP_FLOAT */
+
 /* ***********************************************************************************************/
 /* internal routines */
 /* ***********************************************************************************************/
@@ -1709,6 +1991,13 @@ void cftb1st(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
         wd1r, wd1i, wd3r, wd3i, ss1, ss3;
     PICOFFTSG_FFTTYPE x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 
+#if defined(PICOSIMD)
+    if (fftsgSimd && (n == FFTSG_N)) {
+        fftsg_mdl1Simd(n, a, fftsgB1stW, TRUE);
+        return;
+    }
+#endif
+
     mh = n >> 3;
     m = 2 * mh;
     j1 = m;
@@ -2036,6 +2325,13 @@ void cftmdl1(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
         wd1r, wd1i, wd3r, wd3i, ss1, ss3;
     PICOFFTSG_FFTTYPE x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 
+#if defined(PICOSIMD)
+    if (fftsgSimd && (n == FFTSG_NQ)) {
+        fftsg_mdl1Simd(n, a, fftsgMdl1W, FALSE);
+        return;
+    }
+#endif
+
     mh = n >> 3;
     m = 2 * mh;
     j1 = m;
@@ -2251,6 +2547,13 @@ void cftmdl2(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
         we1r, we1i, we3r, we3i, ss1, ss3;
     PICOFFTSG_FFTTYPE x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i, y0r, y0i, y2r, y2i;
 
+#if defined(PICOSIMD)
+    if (fftsgSimd && (n == FFTSG_NQ)) {
+        fftsg_mdl2Simd(n, a, fftsgMdl2W);
+        return;
+    }
+#endif
+
     mh = n >> 3;
     m = 2 * mh;
     wn4r = WR5000;
@@ -2874,6 +3177,13 @@ void cftf081(PICOFFTSG_FFTTYPE *a)
         y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i,
         y4r, y4i, y5r, y5i, y6r, y6i, y7r, y7i;
 
+#if defined(PICOSIMD)
+    if (fftsgSimd) {
+        fftsg_f081Simd(a);
+        return;
+    }
+#endif
+
     wn4r = WR5000;
     x0r = a[0] + a[8];
     x0i = a[1] + a[9];
@@ -3066,6 +3376,13 @@ void rftfsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
     picoos_int32 i, i0, j, k;
     PICOFFTSG_FFTTYPE w1r, w1i, wkr, wki, wdr, wdi, ss, xr, xi, yr, yi;
 
+#if defined(PICOSIMD)
+    if (fftsgSimd && (n >= 16) && (n <= 64)) {
+        fftsg_rftsubSimd(n, a, (n == 16) ? fftsgRftfW16 : ((n == 32) ? fftsgRftfW32 : fftsgRftfW64));
+        return;
+    }
+#endif
+
     wkr = 0;
     wki = 0;
 
@@ -3143,6 +3460,13 @@ void rftbsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
 {
     picoos_int32 i, i0, j, k;
     PICOFFTSG_FFTTYPE w1r, w1i, wkr, wki, wdr, wdi, ss, xr, xi, yr, yi;
+#if defined(PICOSIMD)
+    if (fftsgSimd && (n == FFTSG_N)) {
+        fftsg_rftsubSimd(n, a, fftsgRftbW);
+        return;
+    }
+#endif
+
     wkr = 0;
     wki = 0;
     wdi=(PICOFFTSG_FFTTYPE)(0.012270614505*PICODSP_WGT_SHIFT);
@@ -3269,6 +3593,308 @@ void dctsub4(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
     a[m] = Mult_W_W(wki, a[m]);
 }
 
+#if defined(PICOSIMD)
+/* ***********************************************************************************************/
+/* vector kernels */
+/* ***********************************************************************************************/
+/* x * w for the two complex numbers in 'x', with wr[0..3] the real and
+   wi[0..3] the signed imaginary parts of the (pre-truncated) twiddles;
+   the products truncate 'x' as Mult_W_W does */
+static PICOSIMD_FN picosimd_int32x4 fftsg_cmulSimd(picosimd_int32x4 x, const PICOFFTSG_FFTTYPE *wr, const PICOFFTSG_FFTTYPE *wi)
+{
+    picosimd_int32x4 t;
+
+    t = PICOSIMD_SHR_TZ(x, 14);
+    return PICOSIMD_ADD(PICOSIMD_MUL(t, PICOSIMD_LOAD(wr)), PICOSIMD_MUL(PICOSIMD_SWAP_PAIRS(t), PICOSIMD_LOAD(wi)));
+}
+
+/* i * x for the two complex numbers in 'x' */
+static PICOSIMD_FN picosimd_int32x4 fftsg_mulISimd(picosimd_int32x4 x)
+{
+    picosimd_int32x4 m;
+
+    m = PICOSIMD_SET(-1, 0, -1, 0);
+    return PICOSIMD_NEG_MASK(PICOSIMD_SWAP_PAIRS(x), m);
+}
+
+/* the lower complex of 'x' and i times the upper one */
+static PICOSIMD_FN picosimd_int32x4 fftsg_mulIHighSimd(picosimd_int32x4 x)
+{
+    picosimd_int32x4 m;
+
+    m = PICOSIMD_SET(0, 0, -1, 0);
+    return PICOSIMD_NEG_MASK(PICOSIMD_SWAP_HIGH_PAIR(x), m);
+}
+
+/* radix-4 pass of cftmdl1 (or of cftb1st, which works on the conjugate
+   input, if 'conj' is set) */
+static PICOSIMD_FN void fftsg_mdl1Simd(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w, picoos_uint8 conj)
+{
+    picoos_int32 j, m, mh;
+    PICOFFTSG_FFTTYPE *a0, *a1, *a2, *a3;
+    PICOFFTSG_FFTTYPE x0r, x0i, c0[2][4], cm[2][4];
+    picosimd_int32x4 cj, x0, x1, x2, x3, y0, y1, y2, y3;
+
+    m = n >> 2;
+    mh = m >> 1;
+    a0 = a;
+    a1 = a0 + m;
+    a2 = a1 + m;
+    a3 = a2 + m;
+    cj = conj ? PICOSIMD_SET(0, -1, 0, -1) : PICOSIMD_DUP(0);
+    for (j = 0; j < m; j += 4) {
+        y0 = PICOSIMD_NEG_MASK(PICOSIMD_LOAD(a0 + j), cj);
+        y1 = PICOSIMD_NEG_MASK(PICOSIMD_LOAD(a1 + j), cj);
+        y2 = PICOSIMD_NEG_MASK(PICOSIMD_LOAD(a2 + j), cj);
+        y3 = PICOSIMD_NEG_MASK(PICOSIMD_LOAD(a3 + j), cj);
+        x0 = PICOSIMD_ADD(y0, y2);
+        x1 = PICOSIMD_SUB(y0, y2);
+        x2 = PICOSIMD_ADD(y1, y3);
+        x3 = fftsg_mulISimd(PICOSIMD_SUB(y1, y3));
+        PICOSIMD_STORE(a0 + j, PICOSIMD_ADD(x0, x2));
+        PICOSIMD_STORE(a1 + j, PICOSIMD_SUB(x0, x2));
+        x0 = PICOSIMD_ADD(x1, x3);
+        x1 = PICOSIMD_SUB(x1, x3);
+        if (j == 0) {
+            PICOSIMD_STORE(c0[0], x0);
+            PICOSIMD_STORE(c0[1], x1);
+        } else if (j == mh) {
+            PICOSIMD_STORE(cm[0], x0);
+            PICOSIMD_STORE(cm[1], x1);
+        }
+        PICOSIMD_STORE(a2 + j, fftsg_cmulSimd(x0, w + j, w + m + j));
+        PICOSIMD_STORE(a3 + j, fftsg_cmulSimd(x1, w + 2 * m + j, w + 3 * m + j));
+    }
+
+    /* the first column is not rotated, the middle one by pi/4 */
+    a2[0] = c0[0][0];
+    a2[1] = c0[0][1];
+    a3[0] = c0[1][0];
+    a3[1] = c0[1][1];
+    x0r = cm[0][0];
+    x0i = cm[0][1];
+    a2[mh] = picofftsg_mult_w_a(WR5000, (x0r - x0i));
+    a2[mh + 1] = picofftsg_mult_w_a(WR5000, (x0i + x0r));
+    x0r = cm[1][0];
+    x0i = cm[1][1];
+    a3[mh] = -picofftsg_mult_w_a(WR5000, (x0r + x0i));
+    a3[mh + 1] = -picofftsg_mult_w_a(WR5000, (x0i - x0r));
+}
+
+/* radix-4 pass of cftmdl2 */
+static PICOSIMD_FN void fftsg_mdl2Simd(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w)
+{
+    picoos_int32 j, m;
+    PICOFFTSG_FFTTYPE *a0, *a1, *a2, *a3;
+    PICOFFTSG_FFTTYPE x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i, y0r, y0i, c0[4][4];
+    picosimd_int32x4 x0, x1, x2, x3, y0, y1, y2, y3;
+
+    m = n >> 2;
+    a0 = a;
+    a1 = a0 + m;
+    a2 = a1 + m;
+    a3 = a2 + m;
+    for (j = 0; j < m; j += 4) {
+        y0 = PICOSIMD_LOAD(a0 + j);
+        y1 = PICOSIMD_LOAD(a1 + j);
+        y2 = fftsg_mulISimd(PICOSIMD_LOAD(a2 + j));
+        y3 = fftsg_mulISimd(PICOSIMD_LOAD(a3 + j));
+        x0 = PICOSIMD_ADD(y0, y2);
+        x1 = PICOSIMD_SUB(y0, y2);
+        x2 = PICOSIMD_ADD(y1, y3);
+        x3 = PICOSIMD_SUB(y1, y3);
+        if (j == 0) {
+            PICOSIMD_STORE(c0[0], x0);
+            PICOSIMD_STORE(c0[1], x1);
+            PICOSIMD_STORE(c0[2], x2);
+            PICOSIMD_STORE(c0[3], x3);
+        }
+        y0 = fftsg_cmulSimd(x0, w + j, w + m + j);
+        y2 = fftsg_cmulSimd(x2, w + 2 * m + j, w + 3 * m + j);
+        PICOSIMD_STORE(a0 + j, PICOSIMD_ADD(y0, y2));
+        PICOSIMD_STORE(a1 + j, PICOSIMD_SUB(y0, y2));
+        y0 = fftsg_cmulSimd(x1, w + 4 * m + j, w + 5 * m + j);
+        y2 = fftsg_cmulSimd(x3, w + 6 * m + j, w + 7 * m + j);
+        PICOSIMD_STORE(a2 + j, PICOSIMD_ADD(y0, y2));
+        PICOSIMD_STORE(a3 + j, PICOSIMD_SUB(y0, y2));
+    }
+
+    /* the first column rotates the sums by pi/4 */
+    x0r = c0[0][0];
+    x0i = c0[0][1];
+    x1r = c0[1][0];
+    x1i = c0[1][1];
+    x2r = c0[2][0];
+    x2i = c0[2][1];
+    x3r = c0[3][0];
+    x3i = c0[3][1];
+    y0r = picofftsg_mult_w_a(WR5000, (x2r - x2i));
+    y0i = picofftsg_mult_w_a(WR5000, (x2i + x2r));
+    a0[0] = x0r + y0r;
+    a0[1] = x0i + y0i;
+    a1[0] = x0r - y0r;
+    a1[1] = x0i - y0i;
+    y0r = picofftsg_mult_w_a(WR5000, (x3r - x3i));
+    y0i = picofftsg_mult_w_a(WR5000, (x3i + x3r));
+    a2[0] = x1r - y0i;
+    a2[1] = x1i + y0r;
+    a3[0] = x1r + y0i;
+    a3[1] = x1i - y0r;
+}
+
+/* cftf081, with the even and odd elements of each 4-point butterfly in
+   the lower and upper half of a vector */
+static PICOSIMD_FN void fftsg_f081Simd(PICOFFTSG_FFTTYPE *a)
+{
+    picosimd_int32x4 x0, x1, x2, x3, y0, y1, y2, y3, h, s, d;
+
+    x0 = PICOSIMD_LOAD(a);
+    x1 = PICOSIMD_LOAD(a + 4);
+    x2 = PICOSIMD_LOAD(a + 8);
+    x3 = PICOSIMD_LOAD(a + 12);
+    y0 = PICOSIMD_ADD(x0, x2);
+    y1 = PICOSIMD_SUB(x0, x2);
+    y2 = PICOSIMD_ADD(x1, x3);
+    y3 = fftsg_mulISimd(PICOSIMD_SUB(x1, x3));
+    x0 = PICOSIMD_ADD(y0, y2);          /* y0, y4 */
+    x2 = PICOSIMD_SUB(y0, y2);          /* y2, y6 */
+    x1 = PICOSIMD_ADD(y1, y3);          /* y1, and y5 before the rotation */
+    x3 = PICOSIMD_SUB(y1, y3);          /* y3, and y7 before the rotation */
+
+    /* y5, y7: rotated by pi/4 */
+    h = PICOSIMD_HIGH_HALVES(x1, x3);
+    h = PICOSIMD_ADD(h, fftsg_mulISimd(h));
+    h = PICOSIMD_MUL(PICOSIMD_SHR_TZ(h, 14), PICOSIMD_DUP(WR5000 >> 15));
+
+    y0 = PICOSIMD_LOW_HALVES(x0, x2);
+    y2 = fftsg_mulIHighSimd(PICOSIMD_HIGH_HALVES(x0, x2));
+    s = PICOSIMD_ADD(y0, y2);
+    d = PICOSIMD_SUB(y0, y2);
+    PICOSIMD_STORE(a, PICOSIMD_LOW_HALVES(s, d));
+    PICOSIMD_STORE(a + 4, PICOSIMD_HIGH_HALVES(s, d));
+
+    y1 = PICOSIMD_LOW_HALVES(x1, x3);
+    y3 = fftsg_mulIHighSimd(h);
+    s = PICOSIMD_ADD(y1, y3);
+    d = PICOSIMD_SUB(y1, y3);
+    PICOSIMD_STORE(a + 8, PICOSIMD_LOW_HALVES(s, d));
+    PICOSIMD_STORE(a + 12, PICOSIMD_HIGH_HALVES(s, d));
+}
+
+/* rftfsub / rftbsub; the lower half of the spectrum is taken two
+   complex at a time together with its mirror image in the upper half */
+static PICOSIMD_FN void fftsg_rftsubSimd(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w)
+{
+    picoos_int32 j, k, m;
+    PICOFFTSG_FFTTYPE xr, xi, yr, yi;
+    picosimd_int32x4 cj, x, y, aj, ak;
+
+    m = n >> 1;
+    cj = PICOSIMD_SET(0, -1, 0, -1);
+    for (j = 4; j < m; j += 4) {
+        k = n - j - 2;
+        aj = PICOSIMD_LOAD(a + j);
+        ak = PICOSIMD_SWAP_HALVES(PICOSIMD_LOAD(a + k));
+        x = PICOSIMD_SUB(aj, PICOSIMD_NEG_MASK(ak, cj));
+        y = fftsg_cmulSimd(x, w + j, w + m + j);
+        PICOSIMD_STORE(a + j, PICOSIMD_SUB(aj, y));
+        PICOSIMD_STORE(a + k, PICOSIMD_SWAP_HALVES(PICOSIMD_ADD(ak, PICOSIMD_NEG_MASK(y, cj))));
+    }
+
+    xr = a[2] - a[n - 2];
+    xi = a[3] + a[n - 1];
+    xr = xr>=0 ? xr>>14 : -((-xr)>>14);
+    xi = xi>=0 ? xi>>14 : -((-xi)>>14);
+    yr = w[2] * xr + w[m + 2] * xi;
+    yi = w[3] * xi + w[m + 3] * xr;
+    a[2] -= yr;
+    a[3] -= yi;
+    a[n - 2] += yr;
+    a[n - 1] -= yi;
+}
+
+/* the vector part of norm_result; 'm2' is a multiple of 4 */
+static PICOSIMD_FN PICOFFTSG_FFTTYPE fftsg_normSimd(picoos_int32 m2, PICOFFTSG_FFTTYPE *tmpX, PICOFFTSG_FFTTYPE *norm_window)
+{
+    picoos_int32 nI;
+    picosimd_int32x4 a, b, e;
+
+    e = PICOSIMD_DUP(0);
+    for (nI = 0; nI < m2; nI += 4) {
+        a = PICOSIMD_SHR_TZ(PICOSIMD_LOAD(tmpX + nI), 11);
+        a = PICOSIMD_MUL(PICOSIMD_SRA(PICOSIMD_LOAD(norm_window + nI), 18), a);
+        PICOSIMD_STORE(tmpX + nI, a);
+        b = PICOSIMD_SRA(PICOSIMD_ABS(a), 18);
+        e = PICOSIMD_ADD(e, PICOSIMD_MUL(b, b));
+    }
+    return PICOSIMD_HSUM(e);
+}
+
+/* the twiddle factors in the format of fftsg_cmulSimd() for complex 'c'
+   of a row of 'm' values, from the result 'pr' + i*'pi' the pass gave for
+   a (truncated) unit input */
+static void fftsg_setTwiddle(PICOFFTSG_FFTTYPE *w, picoos_int32 m, picoos_int32 c, PICOFFTSG_FFTTYPE pr, PICOFFTSG_FFTTYPE pi)
+{
+    w[2 * c] = pr;
+    w[2 * c + 1] = pr;
+    w[m + 2 * c] = -pi;
+    w[m + 2 * c + 1] = pi;
+}
+
+static void fftsg_probeMdl(picoos_int32 n, void (*pass)(picoos_int32, PICOFFTSG_FFTTYPE *), PICOFFTSG_FFTTYPE *w)
+{
+    picoos_int32 c, m;
+    PICOFFTSG_FFTTYPE probe[FFTSG_N];
+
+    m = n >> 2;
+    picoos_mem_set(probe, 0, n * sizeof(probe[0]));
+    for (c = 0; c < m; c += 2) {
+        probe[c] = 1 << 14;
+    }
+    pass(n, probe);
+    for (c = 0; c < m; c += 2) {
+        fftsg_setTwiddle(w, m, c >> 1, probe[2 * m + c], probe[2 * m + c + 1]);
+        fftsg_setTwiddle(w + 2 * m, m, c >> 1, probe[3 * m + c], probe[3 * m + c + 1]);
+    }
+}
+
+static void fftsg_probeMdl2(picoos_int32 n, PICOFFTSG_FFTTYPE *w)
+{
+    picoos_int32 c, m, row;
+    PICOFFTSG_FFTTYPE probe[FFTSG_N];
+
+    m = n >> 2;
+    for (row = 0; row < 2; row++) {
+        picoos_mem_set(probe, 0, n * sizeof(probe[0]));
+        for (c = 0; c < m; c += 2) {
+            probe[row * m + c] = 1 << 14;
+        }
+        cftmdl2(n, probe);
+        for (c = 0; c < m; c += 2) {
+            fftsg_setTwiddle(w + 2 * row * m, m, c >> 1, probe[c], probe[c + 1]);
+            fftsg_setTwiddle(w + (4 + 2 * row) * m, m, c >> 1, probe[2 * m + c], probe[2 * m + c + 1]);
+        }
+    }
+}
+
+static void fftsg_probeRft(picoos_int32 n, void (*pass)(picoos_int32, PICOFFTSG_FFTTYPE *), PICOFFTSG_FFTTYPE *w)
+{
+    picoos_int32 j, m;
+    PICOFFTSG_FFTTYPE probe[FFTSG_N];
+
+    m = n >> 1;
+    picoos_mem_set(probe, 0, n * sizeof(probe[0]));
+    for (j = 2; j < m; j += 2) {
+        probe[j] = 1 << 14;
+    }
+    pass(n, probe);
+    /* the mirror image received the conjugate of the rotated input */
+    for (j = 2; j < m; j += 2) {
+        fftsg_setTwiddle(w, m, j >> 1, probe[n - j], -probe[n - j + 1]);
+    }
+}
+#endif /* PICOSIMD */
+
 #ifdef __cplusplus
 }
 #endif
@@ -42,11 +42,24 @@ extern "C" {
 
 #define PICOFFTSG_FFTTYPE picoos_int32
 
+/* chooses between the scalar and the vector transforms for this
+   processor; call before any transform. It is cheap after the first
+   call and safe to call from several threads. */
+extern void picofftsg_initialize(void);
+
 extern void rdft(int n, int isgn, PICOFFTSG_FFTTYPE *a);
 extern void dfct(int n, float *a, int VAL_SHIFT);
 extern void dfct_nmf(int n, int *a);
 extern float norm_result(int m2, PICOFFTSG_FFTTYPE *tmpX, PICOFFTSG_FFTTYPE *norm_window);
 
+#if defined(PICO_DSP_FLOAT)
+/* the same transforms in floating point, for the signal generator of
+   the PICO_DSP_FLOAT build; n is at most PICODSP_FFTSIZE */
+extern void irdft_float(picoos_single *a);
+extern void dfct_float(picoos_int32 n, picoos_int32 nz, picoos_single *a);
+extern picoos_single norm_result_float(picoos_int32 m2, picoos_single *tmpX, const picoos_int32 *norm_window);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
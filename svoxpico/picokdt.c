@@ -237,6 +237,28 @@ typedef enum {
  *  derived from : picoknow_KnowledgeBase
  */
 
+/* node of a compiled tree (see picokdt_compileDt) */
+typedef struct {
+    picoos_uint8 type;       /* kdt_nodetypes_t */
+    picoos_uint8 question;   /* attribute asked */
+    picoos_uint16 nrforks;   /* 0 if asking the node fails */
+    picoos_uint32 nrvals;    /* discrete: size of its value to fork table */
+    picoos_int32 arg;        /* continuous: threshold; discrete: start of
+                                its value to fork table in forktab */
+    picoos_uint32 forks;     /* start of its forks in forks; a fork is
+                                (node << 1) or (decision << 1) | 1 */
+} kdt_node_t;
+
+/* compiled tree */
+typedef struct {
+    kdt_node_t *nodes;          /* NULL if not compiled (yet) */
+    picoos_uint32 *forks;
+    picoos_uint8 *forktab;
+    picoos_uint32 nrnodes;      /* 0 if not counted (yet) */
+    picoos_uint32 nrforks;
+    picoos_uint32 nrforktab;
+} kdt_compiled_t;
+
 /* subobj shared by all decision trees */
 typedef struct {
     picokdt_kdttype_t type;
@@ -250,49 +272,37 @@ typedef struct {
     picoos_uint8 *qfields;
     picoos_uint8  nrattributes;
     picoos_uint8 *treebody;
+    picoos_uint32 treebodysize;
+
+    /* the tree body is walked unless compiled.nodes is set */
+    kdt_compiled_t compiled;
     /*picoos_uint8  nrvfields;*/  /* fix PICOKDT_NODEINFO_NRVFIELDS */
     /*picoos_uint8  nrqfields;*/  /* fix PICOKDT_NODEINFO_NRQFIELDS */
-
-    /* direct output vector (no output mapping) */
-    picoos_uint8 dset;    /* TRUE if class set, FALSE otherwise */
-    picoos_uint16 dclass;
 } kdt_subobj_t;
 
 /* subobj specific for each decision tree type */
 typedef struct {
     kdt_subobj_t dt;
-    picoos_uint16 invec[PICOKDT_NRATT_POSP];    /* input vector */
-    picoos_uint8 inveclen;  /* nr of ele set in invec; must be =nrattributes */
 } kdtposp_subobj_t;
 
 typedef struct {
     kdt_subobj_t dt;
-    picoos_uint16 invec[PICOKDT_NRATT_POSD];    /* input vector */
-    picoos_uint8 inveclen;  /* nr of ele set in invec; must be =nrattributes */
 } kdtposd_subobj_t;
 
 typedef struct {
     kdt_subobj_t dt;
-    picoos_uint16 invec[PICOKDT_NRATT_G2P];    /* input vector */
-    picoos_uint8 inveclen;  /* nr of ele set in invec; must be =nrattributes */
 } kdtg2p_subobj_t;
 
 typedef struct {
     kdt_subobj_t dt;
-    picoos_uint16 invec[PICOKDT_NRATT_PHR];    /* input vector */
-    picoos_uint8 inveclen;  /* nr of ele set in invec; must be =nrattributes */
 } kdtphr_subobj_t;
 
 typedef struct {
     kdt_subobj_t dt;
-    picoos_uint16 invec[PICOKDT_NRATT_ACC];    /* input vector */
-    picoos_uint8 inveclen;  /* nr of ele set in invec; must be =nrattributes */
 } kdtacc_subobj_t;
 
 typedef struct {
     kdt_subobj_t dt;
-    picoos_uint16 invec[PICOKDT_NRATT_PAM];    /* input vector */
-    picoos_uint8 inveclen;  /* nr of ele set in invec; must be =nrattributes */
 } kdtpam_subobj_t;
 
 
@@ -369,6 +379,11 @@ static pico_status_t kdtDtInitialize(register picoknow_KnowledgeBase this,
         dtp->nrattributes = dtp->tree[PICOKDT_NIPOS_NRATTS];
         dtp->treebody = dtp->qfields + 4 +
             (dtp->nrattributes * PICOKDT_NODEINFO_NRQFIELDS); /* TREEBODYSIZE4*/
+        curpos = 0;
+        picoos_read_mem_pi_uint32(dtp->treebody - 4, &curpos,
+                                  &dtp->treebodysize);
+        dtp->compiled.nodes = NULL;
+        dtp->compiled.nrnodes = 0;
 
         /*dtp->nrvfields = dtp->tree[PICOKDT_NIPOS_NRVFIELDS]; <- is fix */
         /*dtp->nrqfields = dtp->tree[PICOKDT_NIPOS_NRQFIELDS]; <- is fix */
@@ -381,8 +396,6 @@ static pico_status_t kdtDtInitialize(register picoknow_KnowledgeBase this,
             return picoos_emRaiseException(common->em, PICO_EXC_FILE_CORRUPT,
                                            NULL, NULL);
         }
-        dtp->dset = 0;
-        dtp->dclass = 0;
         PICODBG_DEBUG(("tree init: nratt: %d, posomt: %d, postree: %d",
                        dtp->nrattributes, (dtp->outmaptable - dtp->inpmaptable),
                        (dtp->tree - dtp->inpmaptable)));
@@ -433,7 +446,6 @@ static pico_status_t kdtPosPInitialize(register picoknow_KnowledgeBase this,
     pico_status_t status;
     kdtposp_subobj_t *dtposp;
     kdt_subobj_t *dt;
-    picoos_uint8 i;
 
     if (NULL == this || NULL == this->subObj) {
         return picoos_emRaiseException(common->em, PICO_EXC_KB_MISSING,
@@ -451,11 +463,6 @@ static pico_status_t kdtPosPInitialize(register picoknow_KnowledgeBase this,
         return status;
     }
 
-    /* init specialized subobj part */
-    for (i = 0; i < PICOKDT_NRATT_POSP; i++) {
-        dtposp->invec[i] = 0;
-    }
-    dtposp->inveclen = 0;
     PICODBG_DEBUG(("posp tree initialized"));
     return PICO_OK;
 }
@@ -466,7 +473,6 @@ static pico_status_t kdtPosDInitialize(register picoknow_KnowledgeBase this,
     pico_status_t status;
     kdtposd_subobj_t *dtposd;
     kdt_subobj_t *dt;
-    picoos_uint8 i;
 
     if (NULL == this || NULL == this->subObj) {
         return picoos_emRaiseException(common->em, PICO_EXC_KB_MISSING,
@@ -484,11 +490,6 @@ static pico_status_t kdtPosDInitialize(register picoknow_KnowledgeBase this,
         return status;
     }
 
-    /* init spezialized subobj part */
-    for (i = 0; i < PICOKDT_NRATT_POSD; i++) {
-        dtposd->invec[i] = 0;
-    }
-    dtposd->inveclen = 0;
     PICODBG_DEBUG(("posd tree initialized"));
     return PICO_OK;
 }
@@ -499,7 +500,6 @@ static pico_status_t kdtG2PInitialize(register picoknow_KnowledgeBase this,
     pico_status_t status;
     kdtg2p_subobj_t *dtg2p;
     kdt_subobj_t *dt;
-    picoos_uint8 i;
 
     if (NULL == this || NULL == this->subObj) {
         return picoos_emRaiseException(common->em, PICO_EXC_KB_MISSING,
@@ -518,11 +518,6 @@ static pico_status_t kdtG2PInitialize(register picoknow_KnowledgeBase this,
         return status;
     }
 
-    /* init spezialized subobj part */
-    for (i = 0; i < PICOKDT_NRATT_G2P; i++) {
-        dtg2p->invec[i] = 0;
-    }
-    dtg2p->inveclen = 0;
     PICODBG_DEBUG(("g2p tree initialized"));
     return PICO_OK;
 }
@@ -533,7 +528,6 @@ static pico_status_t kdtPhrInitialize(register picoknow_KnowledgeBase this,
     pico_status_t status;
     kdtphr_subobj_t *dtphr;
     kdt_subobj_t *dt;
-    picoos_uint8 i;
 
     if (NULL == this || NULL == this->subObj) {
         return picoos_emRaiseException(common->em, PICO_EXC_KB_MISSING,
@@ -552,11 +546,6 @@ static pico_status_t kdtPhrInitialize(register picoknow_KnowledgeBase this,
         return status;
     }
 
-    /* init spezialized subobj part */
-    for (i = 0; i < PICOKDT_NRATT_PHR; i++) {
-        dtphr->invec[i] = 0;
-    }
-    dtphr->inveclen = 0;
     PICODBG_DEBUG(("phr tree initialized"));
     return PICO_OK;
 }
@@ -567,7 +556,6 @@ static pico_status_t kdtAccInitialize(register picoknow_KnowledgeBase this,
     pico_status_t status;
     kdtacc_subobj_t *dtacc;
     kdt_subobj_t *dt;
-    picoos_uint8 i;
 
     if (NULL == this || NULL == this->subObj) {
         return picoos_emRaiseException(common->em, PICO_EXC_KB_MISSING,
@@ -586,11 +574,6 @@ static pico_status_t kdtAccInitialize(register picoknow_KnowledgeBase this,
         return status;
     }
 
-    /* init spezialized subobj part */
-    for (i = 0; i < PICOKDT_NRATT_ACC; i++) {
-        dtacc->invec[i] = 0;
-    }
-    dtacc->inveclen = 0;
     PICODBG_DEBUG(("acc tree initialized"));
     return PICO_OK;
 }
@@ -601,7 +584,6 @@ static pico_status_t kdtPamInitialize(register picoknow_KnowledgeBase this,
     pico_status_t status;
     kdtpam_subobj_t *dtpam;
     kdt_subobj_t *dt;
-    picoos_uint8 i;
 
     if (NULL == this || NULL == this->subObj) {
         return picoos_emRaiseException(common->em, PICO_EXC_KB_MISSING,
@@ -620,11 +602,6 @@ static pico_status_t kdtPamInitialize(register picoknow_KnowledgeBase this,
         return status;
     }
 
-    /* init spezialized subobj part */
-    for (i = 0; i < PICOKDT_NRATT_PAM; i++) {
-        dtpam->invec[i] = 0;
-    }
-    dtpam->inveclen = 0;
     PICODBG_DEBUG(("pam tree initialized"));
     return PICO_OK;
 }
@@ -996,7 +973,7 @@ static picoos_uint32 kdtGetShiftVal(register kdt_subobj_t *this,
    Notes   :
 */
 static picoos_int8 kdtAskTree(register kdt_subobj_t *this,
-                              picoos_uint16 *invec,
+                              picokdt_DtState state,
                               const kdt_nratt_t invecmax,
                               picoos_uint32 *iByteNo,
                               picoos_int8 *iBitNo) {
@@ -1020,9 +997,9 @@ static picoos_int8 kdtAskTree(register kdt_subobj_t *this,
     /* check of vfields argument done in initialize */
     iQuestion = kdtGetShiftVal(this, this->vfields[eQuestion], iByteNo, iBitNo);
     if ((iQuestion < this->nrattributes) && (iQuestion < invecmax)) {
-        iVal = invec[iQuestion];
+        iVal = state->invec[iQuestion];
     } else {
-        this->dset = FALSE;
+        state->dset = FALSE;
         PICODBG_TRACE(("invalid question"));
         return -1;    /* iQuestion invalid */
     }
@@ -1174,7 +1151,7 @@ static picoos_int8 kdtAskTree(register kdt_subobj_t *this,
                     kdtGetShiftVal(this, kdtGetQFieldsVal(this, iQuestion, eJump),
                                    iByteNo, iBitNo);
                 kdt_jump(iJump, iByteNo, iBitNo);
-                this->dset = FALSE;
+                state->dset = FALSE;
                 return 1;    /* to be continued, no solution yet found */
             } else {
                 kdt_jump(kdtGetQFieldsVal(this, iQuestion, eJump),
@@ -1185,8 +1162,8 @@ static picoos_int8 kdtAskTree(register kdt_subobj_t *this,
                 /* check of vfields argument done in initialize */
                 iDecision = kdtGetShiftVal(this, this->vfields[eDecide],
                                            iByteNo, iBitNo);
-                this->dclass = iDecision;
-                this->dset = TRUE;
+                state->dclass = iDecision;
+                state->dset = TRUE;
                 return 0;    /* solution found */
             } else {
                 /* check of vfields argument done in initialize */
@@ -1195,13 +1172,360 @@ static picoos_int8 kdtAskTree(register kdt_subobj_t *this,
         }/*end if (!iIsDecide)*/
     }/*end for (i = 0; i < iForks; i++ )*/
 
-    this->dset = FALSE;
+    state->dset = FALSE;
     PICODBG_TRACE(("problem determining class"));
     return -1; /* solution not found, problem determining a class */
 }
 
 
 
+/* ************************************************************/
+/* decision tree compilation */
+/* ************************************************************/
+
+/* A tree can be compiled into an array of nodes with their questions,
+   thresholds and forks decoded, the subsets of a discrete node turned
+   into a table mapping each value to its fork. Classifying then only
+   follows the forks instead of walking the tree body bit by bit. The
+   nodes are numbered depth first, so that the first fork of a node
+   usually is the next node. */
+
+/* deepest tree that is compiled, the compilation recursing per level */
+#define PICOKDT_COMPILE_MAXDEPTH  128
+
+/* largest value to fork table of a discrete node */
+#define PICOKDT_COMPILE_MAXNRVALS 4096
+
+/* alignment of the nodes */
+#define PICOKDT_COMPILE_ALIGN     64
+
+/* Name    :   kdtSetForks
+   Function:   has the values from..from+count-1 not in an earlier subset
+               take fork 'fork', extending the value to fork table 'tab'
+               to them first with the default fork 'deffork'
+   Notes   :   the subsets are read in the order of their forks, so the
+               values still at 'deffork' are those in no earlier subset
+*/
+static void kdtSetForks(picoos_uint8 *tab, picoos_uint32 *nrvals,
+                        const picoos_uint32 from, const picoos_uint32 count,
+                        const picoos_uint8 fork, const picoos_uint8 deffork) {
+    picoos_uint32 v;
+
+    for (v = *nrvals; v < from + count; v++) {
+        tab[v] = deffork;
+    }
+    if (from + count > *nrvals) {
+        *nrvals = from + count;
+    }
+    for (v = from; v < from + count; v++) {
+        if (tab[v] == deffork) {
+            tab[v] = fork;
+        }
+    }
+}
+
+
+/* Name    :   kdtCompileSubsets
+   Function:   reads the subsets of a discrete node into the value to
+               fork table 'tab', or only sizes it if 'tab' is NULL
+   Input   :   iByteNo, iBitNo  position of the first subset
+               question         attribute of the node
+               nrforks          forks of the node (nr of subsets + 1)
+   Output  :   nrvals           size of tab: the largest value a subset
+                                contains, +1
+   Returns :   TRUE if okay, FALSE if the subsets cannot be compiled
+   Notes   :   advances iByteNo, iBitNo past the subsets
+*/
+static picoos_uint8 kdtCompileSubsets(register kdt_subobj_t *this,
+                                      picoos_uint32 *iByteNo,
+                                      picoos_int8 *iBitNo,
+                                      const picoos_uint8 question,
+                                      const picoos_uint16 nrforks,
+                                      picoos_uint8 *tab,
+                                      picoos_uint32 *nrvals) {
+    picoos_int32 iSubsetType, iBitPos, iBitCount;
+    picoos_uint32 v;
+    picoos_uint16 i;
+
+    *nrvals = 0;
+    for (i = 0; i + 1 < nrforks; i++) {
+        iSubsetType = kdtGetShiftVal(this, PICOKDT_SUBSETTYPE_NRBITS,
+                                     iByteNo, iBitNo);
+        iBitPos = kdtGetShiftVal(this,
+                                 kdtGetQFieldsVal(this, question, eBitNo),
+                                 iByteNo, iBitNo);
+        iBitCount = 1;
+        if (eOneValue != iSubsetType) {
+            iBitCount =
+                kdtGetShiftVal(this,
+                               kdtGetQFieldsVal(this, question, eBitCount),
+                               iByteNo, iBitNo);
+        }
+        if ((picoos_uint32)(iBitPos + iBitCount) > PICOKDT_COMPILE_MAXNRVALS) {
+            return FALSE;
+        }
+        switch (iSubsetType) {
+            case eOneValue:
+            case eWithoutBitMask:
+                if (NULL != tab) {
+                    kdtSetForks(tab, nrvals, iBitPos, iBitCount, i, nrforks - 1);
+                } else if ((picoos_uint32)(iBitPos + iBitCount) > *nrvals) {
+                    *nrvals = iBitPos + iBitCount;
+                }
+                break;
+            case eTwoValues:
+                /* iBitCount is the second value */
+                if (NULL != tab) {
+                    kdtSetForks(tab, nrvals, iBitPos, 1, i, nrforks - 1);
+                    kdtSetForks(tab, nrvals, iBitCount, 1, i, nrforks - 1);
+                } else {
+                    if ((picoos_uint32)iBitPos + 1 > *nrvals) {
+                        *nrvals = iBitPos + 1;
+                    }
+                    if ((picoos_uint32)iBitCount + 1 > *nrvals) {
+                        *nrvals = iBitCount + 1;
+                    }
+                }
+                break;
+            default: /* eBitMask: the values of the range whose bit is set */
+                if (NULL != tab) {
+                    kdtSetForks(tab, nrvals, iBitPos + iBitCount, 0, i, nrforks - 1);
+                    for (v = 0; v < (picoos_uint32)iBitCount; v++) {
+                        if ((this->treebody[*iByteNo] & (1 << *iBitNo))
+                            && (tab[iBitPos + v] == nrforks - 1)) {
+                            tab[iBitPos + v] = (picoos_uint8)i;
+                        }
+                        if (--(*iBitNo) < 0) {
+                            *iBitNo = 7;
+                            (*iByteNo)++;
+                        }
+                    }
+                } else {
+                    if ((picoos_uint32)(iBitPos + iBitCount) > *nrvals) {
+                        *nrvals = iBitPos + iBitCount;
+                    }
+                    kdt_jump(iBitCount, iByteNo, iBitNo);
+                }
+                if (*iByteNo >= this->treebodysize) {
+                    return FALSE;
+                }
+                break;
+        }
+    }
+    return TRUE;
+}
+
+
+/* Name    :   kdtCompileNode
+   Function:   compiles the subtree at iByteNo, iBitNo into node
+               c->nrnodes and the ones following it, or only counts
+               the nodes, forks and table entries it takes if c->nodes
+               is NULL
+   Returns :   TRUE if okay, FALSE if the tree cannot be compiled
+   Notes   :   asking a compiled node has the same outcome as kdtAskTree
+               has on the node it is compiled from
+*/
+static picoos_uint8 kdtCompileNode(register kdt_subobj_t *this,
+                                   kdt_compiled_t *c,
+                                   picoos_uint32 iByteNo,
+                                   picoos_int8 iBitNo,
+                                   const picoos_uint8 depth) {
+    kdt_node_t node;
+    picoos_uint32 n, fork, tab, iJump, iChildByteNo;
+    picoos_int8 iChildBitNo;
+    picoos_uint16 i;
+
+    if ((depth > PICOKDT_COMPILE_MAXDEPTH) || (iByteNo >= this->treebodysize)) {
+        return FALSE;
+    }
+    n = c->nrnodes++;
+    node.type = kdtGetShiftVal(this, PICOKDT_NODETYPE_NRBITS,
+                               &iByteNo, &iBitNo);
+    node.question = kdtGetShiftVal(this, this->vfields[eQuestion],
+                                   &iByteNo, &iBitNo);
+    node.nrforks = 0;
+    node.nrvals = 0;
+    node.arg = 0;
+    node.forks = c->nrforks;
+
+    if (node.question < this->nrattributes) {
+        switch (node.type) {
+            case eNBinary:
+                node.nrforks = 2;
+                break;
+            case eNContinuous:
+                node.nrforks = 2;
+                node.arg = kdtGetShiftVal(this,
+                                          kdtGetQFieldsVal(this, node.question,
+                                                           eCut),
+                                          &iByteNo, &iBitNo);
+                break;
+            case eNDiscrete:
+                node.nrforks =
+                    kdtGetShiftVal(this,
+                                   kdtGetQFieldsVal(this, node.question,
+                                                    eForkCount),
+                                   &iByteNo, &iBitNo);
+                if (node.nrforks > 0x100) {
+                    return FALSE;
+                }
+                tab = c->nrforktab;
+                if (!kdtCompileSubsets(this, &iByteNo, &iBitNo, node.question,
+                                       node.nrforks,
+                                       (NULL == c->nodes) ? NULL : c->forktab + tab,
+                                       &node.nrvals)) {
+                    return FALSE;
+                }
+                c->nrforktab += node.nrvals;
+                node.arg = tab;
+                break;
+            default: /* eNTerminal is never asked */
+                break;
+        }
+    }
+    c->nrforks += node.nrforks;
+
+    for (i = 0; i < node.nrforks; i++) {
+        if (kdtGetShiftVal(this, PICOKDT_ISDECIDE_NRBITS, &iByteNo, &iBitNo)) {
+            fork = (kdtGetShiftVal(this, this->vfields[eDecide],
+                                   &iByteNo, &iBitNo) << 1) | 1;
+        } else {
+            iJump = kdtGetShiftVal(this,
+                                   kdtGetQFieldsVal(this, node.question, eJump),
+                                   &iByteNo, &iBitNo);
+            iChildByteNo = iByteNo;
+            iChildBitNo = iBitNo;
+            kdt_jump(iJump, &iChildByteNo, &iChildBitNo);
+            fork = c->nrnodes << 1;
+            if (!kdtCompileNode(this, c, iChildByteNo, iChildBitNo, depth + 1)) {
+                return FALSE;
+            }
+        }
+        if (NULL != c->nodes) {
+            c->forks[node.forks + i] = fork;
+        }
+    }
+    if (NULL != c->nodes) {
+        c->nodes[n] = node;
+    }
+    return TRUE;
+}
+
+
+/* counts the nodes, forks and table entries of the tree of 'this' into
+   this->compiled, unless already done. Returns TRUE if okay, FALSE if
+   the tree cannot be compiled */
+static picoos_uint8 kdtCountCompiled(register kdt_subobj_t *this) {
+    kdt_compiled_t *c = &this->compiled;
+
+    if (c->nrnodes > 0) {
+        return TRUE;
+    }
+    c->nodes = NULL;
+    c->nrforks = 0;
+    c->nrforktab = 0;
+    if (!kdtCompileNode(this, c, 0, 7, 0)) {
+        c->nrnodes = 0;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+
+picoos_uint32 picokdt_getCompiledDtSize(picoknow_KnowledgeBase this) {
+    kdt_compiled_t *c;
+
+    if ((NULL == this) || (NULL == this->subObj)
+        || (kdtSubObjDeallocate != this->subDeallocate)
+        || !kdtCountCompiled((kdt_subobj_t *)this->subObj)) {
+        return 0;
+    }
+    c = &((kdt_subobj_t *)this->subObj)->compiled;
+    return PICOKDT_COMPILE_ALIGN + c->nrnodes * sizeof(kdt_node_t)
+        + c->nrforks * sizeof(picoos_uint32) + c->nrforktab;
+}
+
+
+void picokdt_compileDt(picoknow_KnowledgeBase this, void *mem) {
+    kdt_subobj_t *dt = (kdt_subobj_t *)this->subObj;
+    kdt_compiled_t c;
+    picoos_uint32 rem;
+
+    if (!kdtCountCompiled(dt)) {
+        return;
+    }
+    rem = (picoos_uint32)((picoos_objsize_t)mem % PICOKDT_COMPILE_ALIGN);
+    c.nodes = (kdt_node_t *)((picoos_uint8 *)mem
+                             + (rem ? PICOKDT_COMPILE_ALIGN - rem : 0));
+    c.forks = (picoos_uint32 *)(c.nodes + dt->compiled.nrnodes);
+    c.forktab = (picoos_uint8 *)(c.forks + dt->compiled.nrforks);
+    c.nrnodes = 0;
+    c.nrforks = 0;
+    c.nrforktab = 0;
+    kdtCompileNode(dt, &c, 0, 7, 0);
+    dt->compiled = c;
+}
+
+
+/* Name    :   kdtClassify
+   Function:   classifies state->invec with the compiled tree, or by
+               walking the tree body if the tree is not compiled
+   Returns :   =0    solution found
+               <0    error, no solution found
+*/
+static picoos_int8 kdtClassify(register kdt_subobj_t *this,
+                               picokdt_DtState state,
+                               const kdt_nratt_t invecmax) {
+    const kdt_node_t *node;
+    picoos_int32 iVal;
+    picoos_uint32 fork;
+    picoos_uint32 iByteNo;
+    picoos_int8 iBitNo;
+    picoos_int8 rv;
+
+    if (NULL == this->compiled.nodes) {
+        iByteNo = 0;
+        iBitNo = 7;
+        while ((rv = kdtAskTree(this, state, invecmax, &iByteNo, &iBitNo)) > 0) {
+            PICODBG_TRACE(("asking tree"));
+        }
+        return rv;
+    }
+
+    node = this->compiled.nodes;
+    while ((node->nrforks > 0) && (node->question < invecmax)) {
+        iVal = state->invec[node->question];
+        switch (node->type) {
+            case eNContinuous:
+                fork = (iVal <= node->arg) ? 0 : 1;
+                break;
+            case eNDiscrete:
+                fork = ((picoos_uint32)iVal < node->nrvals) ?
+                    this->compiled.forktab[node->arg + iVal] : node->nrforks - 1;
+                break;
+            default: /* eNBinary */
+                fork = iVal;
+                break;
+        }
+        if (fork >= node->nrforks) {
+            break;
+        }
+        fork = this->compiled.forks[node->forks + fork];
+        if (fork & 1) {
+            state->dclass = fork >> 1;
+            state->dset = TRUE;
+            return 0;    /* solution found */
+        }
+        node = this->compiled.nodes + (fork >> 1);
+    }
+
+    state->dset = FALSE;
+    PICODBG_TRACE(("problem determining class"));
+    return -1;
+}
+
+
+
 /* ************************************************************/
 /* decision tree support functions, mappings */
 /* ************************************************************/
@@ -1300,6 +1624,32 @@ static picoos_uint8 kdtMapInFixed(const kdt_subobj_t *dt,
 }
 
 
+/* TRUE if kdtMapInFixed may fail to map some value of input map table
+   'imtnr', FALSE if it maps (or falls back for) every value */
+static picoos_uint8 kdtMapInFixedMayFail(const kdt_subobj_t *dt,
+                                         const picoos_uint8 imtnr) {
+    picoos_uint32 pos;
+
+    pos = 0;
+    if (imtnr >= dt->inpmaptable[pos]) {
+        return TRUE;
+    }
+    if (imtnr > 0) {
+        pos = dt->beg_offset[imtnr];
+    }
+    pos += 2;
+    if (dt->inpmaptable[pos] == PICOKDT_MTTYPE_EMPTY) {
+        return FALSE;
+    } else if ((dt->inpmaptable[pos] != PICOKDT_MTTYPE_BYTE)
+               && (dt->inpmaptable[pos] != PICOKDT_MTTYPE_WORD)) {
+        return TRUE;
+    }
+    /* the fallback value */
+    return (0 == (((picoos_uint16)(dt->inpmaptable[pos+2])) << 8 |
+                  dt->inpmaptable[pos+1]));
+}
+
+
 static picoos_uint8 kdtMapInGraph(const kdt_subobj_t *dt,
                                   const picoos_uint8 imtnr,
                                   const picoos_uint8 *inval,
@@ -1699,6 +2049,7 @@ static picoos_uint8 kdtMapOutVar(const kdt_subobj_t *dt,
 
 
 picoos_uint8 picokdt_dtPosPconstructInVec(const picokdt_DtPosP this,
+                                          picokdt_DtState state,
                                           const picoos_uint8 *graph,
                                           const picoos_uint16 graphlen,
                                           const picoos_uint8 specgraphflag) {
@@ -1731,11 +2082,11 @@ picoos_uint8 picokdt_dtPosPconstructInVec(const picokdt_DtPosP this,
 
     /* not needed, since all elements are set
     for (i = 0; i < PICOKDT_NRATT_POSP; i++) {
-        dtposp->invec[i] = '\x63';
+        state->invec[i] = '\x63';
     }
     */
 
-    dtposp->inveclen = 0;
+    state->inveclen = 0;
 
     while ((poscg < graphlen) &&
            ((lencg = picobase_det_utf8_length(graph[poscg])) > 0)) {
@@ -1744,10 +2095,10 @@ picoos_uint8 picokdt_dtPosPconstructInVec(const picokdt_DtPosP this,
                 /* att-encode front utf graph and add in invec */
                 if (!kdtMapInGraph(&(dtposp->dt), invecpos,
                                    chbuf[chbfront], PICOBASE_UTF8_MAXLEN,
-                                   &(dtposp->invec[invecpos]),
+                                   &(state->invec[invecpos]),
                                    &fallback)) {
                     if (fallback) {
-                        dtposp->invec[invecpos] = fallback;
+                        state->invec[invecpos] = fallback;
                     } else {
                         return FALSE;
                     }
@@ -1781,9 +2132,9 @@ picoos_uint8 picokdt_dtPosPconstructInVec(const picokdt_DtPosP this,
             if (!kdtMapInGraph(&(dtposp->dt), invecpos,
                                PICOKDT_OUTSIDEGRAPH_DEFSTR,
                                PICOKDT_OUTSIDEGRAPH_DEFLEN,
-                               &(dtposp->invec[invecpos]), &fallback)) {
+                               &(state->invec[invecpos]), &fallback)) {
                 if (fallback) {
-                    dtposp->invec[invecpos] = fallback;
+                    state->invec[invecpos] = fallback;
                 } else {
                     return FALSE;
                 }
@@ -1801,9 +2152,9 @@ picoos_uint8 picokdt_dtPosPconstructInVec(const picokdt_DtPosP this,
                 }
                 if (!kdtMapInGraph(&(dtposp->dt), i, chbuf[chbrear],
                                    PICOBASE_UTF8_MAXLEN,
-                                   &(dtposp->invec[i]), &fallback)) {
+                                   &(state->invec[i]), &fallback)) {
                     if (fallback) {
-                        dtposp->invec[i] = fallback;
+                        state->invec[i] = fallback;
                     } else {
                         return FALSE;
                     }
@@ -1813,9 +2164,9 @@ picoos_uint8 picokdt_dtPosPconstructInVec(const picokdt_DtPosP this,
                 if (!kdtMapInGraph(&(dtposp->dt), i,
                                    PICOKDT_OUTSIDEGRAPH_DEFSTR,
                                    PICOKDT_OUTSIDEGRAPH_DEFLEN,
-                                   &(dtposp->invec[i]), &fallback)) {
+                                   &(state->invec[i]), &fallback)) {
                     if (fallback) {
-                        dtposp->invec[i] = fallback;
+                        state->invec[i] = fallback;
                     } else {
                         return FALSE;
                     }
@@ -1826,10 +2177,10 @@ picoos_uint8 picokdt_dtPosPconstructInVec(const picokdt_DtPosP this,
         /* set isSpecChar attribute, reuse var i */
         i = (specgraphflag ? 1 : 0);
         if (!kdtMapInFixed(&(dtposp->dt), KDT_POSP_SPECGRAPHATTPOS, i,
-                           &(dtposp->invec[KDT_POSP_SPECGRAPHATTPOS]),
+                           &(state->invec[KDT_POSP_SPECGRAPHATTPOS]),
                            &fallback)) {
             if (fallback) {
-                dtposp->invec[KDT_POSP_SPECGRAPHATTPOS] = fallback;
+                state->invec[KDT_POSP_SPECGRAPHATTPOS] = fallback;
             } else {
                 return FALSE;
             }
@@ -1837,21 +2188,21 @@ picoos_uint8 picokdt_dtPosPconstructInVec(const picokdt_DtPosP this,
 
         /* set nrGraphs attribute */
         if (!kdtMapInFixed(&(dtposp->dt), KDT_POSP_NRGRAPHSATTPOS, nrutfg,
-                           &(dtposp->invec[KDT_POSP_NRGRAPHSATTPOS]),
+                           &(state->invec[KDT_POSP_NRGRAPHSATTPOS]),
                            &fallback)) {
             if (fallback) {
-                dtposp->invec[KDT_POSP_NRGRAPHSATTPOS] = fallback;
+                state->invec[KDT_POSP_NRGRAPHSATTPOS] = fallback;
             } else {
                 return FALSE;
             }
         }
         PICODBG_DEBUG(("posp-invec: [%d,%d,%d,%d|%d,%d,%d,%d,%d,%d|%d|%d]",
-                       dtposp->invec[0], dtposp->invec[1], dtposp->invec[2],
-                       dtposp->invec[3], dtposp->invec[4], dtposp->invec[5],
-                       dtposp->invec[6], dtposp->invec[7], dtposp->invec[8],
-                       dtposp->invec[9], dtposp->invec[10],
-                       dtposp->invec[11], dtposp->invec[12]));
-        dtposp->inveclen = PICOKDT_NRINPMT_POSP;
+                       state->invec[0], state->invec[1], state->invec[2],
+                       state->invec[3], state->invec[4], state->invec[5],
+                       state->invec[6], state->invec[7], state->invec[8],
+                       state->invec[9], state->invec[10],
+                       state->invec[11], state->invec[12]));
+        state->inveclen = PICOKDT_NRINPMT_POSP;
         return TRUE;
     }
 
@@ -1859,35 +2210,30 @@ picoos_uint8 picokdt_dtPosPconstructInVec(const picokdt_DtPosP this,
 }
 
 
-picoos_uint8 picokdt_dtPosPclassify(const picokdt_DtPosP this) {
-    picoos_uint32 iByteNo;
-    picoos_int8 iBitNo;
+picoos_uint8 picokdt_dtPosPclassify(const picokdt_DtPosP this,
+                                    picokdt_DtState state) {
     picoos_int8 rv;
     kdtposp_subobj_t *dtposp;
     kdt_subobj_t *dt;
 
     dtposp = (kdtposp_subobj_t *)this;
     dt = &(dtposp->dt);
-    iByteNo = 0;
-    iBitNo = 7;
-    while ((rv = kdtAskTree(dt, dtposp->invec, PICOKDT_NRATT_POSP,
-                            &iByteNo, &iBitNo)) > 0) {
-        PICODBG_TRACE(("asking tree"));
-    }
-    PICODBG_DEBUG(("done: %d", dt->dclass));
-    return ((rv == 0) && dt->dset);
+    rv = kdtClassify(dt, state, PICOKDT_NRATT_POSP);
+    PICODBG_DEBUG(("done: %d", state->dclass));
+    return ((rv == 0) && state->dset);
 }
 
 
 picoos_uint8 picokdt_dtPosPdecomposeOutClass(const picokdt_DtPosP this,
+                                             picokdt_DtState state,
                                              picokdt_classify_result_t *dtres) {
     kdtposp_subobj_t *dtposp;
     picoos_uint16 val;
 
     dtposp = (kdtposp_subobj_t *)this;
 
-    if (dtposp->dt.dset &&
-        kdtMapOutFixed(&(dtposp->dt), dtposp->dt.dclass, &val)) {
+    if (state->dset &&
+        kdtMapOutFixed(&(dtposp->dt), state->dclass, &val)) {
         dtres->set = TRUE;
         dtres->class = val;
         return TRUE;
@@ -1905,13 +2251,14 @@ picoos_uint8 picokdt_dtPosPdecomposeOutClass(const picokdt_DtPosP this,
 
 
 picoos_uint8 picokdt_dtPosDconstructInVec(const picokdt_DtPosD this,
+                                          picokdt_DtState state,
                                           const picoos_uint16 * input) {
     kdtposd_subobj_t *dtposd;
     picoos_uint8 i;
     picoos_uint16 fallback = 0;
 
     dtposd = (kdtposd_subobj_t *)this;
-    dtposd->inveclen = 0;
+    state->inveclen = 0;
 
     PICODBG_DEBUG(("in: [%d,%d,%d|%d|%d,%d,%d]",
                    input[0], input[1], input[2],
@@ -1921,10 +2268,10 @@ picoos_uint8 picokdt_dtPosDconstructInVec(const picokdt_DtPosD this,
 
         /* do the imt mapping for all inval */
         if (!kdtMapInFixed(&(dtposd->dt), i, input[i],
-                           &(dtposd->invec[i]), &fallback)) {
+                           &(state->invec[i]), &fallback)) {
             if (fallback) {
                 PICODBG_DEBUG(("*** using fallback for input mapping: %i -> %i", input[i], fallback));
-                dtposd->invec[i] = fallback;
+                state->invec[i] = fallback;
             } else {
                 PICODBG_ERROR(("problem doing input mapping"));
                 return FALSE;
@@ -1933,33 +2280,27 @@ picoos_uint8 picokdt_dtPosDconstructInVec(const picokdt_DtPosD this,
     }
 
     PICODBG_DEBUG(("out: [%d,%d,%d|%d|%d,%d,%d]",
-                   dtposd->invec[0], dtposd->invec[1], dtposd->invec[2],
-                   dtposd->invec[3], dtposd->invec[4], dtposd->invec[5],
-                   dtposd->invec[6]));
-    dtposd->inveclen = PICOKDT_NRINPMT_POSD;
+                   state->invec[0], state->invec[1], state->invec[2],
+                   state->invec[3], state->invec[4], state->invec[5],
+                   state->invec[6]));
+    state->inveclen = PICOKDT_NRINPMT_POSD;
     return TRUE;
 }
 
 
 picoos_uint8 picokdt_dtPosDclassify(const picokdt_DtPosD this,
+                                    picokdt_DtState state,
                                     picoos_uint16 *treeout) {
-    picoos_uint32 iByteNo;
-    picoos_int8 iBitNo;
     picoos_int8 rv;
     kdtposd_subobj_t *dtposd;
     kdt_subobj_t *dt;
 
     dtposd = (kdtposd_subobj_t *)this;
     dt = &(dtposd->dt);
-    iByteNo = 0;
-    iBitNo = 7;
-    while ((rv = kdtAskTree(dt, dtposd->invec, PICOKDT_NRATT_POSD,
-                            &iByteNo, &iBitNo)) > 0) {
-        PICODBG_TRACE(("asking tree"));
-    }
-    PICODBG_DEBUG(("done: %d", dt->dclass));
-    if ((rv == 0) && dt->dset) {
-        *treeout = dt->dclass;
+    rv = kdtClassify(dt, state, PICOKDT_NRATT_POSD);
+    PICODBG_DEBUG(("done: %d", state->dclass));
+    if ((rv == 0) && state->dset) {
+        *treeout = state->dclass;
         return TRUE;
     } else {
         return FALSE;
@@ -1972,14 +2313,15 @@ picoos_uint8 picokdt_dtPosDclassify(const picokdt_DtPosD this,
    returns:       TRUE if okay, FALSE otherwise
 */
 picoos_uint8 picokdt_dtPosDdecomposeOutClass(const picokdt_DtPosD this,
+                                             picokdt_DtState state,
                                              picokdt_classify_result_t *dtres) {
     kdtposd_subobj_t *dtposd;
     picoos_uint16 val;
 
     dtposd = (kdtposd_subobj_t *)this;
 
-    if (dtposd->dt.dset &&
-        kdtMapOutFixed(&(dtposd->dt), dtposd->dt.dclass, &val)) {
+    if (state->dset &&
+        kdtMapOutFixed(&(dtposd->dt), state->dclass, &val)) {
         dtres->set = TRUE;
         dtres->class = val;
         return TRUE;
@@ -2035,6 +2377,7 @@ static picoos_uint16 kdtGetUTF8Nr(const picoos_uint8 *utfgraph,
 
 
 picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
+                                         picokdt_DtState state,
                                          const picoos_uint8 *graph,
                                          const picoos_uint16 graphlen,
                                          const picoos_uint8 count,
@@ -2063,7 +2406,7 @@ picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
                    nrvow, ordvow, *primstressflag, phonech1, phonech2,
                    phonech3));
 
-    dtg2p->inveclen = 0;
+    state->inveclen = 0;
 
     /* many speed-ups possible */
 
@@ -2112,13 +2455,13 @@ picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
 
         if (!kdtMapInGraph(&(dtg2p->dt), iAttr,
                            utf8char, PICOBASE_UTF8_MAXLEN,
-                           &(dtg2p->invec[iAttr]),
+                           &(state->invec[iAttr]),
                            &fallback)) {
             if (fallback) {
-                dtg2p->invec[iAttr] = fallback;
+                state->invec[iAttr] = fallback;
             } else {
                 PICODBG_WARN(("setting attribute %d to zero", iAttr));
-                dtg2p->invec[iAttr] = 0;
+                state->invec[iAttr] = 0;
                 retval = FALSE;
             }
         }
@@ -2149,13 +2492,13 @@ picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
         }
         if (!kdtMapInGraph(&(dtg2p->dt), iAttr,
                            utf8char, PICOBASE_UTF8_MAXLEN,
-                           &(dtg2p->invec[iAttr]),
+                           &(state->invec[iAttr]),
                            &fallback)) {
             if (fallback) {
-                dtg2p->invec[iAttr] = fallback;
+                state->invec[iAttr] = fallback;
             } else {
                 PICODBG_WARN(("setting attribute %d to zero", iAttr));
-                dtg2p->invec[iAttr] = 0;
+                state->invec[iAttr] = 0;
                 retval = FALSE;
             }
         }
@@ -2197,26 +2540,26 @@ picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
         PICODBG_TRACE(("invec %d %d", iAttr, inval));
 
         if (!kdtMapInFixed(&(dtg2p->dt), iAttr, inval,
-                           &(dtg2p->invec[iAttr]), &fallback)) {
+                           &(state->invec[iAttr]), &fallback)) {
             if (fallback) {
-                dtg2p->invec[iAttr] = fallback;
+                state->invec[iAttr] = fallback;
             } else {
                 PICODBG_WARN(("setting attribute %d to zero", iAttr));
-                dtg2p->invec[iAttr] = 0;
+                state->invec[iAttr] = 0;
                 retval = FALSE;
             }
         }
     }
 
     PICODBG_TRACE(("out: [%d,%d%,%d,%d|%d|%d,%d,%d,%d|%d,%d,%d,%d|"
-                   "%d,%d,%d]", dtg2p->invec[0], dtg2p->invec[1],
-                   dtg2p->invec[2], dtg2p->invec[3], dtg2p->invec[4],
-                   dtg2p->invec[5], dtg2p->invec[6], dtg2p->invec[7],
-                   dtg2p->invec[8], dtg2p->invec[9], dtg2p->invec[10],
-                   dtg2p->invec[11], dtg2p->invec[12], dtg2p->invec[13],
-                   dtg2p->invec[14], dtg2p->invec[15]));
-
-    dtg2p->inveclen = PICOKDT_NRINPMT_G2P;
+                   "%d,%d,%d]", state->invec[0], state->invec[1],
+                   state->invec[2], state->invec[3], state->invec[4],
+                   state->invec[5], state->invec[6], state->invec[7],
+                   state->invec[8], state->invec[9], state->invec[10],
+                   state->invec[11], state->invec[12], state->invec[13],
+                   state->invec[14], state->invec[15]));
+
+    state->inveclen = PICOKDT_NRINPMT_G2P;
     return retval;
 }
 
@@ -2224,24 +2567,18 @@ picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
 
 
 picoos_uint8 picokdt_dtG2Pclassify(const picokdt_DtG2P this,
+                                   picokdt_DtState state,
                                    picoos_uint16 *treeout) {
-    picoos_uint32 iByteNo;
-    picoos_int8 iBitNo;
     picoos_int8 rv;
     kdtg2p_subobj_t *dtg2p;
     kdt_subobj_t *dt;
 
     dtg2p = (kdtg2p_subobj_t *)this;
     dt = &(dtg2p->dt);
-    iByteNo = 0;
-    iBitNo = 7;
-    while ((rv = kdtAskTree(dt, dtg2p->invec, PICOKDT_NRATT_G2P,
-                            &iByteNo, &iBitNo)) > 0) {
-        PICODBG_TRACE(("asking tree"));
-    }
-    PICODBG_TRACE(("done: %d", dt->dclass));
-    if ((rv == 0) && dt->dset) {
-        *treeout = dt->dclass;
+    rv = kdtClassify(dt, state, PICOKDT_NRATT_G2P);
+    PICODBG_TRACE(("done: %d", state->dclass));
+    if ((rv == 0) && state->dset) {
+        *treeout = state->dclass;
         return TRUE;
     } else {
         return FALSE;
@@ -2251,13 +2588,14 @@ picoos_uint8 picokdt_dtG2Pclassify(const picokdt_DtG2P this,
 
 
 picoos_uint8 picokdt_dtG2PdecomposeOutClass(const picokdt_DtG2P this,
+                                            picokdt_DtState state,
                                   picokdt_classify_vecresult_t *dtvres) {
     kdtg2p_subobj_t *dtg2p;
 
     dtg2p = (kdtg2p_subobj_t *)this;
 
-    if (dtg2p->dt.dset &&
-        kdtMapOutVar(&(dtg2p->dt), dtg2p->dt.dclass, &(dtvres->nr),
+    if (state->dset &&
+        kdtMapOutVar(&(dtg2p->dt), state->dclass, &(dtvres->nr),
                      dtvres->classvec, PICOKDT_MAXSIZE_OUTVEC)) {
         return TRUE;
     } else {
@@ -2274,6 +2612,7 @@ picoos_uint8 picokdt_dtG2PdecomposeOutClass(const picokdt_DtG2P this,
 /* ************************************************************/
 
 picoos_uint8 picokdt_dtPHRconstructInVec(const picokdt_DtPHR this,
+                                         picokdt_DtState state,
                                          const picoos_uint8 pre2,
                                          const picoos_uint8 pre1,
                                          const picoos_uint8 src,
@@ -2291,7 +2630,7 @@ picoos_uint8 picokdt_dtPHRconstructInVec(const picokdt_DtPHR this,
     PICODBG_DEBUG(("in:  [%d,%d|%d|%d,%d|%d,%d,%d]",
                    pre2, pre1, src, fol1, fol2,
                    nrwordspre, nrwordsfol, nrsyllsfol));
-    dtphr->inveclen = 0;
+    state->inveclen = 0;
 
     for (i = 0; i < PICOKDT_NRATT_PHR; i++) {
         switch (i) {
@@ -2311,9 +2650,9 @@ picoos_uint8 picokdt_dtPHRconstructInVec(const picokdt_DtPHR this,
 
         /* do the imt mapping for all inval */
         if (!kdtMapInFixed(&(dtphr->dt), i, inval,
-                           &(dtphr->invec[i]), &fallback)) {
+                           &(state->invec[i]), &fallback)) {
             if (fallback) {
-                dtphr->invec[i] = fallback;
+                state->invec[i] = fallback;
             } else {
                 PICODBG_ERROR(("problem doing input mapping"));
                 return FALSE;
@@ -2322,43 +2661,38 @@ picoos_uint8 picokdt_dtPHRconstructInVec(const picokdt_DtPHR this,
     }
 
     PICODBG_DEBUG(("out: [%d,%d|%d|%d,%d|%d,%d,%d]",
-                   dtphr->invec[0], dtphr->invec[1], dtphr->invec[2],
-                   dtphr->invec[3], dtphr->invec[4], dtphr->invec[5],
-                   dtphr->invec[6], dtphr->invec[7]));
-    dtphr->inveclen = PICOKDT_NRINPMT_PHR;
+                   state->invec[0], state->invec[1], state->invec[2],
+                   state->invec[3], state->invec[4], state->invec[5],
+                   state->invec[6], state->invec[7]));
+    state->inveclen = PICOKDT_NRINPMT_PHR;
     return TRUE;
 }
 
 
-picoos_uint8 picokdt_dtPHRclassify(const picokdt_DtPHR this) {
-    picoos_uint32 iByteNo;
-    picoos_int8 iBitNo;
+picoos_uint8 picokdt_dtPHRclassify(const picokdt_DtPHR this,
+                                   picokdt_DtState state) {
     picoos_int8 rv;
     kdtphr_subobj_t *dtphr;
     kdt_subobj_t *dt;
 
     dtphr = (kdtphr_subobj_t *)this;
     dt = &(dtphr->dt);
-    iByteNo = 0;
-    iBitNo = 7;
-    while ((rv = kdtAskTree(dt, dtphr->invec, PICOKDT_NRATT_PHR,
-                            &iByteNo, &iBitNo)) > 0) {
-        PICODBG_TRACE(("asking tree"));
-    }
-    PICODBG_DEBUG(("done: %d", dt->dclass));
-    return ((rv == 0) && dt->dset);
+    rv = kdtClassify(dt, state, PICOKDT_NRATT_PHR);
+    PICODBG_DEBUG(("done: %d", state->dclass));
+    return ((rv == 0) && state->dset);
 }
 
 
 picoos_uint8 picokdt_dtPHRdecomposeOutClass(const picokdt_DtPHR this,
+                                            picokdt_DtState state,
                                             picokdt_classify_result_t *dtres) {
     kdtphr_subobj_t *dtphr;
     picoos_uint16 val;
 
     dtphr = (kdtphr_subobj_t *)this;
 
-    if (dtphr->dt.dset &&
-        kdtMapOutFixed(&(dtphr->dt), dtphr->dt.dclass, &val)) {
+    if (state->dset &&
+        kdtMapOutFixed(&(dtphr->dt), state->dclass, &val)) {
         dtres->set = TRUE;
         dtres->class = val;
         return TRUE;
@@ -2375,6 +2709,7 @@ picoos_uint8 picokdt_dtPHRdecomposeOutClass(const picokdt_DtPHR this,
 /* ************************************************************/
 
 picoos_uint8 picokdt_dtPAMconstructInVec(const picokdt_DtPAM this,
+                                         picokdt_DtState state,
                                          const picoos_uint8 *vec,
                                          const picoos_uint8 veclen) {
     kdtpam_subobj_t *dtpam;
@@ -2402,7 +2737,7 @@ picoos_uint8 picokdt_dtPAMconstructInVec(const picokdt_DtPAM this,
                    vec[50], vec[51], vec[52], vec[53], vec[54],
                    vec[55], vec[56], vec[57], vec[58], vec[59]));
 
-    dtpam->inveclen = 0;
+    state->inveclen = 0;
 
     /* check veclen */
     if (veclen != PICOKDT_NRINPMT_PAM) {
@@ -2414,9 +2749,9 @@ picoos_uint8 picokdt_dtPAMconstructInVec(const picokdt_DtPAM this,
 
         /* do the imt mapping for all vec eles */
         if (!kdtMapInFixed(&(dtpam->dt), i, vec[i],
-                           &(dtpam->invec[i]), &fallback)) {
+                           &(state->invec[i]), &fallback)) {
             if (fallback) {
-                dtpam->invec[i] = fallback;
+                state->invec[i] = fallback;
             } else {
                 PICODBG_ERROR(("problem doing input mapping, %d %d", i,vec[i]));
                 return FALSE;
@@ -2425,70 +2760,91 @@ picoos_uint8 picokdt_dtPAMconstructInVec(const picokdt_DtPAM this,
     }
 
     PICODBG_TRACE(("in0:  %d %d %d %d %d %d %d %d %d %d",
-                   dtpam->invec[0], dtpam->invec[1], dtpam->invec[2],
-                   dtpam->invec[3], dtpam->invec[4], dtpam->invec[5],
-                   dtpam->invec[6], dtpam->invec[7], dtpam->invec[8],
-                   dtpam->invec[9]));
+                   state->invec[0], state->invec[1], state->invec[2],
+                   state->invec[3], state->invec[4], state->invec[5],
+                   state->invec[6], state->invec[7], state->invec[8],
+                   state->invec[9]));
     PICODBG_TRACE(("in1:  %d %d %d %d %d %d %d %d %d %d",
-                   dtpam->invec[10], dtpam->invec[11], dtpam->invec[12],
-                   dtpam->invec[13], dtpam->invec[14], dtpam->invec[15],
-                   dtpam->invec[16], dtpam->invec[17], dtpam->invec[18],
-                   dtpam->invec[19]));
+                   state->invec[10], state->invec[11], state->invec[12],
+                   state->invec[13], state->invec[14], state->invec[15],
+                   state->invec[16], state->invec[17], state->invec[18],
+                   state->invec[19]));
     PICODBG_TRACE(("in2:  %d %d %d %d %d %d %d %d %d %d",
-                   dtpam->invec[20], dtpam->invec[21], dtpam->invec[22],
-                   dtpam->invec[23], dtpam->invec[24], dtpam->invec[25],
-                   dtpam->invec[26], dtpam->invec[27], dtpam->invec[28],
-                   dtpam->invec[29]));
+                   state->invec[20], state->invec[21], state->invec[22],
+                   state->invec[23], state->invec[24], state->invec[25],
+                   state->invec[26], state->invec[27], state->invec[28],
+                   state->invec[29]));
     PICODBG_TRACE(("in3:  %d %d %d %d %d %d %d %d %d %d",
-                   dtpam->invec[30], dtpam->invec[31], dtpam->invec[32],
-                   dtpam->invec[33], dtpam->invec[34], dtpam->invec[35],
-                   dtpam->invec[36], dtpam->invec[37], dtpam->invec[38],
-                   dtpam->invec[39]));
+                   state->invec[30], state->invec[31], state->invec[32],
+                   state->invec[33], state->invec[34], state->invec[35],
+                   state->invec[36], state->invec[37], state->invec[38],
+                   state->invec[39]));
     PICODBG_TRACE(("in4:  %d %d %d %d %d %d %d %d %d %d",
-                   dtpam->invec[40], dtpam->invec[41], dtpam->invec[42],
-                   dtpam->invec[43], dtpam->invec[44], dtpam->invec[45],
-                   dtpam->invec[46], dtpam->invec[47], dtpam->invec[48],
-                   dtpam->invec[49]));
+                   state->invec[40], state->invec[41], state->invec[42],
+                   state->invec[43], state->invec[44], state->invec[45],
+                   state->invec[46], state->invec[47], state->invec[48],
+                   state->invec[49]));
     PICODBG_TRACE(("in5:  %d %d %d %d %d %d %d %d %d %d",
-                   dtpam->invec[50], dtpam->invec[51], dtpam->invec[52],
-                   dtpam->invec[53], dtpam->invec[54], dtpam->invec[55],
-                   dtpam->invec[56], dtpam->invec[57], dtpam->invec[58],
-                   dtpam->invec[59]));
+                   state->invec[50], state->invec[51], state->invec[52],
+                   state->invec[53], state->invec[54], state->invec[55],
+                   state->invec[56], state->invec[57], state->invec[58],
+                   state->invec[59]));
 
-    dtpam->inveclen = PICOKDT_NRINPMT_PAM;
+    state->inveclen = PICOKDT_NRINPMT_PAM;
     return TRUE;
 }
 
 
-picoos_uint8 picokdt_dtPAMclassify(const picokdt_DtPAM this) {
-    picoos_uint32 iByteNo;
-    picoos_int8 iBitNo;
+picoos_uint8 picokdt_dtPAMclassify(const picokdt_DtPAM this,
+                                   picokdt_DtState state) {
     picoos_int8 rv;
     kdtpam_subobj_t *dtpam;
     kdt_subobj_t *dt;
 
     dtpam = (kdtpam_subobj_t *)this;
     dt = &(dtpam->dt);
-    iByteNo = 0;
-    iBitNo = 7;
-    while ((rv = kdtAskTree(dt, dtpam->invec, PICOKDT_NRATT_PAM,
-                            &iByteNo, &iBitNo)) > 0) {
-        PICODBG_TRACE(("asking tree"));
-    }
-    PICODBG_DEBUG(("done: %d", dt->dclass));
-    return ((rv == 0) && dt->dset);
+    rv = kdtClassify(dt, state, PICOKDT_NRATT_PAM);
+    PICODBG_DEBUG(("done: %d", state->dclass));
+    return ((rv == 0) && state->dset);
+}
+
+
+picoos_uint8 picokdt_dtPAMgetDependencies(const picokdt_DtPAM this,
+                                          picoos_uint8 *depends) {
+    kdt_subobj_t *dt;
+    picoos_uint32 n;
+    picoos_uint8 i;
+
+    dt = &(((kdtpam_subobj_t *)this)->dt);
+    if (NULL == dt->compiled.nodes) {
+        return FALSE;
+    }
+    for (n = 0; n < dt->compiled.nrnodes; n++) {
+        if ((dt->compiled.nodes[n].nrforks > 0)
+            && (dt->compiled.nodes[n].question < PICOKDT_NRATT_PAM)) {
+            depends[dt->compiled.nodes[n].question] = TRUE;
+        }
+    }
+    /* a value without mapping fails the whole classification */
+    for (i = 0; i < PICOKDT_NRATT_PAM; i++) {
+        if (kdtMapInFixedMayFail(dt, i)) {
+            depends[i] = TRUE;
+        }
+    }
+    return TRUE;
 }
 
 
 picoos_uint8 picokdt_dtPAMdecomposeOutClass(const picokdt_DtPAM this,
+                                            picokdt_DtState state,
                                             picokdt_classify_result_t *dtres) {
     kdtpam_subobj_t *dtpam;
     picoos_uint16 val;
 
     dtpam = (kdtpam_subobj_t *)this;
 
-    if (dtpam->dt.dset &&
-        kdtMapOutFixed(&(dtpam->dt), dtpam->dt.dclass, &val)) {
+    if (state->dset &&
+        kdtMapOutFixed(&(dtpam->dt), state->dclass, &val)) {
         dtres->set = TRUE;
         dtres->class = val;
         return TRUE;
@@ -2505,6 +2861,7 @@ picoos_uint8 picokdt_dtPAMdecomposeOutClass(const picokdt_DtPAM this,
 /* ************************************************************/
 
 picoos_uint8 picokdt_dtACCconstructInVec(const picokdt_DtACC this,
+                                         picokdt_DtState state,
                                          const picoos_uint8 pre2,
                                          const picoos_uint8 pre1,
                                          const picoos_uint8 src,
@@ -2528,7 +2885,7 @@ picoos_uint8 picokdt_dtACCconstructInVec(const picokdt_DtACC this,
                    pre2, pre1, src, fol1, fol2, hist1, hist2,
                    nrwordspre, nrsyllspre, nrwordsfol, nrsyllsfol,
                    footwordsfol, footsyllsfol));
-    dtacc->inveclen = 0;
+    state->inveclen = 0;
 
     for (i = 0; i < PICOKDT_NRATT_ACC; i++) {
         switch (i) {
@@ -2570,9 +2927,9 @@ picoos_uint8 picokdt_dtACCconstructInVec(const picokdt_DtACC this,
 
         /* do the imt mapping for all inval */
         if (!kdtMapInFixed(&(dtacc->dt), i, inval,
-                           &(dtacc->invec[i]), &fallback)) {
+                           &(state->invec[i]), &fallback)) {
             if (fallback) {
-                dtacc->invec[i] = fallback;
+                state->invec[i] = fallback;
             } else {
                 PICODBG_ERROR(("problem doing input mapping"));
                 return FALSE;
@@ -2581,35 +2938,29 @@ picoos_uint8 picokdt_dtACCconstructInVec(const picokdt_DtACC this,
     }
 
     PICODBG_DEBUG(("out: [%d,%d,%d,%d,%d|%d,%d|%d,%d,%d,%d|%d,%d]",
-                   dtacc->invec[0], dtacc->invec[1], dtacc->invec[2],
-                   dtacc->invec[3], dtacc->invec[4], dtacc->invec[5],
-                   dtacc->invec[6], dtacc->invec[7], dtacc->invec[8],
-                   dtacc->invec[9], dtacc->invec[10], dtacc->invec[11],
-                   dtacc->invec[12]));
-    dtacc->inveclen = PICOKDT_NRINPMT_ACC;
+                   state->invec[0], state->invec[1], state->invec[2],
+                   state->invec[3], state->invec[4], state->invec[5],
+                   state->invec[6], state->invec[7], state->invec[8],
+                   state->invec[9], state->invec[10], state->invec[11],
+                   state->invec[12]));
+    state->inveclen = PICOKDT_NRINPMT_ACC;
     return TRUE;
 }
 
 
 picoos_uint8 picokdt_dtACCclassify(const picokdt_DtACC this,
+                                   picokdt_DtState state,
                                    picoos_uint16 *treeout) {
-    picoos_uint32 iByteNo;
-    picoos_int8 iBitNo;
     picoos_int8 rv;
     kdtacc_subobj_t *dtacc;
     kdt_subobj_t *dt;
 
     dtacc = (kdtacc_subobj_t *)this;
     dt = &(dtacc->dt);
-    iByteNo = 0;
-    iBitNo = 7;
-    while ((rv = kdtAskTree(dt, dtacc->invec, PICOKDT_NRATT_ACC,
-                            &iByteNo, &iBitNo)) > 0) {
-        PICODBG_TRACE(("asking tree"));
-    }
-    PICODBG_TRACE(("done: %d", dt->dclass));
-    if ((rv == 0) && dt->dset) {
-        *treeout = dt->dclass;
+    rv = kdtClassify(dt, state, PICOKDT_NRATT_ACC);
+    PICODBG_TRACE(("done: %d", state->dclass));
+    if ((rv == 0) && state->dset) {
+        *treeout = state->dclass;
         return TRUE;
     } else {
         return FALSE;
@@ -2618,14 +2969,15 @@ picoos_uint8 picokdt_dtACCclassify(const picokdt_DtACC this,
 
 
 picoos_uint8 picokdt_dtACCdecomposeOutClass(const picokdt_DtACC this,
+                                            picokdt_DtState state,
                                             picokdt_classify_result_t *dtres) {
     kdtacc_subobj_t *dtacc;
     picoos_uint16 val;
 
     dtacc = (kdtacc_subobj_t *)this;
 
-    if (dtacc->dt.dset &&
-        kdtMapOutFixed(&(dtacc->dt), dtacc->dt.dclass, &val)) {
+    if (state->dset &&
+        kdtMapOutFixed(&(dtacc->dt), state->dclass, &val)) {
         dtres->set = TRUE;
         dtres->class = val;
         return TRUE;
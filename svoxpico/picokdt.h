@@ -77,6 +77,16 @@ pico_status_t picokdt_specializeDtKnowledgeBase(picoknow_KnowledgeBase this,
                                                 picoos_Common common,
                                                 const picokdt_kdttype_t type);
 
+/* number of bytes needed to compile the tree of 'this' into an array of
+   nodes with its questions and subsets decoded, or 0 if 'this' is no
+   decision tree or its tree cannot be compiled */
+picoos_uint32 picokdt_getCompiledDtSize(picoknow_KnowledgeBase this);
+
+/* compiles the tree of 'this' into 'mem', of picokdt_getCompiledDtSize
+   bytes, and classifies with it from then on instead of walking the
+   tree bit by bit. 'mem' has to stay valid as long as 'this' */
+void picokdt_compileDt(picoknow_KnowledgeBase this, void *mem);
+
 
 /* ************************************************************/
 /* decision tree types (opaque) and get Tree functions */
@@ -109,6 +119,30 @@ typedef enum {
     PICOKDT_NRATT_PAM  = 60
 } kdt_nratt_t;
 
+#define PICOKDT_NRATT_MAX PICOKDT_NRATT_PAM
+
+
+/* ************************************************************/
+/* decision tree classification state */
+/* ************************************************************/
+
+/* The decision tree knowledge bases are read-only, so that a loaded
+   resource can be used by any number of engines and threads at the
+   same time. The input vector and the direct tree output of a
+   classification are kept by the caller instead, in a
+   picokdt_dtstate_t that is passed to the constructInVec, classify
+   and decomposeOutClass functions. One state per PU is enough, as
+   the three calls for one tree follow each other. */
+
+typedef struct {
+    picoos_uint16 invec[PICOKDT_NRATT_MAX];    /* input vector */
+    picoos_uint8 inveclen;  /* nr of ele set in invec; must be =nrattributes */
+    picoos_uint8 dset;      /* TRUE if class set, FALSE otherwise */
+    picoos_uint16 dclass;   /* direct tree output (no output mapping) */
+} picokdt_dtstate_t;
+
+typedef picokdt_dtstate_t * picokdt_DtState;
+
 
 /* ************************************************************/
 /* decision tree classification result type */
@@ -137,16 +171,16 @@ typedef struct {
    for every tree type there is a constructInVec function to construct
    the size-optimized input vector for the tree using the input map
    tables that are part of the decistion tree knowledge base. The
-   constructed input vector is stored in the tree object (this->invec
-   and this->inveclen) and will be used in the following call to the
-   classify function.
+   constructed input vector is stored in the classification state
+   (state->invec and state->inveclen) and will be used in the
+   following call to the classify function.
 
    classify:
    for every tree type there is a classify function to apply the
    decision tree to the previously constructed input vector. The
-   size-optimized, encoded output is stored in the tree object
-   (this->outval) and will be used in the following call to the
-   decompose function. Where needed (hitory attribute) the direct tree
+   size-optimized, encoded output is stored in the classification
+   state (state->dclass) and will be used in the following call to
+   the decompose function. Where needed (hitory attribute) the direct tree
    output is returned by the classify function in a variable.
 
    decomposeOutClass:
@@ -209,6 +243,7 @@ typedef struct {
    note:          use PICOKDT_OUTSIDEGRAPH* for att values outside context
 */
 picoos_uint8 picokdt_dtPosPconstructInVec(const picokdt_DtPosP this,
+                                          picokdt_DtState state,
                                           const picoos_uint8 *graph,
                                           const picoos_uint16 graphlen,
                                           const picoos_uint8 specgraphflag);
@@ -217,13 +252,15 @@ picoos_uint8 picokdt_dtPosPconstructInVec(const picokdt_DtPosP this,
 /* classify a previously constructed input vector using tree 'this'
    returns:       TRUE if okay, FALSE otherwise
 */
-picoos_uint8 picokdt_dtPosPclassify(const picokdt_DtPosP this);
+picoos_uint8 picokdt_dtPosPclassify(const picokdt_DtPosP this,
+                                    picokdt_DtState state);
 
 /* decompose the tree output and return the class in dtres
    dtres:         POS or POSgroup ID classification result
    returns:       TRUE if okay, FALSE otherwise
 */
 picoos_uint8 picokdt_dtPosPdecomposeOutClass(const picokdt_DtPosP this,
+                                             picokdt_DtState state,
                                              picokdt_classify_result_t *dtres);
 
 
@@ -249,6 +286,7 @@ picoos_uint8 picokdt_dtPosPdecomposeOutClass(const picokdt_DtPosP this,
                     history, use reverse output mapping in these cases
 */
 picoos_uint8 picokdt_dtPosDconstructInVec(const picokdt_DtPosD this,
+                                          picokdt_DtState state,
                                           const picoos_uint16 * input);
 
 
@@ -257,6 +295,7 @@ picoos_uint8 picokdt_dtPosDconstructInVec(const picokdt_DtPosD this,
    returns:       TRUE if okay, FALSE otherwise
 */
 picoos_uint8 picokdt_dtPosDclassify(const picokdt_DtPosD this,
+                                    picokdt_DtState state,
                                     picoos_uint16 *treeout);
 
 /* decompose the tree output and return the class in dtres
@@ -264,6 +303,7 @@ picoos_uint8 picokdt_dtPosDclassify(const picokdt_DtPosD this,
    returns:       TRUE if okay, FALSE otherwise
 */
 picoos_uint8 picokdt_dtPosDdecomposeOutClass(const picokdt_DtPosD this,
+                                             picokdt_DtState state,
                                              picokdt_classify_result_t *dtres);
 
 /* convert (unique) POS index into corresponding tree output index */
@@ -295,6 +335,7 @@ picoos_uint8 picokdt_dtPosDreverseMapOutFixed(const picokdt_DtPosD this,
    returns:       TRUE if okay, FALSE otherwise
 */
 picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
+                                         picokdt_DtState state,
                                          const picoos_uint8 *graph,
                                          const picoos_uint16 graphlen,
                                          const picoos_uint8 count,
@@ -311,6 +352,7 @@ picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
    returns:       TRUE if okay, FALSE otherwise
 */
 picoos_uint8 picokdt_dtG2Pclassify(const picokdt_DtG2P this,
+                                   picokdt_DtState state,
                                    picoos_uint16 *treeout);
 
 /* decompose the tree output and return the class vector in dtvres
@@ -318,6 +360,7 @@ picoos_uint8 picokdt_dtG2Pclassify(const picokdt_DtG2P this,
    returns:       TRUE if okay, FALSE otherwise
 */
 picoos_uint8 picokdt_dtG2PdecomposeOutClass(const picokdt_DtG2P this,
+                                            picokdt_DtState state,
                                   picokdt_classify_vecresult_t *dtvres);
 
 
@@ -346,6 +389,7 @@ picoos_uint8 picokdt_dtG2PdecomposeOutClass(const picokdt_DtG2P this,
    note:            use PICOKDT_EPSILON for att values outside context
 */
 picoos_uint8 picokdt_dtPHRconstructInVec(const picokdt_DtPHR this,
+                                         picokdt_DtState state,
                                          const picoos_uint8 pre2,
                                          const picoos_uint8 pre1,
                                          const picoos_uint8 src,
@@ -358,13 +402,15 @@ picoos_uint8 picokdt_dtPHRconstructInVec(const picokdt_DtPHR this,
 /* classify a previously constructed input vector using tree 'this'
    returns:       TRUE if okay, FALSE otherwise
 */
-picoos_uint8 picokdt_dtPHRclassify(const picokdt_DtPHR this);
+picoos_uint8 picokdt_dtPHRclassify(const picokdt_DtPHR this,
+                                   picokdt_DtState state);
 
 /* decompose the tree output and return the class vector in dtres
    dtres:         phrasing classification result
    returns:       TRUE if okay, FALSE otherwise
 */
 picoos_uint8 picokdt_dtPHRdecomposeOutClass(const picokdt_DtPHR this,
+                                            picokdt_DtState state,
                                             picokdt_classify_result_t *dtres);
 
 
@@ -401,6 +447,7 @@ picoos_uint8 picokdt_dtPHRdecomposeOutClass(const picokdt_DtPHR this,
    note:            use PICOKDT_EPSILON for att 0-4 values outside context
 */
 picoos_uint8 picokdt_dtACCconstructInVec(const picokdt_DtACC this,
+                                         picokdt_DtState state,
                                          const picoos_uint8 pre2,
                                          const picoos_uint8 pre1,
                                          const picoos_uint8 src,
@@ -420,6 +467,7 @@ picoos_uint8 picokdt_dtACCconstructInVec(const picokdt_DtACC this,
    returns:       TRUE if okay, FALSE otherwise
 */
 picoos_uint8 picokdt_dtACCclassify(const picokdt_DtACC this,
+                                   picokdt_DtState state,
                                    picoos_uint16 *treeout);
 
 /* decompose the tree output and return the class vector in dtres
@@ -427,6 +475,7 @@ picoos_uint8 picokdt_dtACCclassify(const picokdt_DtACC this,
    returns:       TRUE if okay, FALSE otherwise
 */
 picoos_uint8 picokdt_dtACCdecomposeOutClass(const picokdt_DtACC this,
+                                            picokdt_DtState state,
                                             picokdt_classify_result_t *dtres);
 
 
@@ -441,19 +490,31 @@ picoos_uint8 picokdt_dtACCdecomposeOutClass(const picokdt_DtACC this,
    returns:       TRUE if okay, FALSE otherwise
 */
 picoos_uint8 picokdt_dtPAMconstructInVec(const picokdt_DtPAM this,
+                                         picokdt_DtState state,
                                          const picoos_uint8 *vec,
                                          const picoos_uint8 veclen);
 
 /* classify a previously constructed input vector using tree 'this'
    returns:       TRUE if okay, FALSE otherwise
 */
-picoos_uint8 picokdt_dtPAMclassify(const picokdt_DtPAM this);
+picoos_uint8 picokdt_dtPAMclassify(const picokdt_DtPAM this,
+                                   picokdt_DtState state);
+
+/* set depends[i] to TRUE for each attribute i of the 60 of a Pam input
+   vector that the outcome of classifying with tree 'this' depends on,
+   leaving the other elements of 'depends' alone
+   returns:       TRUE if okay, FALSE if not known (the tree not being
+                  compiled)
+*/
+picoos_uint8 picokdt_dtPAMgetDependencies(const picokdt_DtPAM this,
+                                          picoos_uint8 *depends);
 
 /* decompose the tree output and return the class in dtres
    dtres:         phones vector classification result
    returns:       TRUE if okay, FALSE otherwise
 */
 picoos_uint8 picokdt_dtPAMdecomposeOutClass(const picokdt_DtPAM this,
+                                            picokdt_DtState state,
                                             picokdt_classify_result_t *dtres);
 
 #ifdef __cplusplus
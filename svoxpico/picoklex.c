@@ -142,6 +142,10 @@ typedef struct klex_subobj
     picoos_uint16 nrblocks; /* nr lexblocks = nr eles in searchind */
     picoos_uint8 *searchind;
     picoos_uint8 *lexblocks;
+    /* graph index (see picoklex_indexLex), NULL if none */
+    picoos_uint32 nrgraphs; /* nr of different graphs, 0 if not counted */
+    picoos_uint32 hashmask; /* nr of hashind slots - 1 */
+    picoos_uint32 *hashind;
 } klex_subobj_t;
 
 
@@ -171,6 +175,9 @@ static pico_status_t klexInitialize(register picoknow_KnowledgeBase this,
         }
         klex->lexblocks = this->base + PICOKLEX_LEX_NRBLOCKS_SIZE +
                              (klex->nrblocks * (PICOKLEX_LEX_SIE_SIZE));
+        klex->nrgraphs = 0;
+        klex->hashmask = 0;
+        klex->hashind = NULL;
         return PICO_OK;
     } else {
         return picoos_emRaiseException(common->em, PICO_EXC_FILE_CORRUPT,
@@ -475,25 +482,235 @@ static void klex_lexblockLookup(klex_SubObj this,
 }
 
 
+/* ************************************************************/
+/* graph index */
+/* ************************************************************/
+
+/* The lexicon can be given an open addressing hash table from the
+   graph to the position of its first entry, so that a lookup no longer
+   scans the entries of the lexblocks the search index points to. A
+   slot holds the entry position + 1 in its lower 24 bits (0 for an
+   empty slot) and the upper 8 bits of the graph's hash in its upper
+   ones. The table is at most 3/4 full. */
+
+#define PICOKLEX_HASH_POSMASK 0x00FFFFFF
+
+static picoos_uint8 klex_searchLookup(const klex_SubObj klex,
+                                      const picoos_uint8 *graph,
+                                      const picoos_uint16 graphlen,
+                                      picoklex_lexl_result_t *lexres);
+
+static picoos_uint32 klex_hashGraph(const picoos_uint8 *graph,
+                                    const picoos_uint16 graphlen) {
+    picoos_uint32 hash;
+    picoos_uint16 i;
+
+    /* FNV-1a */
+    hash = 2166136261u;
+    for (i = 0; i < graphlen; i++) {
+        hash = (hash ^ graph[i]) * 16777619u;
+    }
+    return hash;
+}
+
+
+/* calls 'visit' with the position of each entry of the lexblocks, in
+   order, unless it returns FALSE. Returns FALSE if an entry does not
+   fit into its lexblock or 'visit' returned FALSE */
+static picoos_uint8 klex_forEachEntry(klex_SubObj this,
+                                      picoos_uint8 (*visit)(klex_SubObj,
+                                                            picoos_uint32),
+                                      picoos_uint32 *nrentries) {
+    picoos_uint32 lexpos, blockEnd;
+    picoos_uint16 b;
+
+    *nrentries = 0;
+    for (b = 0; b < this->nrblocks; b++) {
+        lexpos = (picoos_uint32)b * PICOKLEX_LEXBLOCK_SIZE;
+        blockEnd = lexpos + PICOKLEX_LEXBLOCK_SIZE;
+        while ((lexpos < blockEnd) && (this->lexblocks[lexpos] != 0)) {
+            /* LENGRAPH, then LENPOSPHON, which is at least 2 */
+            if ((lexpos + this->lexblocks[lexpos] >= blockEnd)
+                || (this->lexblocks[lexpos + this->lexblocks[lexpos]] < 2)
+                || (lexpos + this->lexblocks[lexpos]
+                    + this->lexblocks[lexpos + this->lexblocks[lexpos]]
+                    > blockEnd)) {
+                return FALSE;
+            }
+            if ((NULL != visit) && !visit(this, lexpos)) {
+                return FALSE;
+            }
+            (*nrentries)++;
+            lexpos += this->lexblocks[lexpos];
+            lexpos += this->lexblocks[lexpos];
+        }
+    }
+    return TRUE;
+}
+
+
+/* returns the slot of 'graph' or of the empty slot it would take */
+static picoos_uint32 klex_hashSlot(const klex_SubObj this,
+                                   const picoos_uint8 *graph,
+                                   const picoos_uint16 graphlen) {
+    picoos_uint32 hash, i, slot, lexpos;
+
+    hash = klex_hashGraph(graph, graphlen);
+    i = hash & this->hashmask;
+    while (0 != (slot = this->hashind[i])) {
+        lexpos = (slot & PICOKLEX_HASH_POSMASK) - 1;
+        if (((slot >> 24) == (hash >> 24))
+            && (0 == klex_lexMatch(&(this->lexblocks[lexpos]), graph,
+                                   graphlen))) {
+            break;
+        }
+        i = (i + 1) & this->hashmask;
+    }
+    return i;
+}
+
+
+/* enters the entry at 'lexpos' unless its graph has an earlier one */
+static picoos_uint8 klex_hashEnter(klex_SubObj this, picoos_uint32 lexpos) {
+    picoos_uint32 i;
+    const picoos_uint8 *graph = &(this->lexblocks[lexpos + 1]);
+    picoos_uint16 graphlen = this->lexblocks[lexpos] - 1;
+
+    i = klex_hashSlot(this, graph, graphlen);
+    if (0 == this->hashind[i]) {
+        this->hashind[i] = (klex_hashGraph(graph, graphlen) & 0xFF000000)
+            | (lexpos + 1);
+        this->nrgraphs++;
+    }
+    return TRUE;
+}
+
+
+/* TRUE unless the entry at 'lexpos' is the first of its graph and the
+   search index lookup of the graph has another result than the hash
+   lookup would have */
+static picoos_uint8 klex_hashCheck(klex_SubObj this, picoos_uint32 lexpos) {
+    picoklex_lexl_result_t sres, hres;
+    const picoos_uint8 *graph = &(this->lexblocks[lexpos + 1]);
+    picoos_uint16 graphlen = this->lexblocks[lexpos] - 1;
+    picoos_uint8 i;
+
+    if (lexpos + 1 != (this->hashind[klex_hashSlot(this, graph, graphlen)]
+                       & PICOKLEX_HASH_POSMASK)) {
+        return TRUE;
+    }
+    klex_searchLookup(this, graph, graphlen, &sres);
+    hres.nrres = 0;
+    hres.posindlen = 0;
+    hres.phonfound = FALSE;
+    klex_lexblockLookup(this, lexpos,
+                        (picoos_uint32)this->nrblocks * PICOKLEX_LEXBLOCK_SIZE,
+                        graph, graphlen, &hres);
+    if ((sres.nrres != hres.nrres) || (sres.posindlen != hres.posindlen)
+        || (sres.phonfound != hres.phonfound)) {
+        return FALSE;
+    }
+    for (i = 0; i < sres.posindlen; i++) {
+        if (sres.posind[i] != hres.posind[i]) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+
+/* number of slots of the graph index of a lex with 'nrentries' entries */
+static picoos_uint32 klex_hashSize(picoos_uint32 nrentries) {
+    picoos_uint32 size = 1;
+
+    while (size < nrentries + nrentries / 3 + 1) {
+        size <<= 1;
+    }
+    return size;
+}
+
+
+picoos_uint32 picoklex_getLexIndexSize(picoknow_KnowledgeBase this) {
+    klex_SubObj klex;
+    picoos_uint32 nrentries;
+
+    if ((NULL == this) || (NULL == this->subObj)
+        || (klexSubObjDeallocate != this->subDeallocate)) {
+        return 0;
+    }
+    klex = (klex_SubObj) this->subObj;
+    /* the entry positions have to fit into a slot */
+    if ((klex->nrblocks == 0)
+        || ((picoos_uint32)klex->nrblocks * PICOKLEX_LEXBLOCK_SIZE
+            > PICOKLEX_HASH_POSMASK)
+        || !klex_forEachEntry(klex, NULL, &nrentries) || (nrentries == 0)) {
+        return 0;
+    }
+    return klex_hashSize(nrentries) * sizeof(picoos_uint32);
+}
+
+
+void picoklex_indexLex(picoknow_KnowledgeBase this, void *mem) {
+    klex_SubObj klex = (klex_SubObj) this->subObj;
+    picoos_uint32 nrentries, size;
+
+    size = picoklex_getLexIndexSize(this);
+    if (size == 0) {
+        return;
+    }
+    klex->hashind = (picoos_uint32 *) mem;
+    klex->hashmask = size / sizeof(picoos_uint32) - 1;
+    klex->nrgraphs = 0;
+    picoos_mem_set(klex->hashind, 0, size);
+    /* the search index lookup stays in use unless it agrees on every
+       graph with the hash lookup */
+    if (!klex_forEachEntry(klex, klex_hashEnter, &nrentries)
+        || !klex_forEachEntry(klex, klex_hashCheck, &nrentries)) {
+        PICODBG_WARN(("lex cannot be indexed"));
+        klex->hashind = NULL;
+        klex->hashmask = 0;
+        klex->nrgraphs = 0;
+    }
+    PICODBG_DEBUG(("lex index: %d graphs in %d slots", klex->nrgraphs,
+                   klex->hashmask + 1));
+}
+
+
+/* looks 'graph' up in the graph index */
+static picoos_uint8 klex_hashLookup(const klex_SubObj klex,
+                                    const picoos_uint8 *graph,
+                                    const picoos_uint16 graphlen,
+                                    picoklex_lexl_result_t *lexres) {
+    picoos_uint32 slot;
+
+    lexres->nrres = 0;
+    lexres->posindlen = 0;
+    lexres->phonfound = FALSE;
+
+    slot = klex->hashind[klex_hashSlot(klex, graph, graphlen)];
+    if (0 == slot) {
+        return FALSE;
+    }
+    klex_lexblockLookup(klex, (slot & PICOKLEX_HASH_POSMASK) - 1,
+                        (picoos_uint32)klex->nrblocks * PICOKLEX_LEXBLOCK_SIZE,
+                        graph, graphlen, lexres);
+    return (lexres->nrres > 0);
+}
+
+
 /* ************************************************************/
 /* lexicon lookup functions */
 /* ************************************************************/
 
-picoos_uint8 picoklex_lexLookup(const picoklex_Lex this,
-                                const picoos_uint8 *graph,
-                                const picoos_uint16 graphlen,
-                                picoklex_lexl_result_t *lexres) {
+/* looks 'graph' up in the lexblocks the search index points to */
+static picoos_uint8 klex_searchLookup(const klex_SubObj klex,
+                                      const picoos_uint8 *graph,
+                                      const picoos_uint16 graphlen,
+                                      picoklex_lexl_result_t *lexres) {
     picoos_uint16 lbnr, lbc;
     picoos_uint32 lexposStart, lexposEnd;
     picoos_uint8 i;
     picoos_uint8 tgraph[PICOKLEX_LEX_SIE_NRGRAPHS];
-    klex_SubObj klex = (klex_SubObj) this;
-
-    if (NULL == klex) {
-        PICODBG_ERROR(("no lexicon loaded"));
-        /* no exception here needed, already checked at initialization */
-        return FALSE;
-    }
 
     lexres->nrres = 0;
     lexres->posindlen = 0;
@@ -531,6 +748,24 @@ picoos_uint8 picoklex_lexLookup(const picoklex_Lex this,
 }
 
 
+picoos_uint8 picoklex_lexLookup(const picoklex_Lex this,
+                                const picoos_uint8 *graph,
+                                const picoos_uint16 graphlen,
+                                picoklex_lexl_result_t *lexres) {
+    klex_SubObj klex = (klex_SubObj) this;
+
+    if (NULL == klex) {
+        PICODBG_ERROR(("no lexicon loaded"));
+        /* no exception here needed, already checked at initialization */
+        return FALSE;
+    }
+    if (NULL != klex->hashind) {
+        return klex_hashLookup(klex, graph, graphlen, lexres);
+    }
+    return klex_searchLookup(klex, graph, graphlen, lexres);
+}
+
+
 picoos_uint8 picoklex_lexIndLookup(const picoklex_Lex this,
                                    const picoos_uint8 *ind,
                                    const picoos_uint8 indlen,
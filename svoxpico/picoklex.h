@@ -59,6 +59,16 @@ typedef struct picoklex_lex * picoklex_Lex;
 /* return kb lex for usage in PU */
 picoklex_Lex picoklex_getLex(picoknow_KnowledgeBase this);
 
+/* number of bytes needed for an index from the graphs of lex 'this' to
+   their entries, or 0 if 'this' is no lex or cannot be indexed */
+picoos_uint32 picoklex_getLexIndexSize(picoknow_KnowledgeBase this);
+
+/* builds the index of lex 'this' in 'mem', of picoklex_getLexIndexSize
+   bytes, and looks graphs up with it from then on instead of scanning
+   the lexblocks. Keeps scanning if the index does not find the same
+   entries for every graph. 'mem' has to stay valid as long as 'this' */
+void picoklex_indexLex(picoknow_KnowledgeBase this, void *mem);
+
 
 /* ************************************************************/
 /* lexicon lookup result type */
@@ -230,6 +230,7 @@ static pico_status_t kpdfMULInitialize(register picoknow_KnowledgeBase this,
         return picoos_emRaiseException(common->em,PICO_EXC_FILE_CORRUPT,NULL,NULL);
     }
     pdfmul->content = &(this->base[pos]);
+    pdfmul->values = NULL;
     PICODBG_DEBUG(("numframes %d, vecsize %d, numstates %d, ceporder %d, "
                    "numvuv %d, numdeltas %d, meanpow %d, bigpow %d",
                    pdfmul->numframes, pdfmul->vecsize, pdfmul->numstates,
@@ -373,6 +374,79 @@ picokpdf_PdfPHS picokpdf_getPdfPHS(picoknow_KnowledgeBase this) {
 }
 
 
+/* ************************************************************/
+/* pdf MUL decoding */
+/* ************************************************************/
+
+/* the sparse delta means are listed by ascending index, so that a single
+   pass over them finds what searching them per dimension would */
+void picokpdf_decodeMUL(const picokpdf_PdfMUL this, picoos_uint16 vec,
+                        picoos_uint8 from, picoos_uint8 num,
+                        picoos_int32 *values) {
+    picoos_uint8 *p = this->content + vec * this->vecsize + this->numvuv;
+    picoos_uint8 *q;
+    picoos_uint8 ceporder = this->ceporder;
+    picoos_uint8 s, c, ind;
+    picoos_uint16 ivarstart;
+
+    if (this->numdeltas == 0xFF) {
+        /* static, delta and delta delta means, then the same inverse variances */
+        for (s = 0; s < 3; s++) {
+            for (c = from; c < from + num; c++) {
+                q = p + (s * ceporder + c) * 2;
+                values[s * ceporder + c] =
+                    ((picoos_int32) ((picoos_int16) (*(q + 1) << 8)) | *q)
+                    << (this->meanpowUm[s * ceporder + c]);
+            }
+        }
+        ivarstart = ceporder * 6;
+    } else {
+        /* static means, delta (delta) indices, sparse delta (delta)
+           means, then inverse variances */
+        for (c = from; c < from + num; c++) {
+            q = p + c * 2;
+            values[c] = ((picoos_int32) ((picoos_int16) (*(q + 1) << 8)) | *q)
+                << (this->meanpowUm[c]);
+            values[ceporder + c] = 0;
+            values[2 * ceporder + c] = 0;
+        }
+        for (s = 0; s < this->numdeltas; s++) {
+            ind = p[ceporder * 2 + s]; /* delta of dimension ind, or delta delta of ind-ceporder */
+            c = (ind < ceporder) ? ind : ind - ceporder;
+            if ((c >= from) && (c < from + num)) {
+                q = p + ceporder * 2 + this->numdeltas + s * 2;
+                values[ceporder + ind] =
+                    ((picoos_int32) ((picoos_int16) (*(q + 1) << 8)) | *q)
+                    << (this->meanpowUm[ceporder + ind]);
+            }
+        }
+        ivarstart = ceporder * 2 + this->numdeltas * 3;
+    }
+    for (s = 0; s < 3; s++) {
+        for (c = from; c < from + num; c++) {
+            values[(3 + s) * ceporder + c] =
+                (picoos_int32) (p[ivarstart + s * ceporder + c])
+                << (this->ivarpow[s * ceporder + c]);
+        }
+    }
+}
+
+picoos_uint32 picokpdf_getExpandedSizeMUL(const picokpdf_PdfMUL this) {
+    return (picoos_uint32) this->numframes * PICOKPDF_MUL_NUMVALUES
+        * this->ceporder * sizeof(picoos_int32);
+}
+
+void picokpdf_expandPdfMUL(picokpdf_PdfMUL this, picoos_int32 *values) {
+    picoos_uint16 vec;
+    picoos_uint32 n = PICOKPDF_MUL_NUMVALUES * this->ceporder;
+
+    for (vec = 0; vec < this->numframes; vec++) {
+        picokpdf_decodeMUL(this, vec, 0, this->ceporder, values + vec * n);
+    }
+    this->values = values;
+}
+
+
 #ifdef __cplusplus
 }
 #endif
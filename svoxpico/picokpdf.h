@@ -122,6 +122,7 @@ typedef struct picokpdf_pdfmul {
     picoos_uint8 *meanpowUm;  /* KPDF_NUMSTREAMS x ceporder values */
     picoos_uint8 *ivarpow;    /* KPDF_NUMSTREAMS x ceporder values */
     picoos_uint8 *content;
+    picoos_int32 *values;     /* content expanded by picokpdf_expandPdfMUL, or NULL */
 } picokpdf_pdfmul_t;
 
 /* subobj specific for pdf phs type */
@@ -152,6 +153,28 @@ picokpdf_PdfPHS picokpdf_getPdfPHS(picoknow_KnowledgeBase this);
 /* PDF MUL functions */
 /* ************************************************************/
 
+/* a decoded vector holds PICOKPDF_MUL_NUMVALUES rows of ceporder values
+   each: the static, delta and delta delta means, then the static, delta
+   and delta delta inverse variances, all scaled to the fixed point base
+   1<<bigpow (sparse delta means that are not stored are 0) */
+#define PICOKPDF_MUL_NUMVALUES 6
+
+/* decodes the values of cepstral dimensions 'from' to 'from'+'num'-1 of
+   vector 'vec' into 'values', at the place they have in a full decoded
+   vector */
+void picokpdf_decodeMUL(const picokpdf_PdfMUL this, picoos_uint16 vec,
+                        picoos_uint8 from, picoos_uint8 num,
+                        picoos_int32 *values);
+
+/* number of bytes picokpdf_expandPdfMUL needs for all vectors of 'this' */
+picoos_uint32 picokpdf_getExpandedSizeMUL(const picokpdf_PdfMUL this);
+
+/* decodes all vectors of 'this' into 'values', which must hold
+   picokpdf_getExpandedSizeMUL bytes, and has the PUs read them from there
+   (in this->values, vector i at i*PICOKPDF_MUL_NUMVALUES*ceporder) instead
+   of decoding the packed content. 'values' must outlive the kb. */
+void picokpdf_expandPdfMUL(picokpdf_PdfMUL this, picoos_int32 *values);
+
 #ifdef __cplusplus
 }
 #endif
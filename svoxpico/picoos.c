@@ -1305,9 +1305,8 @@ picoos_bool picoos_GetPos(picoos_File f, picoos_uint32 * pos)
         /* if (f->bFile) {
          (*pos) =  BGetPos(f);
          } else { */
-        (*pos) =  LGetPos(f, pos);
+        return LGetPos(f, pos);
         /* } */
-        return TRUE;
     } else {
         (*pos) = 0;
         return FALSE;
@@ -54,6 +54,7 @@ extern "C" {
 typedef picopal_uint8   picoos_uint8;
 typedef picopal_uint16  picoos_uint16;
 typedef picopal_uint32  picoos_uint32;
+typedef picopal_uint64  picoos_uint64;
 
 typedef picopal_int8    picoos_int8;
 typedef picopal_int16   picoos_int16;
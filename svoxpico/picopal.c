@@ -89,6 +89,15 @@ extern "C" {
 #include <time.h>
 #if PICO_PLATFORM == PICO_Windows
 #include <windows.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 
 #if defined(PRAGMA_MESSAGE)
@@ -400,6 +409,69 @@ picopal_objsize_t picopal_fread_bytes (picopal_File f, void * ptr, picopal_objsi
 }
 
 picopal_objsize_t picopal_fwrite_bytes (picopal_File f, void * ptr, picopal_objsize_t objsize, picopal_uint32 nobj){    return (picopal_objsize_t) fwrite(ptr, objsize, nobj, (FILE *)f);}
+
+void * picopal_map_file (picopal_char fileName[], picopal_objsize_t * size)
+{
+    void * start = NULL;
+    picopal_objsize_t len = 0;
+#if PICO_PLATFORM == PICO_Windows
+    HANDLE file, mapping;
+    DWORD flen;
+
+    *size = 0;
+    file = CreateFileA((LPCSTR) fileName, GENERIC_READ, FILE_SHARE_READ, NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (INVALID_HANDLE_VALUE == file) {
+        return NULL;
+    }
+    flen = GetFileSize(file, NULL);
+    if ((INVALID_FILE_SIZE != flen) && (flen > 0)) {
+        len = (picopal_objsize_t) flen;
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (NULL != mapping) {
+            start = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            /* the view keeps the mapping alive */
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd;
+    struct stat st;
+
+    *size = 0;
+    fd = open((const char *) fileName, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    if ((0 == fstat(fd, &st)) && (st.st_size > 0)) {
+        len = (picopal_objsize_t) st.st_size;
+        start = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (MAP_FAILED == start) {
+            start = NULL;
+        }
+    }
+    /* the mapping keeps the file alive */
+    close(fd);
+#endif
+    if (NULL != start) {
+        *size = len;
+    }
+    return start;
+}
+
+void picopal_unmap_file (void * start, picopal_objsize_t size)
+{
+    if (NULL == start) {
+        return;
+    }
+#if PICO_PLATFORM == PICO_Windows
+    (void) size;
+    UnmapViewOfFile(start);
+#else
+    munmap(start, (size_t) size);
+#endif
+}
 /* *************************************************/
 /* functions for debugging/testing purposes only   */
 /* *************************************************/
@@ -475,6 +547,7 @@ picopal_double picopal_quick_exp(const picopal_double y) {
 
     } _eco;
     _eco.n.i = (picopal_int32)(1512775.3951951856938297995605697f * y) + 1072632447;
+    _eco.n.j = 0;
     return _eco.d;
 }
 
@@ -547,6 +620,271 @@ void picopal_get_timer(picopal_uint32 * sec, picopal_uint32 * usec)
 #endif /* IMPLEMENT_TIMER */
 }
 
+picopal_uint64 picopal_get_nanos(void)
+{
+#if PICO_PLATFORM == PICO_Windows
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (0 == freq.QuadPart) {
+        QueryPerformanceFrequency(&freq);
+    }
+    QueryPerformanceCounter(&now);
+    return (picopal_uint64) ((double) now.QuadPart * 1e9 / (double) freq.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (picopal_uint64) now.tv_sec * 1000000000u + (picopal_uint64) now.tv_nsec;
+#endif
+}
+
+/* *************************************************/
+/* threads, events and atomic counters             */
+/* *************************************************/
+
+typedef struct picopal_thread {
+#if PICO_PLATFORM == PICO_Windows
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+    picopal_thread_func func;
+    void * arg;
+} picopal_thread_t;
+
+typedef struct picopal_event {
+#if PICO_PLATFORM == PICO_Windows
+    CRITICAL_SECTION lock;
+    CONDITION_VARIABLE cond;
+#else
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+#endif
+    volatile picopal_int32 seq;
+    volatile picopal_int32 waiters;
+} picopal_event_t;
+
+#if PICO_PLATFORM == PICO_Windows
+static DWORD WINAPI picopal_thread_main(LPVOID arg)
+{
+    picopal_Thread this = (picopal_Thread) arg;
+    this->func(this->arg);
+    return 0;
+}
+#else
+static void * picopal_thread_main(void * arg)
+{
+    picopal_Thread this = (picopal_Thread) arg;
+    this->func(this->arg);
+    return NULL;
+}
+#endif
+
+picopal_Thread picopal_thread_create(picopal_thread_func func, void * arg)
+{
+    picopal_Thread this = (picopal_Thread) malloc(sizeof(*this));
+    if (NULL == this) {
+        return NULL;
+    }
+    this->func = func;
+    this->arg = arg;
+#if PICO_PLATFORM == PICO_Windows
+    this->handle = CreateThread(NULL, 0, picopal_thread_main, this, 0, NULL);
+    if (NULL == this->handle) {
+        free(this);
+        return NULL;
+    }
+#else
+    if (0 != pthread_create(&this->handle, NULL, picopal_thread_main, this)) {
+        free(this);
+        return NULL;
+    }
+#endif
+    return this;
+}
+
+void picopal_thread_join(picopal_Thread * thread)
+{
+    if (NULL != (*thread)) {
+#if PICO_PLATFORM == PICO_Windows
+        WaitForSingleObject((*thread)->handle, INFINITE);
+        CloseHandle((*thread)->handle);
+#else
+        pthread_join((*thread)->handle, NULL);
+#endif
+        free(*thread);
+        *thread = NULL;
+    }
+}
+
+picopal_Event picopal_event_new(void)
+{
+    picopal_Event this = (picopal_Event) malloc(sizeof(*this));
+    if (NULL == this) {
+        return NULL;
+    }
+#if PICO_PLATFORM == PICO_Windows
+    InitializeCriticalSection(&this->lock);
+    InitializeConditionVariable(&this->cond);
+#else
+    pthread_mutex_init(&this->lock, NULL);
+    pthread_cond_init(&this->cond, NULL);
+#endif
+    this->seq = 0;
+    this->waiters = 0;
+    return this;
+}
+
+void picopal_event_dispose(picopal_Event * event)
+{
+    if (NULL != (*event)) {
+#if PICO_PLATFORM == PICO_Windows
+        DeleteCriticalSection(&(*event)->lock);
+#else
+        pthread_cond_destroy(&(*event)->cond);
+        pthread_mutex_destroy(&(*event)->lock);
+#endif
+        free(*event);
+        *event = NULL;
+    }
+}
+
+picopal_uint32 picopal_event_token(picopal_Event this)
+{
+    return (picopal_uint32) picopal_atomic_get(&this->seq);
+}
+
+void picopal_event_wait(picopal_Event this, picopal_uint32 token)
+{
+    /* 'waiters' is raised before 'seq' is re-checked, and a signaller
+       raises 'seq' before looking at 'waiters'; so either we see the
+       new 'seq' here, or the signaller sees us waiting and takes the lock */
+    picopal_atomic_add(&this->waiters, 1);
+#if PICO_PLATFORM == PICO_Windows
+    EnterCriticalSection(&this->lock);
+    while ((picopal_uint32) picopal_atomic_get(&this->seq) == token) {
+        SleepConditionVariableCS(&this->cond, &this->lock, INFINITE);
+    }
+    LeaveCriticalSection(&this->lock);
+#else
+    pthread_mutex_lock(&this->lock);
+    while ((picopal_uint32) picopal_atomic_get(&this->seq) == token) {
+        pthread_cond_wait(&this->cond, &this->lock);
+    }
+    pthread_mutex_unlock(&this->lock);
+#endif
+    picopal_atomic_add(&this->waiters, -1);
+}
+
+void picopal_event_signal(picopal_Event this)
+{
+    picopal_atomic_add(&this->seq, 1);
+    if (picopal_atomic_get(&this->waiters) > 0) {
+#if PICO_PLATFORM == PICO_Windows
+        EnterCriticalSection(&this->lock);
+        WakeAllConditionVariable(&this->cond);
+        LeaveCriticalSection(&this->lock);
+#else
+        pthread_mutex_lock(&this->lock);
+        pthread_cond_broadcast(&this->cond);
+        pthread_mutex_unlock(&this->lock);
+#endif
+    }
+}
+
+picopal_int32 picopal_atomic_get(volatile picopal_int32 * p)
+{
+#if PICO_PLATFORM == PICO_Windows
+    return InterlockedCompareExchange((volatile LONG *) p, 0, 0);
+#else
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+#endif
+}
+
+void picopal_atomic_set(volatile picopal_int32 * p, picopal_int32 val)
+{
+#if PICO_PLATFORM == PICO_Windows
+    InterlockedExchange((volatile LONG *) p, val);
+#else
+    __atomic_store_n(p, val, __ATOMIC_SEQ_CST);
+#endif
+}
+
+picopal_int32 picopal_atomic_add(volatile picopal_int32 * p, picopal_int32 delta)
+{
+#if PICO_PLATFORM == PICO_Windows
+    return InterlockedExchangeAdd((volatile LONG *) p, delta) + delta;
+#else
+    return __atomic_add_fetch(p, delta, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/* *************************************************/
+/* CPU features                                    */
+/* *************************************************/
+
+picopal_uint32 picopal_cpu_features(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.1") ? PICOPAL_CPU_SSE41 : 0;
+#else
+    return 0;
+#endif
+#elif defined(_M_X64) || defined(_M_IX86)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) ? PICOPAL_CPU_SSE41 : 0;
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && defined(PICO_SIMD_NEON)
+    /* Advanced SIMD is part of every ARMv8-A processor; only reported
+       when the unchecked NEON kernels are asked for (see picosimd.h) */
+    return PICOPAL_CPU_NEON;
+#else
+    return 0;
+#endif
+}
+
+/* *************************************************/
+/* process-wide objects                            */
+/* *************************************************/
+
+void * picopal_mem_alloc(picopal_objsize_t size)
+{
+    return malloc(size);
+}
+
+void picopal_mem_free(void ** p)
+{
+    if (NULL != (*p)) {
+        free(*p);
+        *p = NULL;
+    }
+}
+
+#if PICO_PLATFORM == PICO_Windows
+static SRWLOCK picopal_globalLock = SRWLOCK_INIT;
+#else
+static pthread_mutex_t picopal_globalLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+void picopal_global_lock(void)
+{
+#if PICO_PLATFORM == PICO_Windows
+    AcquireSRWLockExclusive(&picopal_globalLock);
+#else
+    pthread_mutex_lock(&picopal_globalLock);
+#endif
+}
+
+void picopal_global_unlock(void)
+{
+#if PICO_PLATFORM == PICO_Windows
+    ReleaseSRWLockExclusive(&picopal_globalLock);
+#else
+    pthread_mutex_unlock(&picopal_globalLock);
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -103,6 +103,7 @@ typedef signed int pico_status_t;
 typedef unsigned char   picopal_uint8;
 typedef unsigned short  picopal_uint16;
 typedef unsigned int    picopal_uint32;
+typedef unsigned long long picopal_uint64;
 
 typedef signed char     picopal_int8;
 typedef signed short    picopal_int16;
@@ -229,6 +230,15 @@ extern picopal_objsize_t picopal_fwrite_bytes (picopal_File f, void * ptr, picop
 
 extern pico_status_t picopal_fflush (picopal_File f);
 
+/* maps the whole file 'fileName' read-only into memory and returns its
+   start, or NULL if it cannot be mapped; '*size' receives the file length.
+   The pages are those of the system's file cache, shared with every other
+   process mapping the same file. */
+extern void * picopal_map_file (picopal_char fileName[], picopal_objsize_t * size);
+
+/* releases a mapping obtained from 'picopal_map_file' */
+extern void picopal_unmap_file (void * start, picopal_objsize_t size);
+
 /*
 extern pico_status_t picopal_fput_char (picopal_File f, picopal_char ch);
 */
@@ -280,6 +290,80 @@ picopal_double picopal_quick_exp(const picopal_double y);
 
 extern void picopal_get_timer(picopal_uint32 * sec, picopal_uint32 * usec);
 
+/* monotonic clock with (close to) nanosecond resolution; only differences
+   between two readings are meaningful */
+extern picopal_uint64 picopal_get_nanos(void);
+
+/* *************************************************/
+/* threads, events and atomic counters             */
+/* *************************************************/
+
+typedef struct picopal_thread * picopal_Thread;
+typedef struct picopal_event * picopal_Event;
+
+typedef void (* picopal_thread_func) (void * arg);
+
+/* starts 'func(arg)' on a new thread; returns NULL if no thread could be
+   created */
+picopal_Thread picopal_thread_create(picopal_thread_func func, void * arg);
+
+/* waits until the thread has returned from its function and releases
+   the thread object; '*thread' is set to NULL */
+void picopal_thread_join(picopal_Thread * thread);
+
+/* an event is a wake-up counter that allows a thread to sleep until
+   another thread signals a change of some shared state. Waiting is
+   done in two steps to avoid lost wake-ups:
+     token = picopal_event_token(ev);
+     if (<shared state unchanged>) picopal_event_wait(ev, token);
+   'picopal_event_wait' returns as soon as the event was signalled
+   after 'token' was taken. Signalling is cheap if no thread waits. */
+picopal_Event picopal_event_new(void);
+
+void picopal_event_dispose(picopal_Event * event);
+
+picopal_uint32 picopal_event_token(picopal_Event event);
+
+void picopal_event_wait(picopal_Event event, picopal_uint32 token);
+
+void picopal_event_signal(picopal_Event event);
+
+/* sequentially consistent operations on 32-bit counters shared between
+   threads; 'picopal_atomic_add' returns the new value */
+picopal_int32 picopal_atomic_get(volatile picopal_int32 * p);
+
+void picopal_atomic_set(volatile picopal_int32 * p, picopal_int32 val);
+
+picopal_int32 picopal_atomic_add(volatile picopal_int32 * p, picopal_int32 delta);
+
+/* *************************************************/
+/* CPU features                                    */
+/* *************************************************/
+
+#define PICOPAL_CPU_SSE41   0x01
+#define PICOPAL_CPU_NEON    0x02
+
+/* the vector units of the processor the program runs on that the
+   library can use, as a set of PICOPAL_CPU_* flags */
+picopal_uint32 picopal_cpu_features(void);
+
+/* *************************************************/
+/* process-wide objects                            */
+/* *************************************************/
+
+/* memory for objects that outlive the pico system that created them and
+   are shared between systems (e.g. shared lingware); returns NULL if
+   out of memory */
+void * picopal_mem_alloc(picopal_objsize_t size);
+
+void picopal_mem_free(void ** p);
+
+/* a single process-wide lock guarding the objects shared between pico
+   systems. It needs no initialization and is not recursive. */
+void picopal_global_lock(void);
+
+void picopal_global_unlock(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -138,6 +138,28 @@ typedef struct
     picopal_uint8 phoneV[PICOPAM_VECT_SIZE];
 } sFtVect, *pSftVect;
 
+/*----------------------------------------------------------------*/
+/*memo of the tree classifications of recent phone feature vectors */
+/*The duration, F0 and spectrum trees of a phone only ask about a  */
+/*part of its PICOPAM_INVEC_SIZE features, and those parts come up */
+/*again and again in a longer text. The memo is direct mapped; an  */
+/*entry holds the features its trees depend on and, depending on   */
+/*'kind', either the duration and F0 classes (vector before        */
+/*pam_update_vector) or the spectrum classes (after)               */
+#define PICOPAM_MEMO_SIZE   1024 /*number of entries, a power of 2  */
+#define PICOPAM_MEMO_NONE   0   /*unused entry                     */
+#define PICOPAM_MEMO_DURLFZ 1   /*classes[0] dur, [1..5] lfz       */
+#define PICOPAM_MEMO_MGC    2   /*classes[0..4] mgc                */
+#define PICOPAM_MEMO_KINDS  2
+
+typedef struct
+{
+    picoos_uint32 hash;
+    picoos_uint16 classes[PICOPAM_MAX_STATES_PER_PHONE + 1];
+    picoos_uint8 kind;
+    picoos_uint8 vec[PICOPAM_INVEC_SIZE]; /*the features keyed on*/
+} pam_memo_entry_t;
+
 /*----------------------------------------------------------
  Name    :   pam_subobj
  Function:   subobject definition for the pam processing
@@ -248,6 +270,10 @@ typedef struct pam_subobj
     picokdt_DtPAM dtdur; /* dtdur knowledge base */
     picokdt_DtPAM dtlfz[PICOPAM_DT_NRLFZ]; /* dtlfz knowledge bases */
     picokdt_DtPAM dtmgc[PICOPAM_DT_NRMGC]; /* dtmgc knowledge bases */
+    picokdt_dtstate_t dtstate; /* classification state of the above trees */
+    pam_memo_entry_t *memo; /* PICOPAM_MEMO_SIZE recent classifications, NULL if none */
+    picoos_uint8 memoNrAtts[PICOPAM_MEMO_KINDS]; /* nr of features the trees of a kind depend on */
+    picoos_uint8 memoAtts[PICOPAM_MEMO_KINDS][PICOPAM_INVEC_SIZE]; /* and which */
     /*---------------------- Pdfs related data -------------------*/
     picokpdf_PdfDUR pdfdur; /* pdfdur knowledge base */
     picokpdf_PdfMUL pdflfz; /* pdflfz knowledge base */
@@ -432,6 +458,9 @@ static pico_status_t pam_expand_vector(register picodata_ProcessingUnit this);
 static picoos_uint8 pam_do_tree(register picodata_ProcessingUnit this,
         const picokdt_DtPAM dtpam, const picoos_uint8 *invec,
         const picoos_uint8 inveclen, picokdt_classify_result_t *dtres);
+static void pam_memo_initialize(register picodata_ProcessingUnit this);
+static pam_memo_entry_t *pam_memo_lookup(register picodata_ProcessingUnit this,
+        picoos_uint8 kind, picoos_uint8 *found);
 static pico_status_t pam_get_f0(register picodata_ProcessingUnit this,
         picoos_uint16 *lf0Index, picoos_uint8 nState, picoos_single *phonF0);
 static pico_status_t pam_get_duration(register picodata_ProcessingUnit this,
@@ -475,6 +504,7 @@ static pico_status_t pam_allocate(picoos_MemoryManager mm, pam_subobj_t *pam)
     pam->sPhFeats = NULL;
     pam->sSyllItems = NULL;
     pam->sSyllItemOffs = NULL;
+    pam->memo = NULL;
 
     /*-----------------------------------------------------------------
      * PAM Local buffers ALLOCATION
@@ -518,6 +548,10 @@ static pico_status_t pam_allocate(picoos_MemoryManager mm, pam_subobj_t *pam)
     }
     pam->sSyllItemOffs = (picoos_int16*) dataI;
 
+    /*the memo only saves time: without the room for it, do without it*/
+    pam->memo = (pam_memo_entry_t *) picoos_allocate(mm,
+            sizeof(pam_memo_entry_t) * PICOPAM_MEMO_SIZE);
+
     return PICO_OK;
 }/*pam_allocate*/
 
@@ -545,6 +579,8 @@ static void pam_deallocate(picoos_MemoryManager mm, pam_subobj_t *pam)
         picoos_deallocate(mm, (void *) &pam->sSyllItems);
     if (pam->sSyllItemOffs != NULL)
         picoos_deallocate(mm, (void *) &pam->sSyllItemOffs);
+    if (pam->memo != NULL)
+        picoos_deallocate(mm, (void *) &pam->memo);
 
 }/*pam_deallocate*/
 
@@ -620,6 +656,11 @@ static pico_status_t pam_initialize(register picodata_ProcessingUnit this, picoo
         { 1, 10, 10, 10, 10 },/*SEND*/
         { 1, 1, 1, 1, 1 } /*DEFAULT*/
         };
+        /* the loop below only ever sets the diagonal; the rest of the
+           table used to be whatever the memory area held before, which
+           is zero in a fresh process. Clear it, so that the durations do
+           not depend on what the area was used for earlier */
+        picoos_mem_set(pam->sil_weights, 0, sizeof(pam->sil_weights));
         for (i = 0; i < PICOPAM_PWIDX_SIZE; i++) {
             for (j = 0; j < PICOPAM_PWIDX_SIZE; j++) {
                 pam->sil_weights[j][j] = tmp_weights[i][j];
@@ -704,6 +745,9 @@ static pico_status_t pam_initialize(register picodata_ProcessingUnit this, picoo
         return PICO_ERR_OTHER;
     }PICODBG_DEBUG(("got tabphones"));
 
+    /*the trees may have changed with the voice*/
+    pam_memo_initialize(this);
+
     return PICO_OK;
 }/*pam_initialize*/
 
@@ -2189,7 +2233,8 @@ static pico_status_t pamPhoneProcess(register picodata_ProcessingUnit this)
     pam_subobj_t *pam;
     pico_status_t sResult;
     picokdt_classify_result_t dTreeResult;
-    picoos_uint8 nI, bWr;
+    pam_memo_entry_t *memo;
+    picoos_uint8 nI, bWr, found, okay;
 
     pam = (pam_subobj_t *) this->subObj;
     if (NULL == this || NULL == this->subObj) {
@@ -2200,25 +2245,43 @@ static pico_status_t pamPhoneProcess(register picodata_ProcessingUnit this)
     sResult = pamCompressVector(this);
     sResult = pamReorgVector(this);
 
-    /*tree traversal for duration*/
-    if (!pam_do_tree(this, pam->dtdur, &(pam->sPhFeats[0]), PICOPAM_INVEC_SIZE,
-            &dTreeResult)) {
-        PICODBG_WARN(("problem using pam tree dtdur, using fallback value"));
-        dTreeResult.class = 0;
-    }
-    pam->durIndex = dTreeResult.class;
-    sResult = pam_get_duration(this, pam->durIndex, &(pam->phonDur),
-            &(pam->numFramesState[0]));
-
-    /*tree traversal for pitch*/
-    for (nI = 0; nI < PICOPAM_MAX_STATES_PER_PHONE; nI++) {
-        if (!pam_do_tree(this, pam->dtlfz[nI], &(pam->sPhFeats[0]),
+    memo = pam_memo_lookup(this, PICOPAM_MEMO_DURLFZ, &found);
+    if (found) {
+        pam->durIndex = memo->classes[0];
+        for (nI = 0; nI < PICOPAM_MAX_STATES_PER_PHONE; nI++)
+            pam->lf0Index[nI] = memo->classes[nI + 1];
+    } else {
+        /*only memorize classes the trees did come up with, so that a
+         failing tree keeps raising its warnings*/
+        okay = TRUE;
+        /*tree traversal for duration*/
+        if (!pam_do_tree(this, pam->dtdur, &(pam->sPhFeats[0]),
                 PICOPAM_INVEC_SIZE, &dTreeResult)) {
-            PICODBG_WARN(("problem using pam tree lf0Tree, using fallback value"));
+            PICODBG_WARN(("problem using pam tree dtdur, using fallback value"));
             dTreeResult.class = 0;
+            okay = FALSE;
+        }
+        pam->durIndex = dTreeResult.class;
+
+        /*tree traversal for pitch*/
+        for (nI = 0; nI < PICOPAM_MAX_STATES_PER_PHONE; nI++) {
+            if (!pam_do_tree(this, pam->dtlfz[nI], &(pam->sPhFeats[0]),
+                    PICOPAM_INVEC_SIZE, &dTreeResult)) {
+                PICODBG_WARN(("problem using pam tree lf0Tree, using fallback value"));
+                dTreeResult.class = 0;
+                okay = FALSE;
+            }
+            pam->lf0Index[nI] = dTreeResult.class;
+        }
+        if (okay && (memo != NULL)) {
+            memo->classes[0] = pam->durIndex;
+            for (nI = 0; nI < PICOPAM_MAX_STATES_PER_PHONE; nI++)
+                memo->classes[nI + 1] = pam->lf0Index[nI];
+            memo->kind = PICOPAM_MEMO_DURLFZ;
         }
-        pam->lf0Index[nI] = dTreeResult.class;
     }
+    sResult = pam_get_duration(this, pam->durIndex, &(pam->phonDur),
+            &(pam->numFramesState[0]));
 
     /*pdf access for pitch*/
     for (nI = 0; nI < PICOPAM_MAX_STATES_PER_PHONE; nI++) {
@@ -2228,14 +2291,27 @@ static pico_status_t pamPhoneProcess(register picodata_ProcessingUnit this)
     /*update vector with duration and pitch for cep tree traversal*/
     sResult = pam_update_vector(this);
     /*cep tree traversal*/
-    for (nI = 0; nI < PICOPAM_MAX_STATES_PER_PHONE; nI++) {
-
-        if (!pam_do_tree(this, pam->dtmgc[nI], &(pam->sPhFeats[0]),
-                PICOPAM_INVEC_SIZE, &dTreeResult)) {
-            PICODBG_WARN(("problem using pam tree lf0Tree, using fallback value"));
-            dTreeResult.class = 0;
+    memo = pam_memo_lookup(this, PICOPAM_MEMO_MGC, &found);
+    if (found) {
+        for (nI = 0; nI < PICOPAM_MAX_STATES_PER_PHONE; nI++)
+            pam->mgcIndex[nI] = memo->classes[nI];
+    } else {
+        okay = TRUE;
+        for (nI = 0; nI < PICOPAM_MAX_STATES_PER_PHONE; nI++) {
+
+            if (!pam_do_tree(this, pam->dtmgc[nI], &(pam->sPhFeats[0]),
+                    PICOPAM_INVEC_SIZE, &dTreeResult)) {
+                PICODBG_WARN(("problem using pam tree lf0Tree, using fallback value"));
+                dTreeResult.class = 0;
+                okay = FALSE;
+            }
+            pam->mgcIndex[nI] = dTreeResult.class;
+        }
+        if (okay && (memo != NULL)) {
+            for (nI = 0; nI < PICOPAM_MAX_STATES_PER_PHONE; nI++)
+                memo->classes[nI] = pam->mgcIndex[nI];
+            memo->kind = PICOPAM_MEMO_MGC;
         }
-        pam->mgcIndex[nI] = dTreeResult.class;
     }
     /*put item to output buffer*/
     sResult = pam_put_item(this, pam->outBuf, pam->outWritePos, &bWr);
@@ -2766,6 +2842,95 @@ static picodata_step_result_t pam_step(register picodata_ProcessingUnit this,
     return PICODATA_PU_IDLE;
 }/*pam_step*/
 
+/**
+ * clears the memo and finds the features its entries are keyed on
+ * @param    this : Pam item subobject pointer
+ * @return    void
+ * @remarks   without the tree dependencies, keys on all the features
+ * @callgraph
+ * @callergraph
+ */
+static void pam_memo_initialize(register picodata_ProcessingUnit this)
+{
+    pam_subobj_t *pam;
+    picoos_uint8 depends[PICOPAM_MEMO_KINDS][PICOPAM_INVEC_SIZE];
+    picoos_uint8 known, nI, nK;
+    picoos_uint16 nE;
+
+    pam = (pam_subobj_t *) this->subObj;
+    if (pam->memo == NULL) {
+        return;
+    }
+    for (nE = 0; nE < PICOPAM_MEMO_SIZE; nE++)
+        pam->memo[nE].kind = PICOPAM_MEMO_NONE;
+
+    picoos_mem_set(depends, 0, sizeof(depends));
+    known = picokdt_dtPAMgetDependencies(pam->dtdur, depends[0]);
+    for (nI = 0; nI < PICOPAM_DT_NRLFZ; nI++)
+        known = known && picokdt_dtPAMgetDependencies(pam->dtlfz[nI], depends[0]);
+    for (nI = 0; nI < PICOPAM_DT_NRMGC; nI++)
+        known = known && picokdt_dtPAMgetDependencies(pam->dtmgc[nI], depends[1]);
+    for (nK = 0; nK < PICOPAM_MEMO_KINDS; nK++) {
+        pam->memoNrAtts[nK] = 0;
+        for (nI = 0; nI < PICOPAM_INVEC_SIZE; nI++) {
+            if (!known || depends[nK][nI])
+                pam->memoAtts[nK][pam->memoNrAtts[nK]++] = nI;
+        }
+    }
+}/*pam_memo_initialize*/
+
+/**
+ * looks the current phone feature vector up in the memo
+ * @param    this : Pam item subobject pointer
+ * @param    kind : PICOPAM_MEMO_DURLFZ or PICOPAM_MEMO_MGC
+ * @param    *found : TRUE if the entry holds the classes of the vector
+ * @return    the memo entry of the vector, to be filled in if not found;
+ *           NULL if there is no memo
+ * @callgraph
+ * @callergraph
+ */
+static pam_memo_entry_t *pam_memo_lookup(register picodata_ProcessingUnit this,
+        picoos_uint8 kind, picoos_uint8 *found)
+{
+    pam_subobj_t *pam;
+    pam_memo_entry_t *entry;
+    const picoos_uint8 *atts;
+    picoos_uint32 hash;
+    picoos_uint8 nI, nrAtts;
+
+    pam = (pam_subobj_t *) this->subObj;
+    *found = FALSE;
+    if (pam->memo == NULL) {
+        return NULL;
+    }
+    nrAtts = pam->memoNrAtts[kind - 1];
+    atts = pam->memoAtts[kind - 1];
+    /*FNV-1a of the features the trees depend on*/
+    hash = 2166136261u ^ kind;
+    for (nI = 0; nI < nrAtts; nI++) {
+        hash = (hash ^ pam->sPhFeats[atts[nI]]) * 16777619u;
+    }
+    entry = &(pam->memo[(hash ^ (hash >> 16)) & (PICOPAM_MEMO_SIZE - 1)]);
+    if ((entry->kind == kind) && (entry->hash == hash)) {
+        for (nI = 0; (nI < nrAtts)
+                && (entry->vec[nI] == pam->sPhFeats[atts[nI]]); nI++) {
+            /*just compare*/
+        }
+        *found = (nI == nrAtts);
+    }
+    if (*found) {
+        this->cacheHits++;
+    } else {
+        this->cacheMisses++;
+        entry->kind = PICOPAM_MEMO_NONE;
+        entry->hash = hash;
+        for (nI = 0; nI < nrAtts; nI++) {
+            entry->vec[nI] = pam->sPhFeats[atts[nI]];
+        }
+    }
+    return entry;
+}/*pam_memo_lookup*/
+
 /**
  * performs one step of a PamTree
  * @param    this : Pam item subobject pointer
@@ -2781,18 +2946,20 @@ static picoos_uint8 pam_do_tree(register picodata_ProcessingUnit this,
         const picokdt_DtPAM dtpam, const picoos_uint8 *invec,
         const picoos_uint8 inveclen, picokdt_classify_result_t *dtres)
 {
+    pam_subobj_t *pam;
     picoos_uint8 okay;
 
+    pam = (pam_subobj_t *) this->subObj;
     okay = TRUE;
-    /* construct input vector, which is set in dtpam */
-    if (!picokdt_dtPAMconstructInVec(dtpam, invec, inveclen)) {
+    /* construct input vector, which is set in the classification state */
+    if (!picokdt_dtPAMconstructInVec(dtpam, &pam->dtstate, invec, inveclen)) {
         /* error constructing invec */
         PICODBG_WARN(("problem with invec"));
         picoos_emRaiseWarning(this->common->em, PICO_WARN_INVECTOR, NULL, NULL);
         okay = FALSE;
     }
     /* classify */
-    if (okay && (!picokdt_dtPAMclassify(dtpam))) {
+    if (okay && (!picokdt_dtPAMclassify(dtpam, &pam->dtstate))) {
         /* error doing classification */
         PICODBG_WARN(("problem classifying"));
         picoos_emRaiseWarning(this->common->em, PICO_WARN_CLASSIFICATION, NULL,
@@ -2800,7 +2967,7 @@ static picoos_uint8 pam_do_tree(register picodata_ProcessingUnit this,
         okay = FALSE;
     }
     /* decompose */
-    if (okay && (!picokdt_dtPAMdecomposeOutClass(dtpam, dtres))) {
+    if (okay && (!picokdt_dtPAMdecomposeOutClass(dtpam, &pam->dtstate, dtres))) {
         /* error decomposing */
         PICODBG_WARN(("problem decomposing"));
         picoos_emRaiseWarning(this->common->em, PICO_WARN_OUTVECTOR, NULL, NULL);
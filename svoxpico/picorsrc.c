@@ -69,6 +69,8 @@ typedef struct picorsrc_resource {
     /* picoos_uint32 size; */
     picoos_uint8 * start; /* start of content (after header) */
     picoknow_KnowledgeBase kbList;
+    struct picorsrc_shared_resource * shared; /* NULL if content and kbList are owned */
+    picoos_uint8 * values; /* owned expanded pdfs, if any (see picorsrc_setPdfExpansion) */
 } picorsrc_resource_t;
 
 
@@ -106,6 +108,8 @@ static picorsrc_Resource picorsrc_newResource(picoos_MemoryManager mm)
         this->raw_mem = NULL;
         this->start = NULL;
         this->kbList = NULL;
+        this->shared = NULL;
+        this->values = NULL;
         /* this->size=0; */
     }
     return this;
@@ -121,6 +125,7 @@ static void picorsrc_disposeResource(picoos_MemoryManager mm, picorsrc_Resource
         if ((*this)->raw_mem != NULL) {
             picoos_deallocProtMem(mm, (void *) &(*this)->raw_mem);
         }
+        picoos_deallocate(mm, (void *) &(*this)->values);
         picoos_deallocate(mm,(void * *)this);
     }
 }
@@ -219,6 +224,7 @@ typedef struct picorsrc_resource_manager {
     picoos_uint16 numKbs;
     picoknow_KnowledgeBase freeKbs;
     picoos_header_string_t tmpHeader;
+    picoos_bool expandPdfs; /* expand the pdfs of resources loaded from now on */
 } picorsrc_resource_manager_t;
 
 pico_status_t picorsrc_createDefaultResource(picorsrc_ResourceManager this /*,
@@ -240,6 +246,7 @@ picorsrc_ResourceManager picorsrc_newResourceManager(picoos_MemoryManager mm, pi
         this->numVdefs = 0;
         this->vdefs = NULL;
         this->freeVdefs = NULL;
+        this->expandPdfs = FALSE;
     }
     return this;
 }
@@ -252,6 +259,11 @@ void picorsrc_disposeResourceManager(picoos_MemoryManager mm, picorsrc_ResourceM
     }
 }
 
+void picorsrc_setPdfExpansion(picorsrc_ResourceManager this, picoos_bool expand)
+{
+    this->expandPdfs = expand;
+}
+
 
 /* ******* accessing resources **************************************/
 
@@ -335,13 +347,13 @@ static pico_status_t readHeader(picorsrc_ResourceManager this,
 }
 
 static pico_status_t picorsrc_createKnowledgeBase(
-        picorsrc_ResourceManager this,
+        picoos_Common common,
         picoos_uint8 * data,
         picoos_uint32 size,
         picoknow_kb_id_t kbid,
         picoknow_KnowledgeBase * kb)
 {
-    (*kb) = picoknow_newKnowledgeBase(this->common->mm);
+    (*kb) = picoknow_newKnowledgeBase(common->mm);
     if (NULL == (*kb)) {
         return PICO_EXC_OUT_OF_MEM;
     }
@@ -352,43 +364,43 @@ static pico_status_t picorsrc_createKnowledgeBase(
         case PICOKNOW_KBID_TPP_MAIN:
         case PICOKNOW_KBID_TPP_USER_1:
         case PICOKNOW_KBID_TPP_USER_2:
-            return picokpr_specializePreprocKnowledgeBase(*kb, this->common);
+            return picokpr_specializePreprocKnowledgeBase(*kb, common);
             break;
         case PICOKNOW_KBID_TAB_GRAPHS:
-            return picoktab_specializeGraphsKnowledgeBase(*kb, this->common);
+            return picoktab_specializeGraphsKnowledgeBase(*kb, common);
             break;
         case PICOKNOW_KBID_TAB_PHONES:
-            return picoktab_specializePhonesKnowledgeBase(*kb, this->common);
+            return picoktab_specializePhonesKnowledgeBase(*kb, common);
             break;
         case PICOKNOW_KBID_TAB_POS:
-            return picoktab_specializePosKnowledgeBase(*kb, this->common);
+            return picoktab_specializePosKnowledgeBase(*kb, common);
             break;
         case PICOKNOW_KBID_FIXED_IDS:
-            return picoktab_specializeIdsKnowledgeBase(*kb, this->common);
+            return picoktab_specializeIdsKnowledgeBase(*kb, common);
             break;
         case PICOKNOW_KBID_LEX_MAIN:
         case PICOKNOW_KBID_LEX_USER_1:
         case PICOKNOW_KBID_LEX_USER_2:
-            return picoklex_specializeLexKnowledgeBase(*kb, this->common);
+            return picoklex_specializeLexKnowledgeBase(*kb, common);
             break;
         case PICOKNOW_KBID_DT_POSP:
-            return picokdt_specializeDtKnowledgeBase(*kb, this->common,
+            return picokdt_specializeDtKnowledgeBase(*kb, common,
                                                      PICOKDT_KDTTYPE_POSP);
             break;
         case PICOKNOW_KBID_DT_POSD:
-            return picokdt_specializeDtKnowledgeBase(*kb, this->common,
+            return picokdt_specializeDtKnowledgeBase(*kb, common,
                                                      PICOKDT_KDTTYPE_POSD);
             break;
         case PICOKNOW_KBID_DT_G2P:
-            return picokdt_specializeDtKnowledgeBase(*kb, this->common,
+            return picokdt_specializeDtKnowledgeBase(*kb, common,
                                                      PICOKDT_KDTTYPE_G2P);
             break;
         case PICOKNOW_KBID_DT_PHR:
-            return picokdt_specializeDtKnowledgeBase(*kb, this->common,
+            return picokdt_specializeDtKnowledgeBase(*kb, common,
                                                      PICOKDT_KDTTYPE_PHR);
             break;
         case PICOKNOW_KBID_DT_ACC:
-             return picokdt_specializeDtKnowledgeBase(*kb, this->common,
+             return picokdt_specializeDtKnowledgeBase(*kb, common,
                                                       PICOKDT_KDTTYPE_ACC);
              break;
         case PICOKNOW_KBID_FST_SPHO_1:
@@ -410,7 +422,7 @@ static pico_status_t picorsrc_createKnowledgeBase(
         case PICOKNOW_KBID_FST_XSAMPA_PARSE:
         case PICOKNOW_KBID_FST_XSAMPA2SVOXPA:
 
-             return picokfst_specializeFSTKnowledgeBase(*kb, this->common);
+             return picokfst_specializeFSTKnowledgeBase(*kb, common);
              break;
 
         case PICOKNOW_KBID_DT_DUR:
@@ -424,24 +436,24 @@ static pico_status_t picorsrc_createKnowledgeBase(
         case PICOKNOW_KBID_DT_MGC3:
         case PICOKNOW_KBID_DT_MGC4:
         case PICOKNOW_KBID_DT_MGC5:
-            return picokdt_specializeDtKnowledgeBase(*kb, this->common,
+            return picokdt_specializeDtKnowledgeBase(*kb, common,
                                                      PICOKDT_KDTTYPE_PAM);
             break;
         case PICOKNOW_KBID_PDF_DUR:
-            return picokpdf_specializePdfKnowledgeBase(*kb, this->common,
+            return picokpdf_specializePdfKnowledgeBase(*kb, common,
                                                        PICOKPDF_KPDFTYPE_DUR);
 
             break;
         case PICOKNOW_KBID_PDF_LFZ:
-            return picokpdf_specializePdfKnowledgeBase(*kb, this->common,
+            return picokpdf_specializePdfKnowledgeBase(*kb, common,
                                                        PICOKPDF_KPDFTYPE_MUL);
             break;
         case PICOKNOW_KBID_PDF_MGC:
-            return picokpdf_specializePdfKnowledgeBase(*kb, this->common,
+            return picokpdf_specializePdfKnowledgeBase(*kb, common,
                                                        PICOKPDF_KPDFTYPE_MUL);
             break;
         case PICOKNOW_KBID_PDF_PHS:
-            return picokpdf_specializePdfKnowledgeBase(*kb, this->common,
+            return picokpdf_specializePdfKnowledgeBase(*kb, common,
                                                        PICOKPDF_KPDFTYPE_PHS);
             break;
 
@@ -449,7 +461,7 @@ static pico_status_t picorsrc_createKnowledgeBase(
 
 #if defined(PICO_DEBUG)
         case PICOKNOW_KBID_DBG:
-            return picokdbg_specializeDbgKnowledgeBase(*kb, this->common);
+            return picokdbg_specializeDbgKnowledgeBase(*kb, common);
             break;
 #endif
 
@@ -461,14 +473,14 @@ static pico_status_t picorsrc_createKnowledgeBase(
 
 
 static pico_status_t picorsrc_releaseKnowledgeBase(
-        picorsrc_ResourceManager this,
+        picoos_Common common,
         picoknow_KnowledgeBase * kb)
 {
     (*kb) = NULL;
     return PICO_OK;
 }
 
-static pico_status_t picorsrc_getKbList(picorsrc_ResourceManager this,
+static pico_status_t picorsrc_getKbList(picoos_Common common,
         picoos_uint8 * data,
         picoos_uint32 datalen,
         picoknow_KnowledgeBase * kbList)
@@ -508,9 +520,9 @@ static pico_status_t picorsrc_getKbList(picorsrc_ResourceManager this,
                 /* currently we consider a kb mentioned in resource but with offset 0 (no knowledge) as
                  * different form a kb not mentioned at all. We might reconsider that later. */
                 PICODBG_DEBUG((" kb (id %i) is mentioned but empty (base:%i, size:%i)",kb->id, kb->base, kb->size));
-                status = picorsrc_createKnowledgeBase(this, NULL, size, (picoknow_kb_id_t)kbid, &kb);
+                status = picorsrc_createKnowledgeBase(common, NULL, size, (picoknow_kb_id_t)kbid, &kb);
             } else {
-                status = picorsrc_createKnowledgeBase(this, data+offset, size, (picoknow_kb_id_t)kbid, &kb);
+                status = picorsrc_createKnowledgeBase(common, data+offset, size, (picoknow_kb_id_t)kbid, &kb);
             }
             PICODBG_DEBUG(("found kb (id %i) starting at %i with size %i",kb->id, kb->base, kb->size));
             if (PICO_OK == status) {
@@ -522,7 +534,7 @@ static pico_status_t picorsrc_getKbList(picorsrc_ResourceManager this,
     if (PICO_OK != status) {
         kb = *kbList;
         while (NULL != kb) {
-            picorsrc_releaseKnowledgeBase(this,&kb);
+            picorsrc_releaseKnowledgeBase(common,&kb);
         }
     }
 
@@ -530,14 +542,339 @@ static pico_status_t picorsrc_getKbList(picorsrc_ResourceManager this,
 
 }
 
+/* ******* expanded pdfs **************************************/
+
+/* the kbs that picokpdf_expandPdfMUL can expand */
+static picoos_bool isExpandablePdf(picoknow_KnowledgeBase kb)
+{
+    return ((PICOKNOW_KBID_PDF_LFZ == kb->id) || (PICOKNOW_KBID_PDF_MGC == kb->id))
+            && (NULL != kb->subObj);
+}
+
+/* number of bytes needed to expand the pdfs of 'kbList' */
+static picoos_uint32 getExpandedPdfSize(picoknow_KnowledgeBase kbList)
+{
+    picoknow_KnowledgeBase kb;
+    picoos_uint32 size = 0;
+
+    for (kb = kbList; NULL != kb; kb = kb->next) {
+        if (isExpandablePdf(kb)) {
+            size += (picokpdf_getExpandedSizeMUL(picokpdf_getPdfMUL(kb))
+                    + PICOOS_ALIGN_SIZE - 1) / PICOOS_ALIGN_SIZE * PICOOS_ALIGN_SIZE;
+        }
+    }
+    return size;
+}
+
+/* expands the pdfs of 'kbList' one after the other into 'values', which
+   holds getExpandedPdfSize bytes */
+static void expandPdfs(picoknow_KnowledgeBase kbList, picoos_uint8 * values)
+{
+    picoknow_KnowledgeBase kb;
+    picokpdf_PdfMUL pdf;
+
+    for (kb = kbList; NULL != kb; kb = kb->next) {
+        if (isExpandablePdf(kb)) {
+            pdf = picokpdf_getPdfMUL(kb);
+            picokpdf_expandPdfMUL(pdf, (picoos_int32 *) values);
+            values += (picokpdf_getExpandedSizeMUL(pdf) + PICOOS_ALIGN_SIZE - 1)
+                    / PICOOS_ALIGN_SIZE * PICOOS_ALIGN_SIZE;
+        }
+    }
+}
+
+/* ******* compiled decision trees **************************************/
+
+/* number of bytes needed to compile the decision trees of 'kbList' */
+static picoos_uint32 getCompiledDtSize(picoknow_KnowledgeBase kbList)
+{
+    picoknow_KnowledgeBase kb;
+    picoos_uint32 size = 0;
+
+    for (kb = kbList; NULL != kb; kb = kb->next) {
+        size += (picokdt_getCompiledDtSize(kb) + PICOOS_ALIGN_SIZE - 1)
+                / PICOOS_ALIGN_SIZE * PICOOS_ALIGN_SIZE;
+    }
+    return size;
+}
+
+/* compiles the decision trees of 'kbList' one after the other into
+   'trees', which holds getCompiledDtSize bytes */
+static void compileDts(picoknow_KnowledgeBase kbList, picoos_uint8 * trees)
+{
+    picoknow_KnowledgeBase kb;
+    picoos_uint32 size;
+
+    for (kb = kbList; NULL != kb; kb = kb->next) {
+        size = picokdt_getCompiledDtSize(kb);
+        if (size > 0) {
+            picokdt_compileDt(kb, trees);
+            trees += (size + PICOOS_ALIGN_SIZE - 1) / PICOOS_ALIGN_SIZE * PICOOS_ALIGN_SIZE;
+        }
+    }
+}
+
+/* ******* lexicon indexes **************************************/
+
+/* number of bytes needed to index the lexicons of 'kbList' */
+static picoos_uint32 getLexIndexSize(picoknow_KnowledgeBase kbList)
+{
+    picoknow_KnowledgeBase kb;
+    picoos_uint32 size = 0;
+
+    for (kb = kbList; NULL != kb; kb = kb->next) {
+        size += (picoklex_getLexIndexSize(kb) + PICOOS_ALIGN_SIZE - 1)
+                / PICOOS_ALIGN_SIZE * PICOOS_ALIGN_SIZE;
+    }
+    return size;
+}
+
+/* indexes the lexicons of 'kbList' one after the other into 'index',
+   which holds getLexIndexSize bytes */
+static void indexLexes(picoknow_KnowledgeBase kbList, picoos_uint8 * index)
+{
+    picoknow_KnowledgeBase kb;
+    picoos_uint32 size;
+
+    for (kb = kbList; NULL != kb; kb = kb->next) {
+        size = picoklex_getLexIndexSize(kb);
+        if (size > 0) {
+            picoklex_indexLex(kb, index);
+            index += (size + PICOOS_ALIGN_SIZE - 1) / PICOOS_ALIGN_SIZE * PICOOS_ALIGN_SIZE;
+        }
+    }
+}
+
+/* ******* shared resources **************************************/
+
+/**  object   : SharedResource
+ *   shortcut : shr
+ *
+ *   the content of a resource file and its knowledge bases, loaded once
+ *   per process into memory of their own. Nothing in it is modified after
+ *   loading, so the resources of any number of resource managers, used
+ *   from any thread, may refer to the same shared resource. The list of
+ *   shared resources and their reference counts are guarded by
+ *   picopal_global_lock.
+ */
+typedef struct picorsrc_shared_resource * picorsrc_SharedResource;
+
+typedef struct picorsrc_shared_resource {
+    picorsrc_SharedResource next;
+    picorsrc_resource_name_t name;
+    picoos_uint32 refCount;     /* number of resources referring to it */
+    void * mem;                 /* memory block holding all of the below */
+    void * map;                 /* read-only mapping of the resource file, if any */
+    picoos_objsize_t mapSize;
+    picoos_uint8 * start;       /* start of content (after header) */
+    picoknow_KnowledgeBase kbList;
+    picoos_bool expanded;       /* whether the pdfs are expanded ... */
+    void * values;              /* ... into this block of their own */
+    void * trees;               /* compiled decision trees, if any */
+    void * lexIndex;            /* lexicon indexes, if any */
+} picorsrc_shared_resource_t;
+
+/* memory needed by the knowledge base objects of a shared resource, on
+   top of the resource content itself */
+#define PICORSRC_SHARED_KB_MEM_SIZE 32768
+
+static picorsrc_SharedResource sharedResources = NULL;
+
+/* returns the shared resource called 'name', with its pdfs expanded or
+   not as 'expanded' says, with its reference count raised, or NULL if
+   there is none. Call with picopal_global_lock held. */
+static picorsrc_SharedResource findSharedResource(const picoos_char * name,
+        picoos_bool expanded)
+{
+    picorsrc_SharedResource shr = sharedResources;
+    while ((NULL != shr) && ((0 != picoos_strcmp(shr->name, name))
+            || (shr->expanded != expanded))) {
+        shr = shr->next;
+    }
+    if (NULL != shr) {
+        shr->refCount++;
+    }
+    return shr;
+}
+
+/* creates a new shared resource called 'name' from the 'len' bytes of
+   content found at the current position 'offset' of 'file' and creates its
+   knowledge bases. The content is used in place from a read-only mapping
+   of the file called 'fileName'; it is only read into memory if the file
+   cannot be mapped. The knowledge bases parse their content byte by byte,
+   so it need not be aligned in the mapping. If 'expand' is set, the pdfs
+   are expanded into a block of their own. Exceptions are raised on
+   'common'. Call with picopal_global_lock held. */
+static pico_status_t newSharedResource(picoos_Common common,
+        picoos_char * fileName, picoos_File file, picoos_uint32 offset,
+        picoos_uint32 len, const picoos_char * name, picoos_bool expand,
+        picorsrc_SharedResource * shared)
+{
+    picoos_objsize_t size, mapSize;
+    void * mem;
+    void * map;
+    picoos_MemoryManager shmm;
+    picoos_Common shcommon;
+    picorsrc_SharedResource shr;
+    picoos_uint8 * raw;
+    picoos_uint8 rem;
+    picoos_char msg[PICOOS_MAX_EXC_MSG_LEN];
+    pico_status_t status;
+    picoos_uint32 valuesSize, treesSize, lexIndexSize;
+
+    *shared = NULL;
+    map = picopal_map_file(fileName, &mapSize);
+    if ((NULL != map) && (mapSize < (picoos_objsize_t) offset + len)) {
+        /* truncated file; let reading it report the error */
+        picopal_unmap_file(map, mapSize);
+        map = NULL;
+    }
+    size = sizeof(picorsrc_shared_resource_t) + PICORSRC_SHARED_KB_MEM_SIZE;
+    if (NULL == map) {
+        size += len + PICOOS_ALIGN_SIZE;
+    }
+    mem = picopal_mem_alloc(size);
+    if (NULL == mem) {
+        picopal_unmap_file(map, mapSize);
+        return picoos_emRaiseException(common->em, PICO_EXC_OUT_OF_MEM, NULL, NULL);
+    }
+
+    /* the knowledge bases are specialized with a common of their own,
+       so that they live as long as 'mem' rather than the system */
+    shmm = picoos_newMemoryManager(mem, size, FALSE);
+    shcommon = (NULL == shmm) ? NULL : picoos_newCommon(shmm);
+    shr = NULL;
+    raw = NULL;
+    if (NULL != shcommon) {
+        shcommon->mm = shmm;
+        shcommon->em = picoos_newExceptionManager(shmm);
+        shr = picoos_allocate(shmm, sizeof(*shr));
+        raw = (NULL != map) ? (picoos_uint8 *) map + offset
+                : picoos_allocate(shmm, len + PICOOS_ALIGN_SIZE);
+    }
+    if ((NULL == shcommon) || (NULL == shcommon->em) || (NULL == shr) || (NULL == raw)) {
+        picopal_mem_free(&mem);
+        picopal_unmap_file(map, mapSize);
+        return picoos_emRaiseException(common->em, PICO_EXC_OUT_OF_MEM, NULL, NULL);
+    }
+
+    shr->next = NULL;
+    picoos_strlcpy(shr->name, name, PICORSRC_MAX_RSRC_NAME_SIZ);
+    shr->refCount = 1;
+    shr->mem = mem;
+    shr->map = map;
+    shr->mapSize = mapSize;
+    shr->kbList = NULL;
+    shr->expanded = expand;
+    shr->values = NULL;
+    shr->trees = NULL;
+    shr->lexIndex = NULL;
+    if (NULL != map) {
+        shr->start = raw;
+        status = PICO_OK;
+    } else {
+        rem = (picoos_objsize_t) raw % PICOOS_ALIGN_SIZE;
+        shr->start = (rem > 0) ? raw + (PICOOS_ALIGN_SIZE - rem) : raw;
+        status = (picoos_ReadBytes(file, shr->start, &len)) ? PICO_OK : PICO_ERR_OTHER;
+    }
+    if (PICO_OK != status) {
+        picoos_emRaiseException(common->em, status, NULL, (picoos_char *)"resource %s", name);
+    } else {
+        status = picorsrc_getKbList(shcommon, shr->start, len, &shr->kbList);
+        if (PICO_OK != status) {
+            /* pass on what went wrong while specializing */
+            picoos_emGetExceptionMessage(shcommon->em, msg, PICOOS_MAX_EXC_MSG_LEN);
+            picoos_emRaiseException(common->em, status, msg, NULL);
+        }
+    }
+    if ((PICO_OK == status) && expand) {
+        valuesSize = getExpandedPdfSize(shr->kbList);
+        if (valuesSize > 0) {
+            shr->values = picopal_mem_alloc(valuesSize);
+            if (NULL == shr->values) {
+                status = picoos_emRaiseException(common->em, PICO_EXC_OUT_OF_MEM,
+                        NULL, (picoos_char *)"expanding the pdfs of %s", name);
+            } else {
+                expandPdfs(shr->kbList, (picoos_uint8 *) shr->values);
+            }
+        }
+    }
+    if (PICO_OK == status) {
+        /* the trees are walked in place if there is no memory to spare */
+        treesSize = getCompiledDtSize(shr->kbList);
+        if (treesSize > 0) {
+            shr->trees = picopal_mem_alloc(treesSize);
+            if (NULL != shr->trees) {
+                compileDts(shr->kbList, (picoos_uint8 *) shr->trees);
+            }
+        }
+        /* likewise the lexicons are scanned without an index */
+        lexIndexSize = getLexIndexSize(shr->kbList);
+        if (lexIndexSize > 0) {
+            shr->lexIndex = picopal_mem_alloc(lexIndexSize);
+            if (NULL != shr->lexIndex) {
+                indexLexes(shr->kbList, (picoos_uint8 *) shr->lexIndex);
+            }
+        }
+    }
+    if (PICO_OK != status) {
+        picopal_mem_free(&mem);
+        picopal_unmap_file(map, mapSize);
+        return status;
+    }
+
+    shr->next = sharedResources;
+    sharedResources = shr;
+    *shared = shr;
+    return PICO_OK;
+}
+
+/* drops one reference to 'shr'; the last one frees it. Takes
+   picopal_global_lock. */
+static void releaseSharedResource(picorsrc_SharedResource shr)
+{
+    picorsrc_SharedResource * link;
+    void * mem = NULL;
+    void * map = NULL;
+    void * values = NULL;
+    void * trees = NULL;
+    void * lexIndex = NULL;
+    picoos_objsize_t mapSize = 0;
+
+    picopal_global_lock();
+    if (0 == --shr->refCount) {
+        link = &sharedResources;
+        while (*link != shr) {
+            link = &(*link)->next;
+        }
+        *link = shr->next;
+        mem = shr->mem;
+        map = shr->map;
+        mapSize = shr->mapSize;
+        values = shr->values;
+        trees = shr->trees;
+        lexIndex = shr->lexIndex;
+    }
+    picopal_global_unlock();
+    /* 'shr' itself lives in 'mem' */
+    picopal_mem_free(&values);
+    picopal_mem_free(&trees);
+    picopal_mem_free(&lexIndex);
+    picopal_mem_free(&mem);
+    picopal_unmap_file(map, mapSize);
+}
+
+
 /* load resource file. the type of resource file etc. are in the header,
- * then follows the directory, then the knowledge bases themselves (as byte streams) */
+ * then follows the directory, then the knowledge bases themselves (as byte streams).
+ * if 'shared' is TRUE, the content and knowledge bases are taken from (or
+ * put into) the process-wide shared resources instead of the system memory */
 
-pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
-        picoos_char * fileName, picorsrc_Resource * resource)
+static pico_status_t rsrcLoadResource(picorsrc_ResourceManager this,
+        picoos_char * fileName, picoos_bool shared, picorsrc_Resource * resource)
 {
     picorsrc_Resource res;
-    picoos_uint32 headerlen, len,maxlen;
+    picoos_uint32 headerlen, len,maxlen, offset, valuesSize;
     picoos_file_header_t header;
     picoos_uint8 rem;
     pico_status_t status = PICO_OK;
@@ -594,15 +931,34 @@ pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
             /* get data length */
         status = picoos_read_pi_uint32(res->file, &len);
         PICODBG_DEBUG(("found net resource len of %i",len));
+        if ((PICO_OK == status) && shared) {
+            /* take content and kbs from the shared resource, loading it
+               if this is its first user */
+            picopal_global_lock();
+            res->shared = findSharedResource(header.field[PICOOS_HEADER_NAME].value,
+                    this->expandPdfs);
+            if (NULL == res->shared) {
+                picoos_GetPos(res->file, &offset);
+                status = newSharedResource(this->common, fileName, res->file,
+                        offset, len, header.field[PICOOS_HEADER_NAME].value,
+                        this->expandPdfs, &res->shared);
+            }
+            picopal_global_unlock();
+            if (PICO_OK == status) {
+                res->start = res->shared->start;
+                res->kbList = res->shared->kbList;
+            }
+            picoos_CloseBinary(this->common, &res->file);
+        }
         /* allocate memory */
-        if (PICO_OK == status) {
+        if ((PICO_OK == status) && !shared) {
             PICODBG_TRACE((">>> 2"));
             maxlen = len + PICOOS_ALIGN_SIZE; /* once would be sufficient? */
             res->raw_mem = picoos_allocProtMem(this->common->mm, maxlen);
             /* res->size = maxlen; */
             status = (NULL == res->raw_mem) ? PICO_EXC_OUT_OF_MEM : PICO_OK;
         }
-        if (PICO_OK == status) {
+        if ((PICO_OK == status) && !shared) {
             rem = (picoos_uint32) res->raw_mem % PICOOS_ALIGN_SIZE;
             if (rem > 0) {
                 res->start = res->raw_mem + (PICOOS_ALIGN_SIZE - rem);
@@ -647,9 +1003,21 @@ pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
             }
         }
 
-        if (PICO_OK == status) {
+        if ((PICO_OK == status) && !shared) {
             /* create kb list from resource */
-            status = picorsrc_getKbList(this, res->start, len, &res->kbList);
+            status = picorsrc_getKbList(this->common, res->start, len, &res->kbList);
+        }
+        if ((PICO_OK == status) && !shared && this->expandPdfs) {
+            valuesSize = getExpandedPdfSize(res->kbList);
+            if (valuesSize > 0) {
+                res->values = picoos_allocate(this->common->mm, valuesSize);
+                if (NULL == res->values) {
+                    status = picoos_emRaiseException(this->common->em, PICO_EXC_OUT_OF_MEM,
+                            NULL, (picoos_char *)"expanding the pdfs of %s", res->name);
+                } else {
+                    expandPdfs(res->kbList, res->values);
+                }
+            }
         }
     }
 
@@ -661,6 +1029,9 @@ pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
         *resource = res;
         PICODBG_DEBUG(("done loading resource %s from %s", res->name, fileName));
     } else {
+        if (NULL != res->shared) {
+            releaseSharedResource(res->shared);
+        }
         picorsrc_disposeResource(this->common->mm, &res);
         PICODBG_ERROR(("failed to load resource"));
     }
@@ -672,14 +1043,26 @@ pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
     }
 }
 
-static pico_status_t picorsrc_releaseKbList(picorsrc_ResourceManager this, picoknow_KnowledgeBase * kbList)
+pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
+        picoos_char * fileName, picorsrc_Resource * resource)
+{
+    return rsrcLoadResource(this, fileName, FALSE, resource);
+}
+
+pico_status_t picorsrc_loadSharedResource(picorsrc_ResourceManager this,
+        picoos_char * fileName, picorsrc_Resource * resource)
+{
+    return rsrcLoadResource(this, fileName, TRUE, resource);
+}
+
+static pico_status_t picorsrc_releaseKbList(picoos_Common common, picoknow_KnowledgeBase * kbList)
 {
     picoknow_KnowledgeBase kbprev, kb;
     kb = *kbList;
     while (NULL != kb) {
         kbprev = kb;
         kb = kb->next;
-        picoknow_disposeKnowledgeBase(this->common->mm,&kbprev);
+        picoknow_disposeKnowledgeBase(common->mm,&kbprev);
     }
     *kbList = NULL;
     return PICO_OK;
@@ -707,6 +1090,7 @@ pico_status_t picorsrc_unloadResource(picorsrc_ResourceManager this, picorsrc_Re
         picoos_deallocProtMem(this->common->mm, (void *) &rsrc->raw_mem);
         PICODBG_DEBUG(("deallocated raw mem"));
     }
+    picoos_deallocate(this->common->mm, (void *) &rsrc->values);
 
     r1 = NULL;
     r2 = this->resources;
@@ -723,8 +1107,12 @@ pico_status_t picorsrc_unloadResource(picorsrc_ResourceManager this, picorsrc_Re
         r1->next = rsrc->next;
     }
 
-    if (NULL != rsrc->kbList) {
-        picorsrc_releaseKbList(this, &rsrc->kbList);
+    if (NULL != rsrc->shared) {
+        /* the kbs belong to the shared resource */
+        rsrc->kbList = NULL;
+        releaseSharedResource(rsrc->shared);
+    } else if (NULL != rsrc->kbList) {
+        picorsrc_releaseKbList(this->common, &rsrc->kbList);
     }
 
     picoos_deallocate(this->common->mm,(void **)resource);
@@ -760,7 +1148,7 @@ pico_status_t picorsrc_createDefaultResource(picorsrc_ResourceManager this
         PICODBG_ERROR(("failed assigning name %s to default resource",res->name));
         status = PICO_ERR_INDEX_OUT_OF_RANGE;
     }
-    status = picorsrc_createKnowledgeBase(this, NULL, 0, (picoknow_kb_id_t)PICOKNOW_KBID_FIXED_IDS, &res->kbList);
+    status = picorsrc_createKnowledgeBase(this->common, NULL, 0, (picoknow_kb_id_t)PICOKNOW_KBID_FIXED_IDS, &res->kbList);
 
     if (PICO_OK == status) {
         res->next = this->resources;
@@ -99,6 +99,10 @@ picorsrc_ResourceManager picorsrc_newResourceManager(picoos_MemoryManager mm, pi
 
 void picorsrc_disposeResourceManager(picoos_MemoryManager mm, picorsrc_ResourceManager * that);
 
+/* have the resources loaded from now on expand their lfz and mgc pdfs
+ * into tables of decoded values (see picokpdf_expandPdfMUL) or not */
+void picorsrc_setPdfExpansion(picorsrc_ResourceManager that, picoos_bool expand);
+
 
 /* **************************************************************************
  *
@@ -116,6 +120,13 @@ picoos_int16 picoctrl_isValidResourceHandle(picorsrc_Resource resource);
 pico_status_t picorsrc_loadResource(picorsrc_ResourceManager that,
         picoos_char * fileName, picorsrc_Resource * resource);
 
+/* same as picorsrc_loadResource, but the content and knowledge bases are
+ * loaded only once per process, outside of the system memory, and are shared
+ * read-only with every other resource manager that loads the same resource
+ * this way (on any thread). They are freed when the last of them unloads it. */
+pico_status_t picorsrc_loadSharedResource(picorsrc_ResourceManager that,
+        picoos_char * fileName, picorsrc_Resource * resource);
+
 /* unload resource file. (warn if resource file is busy) */
 pico_status_t picorsrc_unloadResource(picorsrc_ResourceManager that, picorsrc_Resource * rsrc);
 
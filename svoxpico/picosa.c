@@ -57,6 +57,12 @@ extern "C" {
 
 #define SA_MSGSTR_SIZE 32
 
+/* longest graph and phones of a word kept in the G2P cache; longer
+   words are always transcribed */
+#define SA_G2P_CACHE_MAXGRAPHLEN 36
+#define SA_G2P_CACHE_MAXPLEN     56
+#define SA_G2P_CACHE_NIL         0xFFFF
+
 /*  subobject    : SentAnaUnit
  *  shortcut     : sa
  *  context size : one phrase, max. 30 non-PUNC items, for non-processed items
@@ -180,6 +186,19 @@ typedef struct {
 } picosa_headx_t;
 
 
+/* G2P cache entry: the phones G2P produced for a word and its POS */
+typedef struct {
+    picoos_uint32 hash;
+    picoos_uint16 prev, next; /* neighbours in the order of use */
+    picoos_uint16 hnext;      /* next entry of the same bucket */
+    picoos_uint8 pos;
+    picoos_uint8 graphlen;
+    picoos_uint8 plen;
+    picoos_uint8 graph[SA_G2P_CACHE_MAXGRAPHLEN];
+    picoos_uint8 phones[SA_G2P_CACHE_MAXPLEN];
+} sa_g2p_cache_entry_t;
+
+
 typedef struct sa_subobj {
     picoos_uint8 procState; /* for next processing step decision */
 
@@ -226,6 +245,18 @@ typedef struct sa_subobj {
     /* dtg2p knowledge base */
     picokdt_DtG2P dtg2p;
 
+    /* classification state of the above trees */
+    picokdt_dtstate_t dtstate;
+
+    /* G2P cache of PICO_G2P_CACHE_SIZE entries, NULL if none */
+    sa_g2p_cache_entry_t *g2pCache;
+    picoos_uint16 g2pSize;       /* nr of entries */
+    picoos_uint16 *g2pBuckets;   /* first entry per bucket */
+    picoos_uint16 g2pBucketMask; /* nr of buckets - 1 */
+    picoos_uint16 g2pUsed;       /* nr of entries in use */
+    picoos_uint16 g2pFirst;      /* most recently used entry */
+    picoos_uint16 g2pLast;       /* least recently used entry */
+
     /* lex knowledge base */
     picoklex_Lex lex;
 
@@ -242,6 +273,8 @@ typedef struct sa_subobj {
 } sa_subobj_t;
 
 
+static void saG2PCacheClear(register sa_subobj_t *sa);
+
 static pico_status_t saInitialize(register picodata_ProcessingUnit this, picoos_int32 resetMode) {
     sa_subobj_t * sa;
     picoos_uint16 i;
@@ -417,6 +450,9 @@ static pico_status_t saInitialize(register picodata_ProcessingUnit this, picoos_
     }
     PICODBG_DEBUG(("got %i user lexica", sa->numUlex));
 
+    /* the cached phones may be another voice's */
+    saG2PCacheClear(sa);
+
     return PICO_OK;
 }
 
@@ -434,6 +470,9 @@ static pico_status_t saSubObjDeallocate(register picodata_ProcessingUnit this,
     if (NULL != this) {
         sa = (sa_subobj_t *) this->subObj;
         picotrns_deallocate_alt_desc_buf(mm,&sa->altDescBuf);
+        if (NULL != sa->g2pCache) {
+            picoos_deallocate(mm, (void *) &sa->g2pCache);
+        }
         picoos_deallocate(mm, (void *) &this->subObj);
     }
     return PICO_OK;
@@ -475,6 +514,22 @@ picodata_ProcessingUnit picosa_newSentAnaUnit(picoos_MemoryManager mm,
         picoos_emRaiseException(common->em,PICO_EXC_OUT_OF_MEM, NULL, NULL);
     }
 
+    /* the cache only saves time: without the room for it, do without it */
+    sa->g2pCache = NULL;
+    sa->g2pSize = PICO_G2P_CACHE_SIZE;
+    sa->g2pBuckets = NULL;
+    sa->g2pBucketMask = 0;
+    if (sa->g2pSize > 0) {
+        while (sa->g2pBucketMask + 1 < sa->g2pSize) {
+            sa->g2pBucketMask = (sa->g2pBucketMask << 1) | 1;
+        }
+        sa->g2pCache = (sa_g2p_cache_entry_t *) picoos_allocate(mm,
+                sa->g2pSize * sizeof(sa_g2p_cache_entry_t)
+                + (sa->g2pBucketMask + 1) * sizeof(picoos_uint16));
+        if (NULL != sa->g2pCache) {
+            sa->g2pBuckets = (picoos_uint16 *) (sa->g2pCache + sa->g2pSize);
+        }
+    }
 
     saInitialize(this, PICO_RESET_FULL);
     return this;
@@ -621,7 +676,7 @@ static pico_status_t saDisambPos(register picodata_ProcessingUnit this,
 
         /* no continue so far => POS disambiguation needed */
         /* construct input vector, which is set in dtposd */
-        if (!picokdt_dtPosDconstructInVec(sa->dtposd, valbuf)) {
+        if (!picokdt_dtPosDconstructInVec(sa->dtposd, &sa->dtstate, valbuf)) {
             /* error constructing invec */
             PICODBG_WARN(("problem with invec"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_INVECTOR,
@@ -629,7 +684,7 @@ static pico_status_t saDisambPos(register picodata_ProcessingUnit this,
             okay = FALSE;
         }
         /* classify */
-        if (okay && (!picokdt_dtPosDclassify(sa->dtposd, &prevout))) {
+        if (okay && (!picokdt_dtPosDclassify(sa->dtposd, &sa->dtstate, &prevout))) {
             /* error doing classification */
             PICODBG_WARN(("problem classifying"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_CLASSIFICATION,
@@ -637,7 +692,7 @@ static pico_status_t saDisambPos(register picodata_ProcessingUnit this,
             okay = FALSE;
         }
         /* decompose */
-        if (okay && (!picokdt_dtPosDdecomposeOutClass(sa->dtposd, &dtres))) {
+        if (okay && (!picokdt_dtPosDdecomposeOutClass(sa->dtposd, &sa->dtstate, &dtres))) {
             /* error decomposing */
             PICODBG_WARN(("problem decomposing"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_OUTVECTOR,
@@ -825,7 +880,8 @@ static picoos_uint8 saGetNrVowel(register picodata_ProcessingUnit this,
 }
 
 
-/* do g2p for a full word, right-to-left */
+/* do g2p for a full word, right-to-left; 'complete' is FALSE if
+   there were warnings or phones had to be skipped */
 static picoos_uint8 saDoG2P(register picodata_ProcessingUnit this,
                             register sa_subobj_t *sa,
                             const picoos_uint8 *graph,
@@ -833,7 +889,8 @@ static picoos_uint8 saDoG2P(register picodata_ProcessingUnit this,
                             const picoos_uint8 pos,
                             picoos_uint8 *phones,
                             const picoos_uint16 phonesmaxlen,
-                            picoos_uint16 *plen) {
+                            picoos_uint16 *plen,
+                            picoos_uint8 *complete) {
     picoos_uint16 outNp1Ch; /*last 3 outputs produced*/
     picoos_uint16 outNp2Ch;
     picoos_uint16 outNp3Ch;
@@ -849,6 +906,7 @@ static picoos_uint8 saDoG2P(register picodata_ProcessingUnit this,
     picoos_uint16 i;
 
     *plen = 0;
+    *complete = TRUE;
     okay = TRUE;
 
     /* use sa->tmpbuf[PICOSA_MAXITEMSIZE] to temporarly store the
@@ -895,7 +953,7 @@ static picoos_uint8 saDoG2P(register picodata_ProcessingUnit this,
 
         /* prepare input vector, set inside tree object invec,
          * g2pBuildVector will call the constructInVec tree method */
-        if (!picokdt_dtG2PconstructInVec(sa->dtg2p,
+        if (!picokdt_dtG2PconstructInVec(sa->dtg2p, &sa->dtstate,
                                          graph, /*grapheme start*/
                                          graphlen, /*grapheme length*/
                                          nCount-1, /*grapheme current position*/
@@ -911,25 +969,28 @@ static picoos_uint8 saDoG2P(register picodata_ProcessingUnit this,
             picoos_emRaiseWarning(this->common->em, PICO_WARN_INVECTOR,
                                   NULL, NULL);
             okay = FALSE;
+            *complete = FALSE;
         }
 
         /* classify using the invec in the tree object and save the direct
            tree output also in the tree object */
-        if (okay && (!picokdt_dtG2Pclassify(sa->dtg2p, &nOutVal))) {
+        if (okay && (!picokdt_dtG2Pclassify(sa->dtg2p, &sa->dtstate, &nOutVal))) {
             /* error doing classification */
             PICODBG_WARN(("problem classifying"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_CLASSIFICATION,
                                   NULL, NULL);
             okay = FALSE;
+            *complete = FALSE;
         }
 
         /* decompose the invec in the tree object and return result in dtresv */
-        if (okay && (!picokdt_dtG2PdecomposeOutClass(sa->dtg2p, &dtresv))) {
+        if (okay && (!picokdt_dtG2PdecomposeOutClass(sa->dtg2p, &sa->dtstate, &dtresv))) {
             /* error decomposing */
             PICODBG_WARN(("problem decomposing"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_OUTVECTOR,
                                   NULL, NULL);
             okay = FALSE;
+            *complete = FALSE;
         }
 
         if (okay) {
@@ -947,6 +1008,7 @@ static picoos_uint8 saDoG2P(register picodata_ProcessingUnit this,
                     if (dtresv.classvec[i] > 255) {
                         PICODBG_WARN(("dt result outside valid range, "
                                       "skipping phone"));
+                        *complete = FALSE;
                         continue;
                     }
                     sa->tmpbuf[phonesind--] = (picoos_uint8)dtresv.classvec[i];
@@ -962,6 +1024,7 @@ static picoos_uint8 saDoG2P(register picodata_ProcessingUnit this,
                     PICODBG_WARN(("phones skipped"));
                     picoos_emRaiseWarning(this->common->em,
                                           PICO_WARN_INCOMPLETE, NULL, NULL);
+                    *complete = FALSE;
                 }
             }
         }
@@ -1000,19 +1063,185 @@ static picoos_uint8 saDoG2P(register picodata_ProcessingUnit this,
 }
 
 
+/* ************** g2p cache ***************/
+
+/* The phones G2P produced for the last g2pSize (POS, graph)
+   pairs are kept in a hash table of entries, which are also listed in
+   the order of their use; when all are in use, the least recently used
+   one is taken for a new pair. Only transcriptions that went without
+   warnings are kept, so that a cached word has the same phones as a
+   transcribed one. */
+
+static void saG2PCacheClear(register sa_subobj_t *sa) {
+    picoos_uint16 i;
+
+    if (NULL == sa->g2pCache) {
+        return;
+    }
+    for (i = 0; i <= sa->g2pBucketMask; i++) {
+        sa->g2pBuckets[i] = SA_G2P_CACHE_NIL;
+    }
+    sa->g2pUsed = 0;
+    sa->g2pFirst = SA_G2P_CACHE_NIL;
+    sa->g2pLast = SA_G2P_CACHE_NIL;
+}
+
+
+static picoos_uint32 saG2PCacheHash(const picoos_uint8 *graph,
+                                    const picoos_uint8 graphlen,
+                                    const picoos_uint8 pos) {
+    picoos_uint32 hash;
+    picoos_uint8 i;
+
+    /* FNV-1a */
+    hash = 2166136261u ^ pos;
+    for (i = 0; i < graphlen; i++) {
+        hash = (hash ^ graph[i]) * 16777619u;
+    }
+    return hash;
+}
+
+
+/* removes entry 'e' from the order of use */
+static void saG2PCacheUnlink(register sa_subobj_t *sa, picoos_uint16 e) {
+    sa_g2p_cache_entry_t *entry = &(sa->g2pCache[e]);
+
+    if (SA_G2P_CACHE_NIL == entry->prev) {
+        sa->g2pFirst = entry->next;
+    } else {
+        sa->g2pCache[entry->prev].next = entry->next;
+    }
+    if (SA_G2P_CACHE_NIL == entry->next) {
+        sa->g2pLast = entry->prev;
+    } else {
+        sa->g2pCache[entry->next].prev = entry->prev;
+    }
+}
+
+
+/* puts entry 'e' first in the order of use */
+static void saG2PCacheLinkFirst(register sa_subobj_t *sa, picoos_uint16 e) {
+    sa->g2pCache[e].prev = SA_G2P_CACHE_NIL;
+    sa->g2pCache[e].next = sa->g2pFirst;
+    if (SA_G2P_CACHE_NIL == sa->g2pFirst) {
+        sa->g2pLast = e;
+    } else {
+        sa->g2pCache[sa->g2pFirst].prev = e;
+    }
+    sa->g2pFirst = e;
+}
+
+
+/* returns the entry of 'graph' with POS 'pos', made the most recently
+   used one, or NULL if there is none */
+static sa_g2p_cache_entry_t *saG2PCacheFind(register sa_subobj_t *sa,
+                                            const picoos_uint8 *graph,
+                                            const picoos_uint8 graphlen,
+                                            const picoos_uint8 pos,
+                                            const picoos_uint32 hash) {
+    picoos_uint16 e;
+    picoos_uint8 i;
+    sa_g2p_cache_entry_t *entry;
+
+    for (e = sa->g2pBuckets[hash & sa->g2pBucketMask];
+         e != SA_G2P_CACHE_NIL; e = entry->hnext) {
+        entry = &(sa->g2pCache[e]);
+        if ((entry->hash != hash) || (entry->pos != pos)
+            || (entry->graphlen != graphlen)) {
+            continue;
+        }
+        for (i = 0; (i < graphlen) && (entry->graph[i] == graph[i]); i++) {
+            /* just compare */
+        }
+        if (i == graphlen) {
+            if (e != sa->g2pFirst) {
+                saG2PCacheUnlink(sa, e);
+                saG2PCacheLinkFirst(sa, e);
+            }
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+
+/* keeps 'plen' phones as those of 'graph' with POS 'pos', in place of
+   the least recently used entry if all are in use */
+static void saG2PCacheEnter(register sa_subobj_t *sa,
+                            const picoos_uint8 *graph,
+                            const picoos_uint8 graphlen,
+                            const picoos_uint8 pos,
+                            const picoos_uint32 hash,
+                            const picoos_uint8 *phones,
+                            const picoos_uint16 plen) {
+    picoos_uint16 e, *link;
+    sa_g2p_cache_entry_t *entry;
+
+    if (sa->g2pUsed < sa->g2pSize) {
+        e = sa->g2pUsed++;
+    } else {
+        /* take the least recently used entry out of its bucket */
+        e = sa->g2pLast;
+        saG2PCacheUnlink(sa, e);
+        link = &(sa->g2pBuckets[sa->g2pCache[e].hash & sa->g2pBucketMask]);
+        while (*link != e) {
+            link = &(sa->g2pCache[*link].hnext);
+        }
+        *link = sa->g2pCache[e].hnext;
+    }
+    entry = &(sa->g2pCache[e]);
+    entry->hash = hash;
+    entry->pos = pos;
+    entry->graphlen = graphlen;
+    entry->plen = (picoos_uint8) plen;
+    picoos_mem_copy(graph, entry->graph, graphlen);
+    picoos_mem_copy(phones, entry->phones, plen);
+    entry->hnext = sa->g2pBuckets[hash & sa->g2pBucketMask];
+    sa->g2pBuckets[hash & sa->g2pBucketMask] = e;
+    saG2PCacheLinkFirst(sa, e);
+}
+
+
 /* item in headx[ind]/cbuf1, out: modified headx and cbuf2 */
 
 static pico_status_t saGraphemeToPhoneme(register picodata_ProcessingUnit this,
                                          register sa_subobj_t *sa,
                                          picoos_uint16 ind) {
     picoos_uint16 plen;
+    picoos_uint8 *graph = &(sa->cbuf1[sa->headx[ind].cind]);
+    picoos_uint8 graphlen = sa->headx[ind].head.len;
+    picoos_uint8 pos = sa->headx[ind].head.info1;
+    picoos_uint8 cacheable, complete, okay;
+    picoos_uint32 hash = 0;
+    sa_g2p_cache_entry_t *entry = NULL;
 
     PICODBG_TRACE(("starting g2p"));
 
-    if (saDoG2P(this, sa, &(sa->cbuf1[sa->headx[ind].cind]),
-                sa->headx[ind].head.len, sa->headx[ind].head.info1,
-                &(sa->cbuf2[sa->cbuf2Len]), (sa->cbuf2BufSize - sa->cbuf2Len),
-                &plen)) {
+    cacheable = (NULL != sa->g2pCache) && (graphlen <= SA_G2P_CACHE_MAXGRAPHLEN);
+    if (cacheable) {
+        hash = saG2PCacheHash(graph, graphlen, pos);
+        entry = saG2PCacheFind(sa, graph, graphlen, pos, hash);
+        if (NULL != entry) {
+            this->cacheHits++;
+        } else {
+            this->cacheMisses++;
+        }
+    }
+    if ((NULL != entry) && (entry->plen <= sa->cbuf2BufSize - sa->cbuf2Len)) {
+        plen = entry->plen;
+        picoos_mem_copy(entry->phones, &(sa->cbuf2[sa->cbuf2Len]), plen);
+        okay = TRUE;
+    } else {
+        okay = saDoG2P(this, sa, graph, graphlen, pos,
+                       &(sa->cbuf2[sa->cbuf2Len]),
+                       (sa->cbuf2BufSize - sa->cbuf2Len), &plen, &complete);
+        if (okay && complete && cacheable && (NULL == entry)
+            && (plen <= SA_G2P_CACHE_MAXPLEN)) {
+            saG2PCacheEnter(sa, graph, graphlen, pos, hash,
+                            &(sa->cbuf2[sa->cbuf2Len]), plen);
+        }
+    }
+    if (okay) {
 
         /* check of cbuf2Len done in saDoG2P, phones skipped if needed */
         if (plen > 255) {
@@ -200,6 +200,19 @@ extern "C" {
 /* maximum length of an item incl. head for input GetItem buffer */
 #define PICOSA_MAXITEMSIZE   260
 
+/* nr of out-of-vocabulary words whose G2P phones are remembered, 0 for
+   none; can be set at build time */
+#ifndef PICO_G2P_CACHE_SIZE
+#define PICO_G2P_CACHE_SIZE 256
+#endif
+/* the entries are numbered in 16 bits, 0xFFFF standing for none */
+#if (PICO_G2P_CACHE_SIZE < 0) || (PICO_G2P_CACHE_SIZE >= 0xFFFF)
+#error "PICO_G2P_CACHE_SIZE must be from 0 to 65534"
+#endif
+
+/* engine memory taken by remembering them, at most */
+#define PICOSA_G2P_CACHE_MEM_SIZE (PICO_G2P_CACHE_SIZE * 112 + 64)
+
 
 picodata_ProcessingUnit picosa_newSentAnaUnit(
         picoos_MemoryManager mm,
@@ -89,6 +89,7 @@ typedef struct sig_subobj
     picoos_uint32 nNumFrame;                /* running count for frame number in output items */
     /*---------------------- other working variables ---------------------------*/
     picoos_uint8 innerProcState; /*where to take up work at next processing step*/
+    picoos_uint32 nFrame; /*phase vectors retrieved so far, for debugging*/
     /*-----------------------Definition of the local storage for this PU--------*/
     sig_innerobj_t sig_inner;
     picoos_single pMod; /*pitch modifier*/
@@ -128,6 +129,7 @@ static pico_status_t sigInitialize(register picodata_ProcessingUnit this, picoos
     sig_subObj->outReadPos = 0;
     sig_subObj->outWritePos = 0;
     sig_subObj->needMoreInput = 0;
+    sig_subObj->nFrame = 0;
     sig_subObj->procState = PICOSIG_COLLECT;
     sig_subObj->retState = PICOSIG_COLLECT;
     sig_subObj->innerProcState = 0;
@@ -320,7 +322,6 @@ static pico_status_t getPhsFromPdf(register picodata_ProcessingUnit this,
 {
     sig_subobj_t *sig_subObj;
     picokpdf_PdfPHS pdf;
-    static int nFrame = 0;
 
     picoos_uint32 nIndexValue;
     picoos_uint8 *nCurrIndexOffset, *nContent;
@@ -342,7 +343,7 @@ static pico_status_t getPhsFromPdf(register picodata_ProcessingUnit this,
     nContent += nIndexValue;
     *numComponents = (picoos_int16) *nContent++;
     if (*numComponents>PICODSP_PHASEORDER) {
-        PICODBG_DEBUG(("WARNING : Frame %d -- Phase vector[%d] Components = %d --> too big\n",  nFrame, phsIndex, *numComponents));
+        PICODBG_DEBUG(("WARNING : Frame %d -- Phase vector[%d] Components = %d --> too big\n",  sig_subObj->nFrame, phsIndex, *numComponents));
         *numComponents = PICODSP_PHASEORDER;
     }
     for (nI=0; nI<*numComponents; nI++) {
@@ -351,7 +352,7 @@ static pico_status_t getPhsFromPdf(register picodata_ProcessingUnit this,
     for (nI=*numComponents; nI<PICODSP_PHASEORDER; nI++) {
         phsVect[nI] = 0;
     }
-    nFrame++;
+    sig_subObj->nFrame++;
     return PICO_OK;
 }/*getPhsFromPdf*/
 
@@ -377,13 +378,12 @@ static pico_status_t sigProcess(register picodata_ProcessingUnit this,
 {
 
     register sig_subobj_t * sig_subObj;
-    picoos_int16 n_i;
     picoos_int16 n_frames, n_count;
-    picoos_int16 *s_data, offset;
-    picoos_int32 f_data, mlt, *t1, *tmp1, *tmp2;
+    picoos_int16 *pcm[2], offset;
+    picoos_int32 mlt, *tmp1, *tmp2;
     picoos_uint16 tmp_uint16;
     picopal_int16 tmp_int16;
-    picoos_uint16 i, cnt;
+    picoos_uint16 i;
     picoos_int16 hop_p_half;
 
     sig_subObj = (sig_subobj_t *) this->subObj;
@@ -566,19 +566,15 @@ static pico_status_t sigProcess(register picodata_ProcessingUnit this,
             return PICO_STEP_BUSY;
 
         case 8:
-            /*Ovladd */
-            overlap_add(&(sig_subObj->sig_inner));
-            sig_subObj->innerProcState += 1;
-            return PICO_STEP_BUSY;
-
-        case 9:
             /*-----------------------------------------
-             Save the output FRAME item (0:hop-1)
-             swap remaining buffer
+             Ovladd, save the output FRAME item (0:hop-1)
+             and swap remaining buffer
              ---------------------------------------------*/
             n_frames = 2;
             *numoutb = 0;
             hop_p_half = (sig_subObj->sig_inner.hop_p) / 2;
+            mlt = (picoos_int32) ((sig_subObj->fSampNorm * sig_subObj->vMod)
+                    * PICODSP_END_FLOAT_NORM);
             for (n_count = 0; n_count < n_frames; n_count++) {
                 sig_subObj->outBuf[outWritePos]
                         = (picoos_uint8) PICODATA_ITEM_FRAME;
@@ -588,40 +584,13 @@ static pico_status_t sigProcess(register picodata_ProcessingUnit this,
                         = (picoos_uint8) (sig_subObj->nNumFrame % ((hop_p_half)));
                 sig_subObj->outBuf[outWritePos + 3]
                         = (picoos_uint8) sig_subObj->sig_inner.hop_p;
-                s_data = (picoos_int16 *) &(sig_subObj->outBuf[outWritePos + 4]);
-
-                /*range control and clipping*/
-                mlt = (picoos_int32) ((sig_subObj->fSampNorm * sig_subObj->vMod)
-                        * PICODSP_END_FLOAT_NORM);
-                t1 = &(sig_subObj->sig_inner.WavBuff_p[n_count * (hop_p_half)]);
-                for (n_i = 0; n_i < hop_p_half; n_i++) { /*Normalization*/
-                    f_data = *t1++ * mlt;
-                    if (f_data >= 0)
-                        f_data >>= 14;
-                    else
-                        f_data = -(-f_data >> 14);
-                    if (f_data > PICOSIG_MAXAMP)
-                        f_data = PICOSIG_MAXAMP;
-                    if (f_data < PICOSIG_MINAMP)
-                        f_data = PICOSIG_MINAMP;
-                    *s_data = (picoos_int16) (f_data);
-                    s_data++;
-                }
+                pcm[n_count] = (picoos_int16 *) &(sig_subObj->outBuf[outWritePos + 4]);
                 sig_subObj->nNumFrame = sig_subObj->nNumFrame + 1;
-                *numoutb += ((picoos_int16) n_i * sizeof(picoos_int16)) + 4;
+                *numoutb += ((picoos_int16) hop_p_half * sizeof(picoos_int16)) + 4;
                 outWritePos += *numoutb;
             }/*end for n_count*/
-            /*Swap remaining buffer*/
-            cnt = sig_subObj->sig_inner.m2_p - sig_subObj->sig_inner.hop_p;
-            tmp1 = sig_subObj->sig_inner.WavBuff_p;
-            tmp2
-                    = &(sig_subObj->sig_inner.WavBuff_p[sig_subObj->sig_inner.hop_p]);
-            FAST_DEVICE(cnt,*(tmp1++)=*(tmp2++);)
-            ;
-            cnt = sig_subObj->sig_inner.m2_p - (sig_subObj->sig_inner.m2_p
-                    - sig_subObj->sig_inner.hop_p);
-            FAST_DEVICE(cnt,*(tmp1++)=0;)
-            ;
+            /*range control and clipping happen while adding up*/
+            overlap_add(&(sig_subObj->sig_inner), mlt, pcm);
             sig_subObj->innerProcState = 0; /*reset to step 0*/
             sig_subObj->nNumFrame += 2;
             return PICO_OK;
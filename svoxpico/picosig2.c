@@ -29,6 +29,7 @@
 #include "picodsp.h"
 #include "picosig2.h"
 #include "picofftsg.h"
+#include "picosimd.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,6 +47,48 @@ static void enh_wind_init(sig_innerobj_t *sig_inObj);
 static void init_rand(sig_innerobj_t *sig_inObj);
 static void get_trig(picoos_int32 ang, picoos_int32 *table, picoos_int32 *cs,
         picoos_int32 *sn);
+static void mel_2_lin_interp(picoos_uint8 simd, const picoos_int16 *A,
+        const picoos_int32 *D, picosig2_sample_t *XXr);
+static void env_spec_trig(picoos_uint8 simd, const picoos_int32 *ang,
+        picoos_int32 *table, picoos_int32 *cs, picoos_int32 *sn,
+        picoos_int16 n);
+static void env_spec_polar(picoos_uint8 simd, const picosig2_sample_t *spect,
+        const picoos_int32 *co, const picoos_int32 *so, picosig2_sample_t *Fr,
+        picosig2_sample_t *Fi, picoos_int16 from, picoos_int16 to,
+        picoos_single mult);
+static void div_response(picoos_uint8 simd, picosig2_sample_t *x,
+        picosig2_sample_t d);
+static void add_pulse(picoos_uint8 simd, picosig2_sample_t *t1,
+        const picosig2_sample_t *t2, picosig2_sample_t ff, picoos_int16 cnt,
+        picoos_int16 dir);
+static void shift_excitation(picoos_uint8 simd, picosig2_sample_t *x);
+static void overlap_add_pcm(picoos_uint8 simd, picosig2_sample_t *w,
+        const picosig2_sample_t *v, picoos_int16 hop, picoos_int32 mlt,
+        picoos_int16 *pcm[2]);
+#if defined(PICOSIMD)
+static PICOSIMD_FN picoos_int16 env_spec_trigSimd(const picoos_int32 *ang,
+        const picoos_int32 *table, picoos_int32 *cs, picoos_int32 *sn,
+        picoos_int16 n);
+#if !defined(PICO_DSP_FLOAT)
+static PICOSIMD_FN picoos_int16 mel_2_lin_interpSimd(const picoos_int16 *A,
+        const picoos_int32 *D, picoos_int32 *XXr);
+static PICOSIMD_FN picoos_int16 env_spec_polarSimd(const picoos_int32 *spect,
+        const picoos_int32 *co, const picoos_int32 *so, picoos_int32 *Fr,
+        picoos_int32 *Fi, picoos_int16 from, picoos_int16 to,
+        picoos_single mult);
+static PICOSIMD_FN picoos_int16 div_responseSimd(picoos_int32 *x,
+        picoos_int32 d);
+static PICOSIMD_FN picoos_int16 add_pulseSimd(picoos_int32 *t1,
+        const picoos_int32 *t2, picoos_int32 ff, picoos_int16 cnt,
+        picoos_int16 dir);
+static PICOSIMD_FN picoos_int16 shift_excitationSimd(picoos_int32 *x);
+static PICOSIMD_FN picoos_int16 overlap_add_pcmSimd(const picoos_int32 *w,
+        const picoos_int32 *v, picoos_int32 mlt, picoos_int16 *pcm,
+        picoos_int16 n);
+static PICOSIMD_FN picoos_int16 overlap_addSimd(picoos_int32 *dst,
+        const picoos_int32 *w, const picoos_int32 *v, picoos_int16 n);
+#endif /* !PICO_DSP_FLOAT */
+#endif
 
 /*---------------------------------------------------------------------------
  * PICO SYSTEM FUNCTIONS
@@ -314,7 +357,7 @@ pico_status_t sigAllocate(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj)
         sigDeallocate(mm, sig_inObj);
         return PICO_ERR_OTHER;
     }
-    sig_inObj->sig_vec1 = d32;
+    sig_inObj->sig_vec1 = (picosig2_sample_t *) d32;
 
     return PICO_OK;
 }/*sigAllocate*/
@@ -416,30 +459,36 @@ void sigDspInitialize(sig_innerobj_t *sig_inObj, picoos_int32 resetMode)
     picoos_int32 i, j;
     picoos_int32 *pnt;
 
-    if (resetMode == PICO_RESET_SOFT) {
-        /*minimal initialization when receiving a soft reset */
-        return;
-    }
     /*-----------------------------------------------------------------
-     * Initialization
+     * Initialization; a soft reset keeps the constant parameters and
+     * tables, but forgets the signal history, so that an utterance
+     * following it sounds as if synthesized by a fresh engine
      * ------------------------------------------------------------------*/
-    sig_inObj->warp_p = PICODSP_FREQ_WARP_FACT;
-    sig_inObj->VCutoff_p = PICODSP_V_CUTOFF_FREQ; /*voicing cut off frequency in Hz (will be modeled in the future)*/
-    sig_inObj->UVCutoff_p = PICODSP_UV_CUTOFF_FREQ;/*unvoiced frames only (periodize lowest components to mask bad voicing transitions)*/
-    sig_inObj->Fs_p = PICODSP_SAMP_FREQ; /*Sampling freq*/
-
-    sig_inObj->m1_p = PICODSP_CEPORDER;
-    sig_inObj->m2_p = PICODSP_FFTSIZE; /*also initializes windowLen*/
-    sig_inObj->framesz_p = PICODSP_DISPLACE; /*1/4th of the frame size = displacement*/
-    sig_inObj->hfftsize_p = PICODSP_H_FFTSIZE; /*half of the FFT size*/
-    sig_inObj->voxbnd_p = (picoos_int32) ((picoos_single) sig_inObj->hfftsize_p
-            / ((picoos_single) sig_inObj->Fs_p / (picoos_single) 2)
-            * (picoos_single) sig_inObj->VCutoff_p);
-    sig_inObj->voxbnd2_p
-            = (picoos_int32) ((picoos_single) sig_inObj->hfftsize_p
-                    / ((picoos_single) sig_inObj->Fs_p / (picoos_single) 2)
-                    * (picoos_single) sig_inObj->UVCutoff_p);
-    sig_inObj->hop_p = sig_inObj->framesz_p;
+    if (resetMode == PICO_RESET_FULL) {
+        picofftsg_initialize();
+#if defined(PICOSIMD)
+        sig_inObj->simd_p = (picopal_cpu_features() & PICOSIMD_CPU) != 0;
+#else
+        sig_inObj->simd_p = FALSE;
+#endif
+        sig_inObj->warp_p = PICODSP_FREQ_WARP_FACT;
+        sig_inObj->VCutoff_p = PICODSP_V_CUTOFF_FREQ; /*voicing cut off frequency in Hz (will be modeled in the future)*/
+        sig_inObj->UVCutoff_p = PICODSP_UV_CUTOFF_FREQ;/*unvoiced frames only (periodize lowest components to mask bad voicing transitions)*/
+        sig_inObj->Fs_p = PICODSP_SAMP_FREQ; /*Sampling freq*/
+
+        sig_inObj->m1_p = PICODSP_CEPORDER;
+        sig_inObj->m2_p = PICODSP_FFTSIZE; /*also initializes windowLen*/
+        sig_inObj->framesz_p = PICODSP_DISPLACE; /*1/4th of the frame size = displacement*/
+        sig_inObj->hfftsize_p = PICODSP_H_FFTSIZE; /*half of the FFT size*/
+        sig_inObj->voxbnd_p = (picoos_int32) ((picoos_single) sig_inObj->hfftsize_p
+                / ((picoos_single) sig_inObj->Fs_p / (picoos_single) 2)
+                * (picoos_single) sig_inObj->VCutoff_p);
+        sig_inObj->voxbnd2_p
+                = (picoos_int32) ((picoos_single) sig_inObj->hfftsize_p
+                        / ((picoos_single) sig_inObj->Fs_p / (picoos_single) 2)
+                        * (picoos_single) sig_inObj->UVCutoff_p);
+        sig_inObj->hop_p = sig_inObj->framesz_p;
+    }
     sig_inObj->nextPeak_p = (((int) (PICODSP_FFTSIZE))
             / ((int) PICODSP_DISPLACE) - 1) * sig_inObj->hop_p;
     sig_inObj->phId_p = 0; /*phonetic id*/
@@ -447,22 +496,37 @@ void sigDspInitialize(sig_innerobj_t *sig_inObj, picoos_int32 resetMode)
     sig_inObj->F0_p = (picoos_single) 0.0f;
     sig_inObj->voiced_p = 0;
     sig_inObj->nV = sig_inObj->nU = 0;
+    sig_inObj->prevVoiced_p = sig_inObj->VoicTrans = 0;
     sig_inObj->sMod_p = (picoos_single) 1.0f;
 
     /*cleanup vectors*/
     for (i = 0; i < 2 * PICODSP_FFTSIZE; i++) {
         sig_inObj->sig_vec1[i] = 0;
-        sig_inObj->int_vec26[i] = 0; /*wav buff cleanup */
+        sig_inObj->WavBuff_p[i] = 0; /*wav buff cleanup */
     }
 
     for (i = 0; i < PICODSP_FFTSIZE; i++) {
         sig_inObj->idx_vect1[i] = sig_inObj->idx_vect4[i]
                 = sig_inObj->idx_vect5[i] = sig_inObj->idx_vect6[i] = 0;
-        sig_inObj->int_vec32[i] = sig_inObj->int_vec33[i] = 0;
+        sig_inObj->F2r_p[i] = sig_inObj->F2i_p[i] = 0;
+        /*excitation energies and impulse responses of the previous frames*/
+        sig_inObj->EnV[i] = sig_inObj->EnU[i] = 0;
+        sig_inObj->ImpResp_p[i] = sig_inObj->imp_p[i] = 0;
+    }
+
+    for (i = 0; i < PICODSP_MAX_EX; i++) {
+        sig_inObj->LocV[i] = sig_inObj->LocU[i] = 0;
+    }
+
+    for (i = 0; i < PHASE_BUFF_SIZE; i++) {
+        sig_inObj->VoxBndBuff[i] = 0;
     }
 
     for (i = 0; i < PICODSP_HFFTSIZE_P1; i++) {
         sig_inObj->idx_vect2[i] = (picoos_int16) 0;
+        /*phase and unvoiced phase components of the previous frames*/
+        sig_inObj->ang_p[i] = 0;
+        sig_inObj->outCosTbl[i] = sig_inObj->outSinTbl[i] = 0;
     }
 
     for (i = 0; i < CEPST_BUFF_SIZE; i++) {
@@ -493,10 +557,12 @@ void sigDspInitialize(sig_innerobj_t *sig_inObj, picoos_int32 resetMode)
      Post Filter Hermite's interpolator Matrix
      Mel-2-Lin lookup tables
      ---------------------------------------------*/
-    enh_wind_init(sig_inObj); /*creates the formant enhancement window*/
     init_rand(sig_inObj);
-    gen_hann2(sig_inObj);
-    mel_2_lin_init(sig_inObj);
+    mel_2_lin_init(sig_inObj); /*A_p is idx_vect2, cleared above*/
+    if (resetMode == PICO_RESET_FULL) {
+        enh_wind_init(sig_inObj); /*creates the formant enhancement window*/
+        gen_hann2(sig_inObj);
+    }
 
 }/*sigDspInitialize*/
 
@@ -524,14 +590,19 @@ void sigDspInitialize(sig_innerobj_t *sig_inObj, picoos_int32 resetMode)
 void mel_2_lin_lookup(sig_innerobj_t *sig_inObj, picoos_uint32 scmeanMGC)
 {
     /*Local vars*/
-    picoos_int16 nI, k;
-    picoos_int32 delta, term1, term2;
+    picoos_int16 nI;
 
     /*Local vars to be linked with sig data object*/
-    picoos_int32 *c1, *XXr;
+    picoos_int32 *c1;
+    picosig2_sample_t *XXr;
     picoos_single K1;
     picoos_int32 *D, K2, shift;
-    picoos_int16 m1, *A, m2, m4, voiced, i;
+    picoos_int16 m1, *A, m2, m4, voiced;
+#if defined(PICO_DSP_FLOAT)
+    picoos_single cep[PICODSP_FFTSIZE];
+#else
+    picoos_int16 i;
+#endif
 
     /*Link local variables with sig data object*/
     c1 = sig_inObj->wcep_pI;
@@ -542,12 +613,21 @@ void mel_2_lin_lookup(sig_innerobj_t *sig_inObj, picoos_uint32 scmeanMGC)
     A = sig_inObj->A_p;
     D = sig_inObj->d_p;
 
-    XXr = sig_inObj->wcep_pI;
+    XXr = sig_inObj->spect_p;
     voiced = sig_inObj->voiced_p;
 
     shift = 27 - scmeanMGC;
     K2 = 1 << shift;
     K1 = (picoos_single) PICODSP_START_FLOAT_NORM * K2;
+#if defined(PICO_DSP_FLOAT)
+    /* the spectrum takes the place of the cepstrum, which is read first */
+    cep[0] = (picoos_single) c1[0] * K1;
+    for (nI = 1; nI < m1; nI++) {
+        cep[nI] = (picoos_single) c1[nI] * (picoos_single) K2;
+    }
+    picoos_mem_copy(cep, XXr, m1 * sizeof(picoos_single));
+    dfct_float(m4, m1, XXr);
+#else
     XXr[0] = (picoos_int32) ((picoos_single) c1[0] * K1);
     for (nI = 1; nI < m1; nI++) {
         XXr[nI] = c1[nI] << shift;
@@ -558,6 +638,7 @@ void mel_2_lin_lookup(sig_innerobj_t *sig_inObj, picoos_uint32 scmeanMGC)
 
     picoos_mem_set(XXr + m1, 0, i);
     dfct_nmf(m4, XXr); /* DFCT directly in fixed point */
+#endif
 
     /* *****************************************************************************************
      Linear frequency scale envelope through interpolation.
@@ -569,14 +650,62 @@ void mel_2_lin_lookup(sig_innerobj_t *sig_inObj, picoos_uint32 scmeanMGC)
      - get rid of extra -1 operation by adapting the table A[]
 
      *******************************************************************************************/
+    mel_2_lin_interp((picoos_uint8) sig_inObj->simd_p, A, D, XXr);
+}/*mel_2_lin_lookup*/
+
+/**
+ * linear interpolation step of mel_2_lin_lookup, in place on XXr
+ * @param   simd : TRUE to use the vector kernel
+ * @param   A, D : lookup tables
+ * @param   XXr : DFCT output, replaced by the linear frequency envelope
+ * @return  void
+ */
+#if defined(PICO_DSP_FLOAT)
+static void mel_2_lin_interp(picoos_uint8 simd, const picoos_int16 *A,
+        const picoos_int32 *D, picosig2_sample_t *XXr)
+{
+    picoos_int16 nI, k;
+
     for (nI = 1; nI < PICODSP_H_FFTSIZE; nI++) {
+        k = A[nI];
+        XXr[nI] = XXr[k] + (picoos_single) D[nI] * (1.0f / 32) * (XXr[k + 1] - XXr[k]);
+    }
+}/*mel_2_lin_interp*/
+#else
+static void mel_2_lin_interp(picoos_uint8 simd, const picoos_int16 *A,
+        const picoos_int32 *D, picosig2_sample_t *XXr)
+{
+    picoos_int16 nI, k;
+    picoos_int32 delta, term1, term2;
+#if defined(PICOSIMD_VERIFY)
+    picoos_int32 ref[PICODSP_FFTSIZE];
+
+    if (simd) {
+        picoos_mem_copy(XXr, ref, sizeof(ref));
+        mel_2_lin_interp(FALSE, A, D, ref);
+    }
+#endif
+
+    nI = 1;
+#if defined(PICOSIMD)
+    if (simd) {
+        nI = mel_2_lin_interpSimd(A, D, XXr);
+    }
+#endif
+    for (; nI < PICODSP_H_FFTSIZE; nI++) {
         k = A[nI];
         term2 = XXr[k];
         term1 = XXr[k + 1];
         delta = term1 - term2;
         XXr[nI] = term2 + ((D[nI] * delta) >> 5); /* ok because nI<=A[nI] <=B[nI] */
     }
-}/*mel_2_lin_lookup*/
+#if defined(PICOSIMD_VERIFY)
+    if (simd) {
+        PICOSIMD_VERIFY_EQUAL("mel_2_lin_lookup", ref, XXr, PICODSP_FFTSIZE);
+    }
+#endif
+}/*mel_2_lin_interp*/
+#endif
 
 /**
  * calculate phase
@@ -693,16 +822,18 @@ void phase_spec2(sig_innerobj_t *sig_inObj)
 void env_spec(sig_innerobj_t *sig_inObj)
 {
 
-    picoos_int16 nI;
-    picoos_int32 fcX, fsX, fExp, voxbnd;
-    picoos_int32 *spect, *ang, *ctbl;
+    picoos_int32 voxbnd;
+    picosig2_sample_t *spect;
+    picoos_int32 *ang, *ctbl;
     picoos_int16 voiced, prev_voiced;
     picoos_int32 *co, *so;
-    picoos_int32 *Fr, *Fi;
+    picosig2_sample_t *Fr, *Fi;
     picoos_single mult;
+    picoos_uint8 simd;
+    picoos_int32 tc[PICODSP_HFFTSIZE_P1], ts[PICODSP_HFFTSIZE_P1];
 
     /*Link local variables to sig object*/
-    spect = sig_inObj->wcep_pI; /*spect_p*/
+    spect = sig_inObj->spect_p;
     /*  current spect scale : times PICODSP_FIX_SCALE1 */
     ang = sig_inObj->ang_p;
     /*  current spect scale : PICODSP_M_PI =  PICODSP_FIX_SCALE2 */
@@ -714,6 +845,9 @@ void env_spec(sig_innerobj_t *sig_inObj)
     ctbl = sig_inObj->cos_table;
     /*  ctbl scale : times 4096 */
     mult = PICODSP_ENVSPEC_K1 / PICODSP_FIX_SCALE1;
+    co = sig_inObj->outCosTbl;
+    so = sig_inObj->outSinTbl;
+    simd = (picoos_uint8) sig_inObj->simd_p;
 
     /*remove dc from real part*/
     if (sig_inObj->F0_p > 120) {
@@ -726,39 +860,129 @@ void env_spec(sig_innerobj_t *sig_inObj)
     /* if using rand table, use sin and cos tables as well */
     if (voiced || (prev_voiced)) {
         /*Envelope becomes a complex exponential : F=exp(.5*spect + j*angh);*/
-        for (nI = 0; nI < voxbnd; nI++) {
-            get_trig(ang[nI], ctbl, &fcX, &fsX);
-            fExp = (picoos_int32) EXP((double)spect[nI]*mult);
-            Fr[nI] = fExp * fcX;
-            Fi[nI] = fExp * fsX;
-        }
-        /*         ao=sig_inObj->ang_p+(picoos_int32)voxbnd; */
-        co = sig_inObj->outCosTbl + voxbnd;
-        so = sig_inObj->outSinTbl + voxbnd;
-
-        for (nI = voxbnd; nI < PICODSP_HFFTSIZE_P1; nI++) {
-            fcX = *co++;
-            fsX = *so++;
-            fExp = (picoos_int32) EXP((double)spect[nI]*mult);
-            Fr[nI] = fExp * fcX;
-            Fi[nI] = fExp * fsX;
-        }
+        env_spec_trig(simd, ang, ctbl, tc, ts, (picoos_int16) voxbnd);
+        env_spec_polar(simd, spect, tc, ts, Fr, Fi, 0, (picoos_int16) voxbnd, mult);
+        env_spec_polar(simd, spect, co, so, Fr, Fi, (picoos_int16) voxbnd,
+                PICODSP_HFFTSIZE_P1, mult);
     } else {
-        /*ao=sig_inObj->ang_p+1;*/
-        co = sig_inObj->outCosTbl + 1;
-        so = sig_inObj->outSinTbl + 1;
-        for (nI = 1; nI < PICODSP_HFFTSIZE_P1; nI++) {
-            fcX = *co++;
-            fsX = *so++;
-            fExp = (picoos_int32) EXP((double)spect[nI]*mult);
-
-            Fr[nI] = fExp * fcX;
-            Fi[nI] = fExp * fsX;
-        }
+        env_spec_polar(simd, spect, co, so, Fr, Fi, 1, PICODSP_HFFTSIZE_P1, mult);
     }
 
 }/*env_spec*/
 
+/**
+ * cosine and sine of the first n phases, as get_trig gives them
+ * @param   simd : TRUE to use the vector kernel
+ * @param   ang : phases (scale : PICODSP_M_PI = PICODSP_FIX_SCALE2)
+ * @param   table : cosine table
+ * @param   cs, sn : cosines and sines
+ * @param   n : number of phases
+ * @return  void
+ */
+static void env_spec_trig(picoos_uint8 simd, const picoos_int32 *ang,
+        picoos_int32 *table, picoos_int32 *cs, picoos_int32 *sn,
+        picoos_int16 n)
+{
+    picoos_int16 nI;
+#if defined(PICOSIMD_VERIFY)
+    picoos_int32 refc[PICODSP_HFFTSIZE_P1], refs[PICODSP_HFFTSIZE_P1];
+
+    if (simd) {
+        env_spec_trig(FALSE, ang, table, refc, refs, n);
+    }
+#endif
+
+    nI = 0;
+#if defined(PICOSIMD)
+    if (simd) {
+        nI = env_spec_trigSimd(ang, table, cs, sn, n);
+    }
+#endif
+    for (; nI < n; nI++) {
+        get_trig(ang[nI], table, &cs[nI], &sn[nI]);
+    }
+#if defined(PICOSIMD_VERIFY)
+    if (simd) {
+        PICOSIMD_VERIFY_EQUAL("env_spec cos", refc, cs, n);
+        PICOSIMD_VERIFY_EQUAL("env_spec sin", refs, sn, n);
+    }
+#endif
+}/*env_spec_trig*/
+
+/**
+ * envelope F = exp(.5*spect) * (co + j*so) of the bins from..to-1
+ * @param   simd : TRUE to use the vector kernel
+ * @param   spect : log spectrum (scale : times PICODSP_FIX_SCALE1)
+ * @param   co, so : cosine and sine per bin
+ * @param   Fr, Fi : real and imaginary part of the envelope
+ * @param   mult : PICODSP_ENVSPEC_K1 / PICODSP_FIX_SCALE1
+ * @return  void
+ */
+#if defined(PICO_DSP_FLOAT)
+static void env_spec_polar(picoos_uint8 simd, const picosig2_sample_t *spect,
+        const picoos_int32 *co, const picoos_int32 *so, picosig2_sample_t *Fr,
+        picosig2_sample_t *Fi, picoos_int16 from, picoos_int16 to,
+        picoos_single mult)
+{
+    picoos_int16 nI;
+    picoos_int32 e;
+    picoos_single y, r, fExp;
+    union {
+        picoos_single f;
+        picoos_int32 i;
+    } pow2;
+
+    /* exp(x) = 2^e * exp(r), e the integer nearest to x/ln(2) and |r| <= ln(2)/2;
+       exp(r) by its Taylor polynomial (relative error below 2e-7), 2^e put
+       into the exponent bits as picopal_quick_exp() does (0 below the
+       smallest normal float), without branches so that the loop vectorizes */
+    for (nI = from; nI < to; nI++) {
+        y = spect[nI] * mult * 1.442695041f;
+        e = (picoos_int32) (y + 128.5f) - 128;
+        r = (y - (picoos_single) e) * 0.693147181f;
+        pow2.i = (e < -126) ? 0 : (((e > 127) ? 127 : e) + 127) << 23;
+        fExp = pow2.f * (1 + r * (1 + r * (0.5f + r * (1.0f / 6 + r * (1.0f / 24
+                + r * (1.0f / 120 + r * (1.0f / 720)))))));
+        Fr[nI] = fExp * (picoos_single) co[nI];
+        Fi[nI] = fExp * (picoos_single) so[nI];
+    }
+}/*env_spec_polar*/
+#else
+static void env_spec_polar(picoos_uint8 simd, const picosig2_sample_t *spect,
+        const picoos_int32 *co, const picoos_int32 *so, picosig2_sample_t *Fr,
+        picosig2_sample_t *Fi, picoos_int16 from, picoos_int16 to,
+        picoos_single mult)
+{
+    picoos_int16 nI;
+    picoos_int32 fExp;
+#if defined(PICOSIMD_VERIFY)
+    picoos_int32 refr[PICODSP_HFFTSIZE_P1], refi[PICODSP_HFFTSIZE_P1];
+
+    if (simd) {
+        env_spec_polar(FALSE, spect, co, so, refr, refi, from, to, mult);
+    }
+#endif
+
+    nI = from;
+#if defined(PICOSIMD)
+    if (simd) {
+        nI = env_spec_polarSimd(spect, co, so, Fr, Fi, from, to, mult);
+    }
+#endif
+    for (; nI < to; nI++) {
+        fExp = (picoos_int32) EXP((double)spect[nI]*mult);
+        Fr[nI] = fExp * co[nI];
+        Fi[nI] = fExp * so[nI];
+    }
+#if defined(PICOSIMD_VERIFY)
+    if (simd && (to > from)) {
+        PICOSIMD_VERIFY_EQUAL("env_spec real", refr + from, Fr + from, to - from);
+        PICOSIMD_VERIFY_EQUAL("env_spec imag", refi + from, Fi + from, to - from);
+    }
+#endif
+}/*env_spec_polar*/
+#endif
+
 /**
  * Calculates the impulse response of the comlpex spectrum through inverse rFFT
  * @param   sig_inObj : sig PU internal object of the sub-object
@@ -779,7 +1003,7 @@ void impulse_response(sig_innerobj_t *sig_inObj)
     picoos_int16 nI, nn, m2, m4, voiced;
     picoos_single *E;
     picoos_int32 *norm_window; /* - fixed point */
-    picoos_int32 *fr, *Fr, *Fi, *t1, ff; /* - fixed point */
+    picosig2_sample_t *fr, *Fr, *Fi, ff;
 
     /*Link local variables with sig object*/
     m2 = sig_inObj->m2_p;
@@ -796,28 +1020,48 @@ void impulse_response(sig_innerobj_t *sig_inObj)
         fr[nn] = Fr[nI]; /* - fixed point */
     }
 
-    fr[1] = (picoos_int32) (Fr[m4]);
+    fr[1] = Fr[m4];
     for (nI = 1, nn = 3; nI < m4; nI++, nn += 2) {
         fr[nn] = -Fi[nI]; /* - fixed point */
     }
 
+#if defined(PICO_DSP_FLOAT)
+    irdft_float(fr);
+    /*window, normalize and differentiate*/
+    *E = norm_result_float(m2, fr, norm_window);
+#else
     rdft(m2, -1, fr);
     /*window, normalize and differentiate*/
     *E = norm_result(m2, fr, norm_window);
+#endif
 
     if (*E > 0) {
         f = *E * PICODSP_FIXRESP_NORM;
     } else {
         f = 20; /*PICODSP_FIXRESP_NORM*/
     }
-    ff = (picoos_int32) f;
+    ff = (picosig2_sample_t) f;
     if (ff < 1)
         ff = 1;
     /*normalize impulse response*/
-    t1 = fr;FAST_DEVICE(PICODSP_FFTSIZE,*(t1++) /= ff;); /* - fixed point */
+    div_response((picoos_uint8) sig_inObj->simd_p, fr, ff);
 
 } /* impulse_response */
 
+/**
+ * weight of an excitation pulse: its energy f (from get_simple_excitation)
+ * times the window value w at its position
+ * @return  f * w / 2^PICODSP_SHIFT_FACT1
+ */
+static picosig2_sample_t pulse_gain(picoos_int32 f, picoos_int32 w)
+{
+#if defined(PICO_DSP_FLOAT)
+    return (picoos_single) f * (picoos_single) w * (1.0f / (1 << PICODSP_SHIFT_FACT1));
+#else
+    return (f * w) >> PICODSP_SHIFT_FACT1;
+#endif
+}/*pulse_gain*/
+
 /**
  * time domain pitch synchronous overlap add over two frames (when no voicing transition)
  * @param    sig_inObj : sig PU internal object of the sub-object
@@ -831,12 +1075,14 @@ void td_psola2(sig_innerobj_t *sig_inObj)
 {
     picoos_int16 nI;
     picoos_int16 hop, m2, *nextPeak, voiced;
-    picoos_int32 *t1, *t2;
+    picosig2_sample_t *t1, *t2;
     picoos_int16 cnt;
-    picoos_int32 *fr, *v1, ff, f;
-    picoos_int16 a, i;
+    picosig2_sample_t *fr, *v1, ff;
+    picoos_int32 f;
+    picoos_int16 a;
     picoos_int32 *window;
     picoos_int16 s = (picoos_int16) 1;
+    picoos_uint8 simd;
     window = sig_inObj->window_p;
 
     /*Link local variables with sig object*/
@@ -845,15 +1091,15 @@ void td_psola2(sig_innerobj_t *sig_inObj)
     nextPeak = &(sig_inObj->nextPeak_p);
     voiced = sig_inObj->voiced_p;
     fr = sig_inObj->imp_p;
+    simd = (picoos_uint8) sig_inObj->simd_p;
     /*toggle the pointers and initialize signal vector */
     v1 = sig_inObj->sig_vec1;
 
-    t1 = v1;
-    FAST_DEVICE(PICODSP_FFTSIZE-PICODSP_DISPLACE,*(t1++)=0;);
-    t1 = &(v1[PICODSP_FFTSIZE - PICODSP_DISPLACE]);
-    t2 = &(v1[PICODSP_FFTSIZE]);
-    FAST_DEVICE(PICODSP_FFTSIZE, *(t1++)=*(t2++););
-    t1 = &(v1[2 * PICODSP_FFTSIZE - PICODSP_DISPLACE]);FAST_DEVICE(PICODSP_DISPLACE,*(t1++)=0;);
+    picoos_mem_set(v1, 0, (PICODSP_FFTSIZE - PICODSP_DISPLACE) * sizeof(picosig2_sample_t));
+    picoos_mem_copy(&(v1[PICODSP_FFTSIZE]), &(v1[PICODSP_FFTSIZE - PICODSP_DISPLACE]),
+            PICODSP_FFTSIZE * sizeof(picosig2_sample_t));
+    picoos_mem_set(&(v1[2 * PICODSP_FFTSIZE - PICODSP_DISPLACE]), 0,
+            PICODSP_DISPLACE * sizeof(picosig2_sample_t));
     /*calculate excitation points*/
     get_simple_excitation(sig_inObj, nextPeak);
 
@@ -864,10 +1110,10 @@ void td_psola2(sig_innerobj_t *sig_inObj)
             f = sig_inObj->EnV[nI];
             a = 0;
             cnt = PICODSP_FFTSIZE;
-            ff = (f * window[sig_inObj->LocV[nI]]) >> PICODSP_SHIFT_FACT1;
+            ff = pulse_gain(f, window[sig_inObj->LocV[nI]]);
             t1 = &(v1[a + sig_inObj->LocV[nI]]);
             t2 = &(fr[a]);
-            if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff;);
+            add_pulse(simd, t1, t2, ff, cnt, 1);
         }
     } else if ((sig_inObj->nV == 0) && (sig_inObj->voiced_p == 0)) {
         /* PURELY UNVOICED*/
@@ -877,17 +1123,17 @@ void td_psola2(sig_innerobj_t *sig_inObj)
             if (s == 1) {
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
-                ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
+                ff = pulse_gain(f, window[sig_inObj->LocU[nI]]);
                 t1 = &(v1[a + sig_inObj->LocU[nI]]);
                 t2 = &(fr[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff; );
+                add_pulse(simd, t1, t2, ff, cnt, 1);
             } else { /*s==-1*/
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
-                ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
+                ff = pulse_gain(f, window[sig_inObj->LocU[nI]]);
                 t1 = &(v1[(m2 - 1 - a) + sig_inObj->LocU[nI]]);
                 t2 = &(fr[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1--)+=*(t2++)*ff; );
+                add_pulse(simd, t1, t2, ff, cnt, -1);
             }
         }
     } else if (sig_inObj->VoicTrans == 0) {
@@ -896,10 +1142,10 @@ void td_psola2(sig_innerobj_t *sig_inObj)
             f = sig_inObj->EnV[nI];
             a = 0;
             cnt = PICODSP_FFTSIZE;
-            ff = (f * window[sig_inObj->LocV[nI]]) >> PICODSP_SHIFT_FACT1;
+            ff = pulse_gain(f, window[sig_inObj->LocV[nI]]);
             t1 = &(v1[a + sig_inObj->LocV[nI]]);
             t2 = &(fr[a]);
-            if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff;);
+            add_pulse(simd, t1, t2, ff, cnt, 1);
         }
         /*add remaining stuff from unvoiced part*/
         for (nI = 0; nI < sig_inObj->nU; nI++) {
@@ -908,17 +1154,17 @@ void td_psola2(sig_innerobj_t *sig_inObj)
             if (s == 1) {
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
-                ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
+                ff = pulse_gain(f, window[sig_inObj->LocU[nI]]);
                 t1 = &(v1[a + sig_inObj->LocU[nI]]);
                 t2 = &(sig_inObj->ImpResp_p[a]); /*saved impulse response*/
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff; );
+                add_pulse(simd, t1, t2, ff, cnt, 1);
             } else {
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
-                ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
+                ff = pulse_gain(f, window[sig_inObj->LocU[nI]]);
                 t1 = &(v1[(m2 - 1 - a) + sig_inObj->LocU[nI]]);
                 t2 = &(sig_inObj->ImpResp_p[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1--)+=*(t2++)*ff; );
+                add_pulse(simd, t1, t2, ff, cnt, -1);
             }
         }
     } else {
@@ -929,17 +1175,17 @@ void td_psola2(sig_innerobj_t *sig_inObj)
             if (s > 0) {
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
-                ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
+                ff = pulse_gain(f, window[sig_inObj->LocU[nI]]);
                 t1 = &(v1[a + sig_inObj->LocU[nI]]);
                 t2 = &(fr[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff; );
+                add_pulse(simd, t1, t2, ff, cnt, 1);
             } else {
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
-                ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
+                ff = pulse_gain(f, window[sig_inObj->LocU[nI]]);
                 t1 = &(v1[(m2 - 1 - a) + sig_inObj->LocU[nI]]);
                 t2 = &(fr[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1--)+=*(t2++)*ff; );
+                add_pulse(simd, t1, t2, ff, cnt, -1);
             }
         }
         /*add remaining stuff from voiced part*/
@@ -947,26 +1193,23 @@ void td_psola2(sig_innerobj_t *sig_inObj)
             f = sig_inObj->EnV[nI];
             a = 0;
             cnt = PICODSP_FFTSIZE;
-            ff = (f * window[sig_inObj->LocV[nI]]) >> PICODSP_SHIFT_FACT1;
+            ff = pulse_gain(f, window[sig_inObj->LocV[nI]]);
             t1 = &(v1[a + sig_inObj->LocV[nI]]);
             t2 = &(sig_inObj->ImpResp_p[a]);
-            if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff;);
+            add_pulse(simd, t1, t2, ff, cnt, 1);
         }
     }
 
-    t1 = sig_inObj->sig_vec1;
-    for (i = 0; i < PICODSP_FFTSIZE; i++, t1++) {
-        if (*t1 >= 0)
-            *t1 >>= PICODSP_SHIFT_FACT5;
-        else
-            *t1 = -((-*t1) >> PICODSP_SHIFT_FACT5);
-    }
+    shift_excitation(simd, sig_inObj->sig_vec1);
 
 }/*td_psola2*/
 
 /**
  * overlap + add summing of impulse responses on the final destination sample buffer
+ * and output of the samples that are complete
  * @param    sig_inObj : sig PU internal object of the sub-object
+ * @param    mlt : output gain (times 2^14)
+ * @param    pcm : destinations of the first and of the second hop/2 output samples
  * @return  void
  * @remarks Special treatment at voicing boundaries
  * @remarks Introduced to get rid of time-domain aliasing (and additional speed up)
@@ -976,22 +1219,291 @@ void td_psola2(sig_innerobj_t *sig_inObj)
  * - WavBuff : the destination buffer with past samples (FFT size*2, short)
  * - m2 : fftsize
  * Output
- * - WavBuff : the destination buffer with updated samples (FFT size*2, short)
+ * - pcm : the first hop samples of WavBuff, scaled and clipped to 16 bit
+ * - WavBuff : the destination buffer with the remaining samples, moved by hop
  * @callgraph
  * @callergraph
  */
-void overlap_add(sig_innerobj_t *sig_inObj)
+void overlap_add(sig_innerobj_t *sig_inObj, picoos_int32 mlt,
+        picoos_int16 *pcm[2])
 {
-    /*Local variables*/
-    picoos_int32 *w, *v;
+    overlap_add_pcm((picoos_uint8) sig_inObj->simd_p, sig_inObj->WavBuff_p,
+            sig_inObj->sig_vec1, sig_inObj->hop_p, mlt, pcm);
+}/*overlap_add*/
 
-    /*Link local variables with sig object*/
-    w = sig_inObj->WavBuff_p;
-    v = sig_inObj->sig_vec1;
+#if defined(PICO_DSP_FLOAT)
+/**
+ * x[0..PICODSP_FFTSIZE-1] /= d
+ * @param   simd : unused, the loop is left to the compiler to vectorize
+ * @return  void
+ */
+static void div_response(picoos_uint8 simd, picosig2_sample_t *x,
+        picosig2_sample_t d)
+{
+    picoos_int16 nI;
+    picoos_single r = 1.0f / d;
 
-    FAST_DEVICE(PICODSP_FFTSIZE, *(w++)+=*(v++)<<PICODSP_SHIFT_FACT6;);
+    for (nI = 0; nI < PICODSP_FFTSIZE; nI++) {
+        x[nI] *= r;
+    }
+}/*div_response*/
 
-}/*overlap_add*/
+/**
+ * adds ff times the cnt samples of t2 to the signal, placed from t1 on
+ * forwards (dir 1) or backwards (dir -1)
+ * @param   simd : unused, the loop is left to the compiler to vectorize
+ * @return  void
+ */
+static void add_pulse(picoos_uint8 simd, picosig2_sample_t *t1,
+        const picosig2_sample_t *t2, picosig2_sample_t ff, picoos_int16 cnt,
+        picoos_int16 dir)
+{
+    picoos_int16 nI;
+
+    if (dir > 0) {
+        for (nI = 0; nI < cnt; nI++) {
+            t1[nI] += t2[nI] * ff;
+        }
+    } else {
+        for (nI = 0; nI < cnt; nI++) {
+            t1[-nI] += t2[nI] * ff;
+        }
+    }
+}/*add_pulse*/
+
+/**
+ * scales the PICODSP_FFTSIZE samples of the excitation that are complete
+ * down by 2^PICODSP_SHIFT_FACT5
+ * @param   simd : unused, the loop is left to the compiler to vectorize
+ * @return  void
+ */
+static void shift_excitation(picoos_uint8 simd, picosig2_sample_t *x)
+{
+    picoos_int16 nI;
+
+    for (nI = 0; nI < PICODSP_FFTSIZE; nI++) {
+        x[nI] *= 1.0f / (1 << PICODSP_SHIFT_FACT5);
+    }
+}/*shift_excitation*/
+
+/**
+ * adds the excitation v to the output buffer w; the first hop samples
+ * are scaled by mlt, clipped, rounded and written to pcm, the others
+ * moved to the start of w, which is filled up with 0
+ * @param   simd : unused, the loops are left to the compiler to vectorize
+ * @return  void
+ */
+static void overlap_add_pcm(picoos_uint8 simd, picosig2_sample_t *w,
+        const picosig2_sample_t *v, picoos_int16 hop, picoos_int32 mlt,
+        picoos_int16 *pcm[2])
+{
+    picoos_int16 nI, k, half;
+    picoos_single f_data, scale;
+
+    half = hop / 2;
+    scale = (picoos_single) mlt * (1.0f / (1 << 14));
+    for (k = 0; k < 2; k++) {
+        for (nI = 0; nI < half; nI++) { /*Normalization*/
+            /* rounded and clipped on the offset value, which needs no
+               branches, so that the loop vectorizes */
+            f_data = (w[k * half + nI] + v[k * half + nI]
+                    * (1 << PICODSP_SHIFT_FACT6)) * scale - PICOSIG_MINAMP + 0.5f;
+            if (f_data > PICOSIG_MAXAMP - PICOSIG_MINAMP)
+                f_data = PICOSIG_MAXAMP - PICOSIG_MINAMP;
+            if (f_data < 0)
+                f_data = 0;
+            pcm[k][nI] = (picoos_int16) ((picoos_int32) f_data + PICOSIG_MINAMP);
+        }
+    }
+
+    /*swap remaining buffer*/
+    for (nI = hop; nI < PICODSP_FFTSIZE; nI++) {
+        w[nI - hop] = w[nI] + v[nI] * (1 << PICODSP_SHIFT_FACT6);
+    }
+    for (nI = PICODSP_FFTSIZE - hop; nI < PICODSP_FFTSIZE; nI++) {
+        w[nI] = 0;
+    }
+}/*overlap_add_pcm*/
+#else
+/**
+ * x[0..PICODSP_FFTSIZE-1] /= d, truncating as the C division
+ * @param   simd : TRUE to use the vector kernel
+ * @return  void
+ */
+static void div_response(picoos_uint8 simd, picosig2_sample_t *x,
+        picosig2_sample_t d)
+{
+    picoos_int16 nI;
+#if defined(PICOSIMD_VERIFY)
+    picoos_int32 ref[PICODSP_FFTSIZE];
+
+    if (simd) {
+        picoos_mem_copy(x, ref, sizeof(ref));
+        div_response(FALSE, ref, d);
+    }
+#endif
+
+    nI = 0;
+#if defined(PICOSIMD)
+    if (simd) {
+        nI = div_responseSimd(x, d);
+    }
+#endif
+    for (; nI < PICODSP_FFTSIZE; nI++) {
+        x[nI] /= d;
+    }
+#if defined(PICOSIMD_VERIFY)
+    if (simd) {
+        PICOSIMD_VERIFY_EQUAL("impulse_response", ref, x, PICODSP_FFTSIZE);
+    }
+#endif
+}/*div_response*/
+
+/**
+ * adds ff times the cnt samples of t2 to the signal, placed from t1 on
+ * forwards (dir 1) or backwards (dir -1)
+ * @param   simd : TRUE to use the vector kernel
+ * @return  void
+ */
+static void add_pulse(picoos_uint8 simd, picosig2_sample_t *t1,
+        const picosig2_sample_t *t2, picosig2_sample_t ff, picoos_int16 cnt,
+        picoos_int16 dir)
+{
+    picoos_int16 nI;
+#if defined(PICOSIMD_VERIFY)
+    picoos_int32 ref[PICODSP_FFTSIZE], *first;
+
+    first = (dir > 0) ? t1 : t1 - (cnt - 1);
+    if (simd) {
+        picoos_mem_copy(first, ref, cnt * sizeof(picoos_int32));
+        add_pulse(FALSE, (dir > 0) ? ref : ref + (cnt - 1), t2, ff, cnt, dir);
+    }
+#endif
+
+    nI = 0;
+#if defined(PICOSIMD)
+    if (simd) {
+        nI = add_pulseSimd(t1, t2, ff, cnt, dir);
+    }
+#endif
+    for (; nI < cnt; nI++) {
+        t1[dir * nI] += t2[nI] * ff;
+    }
+#if defined(PICOSIMD_VERIFY)
+    if (simd) {
+        PICOSIMD_VERIFY_EQUAL("td_psola2", ref, first, cnt);
+    }
+#endif
+}/*add_pulse*/
+
+/**
+ * scales the PICODSP_FFTSIZE samples of the excitation that are complete
+ * down by PICODSP_SHIFT_FACT5, truncating towards zero
+ * @param   simd : TRUE to use the vector kernel
+ * @return  void
+ */
+static void shift_excitation(picoos_uint8 simd, picosig2_sample_t *x)
+{
+    picoos_int16 nI;
+#if defined(PICOSIMD_VERIFY)
+    picoos_int32 ref[PICODSP_FFTSIZE];
+
+    if (simd) {
+        picoos_mem_copy(x, ref, sizeof(ref));
+        shift_excitation(FALSE, ref);
+    }
+#endif
+
+    nI = 0;
+#if defined(PICOSIMD)
+    if (simd) {
+        nI = shift_excitationSimd(x);
+    }
+#endif
+    for (; nI < PICODSP_FFTSIZE; nI++) {
+        if (x[nI] >= 0)
+            x[nI] >>= PICODSP_SHIFT_FACT5;
+        else
+            x[nI] = -((-x[nI]) >> PICODSP_SHIFT_FACT5);
+    }
+#if defined(PICOSIMD_VERIFY)
+    if (simd) {
+        PICOSIMD_VERIFY_EQUAL("td_psola2", ref, x, PICODSP_FFTSIZE);
+    }
+#endif
+}/*shift_excitation*/
+
+/**
+ * adds the excitation v to the output buffer w; the first hop samples
+ * are scaled by mlt, clipped and written to pcm, the others moved to
+ * the start of w, which is filled up with 0
+ * @param   simd : TRUE to use the vector kernels
+ * @return  void
+ */
+static void overlap_add_pcm(picoos_uint8 simd, picosig2_sample_t *w,
+        const picosig2_sample_t *v, picoos_int16 hop, picoos_int32 mlt,
+        picoos_int16 *pcm[2])
+{
+    picoos_int16 nI, k, half;
+    picoos_int32 f_data, *wk;
+    const picoos_int32 *vk;
+#if defined(PICOSIMD_VERIFY)
+    picoos_int32 refw[PICODSP_FFTSIZE];
+    picoos_int16 refpcm[2][PICODSP_FFTSIZE / 2], *refp[2];
+
+    if (simd) {
+        picoos_mem_copy(w, refw, sizeof(refw));
+        refp[0] = refpcm[0];
+        refp[1] = refpcm[1];
+        overlap_add_pcm(FALSE, refw, v, hop, mlt, refp);
+    }
+#endif
+
+    half = hop / 2;
+    for (k = 0; k < 2; k++) {
+        /*range control and clipping*/
+        wk = w + k * half;
+        vk = v + k * half;
+        nI = 0;
+#if defined(PICOSIMD)
+        if (simd) {
+            nI = overlap_add_pcmSimd(wk, vk, mlt, pcm[k], half);
+        }
+#endif
+        for (; nI < half; nI++) { /*Normalization*/
+            f_data = (wk[nI] + (vk[nI] << PICODSP_SHIFT_FACT6)) * mlt;
+            if (f_data >= 0)
+                f_data >>= 14;
+            else
+                f_data = -(-f_data >> 14);
+            if (f_data > PICOSIG_MAXAMP)
+                f_data = PICOSIG_MAXAMP;
+            if (f_data < PICOSIG_MINAMP)
+                f_data = PICOSIG_MINAMP;
+            pcm[k][nI] = (picoos_int16) (f_data);
+        }
+    }
+
+    /*swap remaining buffer*/
+    nI = hop;
+#if defined(PICOSIMD)
+    if (simd) {
+        nI += overlap_addSimd(w, w + hop, v + hop, PICODSP_FFTSIZE - hop);
+    }
+#endif
+    for (; nI < PICODSP_FFTSIZE; nI++) {
+        w[nI - hop] = w[nI] + (v[nI] << PICODSP_SHIFT_FACT6);
+    }
+    picoos_mem_set(w + PICODSP_FFTSIZE - hop, 0, hop * sizeof(picoos_int32));
+#if defined(PICOSIMD_VERIFY)
+    if (simd) {
+        PICOSIMD_VERIFY_EQUAL("overlap_add", refw, w, PICODSP_FFTSIZE);
+        PICOSIMD_VERIFY_EQUAL("overlap_add", refpcm[0], pcm[0], half);
+        PICOSIMD_VERIFY_EQUAL("overlap_add", refpcm[1], pcm[1], half);
+    }
+#endif
+}/*overlap_add_pcm*/
+#endif
 
 /*-------------------------------------------------------------------------------
  INITIALIZATION AND INTERNAL    FUNCTIONS
@@ -3970,7 +4482,7 @@ static void get_trig(picoos_int32 ang, picoos_int32 *table, picoos_int32 *cs,
  */
 void save_transition_frame(sig_innerobj_t *sig_inObj)
 {
-    picoos_int32 *tmp, *tmp2; /*for loop unrolling*/
+    picosig2_sample_t *tmp, *tmp2; /*for loop unrolling*/
 
     if (sig_inObj->voiced_p != sig_inObj->prevVoiced_p) {
         sig_inObj->VoicTrans = sig_inObj->prevVoiced_p; /*remember last voicing transition*/
@@ -4093,6 +4605,216 @@ static void get_simple_excitation(sig_innerobj_t *sig_inObj,
 
 }/*get_simple_excitation*/
 
+#if defined(PICOSIMD)
+/* *****************************************************************************/
+/* vector kernels */
+/* *****************************************************************************/
+#if !defined(PICO_DSP_FLOAT)
+/**
+ * mel_2_lin_interp for as many groups of four entries as there are,
+ * starting at 1
+ * @return  the first entry left to the scalar code
+ * @remarks the four lanes of a group read all their inputs before any of
+ * them is written; as every entry reads at or above its own index
+ * (nI<=A[nI]), these are the values the scalar code reads as well
+ */
+static PICOSIMD_FN picoos_int16 mel_2_lin_interpSimd(const picoos_int16 *A,
+        const picoos_int32 *D, picoos_int32 *XXr)
+{
+    picoos_int16 nI;
+    picosimd_int32x4 term1, term2;
+
+    for (nI = 1; nI + 4 <= PICODSP_H_FFTSIZE; nI += 4) {
+        term2 = PICOSIMD_SET(XXr[A[nI]], XXr[A[nI + 1]], XXr[A[nI + 2]],
+                XXr[A[nI + 3]]);
+        term1 = PICOSIMD_SET(XXr[A[nI] + 1], XXr[A[nI + 1] + 1],
+                XXr[A[nI + 2] + 1], XXr[A[nI + 3] + 1]);
+        PICOSIMD_STORE(XXr + nI, PICOSIMD_ADD(term2, PICOSIMD_SRA(
+                PICOSIMD_MUL(PICOSIMD_LOAD(D + nI), PICOSIMD_SUB(term1, term2)), 5)));
+    }
+    return nI;
+}
+#endif /* !PICO_DSP_FLOAT */
+
+/**
+ * get_trig: cosine table value of the phases k (scale as the table
+ * index) and in 'neg' the lanes where it is to be negated
+ */
+static PICOSIMD_FN picosimd_int32x4 get_trigSimd(picosimd_int32x4 k,
+        const picoos_int32 *table, picosimd_int32x4 *neg)
+{
+    picosimd_int32x4 i, m;
+    picoos_int32 idx[4];
+
+    i = PICOSIMD_AND(PICOSIMD_ABS(k), PICOSIMD_DUP(PICODSP_COS_TABLE_LEN4 - 1));
+    m = PICOSIMD_CMPGT(i, PICOSIMD_DUP(PICODSP_COS_TABLE_LEN2));
+    i = PICOSIMD_SELECT(m, PICOSIMD_SUB(PICOSIMD_DUP(PICODSP_COS_TABLE_LEN4), i), i);
+    *neg = PICOSIMD_CMPGT(i, PICOSIMD_DUP(PICODSP_COS_TABLE_LEN));
+    i = PICOSIMD_SELECT(*neg, PICOSIMD_SUB(PICOSIMD_DUP(PICODSP_COS_TABLE_LEN2), i), i);
+    PICOSIMD_STORE(idx, i);
+    return PICOSIMD_SET(table[idx[0]], table[idx[1]], table[idx[2]], table[idx[3]]);
+}
+
+/**
+ * env_spec_trig for as many groups of four phases as there are
+ * @return  the first phase left to the scalar code
+ */
+static PICOSIMD_FN picoos_int16 env_spec_trigSimd(const picoos_int32 *ang,
+        const picoos_int32 *table, picoos_int32 *cs, picoos_int32 *sn,
+        picoos_int16 n)
+{
+    picoos_int16 nI;
+    picosimd_int32x4 k, t, neg;
+
+    for (nI = 0; nI + 4 <= n; nI += 4) {
+        k = PICOSIMD_SRA(PICOSIMD_LOAD(ang + nI), PICODSP_PI_SHIFT);
+        t = get_trigSimd(k, table, &neg);
+        PICOSIMD_STORE(cs + nI, PICOSIMD_NEG_MASK(t, neg));
+        t = get_trigSimd(PICOSIMD_SUB(k, PICOSIMD_DUP(PICODSP_COS_TABLE_LEN)), table, &neg);
+        PICOSIMD_STORE(sn + nI, PICOSIMD_NEG_MASK(t, neg));
+    }
+    return nI;
+}
+
+#if !defined(PICO_DSP_FLOAT)
+/**
+ * env_spec_polar for as many groups of four bins as there are
+ * @return  the first bin left to the scalar code
+ * @remarks (picoos_int32) EXP((double)spect*mult) is evaluated as
+ * picopal_quick_exp does: the upper word of the double is a linear
+ * function of the argument and the lower word is 0
+ */
+static PICOSIMD_FN picoos_int16 env_spec_polarSimd(const picoos_int32 *spect,
+        const picoos_int32 *co, const picoos_int32 *so, picoos_int32 *Fr,
+        picoos_int32 *Fi, picoos_int16 from, picoos_int16 to,
+        picoos_single mult)
+{
+    picoos_int16 nI;
+    picosimd_float64x2 m, c, lo, hi;
+    picosimd_int32x4 x, fExp;
+
+    m = PICOSIMD_F64_DUP((double) mult);
+    c = PICOSIMD_F64_DUP((double) 1512775.3951951856938297995605697f);
+    for (nI = from; nI + 4 <= to; nI += 4) {
+        x = PICOSIMD_LOAD(spect + nI);
+        lo = PICOSIMD_F64_MUL(PICOSIMD_F64_MUL(PICOSIMD_F64_LOW(x), m), c);
+        hi = PICOSIMD_F64_MUL(PICOSIMD_F64_MUL(PICOSIMD_F64_HIGH(x), m), c);
+        x = PICOSIMD_ADD(PICOSIMD_F64_TRUNC(lo, hi), PICOSIMD_DUP(1072632447));
+        fExp = PICOSIMD_F64_TRUNC(PICOSIMD_F64_BITS_LOW(x), PICOSIMD_F64_BITS_HIGH(x));
+        PICOSIMD_STORE(Fr + nI, PICOSIMD_MUL(fExp, PICOSIMD_LOAD(co + nI)));
+        PICOSIMD_STORE(Fi + nI, PICOSIMD_MUL(fExp, PICOSIMD_LOAD(so + nI)));
+    }
+    return nI;
+}
+
+/**
+ * div_response for as many groups of four samples as there are
+ * @return  the first sample left to the scalar code
+ * @remarks the quotient of two int32 in double precision is never
+ * rounded across an integer, so truncating it gives the C quotient
+ */
+static PICOSIMD_FN picoos_int16 div_responseSimd(picoos_int32 *x,
+        picoos_int32 d)
+{
+    picoos_int16 nI;
+    picosimd_float64x2 dd;
+    picosimd_int32x4 t;
+
+    dd = PICOSIMD_F64_DUP((double) d);
+    for (nI = 0; nI + 4 <= PICODSP_FFTSIZE; nI += 4) {
+        t = PICOSIMD_LOAD(x + nI);
+        PICOSIMD_STORE(x + nI, PICOSIMD_F64_TRUNC(PICOSIMD_F64_DIV(PICOSIMD_F64_LOW(t), dd),
+                PICOSIMD_F64_DIV(PICOSIMD_F64_HIGH(t), dd)));
+    }
+    return nI;
+}
+
+/**
+ * add_pulse for as many groups of four samples as there are
+ * @return  the first sample left to the scalar code
+ */
+static PICOSIMD_FN picoos_int16 add_pulseSimd(picoos_int32 *t1,
+        const picoos_int32 *t2, picoos_int32 ff, picoos_int16 cnt,
+        picoos_int16 dir)
+{
+    picoos_int16 nI;
+    picosimd_int32x4 f, x;
+
+    f = PICOSIMD_DUP(ff);
+    if (dir > 0) {
+        for (nI = 0; nI + 4 <= cnt; nI += 4) {
+            x = PICOSIMD_MUL(PICOSIMD_LOAD(t2 + nI), f);
+            PICOSIMD_STORE(t1 + nI, PICOSIMD_ADD(PICOSIMD_LOAD(t1 + nI), x));
+        }
+    } else {
+        for (nI = 0; nI + 4 <= cnt; nI += 4) {
+            x = PICOSIMD_REVERSE(PICOSIMD_MUL(PICOSIMD_LOAD(t2 + nI), f));
+            PICOSIMD_STORE(t1 - nI - 3, PICOSIMD_ADD(PICOSIMD_LOAD(t1 - nI - 3), x));
+        }
+    }
+    return nI;
+}
+
+/**
+ * shift_excitation for as many groups of four samples as there are
+ * @return  the first sample left to the scalar code
+ */
+static PICOSIMD_FN picoos_int16 shift_excitationSimd(picoos_int32 *x)
+{
+    picoos_int16 nI;
+    picosimd_int32x4 t;
+
+    for (nI = 0; nI + 4 <= PICODSP_FFTSIZE; nI += 4) {
+        t = PICOSIMD_LOAD(x + nI);
+        PICOSIMD_STORE(x + nI, PICOSIMD_SHR_TZ(t, PICODSP_SHIFT_FACT5));
+    }
+    return nI;
+}
+
+/**
+ * pcm[i] = clip((w[i] + (v[i] << PICODSP_SHIFT_FACT6)) * mlt / 2^14)
+ * for as many groups of four of the n samples as there are
+ * @return  the number of samples done
+ */
+static PICOSIMD_FN picoos_int16 overlap_add_pcmSimd(const picoos_int32 *w,
+        const picoos_int32 *v, picoos_int32 mlt, picoos_int16 *pcm,
+        picoos_int16 n)
+{
+    picoos_int16 nI;
+    picosimd_int32x4 m, t;
+
+    m = PICOSIMD_DUP(mlt);
+    for (nI = 0; nI + 4 <= n; nI += 4) {
+        t = PICOSIMD_ADD(PICOSIMD_LOAD(w + nI),
+                PICOSIMD_SHL(PICOSIMD_LOAD(v + nI), PICODSP_SHIFT_FACT6));
+        t = PICOSIMD_SHR_TZ(PICOSIMD_MUL(t, m), 14);
+        PICOSIMD_STORE_SAT16(pcm + nI, t);
+    }
+    return nI;
+}
+
+/**
+ * dst[i] = w[i] + (v[i] << PICODSP_SHIFT_FACT6) for as many groups of
+ * four of the n samples as there are; dst may lie below w in the same
+ * buffer
+ * @return  the number of samples done
+ */
+static PICOSIMD_FN picoos_int16 overlap_addSimd(picoos_int32 *dst,
+        const picoos_int32 *w, const picoos_int32 *v, picoos_int16 n)
+{
+    picoos_int16 nI;
+    picosimd_int32x4 t;
+
+    for (nI = 0; nI + 4 <= n; nI += 4) {
+        t = PICOSIMD_ADD(PICOSIMD_LOAD(w + nI),
+                PICOSIMD_SHL(PICOSIMD_LOAD(v + nI), PICODSP_SHIFT_FACT6));
+        PICOSIMD_STORE(dst + nI, t);
+    }
+    return nI;
+}
+#endif /* !PICO_DSP_FLOAT */
+#endif /* PICOSIMD */
+
 #ifdef __cplusplus
 }
 #endif
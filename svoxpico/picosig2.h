@@ -39,6 +39,15 @@ extern "C" {
 }
 #endif
 
+/* the envelope spectrum, the impulse responses, the excitation and the
+   output buffer; floating point in the PICO_DSP_FLOAT build, where they
+   hold the values of the fixed point build without its truncations */
+#if defined(PICO_DSP_FLOAT)
+typedef picoos_single picosig2_sample_t;
+#else
+typedef picoos_int32 picosig2_sample_t;
+#endif
+
 /*----------------------------------------------------------
  // Name    :   sig_innerobj
  // Function:   innerobject definition for the sig processing
@@ -58,18 +67,36 @@ typedef struct sig_innerobj
     picoos_int16 *idx_vect9; /*reserved for LocU*/
 
     picoos_int32 *int_vec22; /*reserved for normalized hanning window - fixed point */
-    picoos_int32 *int_vec23; /*reserved for impresp  - fixed point */
-    picoos_int32 *int_vec24; /*reserved for impresp  - fixed point */
+    union {
+        picoos_int32 *int_vec23; /*reserved for impresp  - fixed point */
+        picosig2_sample_t *smp_vec23; /*the same, as DSP samples*/
+    };
+    union {
+        picoos_int32 *int_vec24; /*reserved for impresp  - fixed point */
+        picosig2_sample_t *smp_vec24; /*the same, as DSP samples*/
+    };
     picoos_int32 *int_vec25; /*reserved for window  - fixed point */
-    picoos_int32 *int_vec26; /*reserved for wavBuf  - fixed point */
-    picoos_int32 *int_vec28; /*reserved for cepstral vectors input - fixed point */
+    union {
+        picoos_int32 *int_vec26; /*reserved for wavBuf  - fixed point */
+        picosig2_sample_t *smp_vec26; /*the same, as DSP samples*/
+    };
+    union {
+        picoos_int32 *int_vec28; /*reserved for cepstral vectors input - fixed point */
+        picosig2_sample_t *smp_vec28; /*the same, as DSP samples*/
+    };
     picoos_int32 *int_vec29; /*reserved for cepstral vectors input - fixed point */
     picoos_int32 *int_vec38; /*reserved for cepstral vectors input - fixed point */
     picoos_int32 *int_vec30; /*reserved for cepstral vectors input - fixed point */
     picoos_int32 *int_vec31; /*reserved for cepstral vectors input - fixed point */
 
-    picoos_int32 *int_vec32; /*reserved for cepstral vectors input - fixed point */
-    picoos_int32 *int_vec33; /*reserved for cepstral vectors input - fixed point */
+    union {
+        picoos_int32 *int_vec32; /*reserved for cepstral vectors input - fixed point */
+        picosig2_sample_t *smp_vec32; /*the same, as DSP samples*/
+    };
+    union {
+        picoos_int32 *int_vec33; /*reserved for cepstral vectors input - fixed point */
+        picosig2_sample_t *smp_vec33; /*the same, as DSP samples*/
+    };
 
     picoos_int32 *int_vec34; /* reserved for sin table- fixed point */
     picoos_int32 *int_vec35; /* reserved for cos table - fixed point */
@@ -88,7 +115,7 @@ typedef struct sig_innerobj
     picoos_int16 idx_vect13[CEPST_BUFF_SIZE]; /*reserved for unrectified pitch value bufferingbefore phase smoothing*/
     picoos_int16 idx_vect14[PHASE_BUFF_SIZE]; /*reserved for vox_bnd value buffering before phase smoothing*/
 
-    picoos_int32 *sig_vec1;
+    picosig2_sample_t *sig_vec1;
 
     picoos_single bvalue1; /*reserved for warp*/
     picoos_int32 ibvalue2; /*reserved for voxbnd*/
@@ -123,6 +150,8 @@ typedef struct sig_innerobj
 
     picoos_int16 ivalue20; /*reserved for n_availabe index*/
 
+    picoos_int16 ivalue21; /*reserved for use of the vector kernels*/
+
     picoos_int32 lvalue1; /*reserved for sampling rate*/
     picoos_int32 lvalue2; /*reserved for VCutoff*/
     picoos_int32 lvalue3; /*reserved for UVCutoff*/
@@ -156,15 +185,16 @@ extern void env_spec(sig_innerobj_t *sig_inObj);
 extern void save_transition_frame(sig_innerobj_t *sig_inObj);
 extern void td_psola2(sig_innerobj_t *sig_inObj);
 extern void impulse_response(sig_innerobj_t *sig_inObj);
-extern void overlap_add(sig_innerobj_t *sig_inObj);
+extern void overlap_add(sig_innerobj_t *sig_inObj, picoos_int32 mlt,
+        picoos_int16 *pcm[2]);
 
 /* -------------------------------------------------------------------
  * symbolic vs area assignements
  * -------------------------------------------------------------------*/
-#define WavBuff_p   int_vec26       /*output is Wav buffer (2*FFTSize)*/
+#define WavBuff_p   smp_vec26       /*output is Wav buffer (2*FFTSize)*/
 #define window_p    int_vec25       /*window function (hanning) */
-#define ImpResp_p   int_vec23       /*output step 6*/
-#define imp_p       int_vec24       /*output step 6*/
+#define ImpResp_p   smp_vec23       /*output step 6*/
+#define imp_p       smp_vec24       /*output step 6*/
 #define warp_p      bvalue1         /*warp factor */
 #define voxbnd_p    ibvalue2         /*phase spectra reconstruction noise factor V*/  /*  fixed point */
 #define voxbnd2_p   ibvalue3         /*phase spectra reconstruction noise factor UV */  /*  fixed point */
@@ -194,6 +224,7 @@ extern void overlap_add(sig_innerobj_t *sig_inObj);
 #define UVCutoff_p  lvalue3         /*unvoicing cut off frequency in Hz*/
 /* Reusable area */
 #define wcep_pI     int_vec28       /*input step1*/
+#define spect_p     smp_vec28       /*output step1, in place of wcep_pI*/
 #define d_p         int_vec38       /*output mel_2_lin_init  : table lookup  vector D*/
 #define A_p         idx_vect2       /*output mel_2_lin_init  : table lookup  vector A*/
 #define ang_p       int_vec39       /*output step4*/
@@ -206,8 +237,8 @@ extern void overlap_add(sig_innerobj_t *sig_inObj);
 #define cos_table   int_vec40
 #define norm_window_p int_vec22     /*window function (hanning) */
 #define norm_window2_p int_vec27    /*window function (hanning) */
-#define F2r_p       int_vec32       /*output step 7*/
-#define F2i_p       int_vec33       /*output step 7*/
+#define F2r_p       smp_vec32       /*output step 7*/
+#define F2i_p       smp_vec33       /*output step 7*/
 #define LocV        idx_vect8       /*excitation position voiced pulses*/
 #define LocU        idx_vect9       /*excitation position unvoiced pulses*/
 
@@ -220,6 +251,7 @@ extern void overlap_add(sig_innerobj_t *sig_inObj);
 #define VoxBndBuff    idx_vect14    /*Buffer for incoming VoxBnd values*/
 
 #define n_available   ivalue20      /*variable for indexing the incoming buffers*/
+#define simd_p        ivalue21      /*TRUE to use the vector kernels (picosimd.h)*/
 
 
 #ifdef __cplusplus
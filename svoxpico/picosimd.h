@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2008-2009 SVOX AG, Baslerstr. 30, 8048 Zuerich, Switzerland
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picosimd.h
+ *
+ * Portable 4 x 32 bit integer vector operations for the DSP kernels
+ *
+ * The operations map onto SSE4.1 on x86 and onto NEON on arm64. The
+ * NEON mapping has not been checked against the scalar code on arm64
+ * yet and is only built if PICO_SIMD_NEON is defined; do that together
+ * with PICOSIMD_VERIFY until it has.
+ * Kernels using them are compiled for the vector unit only (see
+ * PICOSIMD_FN) and must only be called when picopal_cpu_features()
+ * reports it; the scalar code stays the reference and the fallback.
+ * Defining PICO_NO_SIMD leaves PICOSIMD undefined and with it all
+ * vector kernels out of the build.
+ *
+ * All macros may evaluate their arguments more than once; pass plain
+ * variables.
+ *
+ * Defining PICOSIMD_VERIFY makes the kernels that support it compute
+ * the scalar result as well and abort at the first difference.
+ *
+ */
+
+#ifndef PICOSIMD_H_
+#define PICOSIMD_H_
+
+#if !defined(PICO_NO_SIMD)
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PICOSIMD_SSE41 1
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && defined(PICO_SIMD_NEON)
+#define PICOSIMD_NEON 1
+#endif
+#endif
+
+#if defined(PICOSIMD_SSE41)
+#include <smmintrin.h>
+#elif defined(PICOSIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(PICOSIMD_VERIFY)
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+#if defined(PICOSIMD_SSE41) || defined(PICOSIMD_NEON)
+#define PICOSIMD 1
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+}
+#endif
+
+#if defined(PICOSIMD_SSE41)
+
+/* the rest of the library is built for the base instruction set; only
+   the kernels marked with this may use SSE4.1 */
+#if defined(__GNUC__)
+#define PICOSIMD_FN __attribute__((target("sse4.1")))
+#else
+#define PICOSIMD_FN
+#endif
+
+typedef __m128i picosimd_int32x4;
+typedef __m128d picosimd_float64x2;
+
+/* the picopal_cpu_features() flag the kernels need */
+#define PICOSIMD_CPU                PICOPAL_CPU_SSE41
+
+/* lanes are numbered in memory order */
+#define PICOSIMD_LOAD(p)            _mm_loadu_si128((const __m128i *) (p))
+#define PICOSIMD_STORE(p, v)        _mm_storeu_si128((__m128i *) (p), (v))
+#define PICOSIMD_SET(l0, l1, l2, l3) _mm_setr_epi32((l0), (l1), (l2), (l3))
+#define PICOSIMD_DUP(x)             _mm_set1_epi32(x)
+#define PICOSIMD_ADD(a, b)          _mm_add_epi32((a), (b))
+#define PICOSIMD_SUB(a, b)          _mm_sub_epi32((a), (b))
+/* low 32 bits of the product, as the C multiplication */
+#define PICOSIMD_MUL(a, b)          _mm_mullo_epi32((a), (b))
+#define PICOSIMD_XOR(a, b)          _mm_xor_si128((a), (b))
+#define PICOSIMD_AND(a, b)          _mm_and_si128((a), (b))
+/* -1 where a > b, 0 elsewhere */
+#define PICOSIMD_CMPGT(a, b)        _mm_cmpgt_epi32((a), (b))
+/* m ? a : b for a mask m as CMPGT returns it */
+#define PICOSIMD_SELECT(m, a, b)    _mm_blendv_epi8((b), (a), (m))
+/* arithmetic shift right and shift left by a constant */
+#define PICOSIMD_SRA(v, s)          _mm_srai_epi32((v), (s))
+#define PICOSIMD_SHL(v, s)          _mm_slli_epi32((v), (s))
+/* wraps for INT_MIN, as the C negation does */
+#define PICOSIMD_ABS(v)             _mm_abs_epi32(v)
+/* (l1, l0, l3, l2): exchanges real and imaginary part of two complex */
+#define PICOSIMD_SWAP_PAIRS(v)      _mm_shuffle_epi32((v), _MM_SHUFFLE(2, 3, 0, 1))
+/* (l0, l1, l3, l2) */
+#define PICOSIMD_SWAP_HIGH_PAIR(v)  _mm_shuffle_epi32((v), _MM_SHUFFLE(2, 3, 1, 0))
+/* (l2, l3, l0, l1) */
+#define PICOSIMD_SWAP_HALVES(v)     _mm_shuffle_epi32((v), _MM_SHUFFLE(1, 0, 3, 2))
+/* (l3, l2, l1, l0) */
+#define PICOSIMD_REVERSE(v)         _mm_shuffle_epi32((v), _MM_SHUFFLE(0, 1, 2, 3))
+/* (a0, a1, b0, b1) and (a2, a3, b2, b3) */
+#define PICOSIMD_LOW_HALVES(a, b)   _mm_unpacklo_epi64((a), (b))
+#define PICOSIMD_HIGH_HALVES(a, b)  _mm_unpackhi_epi64((a), (b))
+/* stores the lanes as 16 bit, saturated to -32768..32767 */
+#define PICOSIMD_STORE_SAT16(p, v)  _mm_storel_epi64((__m128i *) (p), _mm_packs_epi32((v), (v)))
+/* eight 16 bit values, and the products of the 16 bit lanes of a and b
+   with each two neighbours added into a 32 bit lane */
+#define PICOSIMD_LOAD16(p)          _mm_loadu_si128((const __m128i *) (p))
+#define PICOSIMD_DOT16(a, b)        _mm_madd_epi16((a), (b))
+
+/* lanes 0, 1 and lanes 2, 3 as doubles */
+#define PICOSIMD_F64_LOW(v)         _mm_cvtepi32_pd(v)
+#define PICOSIMD_F64_HIGH(v)        _mm_cvtepi32_pd(PICOSIMD_SWAP_HALVES(v))
+#define PICOSIMD_F64_DUP(x)         _mm_set1_pd(x)
+#define PICOSIMD_F64_MUL(a, b)      _mm_mul_pd((a), (b))
+#define PICOSIMD_F64_DIV(a, b)      _mm_div_pd((a), (b))
+/* (int32) of the two doubles in lo and the two in hi, truncating as the C cast */
+#define PICOSIMD_F64_TRUNC(lo, hi)  _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi))
+/* the doubles whose upper 32 bits are lanes 0, 1 (lanes 2, 3) and whose
+   lower 32 bits are 0 */
+#define PICOSIMD_F64_BITS_LOW(v)    _mm_castsi128_pd(_mm_unpacklo_epi32(_mm_setzero_si128(), (v)))
+#define PICOSIMD_F64_BITS_HIGH(v)   _mm_castsi128_pd(_mm_unpackhi_epi32(_mm_setzero_si128(), (v)))
+
+#elif defined(PICOSIMD_NEON)
+
+#define PICOSIMD_FN
+
+typedef int32x4_t picosimd_int32x4;
+typedef float64x2_t picosimd_float64x2;
+
+#define PICOSIMD_CPU                PICOPAL_CPU_NEON
+
+#define PICOSIMD_LOAD(p)            vld1q_s32((const int32_t *) (p))
+#define PICOSIMD_STORE(p, v)        vst1q_s32((int32_t *) (p), (v))
+#define PICOSIMD_SET(l0, l1, l2, l3) vld1q_s32((const int32_t[4]) { (l0), (l1), (l2), (l3) })
+#define PICOSIMD_DUP(x)             vdupq_n_s32(x)
+#define PICOSIMD_ADD(a, b)          vaddq_s32((a), (b))
+#define PICOSIMD_SUB(a, b)          vsubq_s32((a), (b))
+#define PICOSIMD_MUL(a, b)          vmulq_s32((a), (b))
+#define PICOSIMD_XOR(a, b)          veorq_s32((a), (b))
+#define PICOSIMD_AND(a, b)          vandq_s32((a), (b))
+#define PICOSIMD_CMPGT(a, b)        vreinterpretq_s32_u32(vcgtq_s32((a), (b)))
+#define PICOSIMD_SELECT(m, a, b)    vbslq_s32(vreinterpretq_u32_s32(m), (a), (b))
+#define PICOSIMD_SRA(v, s)          vshrq_n_s32((v), (s))
+#define PICOSIMD_SHL(v, s)          vshlq_n_s32((v), (s))
+#define PICOSIMD_ABS(v)             vabsq_s32(v)
+#define PICOSIMD_SWAP_PAIRS(v)      vrev64q_s32(v)
+#define PICOSIMD_SWAP_HIGH_PAIR(v)  vcombine_s32(vget_low_s32(v), vrev64_s32(vget_high_s32(v)))
+#define PICOSIMD_SWAP_HALVES(v)     vextq_s32((v), (v), 2)
+#define PICOSIMD_REVERSE(v)         vextq_s32(vrev64q_s32(v), vrev64q_s32(v), 2)
+#define PICOSIMD_LOW_HALVES(a, b)   vcombine_s32(vget_low_s32(a), vget_low_s32(b))
+#define PICOSIMD_HIGH_HALVES(a, b)  vcombine_s32(vget_high_s32(a), vget_high_s32(b))
+#define PICOSIMD_STORE_SAT16(p, v)  vst1_s16((int16_t *) (p), vqmovn_s32(v))
+#define PICOSIMD_LOAD16(p)          vreinterpretq_s32_s16(vld1q_s16((const int16_t *) (p)))
+#define PICOSIMD_DOT16(a, b)        vpaddq_s32(vmull_s16(vget_low_s16(vreinterpretq_s16_s32(a)), vget_low_s16(vreinterpretq_s16_s32(b))), \
+                                        vmull_high_s16(vreinterpretq_s16_s32(a), vreinterpretq_s16_s32(b)))
+
+#define PICOSIMD_F64_LOW(v)         vcvtq_f64_s64(vmovl_s32(vget_low_s32(v)))
+#define PICOSIMD_F64_HIGH(v)        vcvtq_f64_s64(vmovl_high_s32(v))
+#define PICOSIMD_F64_DUP(x)         vdupq_n_f64(x)
+#define PICOSIMD_F64_MUL(a, b)      vmulq_f64((a), (b))
+#define PICOSIMD_F64_DIV(a, b)      vdivq_f64((a), (b))
+/* saturating, as the scalar fcvtzs the C cast compiles to */
+#define PICOSIMD_F64_TRUNC(lo, hi)  vcombine_s32(vqmovn_s64(vcvtq_s64_f64(lo)), vqmovn_s64(vcvtq_s64_f64(hi)))
+#define PICOSIMD_F64_BITS_LOW(v)    vreinterpretq_f64_s32(vzip1q_s32(vdupq_n_s32(0), (v)))
+#define PICOSIMD_F64_BITS_HIGH(v)   vreinterpretq_f64_s32(vzip2q_s32(vdupq_n_s32(0), (v)))
+
+#endif
+
+#if defined(PICOSIMD)
+
+/* negates the lanes where 'm' is -1 and keeps those where it is 0 */
+#define PICOSIMD_NEG_MASK(v, m)     PICOSIMD_SUB(PICOSIMD_XOR((v), (m)), (m))
+
+/* shift right truncating towards zero, i.e. x>=0 ? x>>s : -((-x)>>s) */
+#define PICOSIMD_SHR_TZ(v, s)       PICOSIMD_NEG_MASK(PICOSIMD_SRA(PICOSIMD_ABS(v), (s)), PICOSIMD_SRA((v), 31))
+
+/* sum of the four lanes, modulo 2^32 */
+#if defined(PICOSIMD_SSE41)
+#define PICOSIMD_HSUM(v)            _mm_cvtsi128_si32(_mm_add_epi32(_mm_add_epi32((v), PICOSIMD_SWAP_HALVES(v)), \
+                                        PICOSIMD_SWAP_PAIRS(_mm_add_epi32((v), PICOSIMD_SWAP_HALVES(v)))))
+#else
+#define PICOSIMD_HSUM(v)            vaddvq_s32(v)
+#endif
+
+#endif /* PICOSIMD */
+
+#if defined(PICOSIMD_VERIFY)
+/* aborts unless the n int32 at vec equal the scalar reference at ref */
+#define PICOSIMD_VERIFY_EQUAL(what, ref, vec, n) do { \
+        int picosimd_i_; \
+        for (picosimd_i_ = 0; picosimd_i_ < (int) (n); picosimd_i_++) { \
+            if ((ref)[picosimd_i_] != (vec)[picosimd_i_]) { \
+                fprintf(stderr, "picosimd: %s differs from the scalar code at %d: %ld instead of %ld\n", \
+                        (what), picosimd_i_, (long) (vec)[picosimd_i_], (long) (ref)[picosimd_i_]); \
+                abort(); \
+            } \
+        } \
+    } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*PICOSIMD_H_*/
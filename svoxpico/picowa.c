@@ -75,6 +75,7 @@ typedef struct wa_subobj {
 
     /* dtposp knowledge base */
     picokdt_DtPosP dtposp;
+    picokdt_dtstate_t dtstate;
 } wa_subobj_t;
 
 
@@ -213,7 +214,7 @@ static picoos_uint8 waClassifyPos(register picodata_ProcessingUnit this,
     }
 
     /* construct input vector, which is set in dtposp */
-    if (!picokdt_dtPosPconstructInVec(wa->dtposp, graph, graphlen, specchar)) {
+    if (!picokdt_dtPosPconstructInVec(wa->dtposp, &wa->dtstate, graph, graphlen, specchar)) {
         /* error constructing invec */
         PICODBG_WARN(("problem with invec"));
         picoos_emRaiseWarning(this->common->em, PICO_WARN_INVECTOR, NULL, NULL);
@@ -221,7 +222,7 @@ static picoos_uint8 waClassifyPos(register picodata_ProcessingUnit this,
     }
 
     /* classify */
-    if (!picokdt_dtPosPclassify(wa->dtposp)) {
+    if (!picokdt_dtPosPclassify(wa->dtposp, &wa->dtstate)) {
         /* error doing classification */
         PICODBG_WARN(("problem classifying"));
         picoos_emRaiseWarning(this->common->em, PICO_WARN_CLASSIFICATION,
@@ -230,7 +231,7 @@ static picoos_uint8 waClassifyPos(register picodata_ProcessingUnit this,
     }
 
     /* decompose */
-    if (!picokdt_dtPosPdecomposeOutClass(wa->dtposp, &dtres)) {
+    if (!picokdt_dtPosPdecomposeOutClass(wa->dtposp, &wa->dtstate, &dtres)) {
         /* error decomposing */
         PICODBG_WARN(("problem decomposing"));
         picoos_emRaiseWarning(this->common->em, PICO_WARN_OUTVECTOR,